@@ -0,0 +1,161 @@
+#!/bin/sh
+# Time the benchmark programs named as arguments (.spl or .asm files)
+# in each of the VM's execution modes, in spl-run (for .spl files),
+# and in the independent hw1 VM (for .asm files, as a reference point),
+# reporting the median time of the timed runs and the resulting
+# millions of SSM instructions executed per second (MIPS).
+# For .spl files, also report how many instructions
+# the compiler generated per SPL statement.
+# Usage: bench.sh [-w warmups] [-r repetitions] file ...
+: ${COMPILER=./compiler}
+: ${ASM=vm/asm}
+: ${RUNVM=vm/vm}
+: ${SPLRUN=./spl-run}
+: ${REFVM=./hw1-vm}
+: ${INPUTS=char-inputs.txt}
+: ${MODES="vm vm-t vm-s vm-m vm-i spl-run hw1-vm"}
+
+warmups=1
+reps=5
+while test $# -gt 0
+do
+    case "$1" in
+    -w) warmups=$2; shift 2 ;;
+    -r) reps=$2; shift 2 ;;
+    -*) echo "Usage: $0 [-w warmups] [-r repetitions] file ..." >&2
+	exit 2 ;;
+    *) break ;;
+    esac
+done
+if test $# -eq 0
+then
+    echo "Usage: $0 [-w warmups] [-r repetitions] file ..." >&2
+    exit 2
+fi
+
+# the current time in nanoseconds
+now() {
+    date +%s%N
+}
+
+# Run the command given as arguments once, with stdin from $INPUTS,
+# discarding its output, and fail if the command fails
+run_once() {
+    "$@" < "$INPUTS" > /dev/null 2>&1
+}
+
+# Print the median of the numbers on stdin, one per line
+median() {
+    sort -n | awk '{ v[NR] = $1 }
+		   END { if (NR % 2) print v[(NR + 1) / 2];
+			 else print (v[NR / 2] + v[NR / 2 + 1]) / 2 }'
+}
+
+# Time the command given as arguments,
+# doing $warmups untimed runs and then $reps timed runs,
+# and print the median time of the timed runs in nanoseconds,
+# failing (and printing nothing) if any run fails
+time_runs() {
+    i=0
+    while test $i -lt $warmups
+    do
+	run_once "$@" || return 1
+	i=`expr $i + 1`
+    done
+    times=
+    i=0
+    while test $i -lt $reps
+    do
+	start=`now`
+	run_once "$@" || return 1
+	end=`now`
+	times="$times `expr $end - $start`"
+	i=`expr $i + 1`
+    done
+    for t in $times
+    do
+	echo $t
+    done | median
+}
+
+# Print the number of statements in the SPL file $1,
+# counting each assignment, call, if, while, read, and print statement
+count_statements() {
+    sed -e 's/%.*//' "$1" | grep -o ':=\|[A-Za-z][A-Za-z0-9]*' \
+	| grep -c '^\(:=\|call\|if\|while\|read\|print\)$'
+}
+
+# Print the number of instructions in the text section of the BOF file $1
+count_code() {
+    $RUNVM -p "$1" | grep -c '^ *[0-9]*: [A-Z]'
+}
+
+printf "%-24s %-8s %12s %10s\n" "Benchmark" "Mode" "Median (ms)" "MIPS"
+status=0
+for f in "$@"
+do
+    name=`basename "$f"`
+    case "$f" in
+    *.spl) bof=${f%.spl}.bof
+	   $COMPILER "$f" > /dev/null ;;
+    *.asm) bof=${f%.asm}.bof
+	   $ASM "$f" > /dev/null ;;
+    *) echo "$0: $f is not a .spl or .asm file" >&2
+       status=1; continue ;;
+    esac
+    if test $? -ne 0 || test ! -r "$bof"
+    then
+	echo "$0: could not translate $f" >&2
+	status=1
+	continue
+    fi
+    # the instruction counts are the same in every mode
+    counts=`$RUNVM -i "$bof" < "$INPUTS" 2>&1 > /dev/null | grep '^Counts:'`
+    set -- $counts
+    instrs=${2:-0}
+    for mode in $MODES
+    do
+	case "$mode" in
+	vm) cmd="$RUNVM" ;;
+	vm-?) cmd="$RUNVM -${mode#vm-}" ;;
+	spl-run) case "$f" in
+		 *.spl) cmd="$SPLRUN" ; test -x "$SPLRUN" || continue ;;
+		 *) continue ;;
+		 esac ;;
+	hw1-vm) # the hw1 VM only has the base instruction set,
+		# which compiled SPL programs go beyond
+		case "$f" in
+		*.asm) cmd="$REFVM" ; test -x "$REFVM" || continue ;;
+		*) continue ;;
+		esac ;;
+	*) echo "$0: unknown mode $mode" >&2
+	   status=1; continue ;;
+	esac
+	if test $mode = spl-run
+	then
+	    arg=$f
+	else
+	    arg=$bof
+	fi
+	# a run that fails is not timed, as it may have stopped early
+	if ! ns=`time_runs $cmd "$arg"`
+	then
+	    printf "%-24s %-8s %12s %10s\n" "$name" "$mode" "failed" "-"
+	    status=1
+	    continue
+	fi
+	awk -v name="$name" -v mode="$mode" -v ns="$ns" -v instrs="$instrs" \
+	    'BEGIN { printf "%-24s %-8s %12.1f %10.1f\n", name, mode,
+		     ns / 1e6, (ns > 0 ? instrs * 1e3 / ns : 0) }'
+    done
+    case "$f" in
+    *.spl) stmts=`count_statements "$f"`
+	   code=`count_code "$bof"`
+	   awk -v name="$name" -v instrs="$instrs" -v stmts="$stmts" \
+	       -v code="$code" \
+	       'BEGIN { printf "%-24s %d instructions executed; %d generated for %d statements (%.1f per statement)\n",
+			name, instrs, code, stmts, (stmts > 0 ? code / stmts : 0) }' ;;
+    *) printf "%-24s %d instructions executed\n" "$name" "$instrs" ;;
+    esac
+done
+exit $status
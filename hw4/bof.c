@@ -1,7 +1,10 @@
 /* $Id: bof.c,v 1.2 2024/10/23 13:38:20 leavens Exp $ */
+#define _POSIX_C_SOURCE 200809L
 // #include <sys/types.h>
 #include <sys/stat.h>
-// #include <unistd.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -32,14 +35,18 @@ BOFFILE bof_read_open(const char *filename) {
 }
 
 // Return the size (in bytes) of bf
+// (which may be a file in memory, so this does not use stat)
 size_t bof_file_bytes(BOFFILE bf)
 {
-    struct stat st;
-    if (stat(bf.filename, &st) < 0) {
-	bail_with_error("Cannot stat %s to get its size!", bf.filename);
+    long pos = ftell(bf.fileptr);
+    if (pos < 0 || fseek(bf.fileptr, 0L, SEEK_END) != 0) {
+	bail_with_error("Cannot seek in %s to get its size!", bf.filename);
+    }
+    long size = ftell(bf.fileptr);
+    if (size < 0 || fseek(bf.fileptr, pos, SEEK_SET) != 0) {
+	bail_with_error("Cannot seek in %s to get its size!", bf.filename);
     }
-    ;
-    return st.st_size;
+    return size;
 }
 
 // Return true just when bf is at its end, false otherwise
@@ -100,6 +107,115 @@ BOFHeader bof_read_header(BOFFILE bf) {
     */
 }
 
+// Requires: img.bytes holds img.size bytes
+// Check that img holds a complete header with the right magic number,
+// and sections whose lengths fit in the rest of it,
+// then fill in img's header and section pointers and return img.
+// If any errors are encountered, release img and exit with an error message.
+static BOFImage check_image(BOFImage img)
+{
+    const char *msg = NULL;
+    if (img.size < sizeof(BOFHeader)) {
+	msg = "is too short to hold a header";
+    } else {
+	memcpy(&img.header, img.bytes, sizeof(BOFHeader));
+	uint64_t text_bytes = (uint64_t) img.header.text_length * BYTES_PER_WORD;
+	uint64_t data_bytes = (uint64_t) img.header.data_length * BYTES_PER_WORD;
+	if (!bof_has_correct_magic_number(img.header)) {
+	    msg = "has the wrong magic number";
+	} else if (img.header.text_length < 0 || img.header.data_length < 0) {
+	    msg = "has a negative section length";
+	} else if (sizeof(BOFHeader) + text_bytes + data_bytes > img.size) {
+	    msg = "is too short to hold the sections its header describes";
+	} else {
+	    img.sections_end = sizeof(BOFHeader) + text_bytes + data_bytes;
+	    BOFZeroFill zf;
+	    if (img.sections_end + sizeof(zf) <= img.size) {
+		memcpy(&zf, (const char *) img.bytes + img.sections_end,
+		       sizeof(zf));
+		if (strncmp(zf.magic, ZERO_FILL_MAGIC,
+			    MAGIC_BUFFER_SIZE) == 0) {
+		    img.zero_length = zf.zero_length;
+		    img.sections_end += sizeof(zf);
+		}
+	    }
+	    if (img.zero_length < 0) {
+		msg = "has a negative zero-fill length";
+	    }
+	}
+    }
+    if (msg != NULL) {
+	bof_unmap(img);
+	bail_with_error("File %s (%lu bytes) %s!", img.filename,
+			(unsigned long) img.size, msg);
+    }
+    const char *sections = (const char *) img.bytes + sizeof(BOFHeader);
+    img.text = (const uword_type *) sections;
+    img.data = (const word_type *) (img.text + img.header.text_length);
+    return img;
+}
+
+// Map the binary object file named filename into memory,
+// check that its header has the right magic number
+// and that its sections fit in the file,
+// and return the BOFImage for it.
+// Exit the program with an error if this fails.
+BOFImage bof_map(const char *filename)
+{
+    BOFImage img;
+    memset(&img, 0, sizeof(img));
+    img.filename = filename;
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+	bail_with_error("Error opening file for reading: %s", filename);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+	close(fd);
+	bail_with_error("Cannot get the size of %s", filename);
+    }
+    img.size = st.st_size;
+    if (img.size >= sizeof(BOFHeader)) {
+	void *p = mmap(NULL, img.size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (p == MAP_FAILED) {
+	    close(fd);
+	    bail_with_error("Cannot map %s into memory", filename);
+	}
+	img.bytes = p;
+	img.mapped = true;
+    }
+    // the mapping stays valid after the file is closed
+    close(fd);
+    return check_image(img);
+}
+
+// Requires: buf is aligned for words, and holds bytes bytes
+//           that stay allocated while the result is in use
+// Check that the buffer buf, which holds the contents of
+// a binary object file named name (in error messages),
+// has a good header and sections that fit in it,
+// and return the BOFImage for it (which does not copy buf).
+// Exit the program with an error if this fails.
+BOFImage bof_map_memory(const char *name, const void *buf, size_t bytes)
+{
+    assert(((uintptr_t) buf) % BYTES_PER_WORD == 0);
+    BOFImage img;
+    memset(&img, 0, sizeof(img));
+    img.filename = name;
+    img.bytes = buf;
+    img.size = bytes;
+    img.mapped = false;
+    return check_image(img);
+}
+
+// Release the given image (unmapping its file if it was mapped)
+void bof_unmap(BOFImage img)
+{
+    if (img.mapped) {
+	munmap((void *) img.bytes, img.size);
+    }
+}
+
 // Requires: f is open for writing
 // Write the magic number in hexadecimal notation on f, followed by a newline;
 // Note: this is just for help in writing the documentation
@@ -128,6 +244,44 @@ BOFFILE bof_write_open(const char *filename) {
     return bf;
 }
 
+// Open a binary file in memory for reading,
+// whose contents are the given number of bytes starting at buf,
+// and which is named name (in error messages).
+// Exit the program with an error if this fails,
+// otherwise return the BOFFILE for it.
+BOFFILE bof_read_open_memory(const char *name, const void *buf, size_t bytes)
+{
+    BOFFILE bf;
+    bf.fileptr = fmemopen((void *) buf, bytes, "rb");
+    bf.filename = name;
+
+    if (bf.fileptr == NULL) {
+	bail_with_error("Error opening %s in memory for reading", name);
+    }
+
+    return bf;
+}
+
+// Open a binary file in memory for writing,
+// which is named name (in error messages).
+// When the BOFFILE is closed, *bufp is set to point to
+// a malloc-allocated buffer holding what was written,
+// and *bytesp is set to the number of bytes in it.
+// Exit the program with an error if this fails,
+// otherwise return the BOFFILE for it.
+BOFFILE bof_write_open_memory(const char *name, char **bufp, size_t *bytesp)
+{
+    BOFFILE bf;
+    bf.fileptr = open_memstream(bufp, bytesp);
+    bf.filename = name;
+
+    if (bf.fileptr == NULL) {
+	bail_with_error("Error opening %s in memory for writing", name);
+    }
+
+    return bf;
+}
+
 // Requres: bf is open
 // Close the given binary file
 // Exit the program with an error if this fails.
@@ -181,6 +335,212 @@ void bof_write_magic_to_header(BOFHeader *bh)
     assert(bof_has_correct_magic_number(*bh));
 }
 
+// the initial capacity (in bytes) of a BOFBuffer
+#define BOF_BUFFER_INITIAL_CAPACITY 4096
+
+// Initialize bb to hold an empty binary object file,
+// whose text section is the first to be added to
+void bof_buffer_initialize(BOFBuffer *bb)
+{
+    bb->capacity = BOF_BUFFER_INITIAL_CAPACITY;
+    bb->bytes = (char *) malloc(bb->capacity);
+    if (bb->bytes == NULL) {
+	bail_with_error("No space to allocate a BOF buffer!");
+    }
+    // leave room for the header, which is filled in by bof_buffer_write
+    bb->size = sizeof(BOFHeader);
+    bb->text_end = 0;
+    bb->data_end = 0;
+    bb->zero_words = 0;
+}
+
+// Make sure that bb has room for at least bytes more bytes
+static void buffer_reserve(BOFBuffer *bb, size_t bytes)
+{
+    if (bb->size + bytes <= bb->capacity) {
+	return;
+    }
+    size_t cap = bb->capacity;
+    while (bb->size + bytes > cap) {
+	cap *= 2;
+    }
+    char *p = (char *) realloc(bb->bytes, cap);
+    if (p == NULL) {
+	bail_with_error("No space to grow a BOF buffer to %lu bytes!",
+			(unsigned long) cap);
+    }
+    bb->bytes = p;
+    bb->capacity = cap;
+}
+
+// Requires: bb has been initialized
+// Add any zeros waiting at the end of bb's data section to its bytes
+// (for formats that do not use zero-fill records)
+void bof_buffer_flush_zeros(BOFBuffer *bb)
+{
+    if (bb->zero_words == 0 || bb->data_end != 0) {
+	return;
+    }
+    size_t bytes = (size_t) bb->zero_words * BYTES_PER_WORD;
+    buffer_reserve(bb, bytes);
+    memset(bb->bytes + bb->size, 0, bytes);
+    bb->size += bytes;
+    bb->zero_words = 0;
+}
+
+// Requires: bb has been initialized
+// Add the given word to the end of the section being built in bb
+void bof_buffer_add_word(BOFBuffer *bb, word_type w)
+{
+    bof_buffer_flush_zeros(bb);
+    buffer_reserve(bb, BYTES_PER_WORD);
+    memcpy(bb->bytes + bb->size, &w, BYTES_PER_WORD);
+    bb->size += BYTES_PER_WORD;
+}
+
+// Requires: bb has been initialized and the size of buf is at least bytes
+// Add the given number of bytes from buf
+// to the end of the section being built in bb
+void bof_buffer_add_bytes(BOFBuffer *bb, size_t bytes, const void *buf)
+{
+    bof_buffer_flush_zeros(bb);
+    buffer_reserve(bb, bytes);
+    memcpy(bb->bytes + bb->size, buf, bytes);
+    bb->size += bytes;
+}
+
+// Requires: bb's text section is still being built
+//           and holds a whole number of words
+// End bb's text section, so that what is added to bb later
+// goes in its data section
+void bof_buffer_end_text(BOFBuffer *bb)
+{
+    assert(bb->text_end == 0);
+    assert((bb->size - sizeof(BOFHeader)) % BYTES_PER_WORD == 0);
+    bb->text_end = bb->size;
+}
+
+// Requires: bb's text section has ended, but not its data section
+// Add the given number of words of zeros to the end of bb's data section.
+// If nothing else is added to the data section after them,
+// they are written as a zero-fill record (see BOFZeroFill),
+// so they take no space in the file.
+void bof_buffer_add_zeros(BOFBuffer *bb, word_type words)
+{
+    assert(bb->text_end != 0 && bb->data_end == 0 && words >= 0);
+    bb->zero_words += words;
+}
+
+// Requires: bb's text section has ended, but not its data section,
+//           which holds a whole number of words
+// End bb's data section (adding the zero-fill record, if it needs one),
+// so that what is added to bb later
+// follows the sections that the header describes
+void bof_buffer_end_data(BOFBuffer *bb)
+{
+    assert(bb->text_end != 0 && bb->data_end == 0);
+    assert((bb->size - bb->text_end) % BYTES_PER_WORD == 0);
+    bb->data_end = bb->size;
+    if (bb->zero_words > 0) {
+	BOFZeroFill zf;
+	memcpy(zf.magic, ZERO_FILL_MAGIC, MAGIC_BUFFER_SIZE);
+	zf.zero_length = bb->zero_words;
+	buffer_reserve(bb, sizeof(zf));
+	memcpy(bb->bytes + bb->size, &zf, sizeof(zf));
+	bb->size += sizeof(zf);
+    }
+}
+
+// Requires: bb has been initialized
+// Return the number of words in bb's text section
+// (so far, if it is still being built)
+int bof_buffer_text_words(const BOFBuffer *bb)
+{
+    size_t end = (bb->text_end == 0) ? bb->size : bb->text_end;
+    return (end - sizeof(BOFHeader)) / BYTES_PER_WORD;
+}
+
+// Requires: 0 <= i < bof_buffer_text_words(bb)
+// Return (a pointer to) word i of bb's text section,
+// which is valid until something more is added to bb
+word_type *bof_buffer_text_word(BOFBuffer *bb, int i)
+{
+    assert(0 <= i && i < bof_buffer_text_words(bb));
+    return (word_type *) (bb->bytes + sizeof(BOFHeader)) + i;
+}
+
+// Requires: bb has been initialized
+// Return the number of words (rounded up) in bb's data section
+int bof_buffer_data_words(const BOFBuffer *bb)
+{
+    if (bb->text_end == 0) {
+	return 0;
+    }
+    size_t end = (bb->data_end == 0) ? bb->size : bb->data_end;
+    return (end - bb->text_end + BYTES_PER_WORD - 1) / BYTES_PER_WORD;
+}
+
+// Requires: bb has been initialized
+// Return the number of words of zeros at the end of bb's data section
+// that are waiting to be added (or are in its zero-fill record)
+int bof_buffer_zero_words(const BOFBuffer *bb)
+{
+    return bb->zero_words;
+}
+
+// Requires: bf is open for writing in binary,
+//           and bb's sections each hold a whole number of words
+// Write the binary object file built in bb to bf all at once,
+// with a header that is hdr, except that its magic number
+// and its text and data lengths are taken from bb
+// (whose data section is ended, if that has not been done),
+// then release bb's storage.
+// Exit the program with an error if this fails.
+void bof_buffer_write(BOFFILE bf, BOFBuffer *bb, BOFHeader hdr)
+{
+    if (bb->text_end != 0 && bb->data_end == 0) {
+	bof_buffer_end_data(bb);
+    }
+    assert(bb->size % BYTES_PER_WORD == 0);
+    bof_write_magic_to_header(&hdr);
+    hdr.text_length = bof_buffer_text_words(bb);
+    hdr.data_length = bof_buffer_data_words(bb);
+    memcpy(bb->bytes, &hdr, sizeof(BOFHeader));
+
+    // files are written with write, bypassing stdio's buffer;
+    // files in memory have no file descriptor, so use fwrite for those
+    bool ok = true;
+    int fd = -1;
+    if (fflush(bf.fileptr) == 0) {
+	fd = fileno(bf.fileptr);
+    }
+    if (fd < 0) {
+	ok = (fwrite(bb->bytes, bb->size, 1, bf.fileptr) == 1);
+    } else {
+	size_t done = 0;
+	while (ok && done < bb->size) {
+	    ssize_t wr = write(fd, bb->bytes + done, bb->size - done);
+	    ok = (wr > 0);
+	    done += (ok ? wr : 0);
+	}
+    }
+    size_t bytes = bb->size;
+    bof_buffer_free(bb);
+    if (!ok) {
+	bail_with_error("Cannot write %lu bytes to %s",
+			(unsigned long) bytes, bf.filename);
+    }
+}
+
+// Release the storage held by bb (without writing it)
+void bof_buffer_free(BOFBuffer *bb)
+{
+    free(bb->bytes);
+    bb->bytes = NULL;
+    bb->size = 0;
+    bb->capacity = 0;
+}
+
 // Does the given header have the appropriate magic number?
 bool bof_has_correct_magic_number(BOFHeader bh)
 {
@@ -18,12 +18,57 @@ typedef struct { // Field magic should hold value of MAGIC (with no null char)
     word_type stack_bottom_addr;   // word address of stack "bottom" (FP)
 } BOFHeader;
 
+// The data section may be followed by a zero-fill record,
+// whose magic number is ZERO_FILL_MAGIC, giving the number of words
+// of zeros that follow the data section in memory
+// (and that are not in the file, so large uninitialized data is free).
+// Files without one are laid out as before, and loaders that do not
+// look for it still work, as the VM's memory starts out zeroed.
+#define ZERO_FILL_MAGIC "BZ32"
+
+typedef struct {
+    char      magic[MAGIC_BUFFER_SIZE];  // ZERO_FILL_MAGIC (no null char)
+    word_type zero_length;  // words of zeros following the data section
+} BOFZeroFill;
+
 // a type for Binary Output Files
 typedef struct {
     FILE *fileptr;
     const char *filename;
 } BOFFILE;
 
+// a binary object file held in memory (usually mapped from its file),
+// whose header has been checked against its size,
+// so that its sections can be used without further reads or checks
+typedef struct {
+    const char *filename;
+    BOFHeader header;
+    const uword_type *text;  // the text section (header.text_length words)
+    const word_type *data;   // the data section (header.data_length words)
+    word_type zero_length;   // words of zeros after the data (see BOFZeroFill)
+    size_t sections_end;     // the offset past the sections (and zero fill),
+                             // where any optional sections start
+    const void *bytes;       // all of the file's bytes
+    size_t size;             // the size of the file in bytes
+    bool mapped;             // was bytes mapped by bof_map?
+} BOFImage;
+
+// a buffer in which a binary object file is built up in memory,
+// the text section first and then the data section
+// (and then any optional sections, such as debugging information),
+// so that the whole file can be written at once by bof_buffer_write
+typedef struct {
+    char *bytes;       // space for the header, then the sections' bytes
+    size_t size;       // the number of bytes used (including the header)
+    size_t capacity;   // the number of bytes allocated
+    size_t text_end;   // the offset where the text section ends,
+                       // or 0 if the text section is still being added to
+    size_t data_end;   // the offset where the data section ends,
+                       // or 0 if the data section is not yet complete
+    word_type zero_words;  // words of zeros at the end of the data section
+                           // that have not been added to bytes
+} BOFBuffer;
+
 // Open filename for reading as a binary file
 // Exit the program with an error if this fails,
 // otherwise return the FILE pointer to the open file.
@@ -50,11 +95,49 @@ size_t bof_read_bytes(BOFFILE bf, size_t bytes, void *buf);
 // If any errors are encountered, exit with an error message.
 extern BOFHeader bof_read_header(BOFFILE);
 
+// Map the binary object file named filename into memory,
+// check that its header has the right magic number
+// and that its sections fit in the file,
+// and return the BOFImage for it.
+// Exit the program with an error if this fails.
+extern BOFImage bof_map(const char *filename);
+
+// Requires: buf is aligned for words, and holds bytes bytes
+//           that stay allocated while the result is in use
+// Check that the buffer buf, which holds the contents of
+// a binary object file named name (in error messages),
+// has a good header and sections that fit in it,
+// and return the BOFImage for it (which does not copy buf).
+// Exit the program with an error if this fails.
+extern BOFImage bof_map_memory(const char *name, const void *buf,
+				size_t bytes);
+
+// Release the given image (unmapping its file if it was mapped)
+extern void bof_unmap(BOFImage img);
+
 // Open filename for writing as a binary file
 // Exit the program with an error if this fails,
 // otherwise return the BOFFILE for it.
 extern BOFFILE bof_write_open(const char *filename);
 
+// Open a binary file in memory for reading,
+// whose contents are the given number of bytes starting at buf,
+// and which is named name (in error messages).
+// Exit the program with an error if this fails,
+// otherwise return the BOFFILE for it.
+extern BOFFILE bof_read_open_memory(const char *name, const void *buf,
+				    size_t bytes);
+
+// Open a binary file in memory for writing,
+// which is named name (in error messages).
+// When the BOFFILE is closed, *bufp is set to point to
+// a malloc-allocated buffer holding what was written,
+// and *bytesp is set to the number of bytes in it.
+// Exit the program with an error if this fails,
+// otherwise return the BOFFILE for it.
+extern BOFFILE bof_write_open_memory(const char *name,
+				     char **bufp, size_t *bytesp);
+
 // Requres: bf is open
 // Close the given binary file
 // Exit the program with an error if this fails.
@@ -80,6 +163,77 @@ extern void bof_write_header(BOFFILE bf, const BOFHeader hdr);
 // Write the (bits of the) magic number into the header *bh.
 extern void bof_write_magic_to_header(BOFHeader *bh);
 
+// Initialize bb to hold an empty binary object file,
+// whose text section is the first to be added to
+extern void bof_buffer_initialize(BOFBuffer *bb);
+
+// Requires: bb has been initialized
+// Add the given word to the end of the section being built in bb
+extern void bof_buffer_add_word(BOFBuffer *bb, word_type w);
+
+// Requires: bb has been initialized and the size of buf is at least bytes
+// Add the given number of bytes from buf
+// to the end of the section being built in bb
+extern void bof_buffer_add_bytes(BOFBuffer *bb, size_t bytes,
+				 const void *buf);
+
+// Requires: bb's text section is still being built
+//           and holds a whole number of words
+// End bb's text section, so that what is added to bb later
+// goes in its data section
+extern void bof_buffer_end_text(BOFBuffer *bb);
+
+// Requires: bb's text section has ended, but not its data section
+// Add the given number of words of zeros to the end of bb's data section.
+// If nothing else is added to the data section after them,
+// they are written as a zero-fill record (see BOFZeroFill),
+// so they take no space in the file.
+extern void bof_buffer_add_zeros(BOFBuffer *bb, word_type words);
+
+// Requires: bb has been initialized
+// Add any zeros waiting at the end of bb's data section to its bytes
+// (for formats that do not use zero-fill records)
+extern void bof_buffer_flush_zeros(BOFBuffer *bb);
+
+// Requires: bb's text section has ended, but not its data section,
+//           which holds a whole number of words
+// End bb's data section (adding the zero-fill record, if it needs one), so that what is added to bb later
+// follows the sections that the header describes
+extern void bof_buffer_end_data(BOFBuffer *bb);
+
+// Requires: bb has been initialized
+// Return the number of words in bb's text section
+// (so far, if it is still being built)
+extern int bof_buffer_text_words(const BOFBuffer *bb);
+
+// Requires: 0 <= i < bof_buffer_text_words(bb)
+// Return (a pointer to) word i of bb's text section,
+// which is valid until something more is added to bb
+extern word_type *bof_buffer_text_word(BOFBuffer *bb, int i);
+
+// Requires: bb has been initialized
+// Return the number of words (rounded up) in bb's data section,
+// not counting the zeros that are waiting to be added
+extern int bof_buffer_data_words(const BOFBuffer *bb);
+
+// Requires: bb has been initialized
+// Return the number of words of zeros at the end of bb's data section
+// that are waiting to be added (or are in its zero-fill record)
+extern int bof_buffer_zero_words(const BOFBuffer *bb);
+
+// Requires: bf is open for writing in binary,
+//           and bb's sections each hold a whole number of words
+// Write the binary object file built in bb to bf all at once,
+// with a header that is hdr, except that its magic number
+// and its text and data lengths are taken from bb
+// (whose data section is ended, if that has not been done),
+// then release bb's storage.
+// Exit the program with an error if this fails.
+extern void bof_buffer_write(BOFFILE bf, BOFBuffer *bb, BOFHeader hdr);
+
+// Release the storage held by bb (without writing it)
+extern void bof_buffer_free(BOFBuffer *bb);
+
 // Does the given header have the appropriate magic number?
 bool bof_has_correct_magic_number(BOFHeader bh);
 
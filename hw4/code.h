@@ -4,218 +4,57 @@
 #include <stdbool.h>
 #include "machine_types.h"
 #include "instruction.h"
+#include "file_location.h"
 
 // SSM assembly language instructions (that can be in linked lists)
 typedef struct code_s {
     struct code_s *next;
     bin_instr_t instr;
+    // the source of the statement whose code starts with this instruction
+    // (for debugging information), or NULL if it does not start one
+    file_location *file_loc;
 } code;
 
 // Code creation functions below
 
-// --- computational format instructions from table 3 of the SSM Manual ---
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_nop();
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_add(reg_num_type t, offset_type ot,
-		      reg_num_type s, offset_type os);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_sub(reg_num_type t, offset_type ot,
-		      reg_num_type s, offset_type os);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_cpw(reg_num_type t, offset_type ot,
-		      reg_num_type s, offset_type os);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_cpr(reg_num_type t, reg_num_type s);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_and(reg_num_type t, offset_type ot,
-		      reg_num_type s, offset_type os);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_bor(reg_num_type t, offset_type ot,
-		      reg_num_type s, offset_type os);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_nor(reg_num_type t, offset_type ot,
-		      reg_num_type s, offset_type os);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_xor(reg_num_type t, offset_type ot,
-		      reg_num_type s, offset_type os);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_lwr(reg_num_type t, reg_num_type s, offset_type os);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_swr(reg_num_type t, offset_type ot, reg_num_type s);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_sca(reg_num_type t, offset_type ot,
-		      reg_num_type s, offset_type os);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_lwi(reg_num_type t, offset_type ot,
-		      reg_num_type s, offset_type os);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_neg(reg_num_type t, offset_type ot,
-		      reg_num_type s, offset_type os);
-
-// --- other computational format instructions from table 4 ---
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_lit(reg_num_type t, offset_type o,
-		      immediate_type i);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_ari(reg_num_type r, immediate_type i);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_sri(reg_num_type r, immediate_type i);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_mul(reg_num_type s, offset_type o);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_div(reg_num_type s, offset_type o);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_cfhi(reg_num_type t, offset_type o);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_cflo(reg_num_type t, offset_type o);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_sll(reg_num_type t, offset_type o, shift_type h);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_srl(reg_num_type t, offset_type o, shift_type h);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_jmp(reg_num_type s, offset_type o);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_csi(reg_num_type s, offset_type o);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_jrel(offset_type o);
-
-// --- immediate format instructions from table 5 of the SSM Manual ---
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_addi(reg_num_type r, offset_type o, immediate_type i);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_andi(reg_num_type r, offset_type o, uimmed_type i);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_bori(reg_num_type r, offset_type o, uimmed_type i);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_nori(reg_num_type r, offset_type o, uimmed_type i);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_beq(reg_num_type r, offset_type o, immediate_type i);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_bgez(reg_num_type r, offset_type o, immediate_type i);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_bgtz(reg_num_type r, offset_type o, immediate_type i);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_blez(reg_num_type r, offset_type o, immediate_type i);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_bltz(reg_num_type r, offset_type o, immediate_type i);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_bne(reg_num_type r, offset_type o, immediate_type i);
-
-// --- jump format instructions from table 6 of the SSM Manual ---
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_jmpa(address_type a);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_call(address_type a);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_rtn();
-
-// --- system calls from table 7 of the SSM Manual ---
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_exit(offset_type o);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_pstr(reg_num_type s, offset_type o);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_pint(reg_num_type s, offset_type o);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_pch(reg_num_type s, offset_type o);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_rch(reg_num_type t, offset_type o);
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_stra();
-
-// Create and return a fresh instruction
-// with the named mnemonic and parameters
-extern code *code_notr();
+// There is one code creation function for each instruction
+// in instruction_table.h, named code_ followed by the instruction's
+// lower case name (e.g., code_add for ADD).
+// Each creates and returns a fresh instruction with that mnemonic
+// and the given parameters, which depend on the instruction's form.
+// The parameters for each form are as follows.
+#define CODE_PARAMS_no_arg ()
+#define CODE_PARAMS_two_reg_comp \
+    (reg_num_type t, offset_type ot, reg_num_type s, offset_type os)
+#define CODE_PARAMS_two_reg_no_offsets (reg_num_type t, reg_num_type s)
+#define CODE_PARAMS_no_target_offset \
+    (reg_num_type t, reg_num_type s, offset_type os)
+#define CODE_PARAMS_no_source_offset \
+    (reg_num_type t, offset_type ot, reg_num_type s)
+#define CODE_PARAMS_one_reg_offset_arg \
+    (reg_num_type t, offset_type o, immediate_type i)
+#define CODE_PARAMS_one_reg_arg (reg_num_type r, immediate_type i)
+#define CODE_PARAMS_one_reg_offset (reg_num_type s, offset_type o)
+#define CODE_PARAMS_shift (reg_num_type t, offset_type o, shift_type h)
+#define CODE_PARAMS_arg_only (offset_type o)
+#define CODE_PARAMS_immed_arith \
+    (reg_num_type r, offset_type o, immediate_type i)
+#define CODE_PARAMS_immed_bool (reg_num_type r, offset_type o, uimmed_type u)
+#define CODE_PARAMS_branch_test \
+    (reg_num_type r, offset_type o, immediate_type i)
+#define CODE_PARAMS_reg_comp (reg_num_type d, reg_num_type s, reg_num_type t)
+#define CODE_PARAMS_reg_branch \
+    (reg_num_type s, reg_num_type t, immediate_type o)
+#define CODE_PARAMS_jump (address_type a)
+#define CODE_PARAMS_offset_only (offset_type o)
+
+// Notes on particular instructions:
+// BCP takes the number of words to copy from the top of the stack,
+// and BFL takes the value stored from the top of the stack.
+
+#define CODE_DECL(NAME, name, type, op, func, sub, form) \
+    extern code *code_##name CODE_PARAMS_##form;
+SSM_INSTRUCTIONS(CODE_DECL)
+#undef CODE_DECL
 
 #endif
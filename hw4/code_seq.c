@@ -122,14 +122,27 @@ void code_seq_concat(code_seq *s1, code_seq s2)
     code_seq_okay(*s1);
 }
 
+// Record that seq is the code for the statement at floc
+// (if seq is not empty and its first instruction does not already
+// start the code for a statement nested in that one)
+void code_seq_set_file_loc(code_seq seq, file_location *floc)
+{
+    if (!code_seq_is_empty(seq) && seq.first->file_loc == NULL) {
+	seq.first->file_loc = floc;
+    }
+}
+
 // Requires: out is open for writing.
 // Print the instructions in the code_seq to out
 // in assembly language format
 void code_seq_debug_print(FILE *out, code_seq seq)
 {
+    char buf[INSTR_FORMAT_BUF_SIZE + 1];
     while(!code_seq_is_empty(seq)) {
-	fprintf(out, "%s\n",
-		instruction_assembly_form(0, code_seq_first(seq)->instr));
+	size_t len = instruction_format(buf, sizeof(buf) - 1, 0,
+					code_seq_first(seq)->instr);
+	buf[len++] = '\n';
+	fwrite(buf, sizeof(char), len, out);
 	seq = code_seq_rest(seq);
     }
 }
@@ -45,6 +45,11 @@ extern void code_seq_add_to_end(code_seq *seq, code *c);
 // Modifies s1 to be the concatenation of s1 followed by s2
 extern void code_seq_concat(code_seq *s1, code_seq s2);
 
+// Record that seq is the code for the statement at floc
+// (if seq is not empty and its first instruction does not already
+// start the code for a statement nested in that one)
+extern void code_seq_set_file_loc(code_seq seq, file_location *floc);
+
 // Requires: out is open for writing.
 // Print the instructions in the code_seq to out
 // in assembly language format
@@ -81,6 +81,48 @@ code_seq code_utils_deallocate_stack_space(immediate_type words)
     return ret;
 }
 
+// Requires: words >= 0
+// Allocate the given number of words on the runtime stack
+// and initialize all of them to zero (with a constant number of instructions)
+// Modifies when executed: SP register
+code_seq code_utils_allocate_zeroed_stack_space(immediate_type words)
+{
+    assert(words >= 0);
+    code_seq ret = code_seq_empty();
+    // BFL's count is an arg field, so big blocks are done in pieces
+    while (words > 0) {
+	immediate_type n = words;
+	if (n > TWELVEBITSMAXSIGNED) {
+	    n = TWELVEBITSMAXSIGNED;
+	}
+	words -= n;
+	code_seq_concat(&ret, code_utils_allocate_stack_space(n));
+	// BFL takes the value to store from the top of the stack
+	code_seq_add_to_end(&ret, code_lit(SP, 0, 0));
+	code_seq_add_to_end(&ret, code_bfl(SP, 0, n));
+    }
+    return ret;
+}
+
+// Requires: 0 <= words <= TWELVEBITSMAXSIGNED and t != SP and s != SP
+// Copy the given number of words starting at memory[GPR[s]+os]
+// to the words starting at memory[GPR[t]+ot]
+// (with a constant number of instructions)
+// Modifies when executed: memory[GPR[t]+ot] .. memory[GPR[t]+ot+words-1]
+code_seq code_utils_copy_words(reg_num_type t, offset_type ot,
+			       reg_num_type s, offset_type os,
+			       immediate_type words)
+{
+    assert(0 <= words && words <= TWELVEBITSMAXSIGNED);
+    assert(t != SP && s != SP);
+    // BCP takes the number of words to copy from the top of the stack
+    code_seq ret = code_utils_allocate_stack_space(1);
+    code_seq_add_to_end(&ret, code_lit(SP, 0, words));
+    code_seq_add_to_end(&ret, code_bcp(t, ot, s, os));
+    code_seq_concat(&ret, code_utils_deallocate_stack_space(1));
+    return ret;
+}
+
 // Requires: $r3 holds the static link (from the current AR)
 // Set up the runtime stack for a procedure,
 // where the static link is found in register $r3.
@@ -35,6 +35,21 @@ extern code_seq code_utils_allocate_stack_space(immediate_type words);
 // Modifies when executed: SP register
 extern code_seq code_utils_deallocate_stack_space(immediate_type words);
 
+// Requires: words >= 0
+// Allocate the given number of words on the runtime stack
+// and initialize all of them to zero (with a constant number of instructions)
+// Modifies when executed: SP register
+extern code_seq code_utils_allocate_zeroed_stack_space(immediate_type words);
+
+// Requires: 0 <= words <= TWELVEBITSMAXSIGNED and t != SP and s != SP
+// Copy the given number of words starting at memory[GPR[s]+os]
+// to the words starting at memory[GPR[t]+ot]
+// (with a constant number of instructions)
+// Modifies when executed: memory[GPR[t]+ot] .. memory[GPR[t]+ot+words-1]
+extern code_seq code_utils_copy_words(reg_num_type t, offset_type ot,
+				      reg_num_type s, offset_type os,
+				      immediate_type words);
+
 // Set up the runtime stack for a procedure,
 // where the static link is found in register $r3.
 // Modifies when executed, the SP register, the FP register,
@@ -10,6 +10,7 @@
 #include "utilities.h"
 #include "symtab.h"
 #include "scope_check.h"
+#include "bof_cache.h"
 
 // The functions gen_code_initialize and gen_code_program
 // would normally be declared in gen_code.h,
@@ -23,13 +24,18 @@ extern void gen_code_initialize();
 // Generate code for prog into bf
 extern void gen_code_program(BOFFILE bf, block_t prog);
 
+// Generate programs with debugging information (see bof_debug.h)
+extern void gen_code_enable_debug_info();
+
 /* Print a usage message on stderr 
    and exit with failure. */
 static void usage(const char *cmdname)
 {
-    fprintf(stderr, "Usage: %s %s\n       %s %s\n       %s %s\n",
+    fprintf(stderr, "Usage: %s %s\n       %s %s\n       %s %s\n       %s %s\n       %s %s\n",
 	    cmdname, "-l codeFilename.spl",
 	    cmdname, "-u codeFilename.spl",
+	    cmdname, "-g codeFilename.spl",
+	    cmdname, "-k codeFilename.spl",
 	    cmdname, " codeFilename.spl"
 	    );
     exit(EXIT_FAILURE);
@@ -44,10 +50,14 @@ int main(int argc, char *argv[])
     bool lexer_print_output = false;
     // should the unparse of the AST be shown?
     bool parser_unparse = false;
+    // should the program have debugging information?
+    bool debug_info = false;
+    // should the BOF cache's statistics be printed (see bof_cache.h)?
+    bool cache_statistics_print = false;
     const char *cmdname = argv[0];
     argc--;
     argv++;
-    // possible options: -l, and -u
+    // possible options: -l, -u, -g, and -k
     while (argc > 0 && strlen(argv[0]) >= 2 && argv[0][0] == '-') {
 	if (strcmp(argv[0],"-l") == 0) {
 	    lexer_print_output = true;
@@ -57,6 +67,14 @@ int main(int argc, char *argv[])
 	    parser_unparse = true;
 	    argc--;
 	    argv++;
+	} else if (strcmp(argv[0],"-g") == 0) {
+	    debug_info = true;
+	    argc--;
+	    argv++;
+	} else if (strcmp(argv[0],"-k") == 0) {
+	    cache_statistics_print = true;
+	    argc--;
+	    argv++;
 	} else {
 	    // bad option!
 	    usage(cmdname);
@@ -94,6 +112,24 @@ int main(int argc, char *argv[])
 	return EXIT_SUCCESS;
     }
 
+    // if the output is in the BOF cache, use it and skip all the work;
+    // the key includes the options that change the output
+    // (and the file's name when it is recorded in debugging information)
+    BOFCache cache;
+    bool caching = !parser_unparse && bof_cache_open(&cache, cmdname);
+    if (caching) {
+	char options[BOF_CACHE_PATH_SIZE];
+	snprintf(options, sizeof(options), "%s%s",
+		 debug_info ? "-g " : "", debug_info ? filename : "");
+	caching = bof_cache_set_key(&cache, filename, options);
+    }
+    if (caching && bof_cache_fetch(&cache, boffilename)) {
+	if (cache_statistics_print) {
+	    bof_cache_print_statistics(stderr, &cache);
+	}
+	return EXIT_SUCCESS;
+    }
+
     // otherwise (if not lexer_print_outout) continue to parse etc.
     block_t progast = parseProgram(filename);
 
@@ -112,9 +148,30 @@ int main(int argc, char *argv[])
     }
 
     // generate code from the ASTs
+    // (gen_code_program closes the BOFFILE when it is done),
+    // removing the partly written BOF file if that fails
     gen_code_initialize();
+    if (debug_info) {
+	gen_code_enable_debug_info();
+    }
     BOFFILE bf = bof_write_open(boffilename);
-    gen_code_program(bf, progast);
+    error_context ec;
+    error_context_enter(&ec);
+    if (setjmp(ec.env) == 0) {
+	gen_code_program(bf, progast);
+	error_context_leave(&ec);
+    } else {
+	bof_close(bf);
+	remove(boffilename);
+	error_context_propagate(&ec);
+    }
+
+    if (caching) {
+	bof_cache_store(&cache, boffilename);
+	if (cache_statistics_print) {
+	    bof_cache_print_statistics(stderr, &cache);
+	}
+    }
 
     return EXIT_SUCCESS;
 }
@@ -6,75 +6,131 @@
 #include "id_use.h"
 #include "code_utils.h"
 #include "literal_table.h"
+#include "region_marker.h"
+#include "bof_debug.h"
 #include "gen_code.h"
 #include "utilities.h"
 #include "regname.h"
 
 #define STACK_SPACE 4096
 
+// should programs be generated with debugging information?
+static bool debug_info_enabled = false;
+
 // Initialize the code generator
 void gen_code_initialize()
 {
     literal_table_initialize();
 }
 
-// Requires: bf if open for writing in binary
-// and prior to this scope checking and type checking have been done.
-// Write all the instructions in cs to bf in order
-static void gen_code_output_seq(BOFFILE bf, code_seq cs)
+// Generate programs with debugging information (see bof_debug.h)
+void gen_code_enable_debug_info()
+{
+    debug_info_enabled = true;
+}
+
+// Requires: prior to this scope checking and type checking have been done.
+// Add all the instructions in cs to the text section in bb in order,
+// and, if dbg is not NULL, the source lines of the statements they start
+static void gen_code_output_seq(BOFBuffer *bb, code_seq cs, BOFDebugInfo *dbg)
 {
     while (!code_seq_is_empty(cs))
     {
-        bin_instr_t inst = code_seq_first(cs)->instr;
-        instruction_write_bin_instr(bf, inst);
+        code *c = code_seq_first(cs);
+        if (dbg != NULL && c->file_loc != NULL)
+        {
+            bof_debug_add_line(dbg, bof_buffer_text_words(bb),
+                               c->file_loc->filename, c->file_loc->line);
+        }
+        bof_buffer_add_word(bb, (word_type) instruction_encode(c->instr));
         cs = code_seq_rest(cs);
     }
 }
 
-// Return a header appropriate for the give code
-static BOFHeader gen_code_program_header(code_seq main_cs)
+// Add the constants and variables declared in blk,
+// which is nested level blocks inside the program, to dbg,
+// at the offsets that scope checking gave them
+// (constants first, then variables, in order of declaration)
+static void gen_code_debug_variables(BOFDebugInfo *dbg, block_t blk, int level)
+{
+    int offset = 0;
+    for (const_decl_t *cdp = blk.const_decls.start; cdp != NULL;
+         cdp = cdp->next)
+    {
+        for (const_def_t *cdf = cdp->const_def_list.start; cdf != NULL;
+             cdf = cdf->next)
+        {
+            bof_debug_add_variable(dbg, cdf->ident.name, level, offset++);
+        }
+    }
+    for (var_decl_t *vdp = blk.var_decls.var_decls; vdp != NULL;
+         vdp = vdp->next)
+    {
+        for (ident_t *idp = vdp->ident_list.start; idp != NULL;
+             idp = idp->next)
+        {
+            bof_debug_add_variable(dbg, idp->name, level, offset++);
+        }
+    }
+}
+
+// Return a header appropriate for the code in bb
+// (bof_buffer_write fills in the section lengths)
+static BOFHeader gen_code_program_header(const BOFBuffer *bb)
 {
     BOFHeader ret;
 
-    // set magic number
-    bof_write_magic_to_header(&ret);
     ret.text_start_address = 0;
-    ret.text_length = code_seq_size(main_cs);
 
     // calculate data segment start address
-    int dsa = MAX(ret.text_length, 1024);
+    int dsa = MAX(bof_buffer_text_words(bb), 1024);
     ret.data_start_address = dsa;
 
-    // init data_length
-    ret.data_length = literal_table_size();
-
     // calculate stack bottom address
-    int sba = ret.data_start_address + ret.data_length + STACK_SPACE;
+    int sba = ret.data_start_address + bof_buffer_data_words(bb)
+        + STACK_SPACE;
     ret.stack_bottom_addr = sba;
 
     return ret;
 }
 
-static void gen_code_output_literals(BOFFILE bf)
+// Add the literals to the data section in bb
+static void gen_code_output_literals(BOFBuffer *bb)
 {
     literal_table_start_iteration();
     while (literal_table_iteration_has_next())
     {
         word_type w = literal_table_iteration_next();
-        // debug_print("Writing literal %f to BOF file\n", w);
-        bof_write_float(bf, w);
+        bof_buffer_add_word(bb, w);
     }
     literal_table_end_iteration(); // not necessary
 }
 
 // Requires: bf is open for writing in binary
-// Write the program's BOFFILE to bf
-static void gen_code_output_program(BOFFILE bf, code_seq main_cs)
+// Write the program's BOFFILE to bf, all at once,
+// with debugging information for prog if that is enabled
+static void gen_code_output_program(BOFFILE bf, code_seq main_cs,
+                                    block_t prog)
 {
-    BOFHeader bfh = gen_code_program_header(main_cs);
-    bof_write_header(bf, bfh);
-    gen_code_output_seq(bf, main_cs);
-    gen_code_output_literals(bf);
+    BOFBuffer bb;
+    bof_buffer_initialize(&bb);
+    BOFDebugInfo dbg;
+    bof_debug_initialize(&dbg);
+    BOFDebugInfo *dbgp = debug_info_enabled ? &dbg : NULL;
+    gen_code_output_seq(&bb, main_cs, dbgp);
+    bof_buffer_end_text(&bb);
+    gen_code_output_literals(&bb);
+    // the header must describe the sections, not the debugging information
+    BOFHeader bh = gen_code_program_header(&bb);
+    if (dbgp != NULL)
+    {
+        bof_debug_add_symbol(dbgp, "program", debug_sym_procedure, 0,
+                             bof_buffer_text_words(&bb));
+        gen_code_debug_variables(dbgp, prog, 0);
+        bof_debug_add_to_buffer(&bb, dbgp);
+    }
+    bof_debug_free(&dbg);
+    bof_buffer_write(bf, &bb, bh);
     bof_close(bf);
 }
 
@@ -93,10 +149,12 @@ void gen_code_program(BOFFILE bf, block_t prog)
     main_cs = code_utils_set_up_program();
     code_seq_concat(&main_cs, gen_code_stmts(&prog.stmts));
     code_seq_concat(&main_cs, gen_code_stmts(&prog.stmts));
+    // end any measurement regions marked after the last statement
+    code_seq_concat(&main_cs, region_marker_gen_code_remaining());
     code_seq_concat(&main_cs, code_utils_restore_registers_from_AR());
     code_seq_concat(&main_cs, code_utils_deallocate_stack_space(vars_len_in_bytes));
     main_cs = code_utils_tear_down_program();
-    gen_code_output_program(bf, main_cs);
+    gen_code_output_program(bf, main_cs, prog);
 }
 
 // Generate code for the var_decls_t vds to out
@@ -126,26 +184,19 @@ code_seq gen_code_var_decl(var_decl_t vd)
 }
 
 // Generate code for the identififers in idents with type ident_t
-// in reverse order (so the first declared are allocated last).
-// There are 2 instructions generated for each identifier declared
-// (one to allocate space and another to initialize that space)
+// (the first declared are allocated last, i.e., at the highest address).
+// The space for all of them is allocated and zeroed with a block fill,
+// so the number of instructions does not depend on how many are declared
 code_seq gen_code_idents(ident_list_t idents)
 {
-    code_seq ret = code_seq_empty();
+    immediate_type count = 0;
     ident_t *idp = idents.start;
     while (idp != NULL)
     {
-        // Allocate space for the variable on the stack
-        code_seq alloc_and_init = code_seq_singleton(code_addi(SP, SP, -BYTES_PER_WORD));
-
-        // Initialize the allocated space to zero
-        code_seq_add_to_end(&alloc_and_init, code_swr(0, 0, SP));
-
-        // Concatenate the generated code in reverse order for proper addressing
-        code_seq_concat(&alloc_and_init, ret);
+        count++;
         idp = idp->next;
     }
-    return ret;
+    return code_utils_allocate_zeroed_stack_space(count);
 }
 
 // Generate code for stmt
@@ -196,7 +247,11 @@ code_seq gen_code_stmts(stmts_t *stmts)
         stmt_t *current_stmt = stmts->stmt_list.start;
         while (current_stmt != NULL)
         {
+            // start or end any measurement regions marked before it
+            code_seq_concat(&ret, region_marker_gen_code_before(
+                                      current_stmt->file_loc->line));
             code_seq stmt_code = gen_code_stmt(*current_stmt);
+            code_seq_set_file_loc(stmt_code, current_stmt->file_loc);
             code_seq_concat(&ret, stmt_code);
             current_stmt = current_stmt->next;
         }
@@ -282,8 +337,7 @@ code_seq gen_code_if_stmt(if_stmt_t stmt)
         break;
     // Add cases for other operators as needed
     default:
-        fprintf(stderr, "Unsupported operator in condition\n");
-        exit(1);
+        bail_with_error("Unsupported operator in condition");
     }
 
     code_seq_concat(&ret, condition_code);
@@ -378,8 +432,7 @@ code_seq gen_code_while_stmt(while_stmt_t stmt)
         break;
     // Add cases for other operators as needed
     default:
-        fprintf(stderr, "Unsupported operator in condition\n");
-        exit(1);
+        bail_with_error("Unsupported operator in condition");
     }
 
     // Load zero into $r0 to use in comparison
@@ -10,6 +10,11 @@
 // Initialize the code generator
 extern void gen_code_initialize();
 
+// Generate programs with debugging information (see bof_debug.h),
+// which gives the source line of each statement's code,
+// the range of addresses of the program, and the program's variables
+extern void gen_code_enable_debug_info();
+
 // Requires: bf if open for writing in binary
 // Generate code for the given AST
 extern void gen_code_program(BOFFILE bf, program_t prog);
@@ -5,6 +5,7 @@
 #include <stdbool.h>
 #include "machine_types.h"
 #include "bof.h"
+#include "instruction_table.h"
 
 // op codes in binary instructions for the SSM
 typedef enum {COMP_O = 0, OTHC_O = 1, ADDI_O = 2, ANDI_O = 3, BORI_O = 4,
@@ -16,24 +17,89 @@ typedef enum {COMP_O = 0, OTHC_O = 1, ADDI_O = 2, ANDI_O = 3, BORI_O = 4,
 // function codes in binary instructions for the SSM (when opcode is 0)
 typedef enum {NOP_F = 0, ADD_F = 1, SUB_F = 2, CPW_F = 3, CPR_F = 4, 
 	      AND_F = 5, BOR_F = 6, NOR_F = 7, XOR_F = 8,
-	      LWR_F = 9, SWR_F = 10, SCA_F = 11, LWI_F = 12, NEG_F = 13
+	      LWR_F = 9, SWR_F = 10, SCA_F = 11, LWI_F = 12, NEG_F = 13,
+	      BCP_F = 14, REG_F = 15
              } func0_code;
 
 // function codes in binary instructions for the SSM (when opcode is 1)
 typedef enum {LIT_F = 1, ARI_F = 2, SRI_F = 3, MUL_F = 4, DIV_F = 5,
 	      CFHI_F = 6, CFLO_F = 7, SLL_F = 8, SRL_F = 9, JMP_F = 10,
-	      CSI_F = 11, JREL_F = 12, SYS_F = 15
+	      CSI_F = 11, JREL_F = 12, BFL_F = 13, RBR_F = 14, SYS_F = 15
              } func1_code;
 
+// register operation codes in register computational instructions
+// (when opcode is 0 and function code is REG_F)
+typedef enum {RADD_R = 0, RSUB_R = 1, RMUL_R = 2, RDIV_R = 3,
+	      RAND_R = 4, RBOR_R = 5, RXOR_R = 6, RSLT_R = 7
+             } reg_op_code;
+
+// comparison codes in register branch instructions
+// (when opcode is 1 and function code is RBR_F)
+typedef enum {BREQ_C = 0, BRNE_C = 1, BRLT_C = 2, BRLE_C = 3,
+	      BRGT_C = 4, BRGE_C = 5
+             } reg_branch_code;
+
 // instruction types (each is a binary instruction format)
 typedef enum {comp_instr_type, other_comp_instr_type,
 	      immed_instr_type, jump_instr_type, syscall_instr_type,
+	      reg_comp_instr_type, reg_branch_instr_type,
 	      error_instr_type
              } instr_type;
 
+// shapes of the operands of instructions in assembly language
+typedef enum {no_arg_form, two_reg_comp_form, two_reg_no_offsets_form,
+	      no_target_offset_form, no_source_offset_form,
+	      one_reg_offset_arg_form, one_reg_arg_form, one_reg_offset_form,
+	      shift_form, arg_only_form, immed_arith_form, immed_bool_form,
+	      branch_test_form, reg_comp_form, reg_branch_form,
+	      jump_form, offset_only_form
+             } instr_form;
+
+// dense numbers for the instructions, one for each row of
+// SSM_INSTRUCTIONS in instruction_table.h (e.g., ADD_I for ADD);
+// error_instr_id is for words that are not valid instructions
+#define INSTR_ID(NAME, name, type, op, func, sub, form) NAME##_I,
+typedef enum {error_instr_id = 0,
+	      SSM_INSTRUCTIONS(INSTR_ID)
+	      num_instr_ids
+             } instr_id;
+#undef INSTR_ID
+
+// what the table in instruction_table.h says about an instruction
+typedef struct {
+    const char *mnemonic;
+    instr_type type;
+    op_code op;
+    func_type func;
+    unsigned short sub;  // register operation, comparison or syscall code
+    instr_form form;
+} instr_info_t;
+
+// the information about each instruction, indexed by its instr_id
+extern const instr_info_t instruction_info[num_instr_ids];
+
 // system calls
+// (the bulk I/O calls, from read_line_sc to print_bytes_sc,
+//  take their count from the word on top of the stack
+//  and replace it with the number of items transferred;
+//  the thread and atomic calls, from spawn_thread_sc to fetch_and_add_sc,
+//  and create_coroutine_sc
+//  also leave their result in the word on top of the stack;
+//  the region calls, begin_region_sc and end_region_sc,
+//  name the measurement region with a string, as print_str_sc does;
+//  the heap calls, allocate_sc and resize_sc, leave the address
+//  of the (new) block on top of the stack, or 0 if there is no room)
 typedef enum {exit_sc = 1, print_str_sc = 2, print_int_sc = 3,
 	      print_char_sc = 4, read_char_sc = 5,
+	      read_line_sc = 6, read_bytes_sc = 7,
+	      print_chars_sc = 8, print_bytes_sc = 9,
+	      spawn_thread_sc = 10, join_thread_sc = 11,
+	      compare_and_swap_sc = 12, fetch_and_add_sc = 13,
+	      create_coroutine_sc = 14, yield_sc = 15,
+	      resume_sc = 16,
+	      begin_region_sc = 17, end_region_sc = 18,
+	      allocate_sc = 19, free_sc = 20,
+	      resize_sc = 21,
 	      start_tracing_sc = 2046, stop_tracing_sc = 2047
 } syscall_type;
 
@@ -65,6 +131,30 @@ typedef struct {
     func_type func : 4;
 } syscall_instr_t;
 
+// register computational instructions, with opcode 0 and func field REG_F,
+// which work only on registers: GPR[rd] = GPR[rs] rop GPR[rt]
+// (these are meant for holding temporaries in $r3-$r6)
+typedef struct {
+    opcode_type op : 4;
+    reg_num_type rd : 3;  // destination register
+    reg_op_code rop : 9;  // register operation
+    reg_num_type rs : 3;  // first source register
+    reg_num_type rt : 3;  // second source register
+    unsigned int : 6;     // unused
+    func_type func : 4;
+} reg_comp_instr_t;
+
+// register branch instructions, with opcode 1 and func field RBR_F,
+// which branch by offset words if GPR[rs] cmp GPR[rt]
+typedef struct {
+    opcode_type op : 4;
+    reg_num_type rs : 3;  // first register compared
+    reg_num_type rt : 3;  // second register compared
+    reg_branch_code cmp : 6;
+    arg_type offset : 12; // relative to the branch's address
+    func_type func : 4;
+} reg_branch_instr_t;
+
 // immediate operand type instructions
 // with signed immediate operands
 typedef struct {
@@ -94,6 +184,8 @@ typedef union {
     comp_instr_t comp;
     other_comp_instr_t othc;
     syscall_instr_t syscall;
+    reg_comp_instr_t rcomp;
+    reg_branch_instr_t rbranch;
     immed_instr_t immed;
     uimmed_instr_t uimmed;
     jump_instr_t jump;
@@ -102,6 +194,44 @@ typedef union {
 // Return the type of the binary instruction given
 extern instr_type instruction_type(bin_instr_t i);
 
+// Return the instr_id of the binary instruction given,
+// which is error_instr_id if it is not a valid instruction
+extern instr_id instruction_id(bin_instr_t bi);
+
+// Return the binary instruction encoded in the word w,
+// using the bit positions of the SSM's binary instruction format
+// (so this does not depend on how the compiler lays out bit-fields)
+extern bin_instr_t instruction_decode(uword_type w);
+
+// Return the word that encodes the binary instruction bi,
+// using the bit positions of the SSM's binary instruction format
+extern uword_type instruction_encode(bin_instr_t bi);
+
+// Requires: id != error_instr_id
+// Return the binary instruction with the given id and operands.
+// The operands are used as the instruction's binary format needs them:
+// registers r, r2 and r3 and offsets o and o2 in the order they
+// are written in assembly language, and arg for any immediate argument,
+// shift, branch offset, or jump address.
+extern bin_instr_t instruction_make(instr_id id,
+				    reg_num_type r, offset_type o,
+				    reg_num_type r2, offset_type o2,
+				    reg_num_type r3, word_type arg);
+
+// Return the number (0, 1, or 2) of bi's operands that are a register
+// and an offset naming a memory location relative to that register
+// (for SCA, the address itself), such as $gp-relative data accesses.
+// Those operands' registers and offsets are put in regs and offsets,
+// in the order they are written in assembly language.
+extern int instruction_memory_operands(bin_instr_t bi, reg_num_type regs[2],
+				       offset_type offsets[2]);
+
+// Requires: 0 <= which < instruction_memory_operands(*bi, ...)
+// Change the offset of the operand numbered which
+// (as in instruction_memory_operands) of *bi to o
+extern void instruction_set_memory_offset(bin_instr_t *bi, int which,
+					  offset_type o);
+
 // Requires: bof is open for reading in binary
 // Read a single instruction (in binary) from bf and return it,
 // but exit with an error if there is a problem.
@@ -127,6 +257,17 @@ extern void instruction_write_otherCompInstr(BOFFILE bf, other_comp_instr_t oci)
 // but exit with an error if there is a problem.
 extern void instruction_write_syscallInstr(BOFFILE bf, syscall_instr_t si);
 
+// Requires: bof is open for writing in binary
+// Write the register computational instruction rci to bf in binary,
+// but exit with an error if there is a problem.
+extern void instruction_write_regCompInstr(BOFFILE bf, reg_comp_instr_t rci);
+
+// Requires: bof is open for writing in binary
+// Write the register branch instruction rbi to bf in binary,
+// but exit with an error if there is a problem.
+extern void instruction_write_regBranchInstr(BOFFILE bf,
+					     reg_branch_instr_t rbi);
+
 // Requires: bof is open for writing in binary
 // Write the immediate instruction ii with opcode op to bf in binary,
 // but exit with an error if there is a problem.
@@ -145,8 +286,31 @@ extern void instruction_write_jumpInstr(BOFFILE bf, jump_instr_t ji);
 // Return the assembly language name (mnemonic) for bi
 extern const char *instruction_mnemonic(bin_instr_t bi);
 
+// the size of a buffer that can hold the assembly language form
+// of any instruction (see instruction_format)
+#define INSTR_FORMAT_BUF_SIZE 128
+
+// Requires: buf has room for size chars and size > 0.
+// Format the assembly language form of instr, which is found
+// at address addr, into buf, always followed by a null char,
+// and return the number of chars put into buf before that null char.
+// If size is at least INSTR_FORMAT_BUF_SIZE, the whole form fits.
+// This uses no static storage, so it may be called from several threads.
+extern size_t instruction_format(char *buf, size_t size,
+				 address_type addr, bin_instr_t instr);
+
+// Requires: buf has room for size chars and size > width + 3.
+// Format a line consisting of addr (right justified in width columns),
+// ": ", the assembly language form of instr (which is found at addr),
+// and a newline into buf, always followed by a null char,
+// and return the number of chars put into buf before that null char.
+// If size is at least width + INSTR_FORMAT_BUF_SIZE + 3, the whole line fits.
+extern size_t instruction_format_line(char *buf, size_t size, int width,
+				      address_type addr, bin_instr_t instr);
+
 // Return a string containing the assembly language form of instr,
-// which is found at address addr
+// which is found at address addr.
+// The string is overwritten by the next call in the same thread.
 extern const char *instruction_assembly_form(address_type addr,
 					     bin_instr_t instr);
 
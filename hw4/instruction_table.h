@@ -0,0 +1,128 @@
+// $Id$
+#ifndef _INSTRUCTION_TABLE_H
+#define _INSTRUCTION_TABLE_H
+
+// The SSM instruction set, described once.
+// Each row of SSM_INSTRUCTIONS has the form
+//     X(NAME, name, type, op, func, sub, form)
+// where NAME is the instruction's mnemonic, name is that in lower case,
+// type is its binary format (an instr_type),
+// op and func are its op and function codes (func is 0 if the binary
+// format has no function code),
+// sub is its register operation, comparison, or system call code
+// (0 for the other instructions),
+// and form is the shape of its operands in assembly language
+// (an instr_form without the _form suffix).
+// Other modules define X to generate what they need from the table:
+// instruction.c generates the decoding tables and mnemonics,
+// machine.c the interpreter's handler table, lexer.c the token mappings,
+// and code.h and code.c the code_* constructors.
+// Adding an instruction means adding a row here, a handler in machine.c,
+// and (for the assembler) a token and grammar rule in asm.y and asm_lexer.l.
+
+#define SSM_INSTRUCTIONS(X) \
+    /* computational instructions */ \
+    X(NOP,  nop,  comp_instr_type, COMP_O, NOP_F, 0, no_arg) \
+    X(ADD,  add,  comp_instr_type, COMP_O, ADD_F, 0, two_reg_comp) \
+    X(SUB,  sub,  comp_instr_type, COMP_O, SUB_F, 0, two_reg_comp) \
+    X(CPW,  cpw,  comp_instr_type, COMP_O, CPW_F, 0, two_reg_comp) \
+    X(CPR,  cpr,  comp_instr_type, COMP_O, CPR_F, 0, two_reg_no_offsets) \
+    X(AND,  and,  comp_instr_type, COMP_O, AND_F, 0, two_reg_comp) \
+    X(BOR,  bor,  comp_instr_type, COMP_O, BOR_F, 0, two_reg_comp) \
+    X(NOR,  nor,  comp_instr_type, COMP_O, NOR_F, 0, two_reg_comp) \
+    X(XOR,  xor,  comp_instr_type, COMP_O, XOR_F, 0, two_reg_comp) \
+    X(LWR,  lwr,  comp_instr_type, COMP_O, LWR_F, 0, no_target_offset) \
+    X(SWR,  swr,  comp_instr_type, COMP_O, SWR_F, 0, no_source_offset) \
+    X(SCA,  sca,  comp_instr_type, COMP_O, SCA_F, 0, two_reg_comp) \
+    X(LWI,  lwi,  comp_instr_type, COMP_O, LWI_F, 0, two_reg_comp) \
+    X(NEG,  neg,  comp_instr_type, COMP_O, NEG_F, 0, two_reg_comp) \
+    X(BCP,  bcp,  comp_instr_type, COMP_O, BCP_F, 0, two_reg_comp) \
+    /* register computational instructions */ \
+    X(RADD, radd, reg_comp_instr_type, COMP_O, REG_F, RADD_R, reg_comp) \
+    X(RSUB, rsub, reg_comp_instr_type, COMP_O, REG_F, RSUB_R, reg_comp) \
+    X(RMUL, rmul, reg_comp_instr_type, COMP_O, REG_F, RMUL_R, reg_comp) \
+    X(RDIV, rdiv, reg_comp_instr_type, COMP_O, REG_F, RDIV_R, reg_comp) \
+    X(RAND, rand, reg_comp_instr_type, COMP_O, REG_F, RAND_R, reg_comp) \
+    X(RBOR, rbor, reg_comp_instr_type, COMP_O, REG_F, RBOR_R, reg_comp) \
+    X(RXOR, rxor, reg_comp_instr_type, COMP_O, REG_F, RXOR_R, reg_comp) \
+    X(RSLT, rslt, reg_comp_instr_type, COMP_O, REG_F, RSLT_R, reg_comp) \
+    /* other computational instructions */ \
+    X(LIT,  lit,  other_comp_instr_type, OTHC_O, LIT_F, 0, one_reg_offset_arg) \
+    X(ARI,  ari,  other_comp_instr_type, OTHC_O, ARI_F, 0, one_reg_arg) \
+    X(SRI,  sri,  other_comp_instr_type, OTHC_O, SRI_F, 0, one_reg_arg) \
+    X(MUL,  mul,  other_comp_instr_type, OTHC_O, MUL_F, 0, one_reg_offset) \
+    X(DIV,  div,  other_comp_instr_type, OTHC_O, DIV_F, 0, one_reg_offset) \
+    X(CFHI, cfhi, other_comp_instr_type, OTHC_O, CFHI_F, 0, one_reg_offset) \
+    X(CFLO, cflo, other_comp_instr_type, OTHC_O, CFLO_F, 0, one_reg_offset) \
+    X(SLL,  sll,  other_comp_instr_type, OTHC_O, SLL_F, 0, shift) \
+    X(SRL,  srl,  other_comp_instr_type, OTHC_O, SRL_F, 0, shift) \
+    X(JMP,  jmp,  other_comp_instr_type, OTHC_O, JMP_F, 0, one_reg_offset) \
+    X(CSI,  csi,  other_comp_instr_type, OTHC_O, CSI_F, 0, one_reg_offset) \
+    X(JREL, jrel, other_comp_instr_type, OTHC_O, JREL_F, 0, arg_only) \
+    X(BFL,  bfl,  other_comp_instr_type, OTHC_O, BFL_F, 0, one_reg_offset_arg) \
+    /* register branch instructions */ \
+    X(BREQ, breq, reg_branch_instr_type, OTHC_O, RBR_F, BREQ_C, reg_branch) \
+    X(BRNE, brne, reg_branch_instr_type, OTHC_O, RBR_F, BRNE_C, reg_branch) \
+    X(BRLT, brlt, reg_branch_instr_type, OTHC_O, RBR_F, BRLT_C, reg_branch) \
+    X(BRLE, brle, reg_branch_instr_type, OTHC_O, RBR_F, BRLE_C, reg_branch) \
+    X(BRGT, brgt, reg_branch_instr_type, OTHC_O, RBR_F, BRGT_C, reg_branch) \
+    X(BRGE, brge, reg_branch_instr_type, OTHC_O, RBR_F, BRGE_C, reg_branch) \
+    /* system calls */ \
+    X(EXIT, exit, syscall_instr_type, OTHC_O, SYS_F, exit_sc, offset_only) \
+    X(PSTR, pstr, syscall_instr_type, OTHC_O, SYS_F, print_str_sc, one_reg_offset) \
+    X(PINT, pint, syscall_instr_type, OTHC_O, SYS_F, print_int_sc, one_reg_offset) \
+    X(PCH,  pch,  syscall_instr_type, OTHC_O, SYS_F, print_char_sc, one_reg_offset) \
+    X(RCH,  rch,  syscall_instr_type, OTHC_O, SYS_F, read_char_sc, one_reg_offset) \
+    X(RLN,  rln,  syscall_instr_type, OTHC_O, SYS_F, read_line_sc, one_reg_offset) \
+    X(RBYT, rbyt, syscall_instr_type, OTHC_O, SYS_F, read_bytes_sc, one_reg_offset) \
+    X(PCHS, pchs, syscall_instr_type, OTHC_O, SYS_F, print_chars_sc, one_reg_offset) \
+    X(PBYT, pbyt, syscall_instr_type, OTHC_O, SYS_F, print_bytes_sc, one_reg_offset) \
+    X(SPWN, spwn, syscall_instr_type, OTHC_O, SYS_F, spawn_thread_sc, one_reg_offset) \
+    X(JOIN, join, syscall_instr_type, OTHC_O, SYS_F, join_thread_sc, one_reg_offset) \
+    X(CAS,  cas,  syscall_instr_type, OTHC_O, SYS_F, compare_and_swap_sc, one_reg_offset) \
+    X(FADD, fadd, syscall_instr_type, OTHC_O, SYS_F, fetch_and_add_sc, one_reg_offset) \
+    X(COCR, cocr, syscall_instr_type, OTHC_O, SYS_F, create_coroutine_sc, one_reg_offset) \
+    X(YLD,  yld,  syscall_instr_type, OTHC_O, SYS_F, yield_sc, no_arg) \
+    X(RSM,  rsm,  syscall_instr_type, OTHC_O, SYS_F, resume_sc, one_reg_offset) \
+    X(MBEG, mbeg, syscall_instr_type, OTHC_O, SYS_F, begin_region_sc, one_reg_offset) \
+    X(MEND, mend, syscall_instr_type, OTHC_O, SYS_F, end_region_sc, one_reg_offset) \
+    X(ALOC, aloc, syscall_instr_type, OTHC_O, SYS_F, allocate_sc, one_reg_offset) \
+    X(FREE, free, syscall_instr_type, OTHC_O, SYS_F, free_sc, one_reg_offset) \
+    X(RSZ,  rsz,  syscall_instr_type, OTHC_O, SYS_F, resize_sc, one_reg_offset) \
+    X(STRA, stra, syscall_instr_type, OTHC_O, SYS_F, start_tracing_sc, no_arg) \
+    X(NOTR, notr, syscall_instr_type, OTHC_O, SYS_F, stop_tracing_sc, no_arg) \
+    /* immediate format instructions */ \
+    X(ADDI, addi, immed_instr_type, ADDI_O, 0, 0, immed_arith) \
+    X(ANDI, andi, immed_instr_type, ANDI_O, 0, 0, immed_bool) \
+    X(BORI, bori, immed_instr_type, BORI_O, 0, 0, immed_bool) \
+    X(NORI, nori, immed_instr_type, NORI_O, 0, 0, immed_bool) \
+    X(XORI, xori, immed_instr_type, XORI_O, 0, 0, immed_bool) \
+    X(BEQ,  beq,  immed_instr_type, BEQ_O, 0, 0, branch_test) \
+    X(BGEZ, bgez, immed_instr_type, BGEZ_O, 0, 0, branch_test) \
+    X(BGTZ, bgtz, immed_instr_type, BGTZ_O, 0, 0, branch_test) \
+    X(BLEZ, blez, immed_instr_type, BLEZ_O, 0, 0, branch_test) \
+    X(BLTZ, bltz, immed_instr_type, BLTZ_O, 0, 0, branch_test) \
+    X(BNE,  bne,  immed_instr_type, BNE_O, 0, 0, branch_test) \
+    /* jump format instructions */ \
+    X(JMPA, jmpa, jump_instr_type, JMPA_O, 0, 0, jump) \
+    X(CALL, call, jump_instr_type, CALL_O, 0, 0, jump) \
+    X(RTN,  rtn,  jump_instr_type, RTN_O, 0, 0, no_arg)
+
+// INSTR_TYPE_SELECT(type, comp, othc, immed, jump, sys, rcomp, rbranch)
+// expands to the one of its other arguments that goes with the given type,
+// so that an X can treat the kinds of instructions differently,
+// e.g., by selecting between a macro and INSTR_SKIP
+#define INSTR_TYPE_SELECT(type, comp, othc, immed, jump, sys, rcomp, rbranch) \
+    INSTR_TYPE_SELECT_##type(comp, othc, immed, jump, sys, rcomp, rbranch)
+#define INSTR_TYPE_SELECT_comp_instr_type(c, o, i, j, s, rc, rb) c
+#define INSTR_TYPE_SELECT_other_comp_instr_type(c, o, i, j, s, rc, rb) o
+#define INSTR_TYPE_SELECT_immed_instr_type(c, o, i, j, s, rc, rb) i
+#define INSTR_TYPE_SELECT_jump_instr_type(c, o, i, j, s, rc, rb) j
+#define INSTR_TYPE_SELECT_syscall_instr_type(c, o, i, j, s, rc, rb) s
+#define INSTR_TYPE_SELECT_reg_comp_instr_type(c, o, i, j, s, rc, rb) rc
+#define INSTR_TYPE_SELECT_reg_branch_instr_type(c, o, i, j, s, rc, rb) rb
+
+// a macro that ignores its arguments, for use with INSTR_TYPE_SELECT
+#define INSTR_SKIP(...)
+
+#endif
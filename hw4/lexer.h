@@ -9,6 +9,10 @@
 // from the given file name
 extern void lexer_init(char *fname);
 
+// Release the lexer's input file, if it is still open
+// (as it is when parsing stops before the end of the file)
+extern void lexer_close();
+
 // Return the next token in the input
 extern int yylex();
 
@@ -1,5 +1,6 @@
 // $Id: literal_table.c,v 1.4 2023/11/13 12:45:51 leavens Exp $
 #include <assert.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "literal_table.h"
@@ -86,16 +87,12 @@ bool literal_table_present(const char *sought, word_type value)
     return literal_table_find_offset(sought, value) >= 0;
 }
 
-// Return the word offset for val_string/value
-// entering it in the table if it's not already present
-unsigned int literal_table_lookup(const char *val_string, word_type value)
+// Requires: val_string is not already in the table
+// Enter val_string/value as the last entry in the table
+// and return its word offset
+static unsigned int literal_table_add(const char *val_string, word_type value)
 {
-    int ret = literal_table_find_offset(val_string, value);
-    if (ret >= 0) {
-	// don't insert if it's already present
-	return ret;
-    }
-    // it's not already present, so insert it
+    int ret;
     literal_table_entry_t *new_entry
 	= (literal_table_entry_t *)malloc(sizeof(literal_table_entry_t));
     new_entry->text = val_string;
@@ -117,6 +114,61 @@ unsigned int literal_table_lookup(const char *val_string, word_type value)
     return ret;
 }
 
+// Return the word offset for val_string/value
+// entering it in the table if it's not already present
+unsigned int literal_table_lookup(const char *val_string, word_type value)
+{
+    int ret = literal_table_find_offset(val_string, value);
+    if (ret >= 0) {
+	// don't insert if it's already present
+	return ret;
+    }
+    // it's not already present, so insert it
+    return literal_table_add(val_string, value);
+}
+
+// Return the word offset of the first of the consecutive words
+// that hold the characters of str (with a terminating null character),
+// entering them in the table if they're not already present
+unsigned int literal_table_lookup_string(const char *str)
+{
+    size_t len = strlen(str);
+    // the text of the first word's entry is str in quotes,
+    // which cannot be confused with the print form of a number
+    char *key = (char *) malloc(len + 3);
+    if (key == NULL) {
+	bail_with_error("No space to allocate a string literal's key!");
+    }
+    sprintf(key, "\"%s\"", str);
+    int ret = literal_table_find_offset(key, 0);
+    if (ret >= 0) {
+	free(key);
+	return ret;
+    }
+    size_t words = len / BYTES_PER_WORD + 1;
+    for (size_t i = 0; i < words; i++) {
+	word_type w = 0;
+	size_t n = len + 1 - i * BYTES_PER_WORD;
+	memcpy(&w, str + i * BYTES_PER_WORD,
+	       n < BYTES_PER_WORD ? n : BYTES_PER_WORD);
+	const char *text = key;
+	if (i > 0) {
+	    // the later words get texts that nothing else can have
+	    char *later = (char *) malloc(len + 24);
+	    if (later == NULL) {
+		bail_with_error("No space to allocate a string literal's key!");
+	    }
+	    sprintf(later, "%s+%zu", key, i);
+	    text = later;
+	}
+	unsigned int offset = literal_table_add(text, w);
+	if (i == 0) {
+	    ret = offset;
+	}
+    }
+    return ret;
+}
+
 // === iteration helpers ===
 
 // Start an iteration over the literal table
@@ -153,7 +205,7 @@ bool literal_table_iteration_has_next()
 word_type literal_table_iteration_next()
 {
     assert(iteration_next != NULL);
-    float ret = iteration_next->value;
+    word_type ret = iteration_next->value;
     iteration_next = iteration_next->next;
     return ret;
 }
\ No newline at end of file
@@ -27,6 +27,11 @@ extern bool literal_table_present(const char *sought, word_type value);
 // entering it in the table if it's not already present
 extern unsigned int literal_table_lookup(const char *val_string, word_type value);
 
+// Return the word offset of the first of the consecutive words
+// that hold the characters of str (with a terminating null character),
+// entering them in the table if they're not already present
+extern unsigned int literal_table_lookup_string(const char *str);
+
 // === iteration helpers ===
 
 // Start an iteration over the literal table
@@ -10,13 +10,25 @@
 extern int yyparse (char const *file_name);
 
 // Parse a PL/0 program using the tokens from the lexer,
-// returning the program's AST
+// returning the program's AST.
+// A syntax error is reported by bail_with_exit_code
+// (after the parser prints a message about it),
+// and the lexer's input file is released before any error is reported.
 extern block_t parseProgram(char *file_name)
 {
     lexer_init(file_name);
-    int rc = yyparse(file_name);
-    if (rc != 0) {
-	exit(rc);
+    error_context ec;
+    error_context_enter(&ec);
+    if (setjmp(ec.env) == 0) {
+	int rc = yyparse(file_name);
+	error_context_leave(&ec);
+	if (rc != 0) {
+	    lexer_close();
+	    bail_with_exit_code(rc);
+	}
+    } else {
+	lexer_close();
+	error_context_propagate(&ec);
     }
     return progast;
 }
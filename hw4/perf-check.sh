@@ -0,0 +1,109 @@
+#!/bin/sh
+# Compare the instruction and memory operation counts of running
+# compiled SPL programs with those recorded in a baseline file,
+# failing if any test's counts grew by more than threshold percent.
+# With -u, write the current counts into the baseline file instead.
+# Usage: perf-check.sh [-u] baseline threshold test.spl ...
+# The baseline file has one line per test: name instructions memory-ops
+: ${COMPILER=./compiler}
+: ${RUNVM=vm/vm}
+: ${INPUTS=char-inputs.txt}
+
+update=false
+if test "$1" = "-u"
+then
+    update=true
+    shift
+fi
+if test $# -lt 2
+then
+    echo "Usage: $0 [-u] baseline threshold test.spl ..." >&2
+    exit 2
+fi
+baseline=$1
+threshold=$2
+shift 2
+
+if test $update = false && test ! -r "$baseline"
+then
+    echo "$0: no baseline file $baseline (make one with -u)" >&2
+    exit 2
+fi
+
+current=`mktemp` || exit 2
+trap 'rm -f "$current"' EXIT
+for f in "$@"
+do
+    name=`basename "$f" .spl`
+    bof=${f%.spl}.bof
+    rm -f "$bof"
+    if ! $COMPILER "$f" > /dev/null 2>&1
+    then
+	echo "$name: does not compile" >&2
+	echo "$name - -" >> "$current"
+	continue
+    fi
+    counts=`cat "$INPUTS" | $RUNVM -i "$bof" 2>&1 > /dev/null | grep '^Counts:'`
+    # counts is "Counts: N instructions, M memory operations"
+    set -- $counts
+    if test -z "$counts"
+    then
+	echo "$name: no counts from $RUNVM" >&2
+	echo "$name - -" >> "$current"
+    else
+	echo "$name $2 $4" >> "$current"
+    fi
+done
+
+if test $update = true
+then
+    cp "$current" "$baseline"
+    echo "Wrote counts for `wc -l < "$current"` tests to $baseline"
+    exit 0
+fi
+
+awk -v threshold="$threshold" '
+    # first the baseline, then the current counts
+    FNR == NR { instrs[$1] = $2; memops[$1] = $3; next }
+    # Report a change in the count named what from old to new,
+    # returning 1 if it is a regression
+    function compare(name, what, old, new) {
+	if (old == "-" || new == "-") {
+	    if (old != new) {
+		printf "%s: %s %s -> %s\n", name, what, old, new
+		return new == "-"
+	    }
+	    return 0
+	}
+	if (new > old * (100 + threshold) / 100) {
+	    # growth from 0 has no percentage, so show how much it grew
+	    if (old == 0) {
+		printf "%s: %s %d -> %d (+%d) REGRESSION\n",
+		       name, what, old, new, new - old
+	    } else {
+		printf "%s: %s %d -> %d (+%.1f%%) REGRESSION\n",
+		       name, what, old, new, 100 * (new - old) / old
+	    }
+	    return 1
+	} else if (new != old) {
+	    printf "%s: %s %d -> %d (%+.1f%%)\n",
+		   name, what, old, new, old == 0 ? 0 : 100 * (new - old) / old
+	}
+	return 0
+    }
+    {
+	if (!($1 in instrs)) {
+	    printf "%s: not in the baseline\n", $1
+	    next
+	}
+	failed += compare($1, "instructions", instrs[$1], $2)
+	failed += compare($1, "memory operations", memops[$1], $3)
+    }
+    END {
+	if (failed) {
+	    printf "%d performance regression(s) beyond %s%%!\n",
+		   failed, threshold
+	    exit 1
+	}
+	print "No performance regressions."
+    }' "$baseline" "$current"
@@ -0,0 +1,97 @@
+/* $Id$ */
+#include <stdlib.h>
+#include <limits.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdbool.h>
+#include "utilities.h"
+#include "regname.h"
+#include "machine_types.h"
+#include "literal_table.h"
+#include "region_marker.h"
+
+// remembered region markers
+typedef struct region_marker_s {
+    struct region_marker_s *next;
+    unsigned int line;
+    bool is_begin;
+    const char *name;
+} region_marker_t;
+
+// the remembered markers are a queue, in the order they were found,
+// with first pointing to the first marker and last to the last one
+static region_marker_t *first = NULL;
+static region_marker_t *last = NULL;
+
+// Requires: text is the text of a region marker comment
+//           that starts on the given line
+// Remember the marker so that code can be generated for it
+void region_marker_note(unsigned int line, const char *text)
+{
+    // skip the "%@"
+    const char *p = text + 2;
+    bool is_begin = (strncmp(p, "begin", 5) == 0);
+    p += is_begin ? 5 : 3;
+    while (isspace((unsigned char) *p)) {
+	p++;
+    }
+    const char *start = p;
+    while (isalnum((unsigned char) *p)) {
+	p++;
+    }
+
+    region_marker_t *rm = (region_marker_t *) malloc(sizeof(region_marker_t));
+    char *name = (char *) malloc(p - start + 1);
+    if (rm == NULL || name == NULL) {
+	bail_with_error("No space to remember a region marker!");
+    }
+    strncpy(name, start, p - start);
+    name[p - start] = '\0';
+    rm->next = NULL;
+    rm->line = line;
+    rm->is_begin = is_begin;
+    rm->name = name;
+    if (first == NULL) {
+	first = rm;
+    } else {
+	last->next = rm;
+    }
+    last = rm;
+}
+
+// Return the code for the region marker rm
+static code *region_marker_gen_code(region_marker_t *rm)
+{
+    unsigned int offset = literal_table_lookup_string(rm->name);
+    machine_types_check_fits_in_offset(offset);
+    if (rm->is_begin) {
+	return code_mbeg(GP, offset);
+    } else {
+	return code_mend(GP, offset);
+    }
+}
+
+// Return the code for all the remembered region markers
+// that are on lines before the given line (in order),
+// and forget them
+code_seq region_marker_gen_code_before(unsigned int line)
+{
+    code_seq ret = code_seq_empty();
+    while (first != NULL && first->line < line) {
+	region_marker_t *rm = first;
+	code_seq_add_to_end(&ret, region_marker_gen_code(rm));
+	first = rm->next;
+	free(rm);
+    }
+    if (first == NULL) {
+	last = NULL;
+    }
+    return ret;
+}
+
+// Return the code for all the remaining remembered region markers
+// (in order), and forget them
+code_seq region_marker_gen_code_remaining()
+{
+    return region_marker_gen_code_before(UINT_MAX);
+}
@@ -0,0 +1,26 @@
+/* $Id$ */
+// Region markers are SPL comments of the forms
+//    %@begin name
+//    %@end name
+// which mark where a named measurement region starts and ends,
+// so that the code generator can put the VM's MBEG and MEND
+// system calls there.
+#ifndef _REGION_MARKER_H
+#define _REGION_MARKER_H
+#include "code_seq.h"
+
+// Requires: text is the text of a region marker comment
+//           that starts on the given line
+// Remember the marker so that code can be generated for it
+extern void region_marker_note(unsigned int line, const char *text);
+
+// Return the code for all the remembered region markers
+// that are on lines before the given line (in order),
+// and forget them
+extern code_seq region_marker_gen_code_before(unsigned int line);
+
+// Return the code for all the remaining remembered region markers
+// (in order), and forget them
+extern code_seq region_marker_gen_code_remaining();
+
+#endif
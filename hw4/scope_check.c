@@ -18,9 +18,19 @@
 // and Check the given program AST for duplicate declarations
 // or uses of identifiers that were not declared.
 // Modifies the given AST to have appropriate id_use pointers.
+// If an error is reported, the symbol table is emptied first.
 void scope_check_program(block_t *prog)
 {
-    scope_check_block(prog);
+    error_context ec;
+    error_context_enter(&ec);
+    if (setjmp(ec.env) == 0) {
+	scope_check_block(prog);
+	error_context_leave(&ec);
+    } else {
+	// leave no scopes behind to confuse checking the next program
+	symtab_initialize();
+	error_context_propagate(&ec);
+    }
 }
 
 // build the symbol table and check the declarations in blk
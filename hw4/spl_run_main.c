@@ -0,0 +1,140 @@
+/* $Id$ */
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bof.h"
+#include "bof_cache.h"
+#include "parser.h"
+#include "ast.h"
+#include "utilities.h"
+#include "symtab.h"
+#include "scope_check.h"
+#include "vm/machine.h"
+
+// This is the spl-run program, which compiles an SPL program
+// into a binary object file image in memory and runs that image
+// in the VM, all in one process and without writing a .bof file.
+// Images are kept in the BOF cache (see bof_cache.h), when it is enabled,
+// like the compiler's binary object files, so a program that was run before
+// is not compiled again (unless spl-run has been rebuilt since).
+
+// The functions gen_code_initialize and gen_code_program
+// are declared here as in compiler_main.c
+
+// Initialize the code generator
+extern void gen_code_initialize();
+
+// Requires: bf is open for writing
+// Generate code for prog into bf
+extern void gen_code_program(BOFFILE bf, block_t prog);
+
+/* Print a usage message on stderr 
+   and exit with failure. */
+static void usage(const char *cmdname)
+{
+    fprintf(stderr, "Usage: %s [-t] [-s] [-m] [-i] %s\n",
+	    cmdname, "codeFilename.spl");
+    exit(EXIT_FAILURE);
+}
+
+// Compile the SPL program in the file named filename,
+// put the image of its binary object file in a malloc-allocated buffer,
+// set *bytesp to the size of that image, and return the buffer
+static char *compile_to_memory(const char *filename, size_t *bytesp)
+{
+    block_t progast = parseProgram((char *) filename);
+    // build symbol table and check for duplicate declarations,
+    // recording id-use information in the AST
+    symtab_initialize();
+    scope_check_program(&progast);
+    // generate code from the AST into memory
+    // (gen_code_program closes the BOFFILE when it is done),
+    // releasing the partial image if that fails
+    char *image = NULL;
+    gen_code_initialize();
+    BOFFILE bf = bof_write_open_memory(filename, &image, bytesp);
+    error_context ec;
+    error_context_enter(&ec);
+    if (setjmp(ec.env) == 0) {
+	gen_code_program(bf, progast);
+	error_context_leave(&ec);
+    } else {
+	bof_close(bf);
+	free(image);
+	error_context_propagate(&ec);
+    }
+    return image;
+}
+
+// Compile and run the SPL program named on the command line
+int main(int argc, char *argv[])
+{
+    const char *cmdname = argv[0];
+    argc--;
+    argv++;
+
+    bool trace_execution = false;
+    bool heap_statistics = false;
+    bool memory_profile = false;
+    bool execution_counts = false;
+    while (argc > 0 && strlen(argv[0]) >= 2 && argv[0][0] == '-') {
+	if (strcmp(argv[0], "-t") == 0) {
+	    trace_execution = true;
+	} else if (strcmp(argv[0], "-s") == 0) {
+	    heap_statistics = true;
+	} else if (strcmp(argv[0], "-m") == 0) {
+	    memory_profile = true;
+	} else if (strcmp(argv[0], "-i") == 0) {
+	    execution_counts = true;
+	} else {
+	    // bad option!
+	    usage(cmdname);
+	}
+	argc--;
+	argv++;
+    }
+
+    // must have exactly one file name
+    if (argc != 1) {
+	usage(cmdname);
+    }
+
+    // the name of the file
+    const char *filename = argv[0];
+    const char *lastdot = strrchr(filename, '.');
+    if (lastdot == NULL || strcmp(lastdot, ".spl") != 0) {
+	bail_with_error("filename argument must end in .spl not %s",
+			filename);
+    }
+
+    // if the image is in the BOF cache, use it instead of compiling;
+    // the key is that of the source file (no options change the image)
+    char *image = NULL;
+    size_t image_bytes = 0;
+    BOFCache cache;
+    bool caching = bof_cache_open(&cache, cmdname)
+	&& bof_cache_set_key(&cache, filename, "");
+    if (!caching || !bof_cache_fetch_memory(&cache, &image, &image_bytes)) {
+	image = compile_to_memory(filename, &image_bytes);
+	if (caching) {
+	    bof_cache_store_memory(&cache, image, image_bytes);
+	}
+    }
+
+    // run the image
+    BOFImage img = bof_map_memory(filename, image, image_bytes);
+    machine_load(img);
+    free(image);
+    if (heap_statistics) {
+	machine_enable_heap_statistics();
+    }
+    if (memory_profile) {
+	machine_enable_memory_profile();
+    }
+    if (execution_counts) {
+	machine_enable_execution_counts();
+    }
+    // the program's exit code is spl-run's
+    return machine_run(trace_execution);
+}
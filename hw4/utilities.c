@@ -41,32 +41,86 @@ static void vdebug_print(const char *fmt, va_list args)
 }
 #endif
 
-static void vbail_with_error(const char* fmt, va_list args);
+// the calling thread's innermost error context (NULL if there is none)
+static _Thread_local error_context *current_error_context = NULL;
+
+// Make ec the calling thread's innermost error context
+void error_context_enter(error_context *ec)
+{
+    ec->status = 0;
+    ec->message[0] = '\0';
+    ec->enclosing = current_error_context;
+    current_error_context = ec;
+}
+
+// Requires: ec is the calling thread's innermost error context
+// Leave ec, making the error context it was entered in innermost again
+void error_context_leave(error_context *ec)
+{
+    assert(current_error_context == ec);
+    current_error_context = ec->enclosing;
+}
+
+// Report an error with the given exit code and message (which may be empty).
+// If there is an error context, leave it and give it the error,
+// otherwise print the message (if any) on stderr and exit,
+// so a call to this does not return.
+static void report_error(int status, const char *msg)
+{
+    error_context *ec = current_error_context;
+    if (ec == NULL) {
+	if (msg[0] != '\0') {
+	    fprintf(stderr, "%s\n", msg);
+	}
+	fflush(stderr);
+	exit(status);
+    }
+    current_error_context = ec->enclosing;
+    ec->status = status;
+    snprintf(ec->message, ERROR_MESSAGE_SIZE, "%s", msg);
+    longjmp(ec->env, 1);
+}
+
+// Requires: ec caught an error
+// Report that error again, to the calling thread's innermost error context,
+// so a call to this does not return.
+void error_context_propagate(const error_context *ec)
+{
+    report_error(ec->status, ec->message);
+}
+
+static void vbail_with_error(const char *prefix, const char* fmt,
+			     va_list args);
 
 // Format a string error message and print it followed by a newline on stderr
 // using perror (for an OS error, if the errno is not 0)
 // then exit with a failure code, so a call to this does not return.
+// If there is an error context, the message and failure code
+// are given to it instead.
 void bail_with_error(const char *fmt, ...)
 {
     fflush(stdout); // flush so output comes after what has happened already
     va_list(args);
     va_start(args, fmt);
-    vbail_with_error(fmt, args);
+    vbail_with_error("", fmt, args);
 }
 
-// The variadic version of bail_with_error
-static void vbail_with_error(const char* fmt, va_list args)
+// The variadic version of bail_with_error,
+// which puts prefix before the formatted message
+static void vbail_with_error(const char *prefix, const char* fmt,
+			     va_list args)
 {
     extern int errno;
-    char buff[2048];
-    vsprintf(buff, fmt, args);
-    if (errno != 0) {
-	perror(buff);
-    } else {
-	fprintf(stderr, "%s\n", buff);
+    int err = errno;
+    char buff[ERROR_MESSAGE_SIZE];
+    int len = snprintf(buff, sizeof(buff), "%s", prefix);
+    vsnprintf(buff + len, sizeof(buff) - len, fmt, args);
+    if (err != 0) {
+	// add the description of err, as perror would
+	len = strlen(buff);
+	snprintf(buff + len, sizeof(buff) - len, ": %s", strerror(err));
     }
-    fflush(stderr);
-    exit(EXIT_FAILURE);
+    report_error(EXIT_FAILURE, buff);
 }
 
 // Print an error message on stderr
@@ -74,15 +128,27 @@ static void vbail_with_error(const char* fmt, va_list args)
 // (prints: filename, a colon, " line ", the line number, and a space)
 // and then the message.
 // Then exit with a failure code, so this function does not return.
+// If there is an error context, the message and failure code
+// are given to it instead.
 void bail_with_prog_error(file_location floc, const char *fmt, ...)
 {
     fflush(stdout); // flush so output comes after what has happened already
-    // print file, line, column information
-    fprintf(stderr, "%s: line %d ", floc.filename, floc.line);
+    // the file, line, column information
+    char prefix[BUFSIZ];
+    snprintf(prefix, sizeof(prefix), "%s: line %d ", floc.filename, floc.line);
 
     va_list(args);
     va_start(args, fmt);
-    vbail_with_error(fmt, args);
+    vbail_with_error(prefix, fmt, args);
+}
+
+// Exit with the given exit code (without printing any message),
+// so this function does not return.
+// If there is an error context, the exit code is given to it instead.
+void bail_with_exit_code(int status)
+{
+    fflush(stdout); // flush so output comes after what has happened already
+    report_error(status, "");
 }
 
 #define BUF_SIZE 1024
@@ -0,0 +1,151 @@
+/* $Id$ */
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+#include "utilities.h"
+
+// the number of bytes in a chunk (unless a larger one is needed)
+#define CHUNK_BYTES 4096
+
+// a chunk of space in a generation of the arena
+typedef struct arena_chunk_s {
+    struct arena_chunk_s *next;
+    size_t used;      // the number of bytes of data in use
+    size_t size;      // the number of bytes of data
+    max_align_t data[];
+} arena_chunk;
+
+// The arena's state is kept per thread, so each thread has its own arena
+
+// is space allocated from the arena?
+static _Thread_local bool started = false;
+// the chunks of the current and previous generations
+// (the current one is allocated from its first chunk)
+static _Thread_local arena_chunk *current = NULL;
+static _Thread_local arena_chunk *previous = NULL;
+// chunks of CHUNK_BYTES that have been freed, for reuse
+static _Thread_local arena_chunk *spare = NULL;
+
+// Return size rounded up to a multiple of the alignment of any type
+static size_t round_to_alignment(size_t size)
+{
+    size_t align = sizeof(max_align_t);
+    return (size + align - 1) / align * align;
+}
+
+// Return a chunk with room for at least size bytes,
+// exiting with an error if there is no space
+static arena_chunk *new_chunk(size_t size)
+{
+    if (size <= CHUNK_BYTES && spare != NULL) {
+	arena_chunk *c = spare;
+	spare = spare->next;
+	c->used = 0;
+	return c;
+    }
+    size_t bytes = (size > CHUNK_BYTES) ? size : CHUNK_BYTES;
+    arena_chunk *c = (arena_chunk *) malloc(sizeof(arena_chunk) + bytes);
+    if (c == NULL) {
+	bail_with_error("No space to allocate %lu bytes!",
+			(unsigned long) size);
+    }
+    c->used = 0;
+    c->size = bytes;
+    return c;
+}
+
+// Return (a pointer to) size bytes of fresh space,
+// aligned for any type.
+// Exit the program with an error if there is no space.
+void *arena_alloc(size_t size)
+{
+    if (!started) {
+	void *ret = malloc(size);
+	if (ret == NULL) {
+	    bail_with_error("No space to allocate %lu bytes!",
+			    (unsigned long) size);
+	}
+	return ret;
+    }
+    size = round_to_alignment(size);
+    if (current == NULL || current->size - current->used < size) {
+	arena_chunk *c = new_chunk(size);
+	c->next = current;
+	current = c;
+    }
+    void *ret = (char *) current->data + current->used;
+    current->used += size;
+    return ret;
+}
+
+// Return (a pointer to) a fresh copy of the string s
+// Exit the program with an error if there is no space.
+char *arena_strdup(const char *s)
+{
+    size_t len = strlen(s) + 1;
+    char *ret = (char *) arena_alloc(len);
+    memcpy(ret, s, len);
+    return ret;
+}
+
+// Start allocating from the arena
+// (this does nothing if it is already started)
+void arena_start()
+{
+    started = true;
+}
+
+// Is space being allocated from the arena?
+bool arena_started()
+{
+    return started;
+}
+
+// Requires: the arena is started
+// Free the previous generation's space
+// and make the current generation the previous one
+void arena_flip()
+{
+    assert(started);
+    while (previous != NULL) {
+	arena_chunk *c = previous;
+	previous = c->next;
+	if (c->size == CHUNK_BYTES) {
+	    c->next = spare;
+	    spare = c;
+	} else {
+	    free(c);
+	}
+    }
+    previous = current;
+    current = NULL;
+}
+
+// Stop allocating from the arena, keeping (never freeing)
+// the space that both of its generations hold
+void arena_stop()
+{
+    started = false;
+    current = NULL;
+    previous = NULL;
+}
+
+// Free the chunks on the list starting at c
+static void free_chunks(arena_chunk *c)
+{
+    while (c != NULL) {
+	arena_chunk *next = c->next;
+	free(c);
+	c = next;
+    }
+}
+
+// Stop allocating from the arena and free all the space
+// that both of its generations hold
+void arena_release()
+{
+    free_chunks(current);
+    free_chunks(previous);
+    arena_stop();
+}
@@ -0,0 +1,50 @@
+/* $Id$ */
+// Allocation of the space for tokens and ASTs,
+// which can be freed soon after it is used when assembling in one pass
+#ifndef _ARENA_H
+#define _ARENA_H
+#include <stdbool.h>
+#include <stddef.h>
+
+// Normally the space allocated here comes from malloc and is never freed
+// (like the rest of an AST).
+// While the arena is started, it comes from the arena's chunks instead,
+// which are in two generations: the current one, which is allocated from,
+// and the previous one. Each call of arena_flip frees the previous
+// generation and makes the current one previous, so space allocated
+// before the last flip but one is gone. (Two generations are kept
+// as the parser reads one token ahead, so the first token of a statement
+// is allocated before the flip that ends the statement before it.)
+// A caller that is done with everything allocated while the arena
+// was started (e.g., a whole AST) can free it all with arena_release.
+
+// Return (a pointer to) size bytes of fresh space,
+// aligned for any type.
+// Exit the program with an error if there is no space.
+extern void *arena_alloc(size_t size);
+
+// Return (a pointer to) a fresh copy of the string s
+// Exit the program with an error if there is no space.
+extern char *arena_strdup(const char *s);
+
+// Start allocating from the arena
+// (this does nothing if it is already started)
+extern void arena_start();
+
+// Is space being allocated from the arena?
+extern bool arena_started();
+
+// Requires: the arena is started
+// Free the previous generation's space
+// and make the current generation the previous one
+extern void arena_flip();
+
+// Stop allocating from the arena, keeping (never freeing)
+// the space that both of its generations hold
+extern void arena_stop();
+
+// Stop allocating from the arena and free all the space
+// that both of its generations hold
+extern void arena_release();
+
+#endif
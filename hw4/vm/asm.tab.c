@@ -55,7 +55,7 @@
 #define YYSKELETON_NAME "yacc.c"
 
 /* Pure parsers.  */
-#define YYPURE 0
+#define YYPURE 2
 
 /* Push parsers.  */
 #define YYPUSH 0
@@ -130,126 +130,158 @@ enum yysymbol_kind_t
   YYSYMBOL_scaopsym = 28,                  /* "SCA"  */
   YYSYMBOL_lwiopsym = 29,                  /* "LWI"  */
   YYSYMBOL_negopsym = 30,                  /* "NEG"  */
-  YYSYMBOL_litopsym = 31,                  /* "LIT"  */
-  YYSYMBOL_ariopsym = 32,                  /* "ARI"  */
-  YYSYMBOL_sriopsym = 33,                  /* "SRI"  */
-  YYSYMBOL_mulopsym = 34,                  /* "MUL"  */
-  YYSYMBOL_divopsym = 35,                  /* "DIV"  */
-  YYSYMBOL_cfhiopsym = 36,                 /* "CFHI"  */
-  YYSYMBOL_cfloopsym = 37,                 /* "CFLO"  */
-  YYSYMBOL_sllopsym = 38,                  /* "SLL"  */
-  YYSYMBOL_srlopsym = 39,                  /* "SRL"  */
-  YYSYMBOL_jmpopsym = 40,                  /* "JMP"  */
-  YYSYMBOL_jrelopsym = 41,                 /* "JREL"  */
-  YYSYMBOL_addiopsym = 42,                 /* "ADDI"  */
-  YYSYMBOL_andiopsym = 43,                 /* "ANDI"  */
-  YYSYMBOL_boriopsym = 44,                 /* "BORI"  */
-  YYSYMBOL_noriopsym = 45,                 /* "NORI"  */
-  YYSYMBOL_xoriopsym = 46,                 /* "XORI"  */
-  YYSYMBOL_beqopsym = 47,                  /* "BEQ"  */
-  YYSYMBOL_bgezopsym = 48,                 /* "BGEZ"  */
-  YYSYMBOL_blezopsym = 49,                 /* "BLEZ"  */
-  YYSYMBOL_bgtzopsym = 50,                 /* "BGTZ"  */
-  YYSYMBOL_bltzopsym = 51,                 /* "BLTZ"  */
-  YYSYMBOL_bneopsym = 52,                  /* "BNE"  */
-  YYSYMBOL_csiopsym = 53,                  /* "CSI"  */
-  YYSYMBOL_jmpaopsym = 54,                 /* "JMPA"  */
-  YYSYMBOL_callopsym = 55,                 /* "CALL"  */
-  YYSYMBOL_rtnopsym = 56,                  /* "RTN"  */
-  YYSYMBOL_exitopsym = 57,                 /* "EXIT"  */
-  YYSYMBOL_pstropsym = 58,                 /* "PSTR"  */
-  YYSYMBOL_pintopsym = 59,                 /* "PINT"  */
-  YYSYMBOL_pchopsym = 60,                  /* "PCH"  */
-  YYSYMBOL_rchopsym = 61,                  /* "RCH"  */
-  YYSYMBOL_straopsym = 62,                 /* "STRA"  */
-  YYSYMBOL_notropsym = 63,                 /* "NOTR"  */
-  YYSYMBOL_regsym = 64,                    /* regsym  */
-  YYSYMBOL_wordsym = 65,                   /* "WORD"  */
-  YYSYMBOL_charsym = 66,                   /* "CHAR"  */
-  YYSYMBOL_stringsym = 67,                 /* "STRING"  */
-  YYSYMBOL_charliteralsym = 68,            /* charliteralsym  */
-  YYSYMBOL_stringliteralsym = 69,          /* stringliteralsym  */
-  YYSYMBOL_YYACCEPT = 70,                  /* $accept  */
-  YYSYMBOL_program = 71,                   /* program  */
-  YYSYMBOL_textSection = 72,               /* textSection  */
-  YYSYMBOL_entryPoint = 73,                /* entryPoint  */
-  YYSYMBOL_addr = 74,                      /* addr  */
-  YYSYMBOL_label = 75,                     /* label  */
-  YYSYMBOL_asmInstrs = 76,                 /* asmInstrs  */
-  YYSYMBOL_asmInstr = 77,                  /* asmInstr  */
-  YYSYMBOL_labelOpt = 78,                  /* labelOpt  */
-  YYSYMBOL_empty = 79,                     /* empty  */
-  YYSYMBOL_instr = 80,                     /* instr  */
-  YYSYMBOL_noArgInstr = 81,                /* noArgInstr  */
-  YYSYMBOL_noArgOp = 82,                   /* noArgOp  */
-  YYSYMBOL_twoRegCompInstr = 83,           /* twoRegCompInstr  */
-  YYSYMBOL_twoRegCompOp = 84,              /* twoRegCompOp  */
-  YYSYMBOL_offset = 85,                    /* offset  */
-  YYSYMBOL_number = 86,                    /* number  */
-  YYSYMBOL_sign = 87,                      /* sign  */
-  YYSYMBOL_twoRegNoOffsetsInstr = 88,      /* twoRegNoOffsetsInstr  */
-  YYSYMBOL_twoRegNoOffsetsOp = 89,         /* twoRegNoOffsetsOp  */
-  YYSYMBOL_noTargetOffsetInstr = 90,       /* noTargetOffsetInstr  */
-  YYSYMBOL_noTargetOffsetOp = 91,          /* noTargetOffsetOp  */
-  YYSYMBOL_noSourceOffsetInstr = 92,       /* noSourceOffsetInstr  */
-  YYSYMBOL_noSourceOffsetOp = 93,          /* noSourceOffsetOp  */
-  YYSYMBOL_oneRegOffsetArgInstr = 94,      /* oneRegOffsetArgInstr  */
-  YYSYMBOL_oneRegOffsetArgOp = 95,         /* oneRegOffsetArgOp  */
-  YYSYMBOL_arg = 96,                       /* arg  */
-  YYSYMBOL_oneRegArgInstr = 97,            /* oneRegArgInstr  */
-  YYSYMBOL_oneRegArgOp = 98,               /* oneRegArgOp  */
-  YYSYMBOL_oneRegOffsetInstr = 99,         /* oneRegOffsetInstr  */
-  YYSYMBOL_oneRegOffsetOp = 100,           /* oneRegOffsetOp  */
-  YYSYMBOL_shiftInstr = 101,               /* shiftInstr  */
-  YYSYMBOL_shiftOp = 102,                  /* shiftOp  */
-  YYSYMBOL_shift = 103,                    /* shift  */
-  YYSYMBOL_argOnlyInstr = 104,             /* argOnlyInstr  */
-  YYSYMBOL_argOnlyOp = 105,                /* argOnlyOp  */
-  YYSYMBOL_immedArithInstr = 106,          /* immedArithInstr  */
-  YYSYMBOL_immedArithOp = 107,             /* immedArithOp  */
-  YYSYMBOL_immed = 108,                    /* immed  */
-  YYSYMBOL_immedBoolInstr = 109,           /* immedBoolInstr  */
-  YYSYMBOL_immedBoolOp = 110,              /* immedBoolOp  */
-  YYSYMBOL_uimmed = 111,                   /* uimmed  */
-  YYSYMBOL_branchTestInstr = 112,          /* branchTestInstr  */
-  YYSYMBOL_branchTestOp = 113,             /* branchTestOp  */
-  YYSYMBOL_jumpInstr = 114,                /* jumpInstr  */
-  YYSYMBOL_jumpOp = 115,                   /* jumpOp  */
-  YYSYMBOL_syscallInstr = 116,             /* syscallInstr  */
-  YYSYMBOL_offsetOnlySyscall = 117,        /* offsetOnlySyscall  */
-  YYSYMBOL_offsetOnlySyscallOp = 118,      /* offsetOnlySyscallOp  */
-  YYSYMBOL_regOffsetSyscall = 119,         /* regOffsetSyscall  */
-  YYSYMBOL_regOffsetSyscallOp = 120,       /* regOffsetSyscallOp  */
-  YYSYMBOL_noArgSyscall = 121,             /* noArgSyscall  */
-  YYSYMBOL_noArgSyscallOp = 122,           /* noArgSyscallOp  */
-  YYSYMBOL_dataSection = 123,              /* dataSection  */
-  YYSYMBOL_staticStartAddr = 124,          /* staticStartAddr  */
-  YYSYMBOL_staticDecls = 125,              /* staticDecls  */
-  YYSYMBOL_staticDecl = 126,               /* staticDecl  */
-  YYSYMBOL_dataSize = 127,                 /* dataSize  */
-  YYSYMBOL_initializerOpt = 128,           /* initializerOpt  */
-  YYSYMBOL_stackSection = 129,             /* stackSection  */
-  YYSYMBOL_stackBottomAddr = 130           /* stackBottomAddr  */
+  YYSYMBOL_bcpopsym = 31,                  /* "BCP"  */
+  YYSYMBOL_litopsym = 32,                  /* "LIT"  */
+  YYSYMBOL_ariopsym = 33,                  /* "ARI"  */
+  YYSYMBOL_sriopsym = 34,                  /* "SRI"  */
+  YYSYMBOL_mulopsym = 35,                  /* "MUL"  */
+  YYSYMBOL_divopsym = 36,                  /* "DIV"  */
+  YYSYMBOL_cfhiopsym = 37,                 /* "CFHI"  */
+  YYSYMBOL_cfloopsym = 38,                 /* "CFLO"  */
+  YYSYMBOL_sllopsym = 39,                  /* "SLL"  */
+  YYSYMBOL_srlopsym = 40,                  /* "SRL"  */
+  YYSYMBOL_jmpopsym = 41,                  /* "JMP"  */
+  YYSYMBOL_jrelopsym = 42,                 /* "JREL"  */
+  YYSYMBOL_bflopsym = 43,                  /* "BFL"  */
+  YYSYMBOL_addiopsym = 44,                 /* "ADDI"  */
+  YYSYMBOL_andiopsym = 45,                 /* "ANDI"  */
+  YYSYMBOL_boriopsym = 46,                 /* "BORI"  */
+  YYSYMBOL_noriopsym = 47,                 /* "NORI"  */
+  YYSYMBOL_xoriopsym = 48,                 /* "XORI"  */
+  YYSYMBOL_beqopsym = 49,                  /* "BEQ"  */
+  YYSYMBOL_bgezopsym = 50,                 /* "BGEZ"  */
+  YYSYMBOL_blezopsym = 51,                 /* "BLEZ"  */
+  YYSYMBOL_bgtzopsym = 52,                 /* "BGTZ"  */
+  YYSYMBOL_bltzopsym = 53,                 /* "BLTZ"  */
+  YYSYMBOL_bneopsym = 54,                  /* "BNE"  */
+  YYSYMBOL_raddopsym = 55,                 /* "RADD"  */
+  YYSYMBOL_rsubopsym = 56,                 /* "RSUB"  */
+  YYSYMBOL_rmulopsym = 57,                 /* "RMUL"  */
+  YYSYMBOL_rdivopsym = 58,                 /* "RDIV"  */
+  YYSYMBOL_randopsym = 59,                 /* "RAND"  */
+  YYSYMBOL_rboropsym = 60,                 /* "RBOR"  */
+  YYSYMBOL_rxoropsym = 61,                 /* "RXOR"  */
+  YYSYMBOL_rsltopsym = 62,                 /* "RSLT"  */
+  YYSYMBOL_breqopsym = 63,                 /* "BREQ"  */
+  YYSYMBOL_brneopsym = 64,                 /* "BRNE"  */
+  YYSYMBOL_brltopsym = 65,                 /* "BRLT"  */
+  YYSYMBOL_brleopsym = 66,                 /* "BRLE"  */
+  YYSYMBOL_brgtopsym = 67,                 /* "BRGT"  */
+  YYSYMBOL_brgeopsym = 68,                 /* "BRGE"  */
+  YYSYMBOL_csiopsym = 69,                  /* "CSI"  */
+  YYSYMBOL_jmpaopsym = 70,                 /* "JMPA"  */
+  YYSYMBOL_callopsym = 71,                 /* "CALL"  */
+  YYSYMBOL_rtnopsym = 72,                  /* "RTN"  */
+  YYSYMBOL_exitopsym = 73,                 /* "EXIT"  */
+  YYSYMBOL_pstropsym = 74,                 /* "PSTR"  */
+  YYSYMBOL_pintopsym = 75,                 /* "PINT"  */
+  YYSYMBOL_pchopsym = 76,                  /* "PCH"  */
+  YYSYMBOL_rchopsym = 77,                  /* "RCH"  */
+  YYSYMBOL_rlnopsym = 78,                  /* "RLN"  */
+  YYSYMBOL_rbytopsym = 79,                 /* "RBYT"  */
+  YYSYMBOL_pchsopsym = 80,                 /* "PCHS"  */
+  YYSYMBOL_pbytopsym = 81,                 /* "PBYT"  */
+  YYSYMBOL_spwnopsym = 82,                 /* "SPWN"  */
+  YYSYMBOL_joinopsym = 83,                 /* "JOIN"  */
+  YYSYMBOL_casopsym = 84,                  /* "CAS"  */
+  YYSYMBOL_faddopsym = 85,                 /* "FADD"  */
+  YYSYMBOL_cocropsym = 86,                 /* "COCR"  */
+  YYSYMBOL_yldopsym = 87,                  /* "YLD"  */
+  YYSYMBOL_rsmopsym = 88,                  /* "RSM"  */
+  YYSYMBOL_mbegopsym = 89,                 /* "MBEG"  */
+  YYSYMBOL_mendopsym = 90,                 /* "MEND"  */
+  YYSYMBOL_alocopsym = 91,                 /* "ALOC"  */
+  YYSYMBOL_freeopsym = 92,                 /* "FREE"  */
+  YYSYMBOL_rszopsym = 93,                  /* "RSZ"  */
+  YYSYMBOL_straopsym = 94,                 /* "STRA"  */
+  YYSYMBOL_notropsym = 95,                 /* "NOTR"  */
+  YYSYMBOL_regsym = 96,                    /* regsym  */
+  YYSYMBOL_wordsym = 97,                   /* "WORD"  */
+  YYSYMBOL_charsym = 98,                   /* "CHAR"  */
+  YYSYMBOL_stringsym = 99,                 /* "STRING"  */
+  YYSYMBOL_charliteralsym = 100,           /* charliteralsym  */
+  YYSYMBOL_stringliteralsym = 101,         /* stringliteralsym  */
+  YYSYMBOL_YYACCEPT = 102,                 /* $accept  */
+  YYSYMBOL_program = 103,                  /* program  */
+  YYSYMBOL_textSection = 104,              /* textSection  */
+  YYSYMBOL_entryPoint = 105,               /* entryPoint  */
+  YYSYMBOL_addr = 106,                     /* addr  */
+  YYSYMBOL_label = 107,                    /* label  */
+  YYSYMBOL_asmInstrs = 108,                /* asmInstrs  */
+  YYSYMBOL_asmInstr = 109,                 /* asmInstr  */
+  YYSYMBOL_labelOpt = 110,                 /* labelOpt  */
+  YYSYMBOL_empty = 111,                    /* empty  */
+  YYSYMBOL_instr = 112,                    /* instr  */
+  YYSYMBOL_noArgInstr = 113,               /* noArgInstr  */
+  YYSYMBOL_noArgOp = 114,                  /* noArgOp  */
+  YYSYMBOL_twoRegCompInstr = 115,          /* twoRegCompInstr  */
+  YYSYMBOL_twoRegCompOp = 116,             /* twoRegCompOp  */
+  YYSYMBOL_offset = 117,                   /* offset  */
+  YYSYMBOL_number = 118,                   /* number  */
+  YYSYMBOL_sign = 119,                     /* sign  */
+  YYSYMBOL_twoRegNoOffsetsInstr = 120,     /* twoRegNoOffsetsInstr  */
+  YYSYMBOL_twoRegNoOffsetsOp = 121,        /* twoRegNoOffsetsOp  */
+  YYSYMBOL_noTargetOffsetInstr = 122,      /* noTargetOffsetInstr  */
+  YYSYMBOL_noTargetOffsetOp = 123,         /* noTargetOffsetOp  */
+  YYSYMBOL_noSourceOffsetInstr = 124,      /* noSourceOffsetInstr  */
+  YYSYMBOL_noSourceOffsetOp = 125,         /* noSourceOffsetOp  */
+  YYSYMBOL_oneRegOffsetArgInstr = 126,     /* oneRegOffsetArgInstr  */
+  YYSYMBOL_oneRegOffsetArgOp = 127,        /* oneRegOffsetArgOp  */
+  YYSYMBOL_arg = 128,                      /* arg  */
+  YYSYMBOL_oneRegArgInstr = 129,           /* oneRegArgInstr  */
+  YYSYMBOL_oneRegArgOp = 130,              /* oneRegArgOp  */
+  YYSYMBOL_oneRegOffsetInstr = 131,        /* oneRegOffsetInstr  */
+  YYSYMBOL_oneRegOffsetOp = 132,           /* oneRegOffsetOp  */
+  YYSYMBOL_shiftInstr = 133,               /* shiftInstr  */
+  YYSYMBOL_shiftOp = 134,                  /* shiftOp  */
+  YYSYMBOL_shift = 135,                    /* shift  */
+  YYSYMBOL_argOnlyInstr = 136,             /* argOnlyInstr  */
+  YYSYMBOL_argOnlyOp = 137,                /* argOnlyOp  */
+  YYSYMBOL_immedArithInstr = 138,          /* immedArithInstr  */
+  YYSYMBOL_immedArithOp = 139,             /* immedArithOp  */
+  YYSYMBOL_immed = 140,                    /* immed  */
+  YYSYMBOL_immedBoolInstr = 141,           /* immedBoolInstr  */
+  YYSYMBOL_immedBoolOp = 142,              /* immedBoolOp  */
+  YYSYMBOL_uimmed = 143,                   /* uimmed  */
+  YYSYMBOL_branchTestInstr = 144,          /* branchTestInstr  */
+  YYSYMBOL_branchTestOp = 145,             /* branchTestOp  */
+  YYSYMBOL_regCompInstr = 146,             /* regCompInstr  */
+  YYSYMBOL_regCompOp = 147,                /* regCompOp  */
+  YYSYMBOL_regBranchInstr = 148,           /* regBranchInstr  */
+  YYSYMBOL_regBranchOp = 149,              /* regBranchOp  */
+  YYSYMBOL_jumpInstr = 150,                /* jumpInstr  */
+  YYSYMBOL_jumpOp = 151,                   /* jumpOp  */
+  YYSYMBOL_syscallInstr = 152,             /* syscallInstr  */
+  YYSYMBOL_offsetOnlySyscall = 153,        /* offsetOnlySyscall  */
+  YYSYMBOL_offsetOnlySyscallOp = 154,      /* offsetOnlySyscallOp  */
+  YYSYMBOL_regOffsetSyscall = 155,         /* regOffsetSyscall  */
+  YYSYMBOL_regOffsetSyscallOp = 156,       /* regOffsetSyscallOp  */
+  YYSYMBOL_noArgSyscall = 157,             /* noArgSyscall  */
+  YYSYMBOL_noArgSyscallOp = 158,           /* noArgSyscallOp  */
+  YYSYMBOL_dataSection = 159,              /* dataSection  */
+  YYSYMBOL_staticStartAddr = 160,          /* staticStartAddr  */
+  YYSYMBOL_staticDecls = 161,              /* staticDecls  */
+  YYSYMBOL_staticDecl = 162,               /* staticDecl  */
+  YYSYMBOL_dataSize = 163,                 /* dataSize  */
+  YYSYMBOL_initializerOpt = 164,           /* initializerOpt  */
+  YYSYMBOL_stackSection = 165,             /* stackSection  */
+  YYSYMBOL_stackBottomAddr = 166           /* stackBottomAddr  */
 };
 typedef enum yysymbol_kind_t yysymbol_kind_t;
 
 
 
 /* Unqualified %code blocks.  */
-#line 160 "asm.y"
+#line 201 "asm.y"
 
  /* extern declarations provided by the lexer */
-extern int yylex(void);
-
- /* extern void yyerror(char const *msg); */
+#include "lexer.h"
 
- /* The AST for the program, set by the semantic action for program. */
-ast_program_t progast; 
-
- /* Set the program's ast to be t */
-extern void setProgAST(ast_program_t t);
+ /* Report an error to the user on stderr (see lexer_error) */
+static void yyerror(YYLTYPE *llocp, char const *file_name, yyscan_t scanner,
+		    ast_program_t *progast, const char *msg);
 
-#line 253 "asm.tab.c"
+#line 285 "asm.tab.c"
 
 #ifdef short
 # undef short
@@ -552,19 +584,19 @@ union yyalloc
 /* YYFINAL -- State number of the termination state.  */
 #define YYFINAL  9
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   146
+#define YYLAST   187
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  70
+#define YYNTOKENS  102
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  61
+#define YYNNTS  65
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  118
+#define YYNRULES  154
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  195
+#define YYNSTATES  241
 
 /* YYMAXUTOK -- Last valid token kind.  */
-#define YYMAXUTOK   324
+#define YYMAXUTOK   356
 
 
 /* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
@@ -610,25 +642,32 @@ static const yytype_int8 yytranslate[] =
       35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
       45,    46,    47,    48,    49,    50,    51,    52,    53,    54,
       55,    56,    57,    58,    59,    60,    61,    62,    63,    64,
-      65,    66,    67,    68,    69
+      65,    66,    67,    68,    69,    70,    71,    72,    73,    74,
+      75,    76,    77,    78,    79,    80,    81,    82,    83,    84,
+      85,    86,    87,    88,    89,    90,    91,    92,    93,    94,
+      95,    96,    97,    98,    99,   100,   101
 };
 
 #if YYDEBUG
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,   175,   175,   178,   182,   184,   185,   188,   191,   192,
-     195,   197,   198,   201,   204,   204,   204,   205,   205,   205,
-     206,   206,   206,   206,   207,   207,   207,   207,   208,   212,
-     214,   214,   217,   225,   225,   225,   226,   226,   226,   226,
-     226,   226,   226,   229,   236,   246,   246,   247,   251,   258,
-     261,   268,   271,   278,   281,   290,   292,   300,   309,   309,
-     312,   321,   321,   321,   321,   321,   321,   324,   333,   333,
-     335,   343,   351,   354,   362,   364,   372,   380,   380,   380,
-     380,   382,   390,   398,   398,   398,   398,   398,   398,   401,
-     412,   412,   415,   415,   415,   417,   425,   428,   436,   436,
-     436,   436,   439,   447,   447,   451,   455,   458,   459,   462,
-     465,   466,   467,   472,   473,   475,   477,   481,   484
+       0,   212,   212,   215,   219,   221,   222,   225,   228,   229,
+     232,   234,   235,   238,   241,   241,   241,   242,   242,   242,
+     243,   243,   243,   243,   244,   244,   244,   244,   245,   245,
+     245,   249,   251,   251,   254,   262,   262,   262,   263,   263,
+     263,   263,   263,   263,   263,   264,   267,   274,   284,   284,
+     285,   290,   297,   300,   307,   310,   317,   320,   329,   329,
+     331,   339,   348,   348,   351,   360,   360,   360,   360,   360,
+     360,   363,   372,   372,   374,   382,   390,   393,   401,   403,
+     411,   419,   419,   419,   419,   421,   429,   437,   437,   437,
+     437,   437,   437,   440,   446,   446,   446,   446,   447,   447,
+     447,   447,   450,   457,   457,   457,   457,   457,   457,   460,
+     471,   471,   474,   474,   474,   476,   484,   487,   495,   495,
+     495,   495,   496,   496,   496,   496,   497,   497,   497,   497,
+     498,   498,   499,   499,   500,   500,   500,   503,   511,   511,
+     511,   515,   519,   522,   523,   526,   529,   530,   531,   536,
+     537,   539,   541,   545,   548
 };
 #endif
 
@@ -648,32 +687,36 @@ yysymbol_name (yysymbol_kind_t yysymbol)
   "end of file", "error", "invalid token", "eolsym", "identsym",
   "unsignednumsym", "+", "-", ",", ".text", ".data", ".stack", ".end", ":",
   "[", "]", "=", "NOP", "ADD", "SUB", "CPW", "CPR", "AND", "BOR", "NOR",
-  "XOR", "LWR", "SWR", "SCA", "LWI", "NEG", "LIT", "ARI", "SRI", "MUL",
-  "DIV", "CFHI", "CFLO", "SLL", "SRL", "JMP", "JREL", "ADDI", "ANDI",
-  "BORI", "NORI", "XORI", "BEQ", "BGEZ", "BLEZ", "BGTZ", "BLTZ", "BNE",
-  "CSI", "JMPA", "CALL", "RTN", "EXIT", "PSTR", "PINT", "PCH", "RCH",
-  "STRA", "NOTR", "regsym", "WORD", "CHAR", "STRING", "charliteralsym",
-  "stringliteralsym", "$accept", "program", "textSection", "entryPoint",
-  "addr", "label", "asmInstrs", "asmInstr", "labelOpt", "empty", "instr",
-  "noArgInstr", "noArgOp", "twoRegCompInstr", "twoRegCompOp", "offset",
-  "number", "sign", "twoRegNoOffsetsInstr", "twoRegNoOffsetsOp",
-  "noTargetOffsetInstr", "noTargetOffsetOp", "noSourceOffsetInstr",
-  "noSourceOffsetOp", "oneRegOffsetArgInstr", "oneRegOffsetArgOp", "arg",
-  "oneRegArgInstr", "oneRegArgOp", "oneRegOffsetInstr", "oneRegOffsetOp",
-  "shiftInstr", "shiftOp", "shift", "argOnlyInstr", "argOnlyOp",
-  "immedArithInstr", "immedArithOp", "immed", "immedBoolInstr",
-  "immedBoolOp", "uimmed", "branchTestInstr", "branchTestOp", "jumpInstr",
-  "jumpOp", "syscallInstr", "offsetOnlySyscall", "offsetOnlySyscallOp",
-  "regOffsetSyscall", "regOffsetSyscallOp", "noArgSyscall",
-  "noArgSyscallOp", "dataSection", "staticStartAddr", "staticDecls",
-  "staticDecl", "dataSize", "initializerOpt", "stackSection",
-  "stackBottomAddr", YY_NULLPTR
+  "XOR", "LWR", "SWR", "SCA", "LWI", "NEG", "BCP", "LIT", "ARI", "SRI",
+  "MUL", "DIV", "CFHI", "CFLO", "SLL", "SRL", "JMP", "JREL", "BFL", "ADDI",
+  "ANDI", "BORI", "NORI", "XORI", "BEQ", "BGEZ", "BLEZ", "BGTZ", "BLTZ",
+  "BNE", "RADD", "RSUB", "RMUL", "RDIV", "RAND", "RBOR", "RXOR", "RSLT",
+  "BREQ", "BRNE", "BRLT", "BRLE", "BRGT", "BRGE", "CSI", "JMPA", "CALL",
+  "RTN", "EXIT", "PSTR", "PINT", "PCH", "RCH", "RLN", "RBYT", "PCHS",
+  "PBYT", "SPWN", "JOIN", "CAS", "FADD", "COCR", "YLD", "RSM", "MBEG",
+  "MEND", "ALOC", "FREE", "RSZ", "STRA", "NOTR", "regsym", "WORD", "CHAR",
+  "STRING", "charliteralsym", "stringliteralsym", "$accept", "program",
+  "textSection", "entryPoint", "addr", "label", "asmInstrs", "asmInstr",
+  "labelOpt", "empty", "instr", "noArgInstr", "noArgOp", "twoRegCompInstr",
+  "twoRegCompOp", "offset", "number", "sign", "twoRegNoOffsetsInstr",
+  "twoRegNoOffsetsOp", "noTargetOffsetInstr", "noTargetOffsetOp",
+  "noSourceOffsetInstr", "noSourceOffsetOp", "oneRegOffsetArgInstr",
+  "oneRegOffsetArgOp", "arg", "oneRegArgInstr", "oneRegArgOp",
+  "oneRegOffsetInstr", "oneRegOffsetOp", "shiftInstr", "shiftOp", "shift",
+  "argOnlyInstr", "argOnlyOp", "immedArithInstr", "immedArithOp", "immed",
+  "immedBoolInstr", "immedBoolOp", "uimmed", "branchTestInstr",
+  "branchTestOp", "regCompInstr", "regCompOp", "regBranchInstr",
+  "regBranchOp", "jumpInstr", "jumpOp", "syscallInstr",
+  "offsetOnlySyscall", "offsetOnlySyscallOp", "regOffsetSyscall",
+  "regOffsetSyscallOp", "noArgSyscall", "noArgSyscallOp", "dataSection",
+  "staticStartAddr", "staticDecls", "staticDecl", "dataSize",
+  "initializerOpt", "stackSection", "stackBottomAddr", YY_NULLPTR
   };
   return yy_sname[yysymbol];
 }
 #endif
 
-#define YYPACT_NINF (-140)
+#define YYPACT_NINF (-180)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
@@ -687,77 +730,87 @@ yysymbol_name (yysymbol_kind_t yysymbol)
    STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-      10,     4,     5,    19,  -140,  -140,    26,  -140,  -140,  -140,
-      27,    20,    22,     6,  -140,    71,  -140,  -140,  -140,    29,
-      24,  -140,  -140,  -140,  -140,  -140,  -140,  -140,  -140,  -140,
-    -140,  -140,  -140,  -140,  -140,  -140,  -140,  -140,  -140,  -140,
-    -140,  -140,  -140,  -140,  -140,  -140,  -140,  -140,  -140,  -140,
-    -140,  -140,  -140,  -140,  -140,  -140,  -140,  -140,  -140,  -140,
-    -140,  -140,  -140,  -140,  -140,  -140,  -140,  -140,  -140,  -140,
-      34,  -140,  -140,  -140,   -26,  -140,   -25,  -140,   -24,  -140,
-     -23,  -140,   -22,  -140,   -20,  -140,   -19,  -140,   -18,  -140,
-      21,  -140,   -17,  -140,   -16,  -140,   -15,  -140,     4,  -140,
-    -140,    21,  -140,   -14,  -140,  -140,  -140,   -41,  -140,  -140,
-    -140,  -140,    43,    44,    45,    47,    48,    49,    50,    51,
-    -140,  -140,  -140,  -140,    55,  -140,    53,    54,    59,  -140,
-    -140,  -140,    60,  -140,  -140,    56,  -140,    65,    21,    -1,
-       7,    21,    21,    21,    21,    21,  -140,    21,    21,    21,
-      21,    67,    57,    66,  -140,    68,    70,    72,  -140,  -140,
-      73,    74,    76,    78,  -140,    64,    -4,  -140,   132,    11,
-      21,    75,    21,   131,    21,   133,    21,  -140,  -140,  -140,
-    -140,  -140,   129,  -140,  -140,  -140,  -140,  -140,  -140,  -140,
-    -140,  -140,  -140,    21,  -140
+       6,     1,     3,     8,  -180,  -180,    19,  -180,  -180,  -180,
+      26,    21,    20,    18,  -180,    87,  -180,  -180,  -180,    29,
+      24,  -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,
+    -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,
+    -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,
+    -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,
+    -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,
+    -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,
+    -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,
+    -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,
+    -180,  -180,    34,  -180,  -180,  -180,   -58,  -180,   -57,  -180,
+     -56,  -180,   -54,  -180,   -53,  -180,   -52,  -180,   -51,  -180,
+     -49,  -180,    23,  -180,   -48,  -180,   -47,  -180,   -46,  -180,
+     -45,  -180,   -44,  -180,     1,  -180,  -180,    23,  -180,   -43,
+    -180,  -180,  -180,   -72,  -180,  -180,  -180,  -180,    46,    47,
+      48,    49,    50,    51,    53,    54,  -180,  -180,  -180,  -180,
+      58,  -180,    56,    57,    59,    60,    61,  -180,  -180,  -180,
+      62,  -180,  -180,    52,  -180,    67,    23,   -24,   -22,    23,
+      23,    23,    23,    23,  -180,    23,    23,    23,   -21,   -20,
+      23,    72,    63,    70,  -180,    73,    74,    75,  -180,  -180,
+      76,    77,    78,    80,    81,    82,  -180,    65,     2,  -180,
+      88,    -4,    23,     0,    23,    89,    23,    93,    23,     4,
+      23,  -180,  -180,  -180,  -180,  -180,   175,  -180,  -180,  -180,
+    -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,    23,
+    -180
 };
 
 /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
    Performed when YYTABLE does not specify something else to do.  Zero
    means the default is an error.  */
-static const yytype_int8 yydefact[] =
+static const yytype_uint8 yydefact[] =
 {
        0,     0,     0,     0,     7,     6,    13,     4,     5,     1,
-       0,     0,     0,    13,     8,     0,    12,   106,    13,     0,
-       0,    11,     9,    30,    33,    34,    35,    49,    36,    37,
-      38,    39,    51,    53,    40,    41,    42,    55,    58,    59,
-      61,    62,    63,    64,    68,    69,    65,    72,    74,    77,
-      78,    80,    79,    83,    84,    86,    85,    87,    88,    66,
-      90,    91,    31,    96,    98,    99,   100,   101,   103,   104,
-       0,    14,    29,    15,     0,    16,     0,    17,     0,    18,
-       0,    19,     0,    20,     0,    21,     0,    22,     0,    23,
-      13,    24,     0,    25,     0,    26,     0,    27,     0,    28,
-      92,    13,    93,     0,    94,   102,   107,   105,   118,   117,
-       2,    10,     0,     0,     0,     0,     0,     0,     0,     0,
-      45,    46,    47,    56,     0,    71,     0,     0,     0,    89,
-      95,    43,     0,   110,   111,     0,   108,     0,    13,     0,
-       0,    13,    13,    13,    13,    13,    44,    13,    13,    13,
-      13,     0,    13,     0,    48,     0,     0,     0,    57,    60,
-       0,     0,     0,     0,    97,     0,    13,   116,     0,     0,
-      13,     0,    13,     0,    13,     0,    13,   112,   114,   115,
-     113,   109,     0,    50,    52,    54,    70,    67,    75,    73,
-      81,    76,    82,    13,    32
+       0,     0,     0,    13,     8,     0,    12,   142,    13,     0,
+       0,    11,     9,    32,    35,    36,    37,    52,    38,    39,
+      40,    41,    54,    56,    42,    43,    44,    45,    58,    62,
+      63,    65,    66,    67,    68,    72,    73,    69,    76,    59,
+      78,    81,    82,    84,    83,    87,    88,    90,    89,    91,
+      92,    94,    95,    96,    97,    98,    99,   100,   101,   103,
+     104,   105,   106,   107,   108,    70,   110,   111,    33,   116,
+     118,   119,   120,   121,   122,   123,   124,   125,   126,   127,
+     128,   129,   130,   140,   131,   132,   133,   134,   135,   136,
+     138,   139,     0,    14,    31,    15,     0,    16,     0,    17,
+       0,    18,     0,    19,     0,    20,     0,    21,     0,    22,
+       0,    23,    13,    24,     0,    25,     0,    26,     0,    29,
+       0,    30,     0,    27,     0,    28,   112,    13,   113,     0,
+     114,   137,   143,   141,   154,   153,     2,    10,     0,     0,
+       0,     0,     0,     0,     0,     0,    48,    49,    50,    60,
+       0,    75,     0,     0,     0,     0,     0,   109,   115,    46,
+       0,   146,   147,     0,   144,     0,    13,     0,     0,    13,
+      13,    13,    13,    13,    47,    13,    13,    13,     0,     0,
+      13,     0,    13,     0,    51,     0,     0,     0,    61,    64,
+       0,     0,     0,     0,     0,     0,   117,     0,    13,   152,
+       0,     0,    13,     0,    13,     0,    13,     0,    13,     0,
+      13,   148,   150,   151,   149,   145,     0,    53,    55,    57,
+      74,    71,    79,    77,    85,    80,    86,    93,   102,    13,
+      34
 };
 
 /* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
-    -140,  -140,  -140,  -140,    42,     0,  -140,   128,  -140,    -6,
-    -140,  -140,  -140,  -140,  -140,  -127,   -89,  -140,  -140,  -140,
-    -140,  -140,  -140,  -140,  -140,  -140,  -139,  -140,  -140,  -140,
-    -140,  -140,  -140,  -140,  -140,  -140,  -140,  -140,   -34,  -140,
-    -140,  -140,  -140,  -140,  -140,  -140,  -140,  -140,  -140,  -140,
-    -140,  -140,  -140,  -140,  -140,  -140,  -140,  -140,  -140,  -140,
-    -140
+    -180,  -180,  -180,  -180,   -33,    -2,  -180,   171,  -180,    -6,
+    -180,  -180,  -180,  -180,  -180,  -166,  -121,  -180,  -180,  -180,
+    -180,  -180,  -180,  -180,  -180,  -180,  -179,  -180,  -180,  -180,
+    -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,   -31,  -180,
+    -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,
+    -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,  -180,
+    -180,  -180,  -180,  -180,  -180
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_uint8 yydefgoto[] =
 {
-       0,     2,     3,     6,     7,     8,    13,    14,    15,   122,
-      70,    71,    72,    73,    74,   130,   131,   124,    75,    76,
-      77,    78,    79,    80,    81,    82,   125,    83,    84,    85,
-      86,    87,    88,   187,    89,    90,    91,    92,   189,    93,
-      94,   191,    95,    96,    97,    98,    99,   100,   101,   102,
-     103,   104,   105,    11,    18,   107,   136,   137,   168,    20,
-     109
+       0,     2,     3,     6,     7,     8,    13,    14,    15,   158,
+     102,   103,   104,   105,   106,   168,   169,   160,   107,   108,
+     109,   110,   111,   112,   113,   114,   161,   115,   116,   117,
+     118,   119,   120,   231,   121,   122,   123,   124,   233,   125,
+     126,   235,   127,   128,   129,   130,   131,   132,   133,   134,
+     135,   136,   137,   138,   139,   140,   141,    11,    18,   143,
+     174,   175,   210,    20,   145
 };
 
 /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
@@ -765,83 +818,100 @@ static const yytype_uint8 yydefgoto[] =
    number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_int16 yytable[] =
 {
-      16,   123,   120,   121,   158,     9,    12,    16,     4,     5,
-       4,   153,   106,    12,   156,   157,    -3,   159,   160,     1,
-     161,   162,   163,   164,   133,   134,   135,   120,   121,    10,
-       4,    19,    17,   185,   108,    21,   110,   111,   112,   113,
-     114,   115,   116,   183,   117,   118,   119,   126,   127,   128,
-     132,   138,   139,   140,   123,   141,   142,   143,   144,   145,
-     146,   147,   148,   154,   178,   179,   194,   149,   150,   152,
-     151,   155,   165,   166,   169,   182,   170,   180,   171,   177,
-     172,   173,   174,   123,   175,   188,   176,   188,    23,    24,
-      25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
-      35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
-      45,    46,    47,    48,    49,    50,    51,    52,    53,    54,
-      55,    56,    57,    58,    59,    60,    61,    62,    63,    64,
-      65,    66,    67,    68,    69,   181,   186,   193,   190,   184,
-     129,    22,   192,     0,     0,     0,   167
+      16,   159,   198,     9,    12,     4,     5,    16,   156,   157,
+     193,    12,   142,   196,   197,     1,   199,   200,    10,   201,
+     202,   203,     4,     4,   206,   171,   172,   173,    -3,   156,
+     157,    17,    19,    21,   144,   229,   146,   147,   148,   149,
+     150,   238,   151,   152,   153,   154,   227,   155,   162,   163,
+     164,   165,   166,   170,   176,   177,   178,   179,   180,   181,
+     159,   182,   183,   184,   185,   186,   191,   187,   188,   189,
+     190,   192,   194,   240,   195,   204,   205,   207,   211,   208,
+     221,   212,   213,   214,   215,   216,   217,   224,   218,   219,
+     220,   225,   226,   159,   230,   232,   228,   232,   234,   159,
+     237,   167,   222,   223,    23,    24,    25,    26,    27,    28,
+      29,    30,    31,    32,    33,    34,    35,    36,    37,    38,
+      39,    40,    41,    42,    43,    44,    45,    46,    47,    48,
+      49,    50,    51,    52,    53,    54,    55,    56,    57,    58,
+      59,    60,    61,    62,    63,    64,    65,    66,    67,    68,
+      69,    70,    71,    72,    73,    74,    75,    76,    77,    78,
+      79,    80,    81,    82,    83,    84,    85,    86,    87,    88,
+      89,    90,    91,    92,    93,    94,    95,    96,    97,    98,
+      99,   100,   101,   239,    22,     0,   209,   236
 };
 
 static const yytype_int16 yycheck[] =
 {
-       6,    90,     6,     7,   143,     0,     6,    13,     4,     5,
-       4,   138,    18,    13,   141,   142,    10,   144,   145,     9,
-     147,   148,   149,   150,    65,    66,    67,     6,     7,    10,
-       4,    11,     5,   172,     5,    13,    12,     3,    64,    64,
-      64,    64,    64,   170,    64,    64,    64,    64,    64,    64,
-      64,     8,     8,     8,   143,     8,     8,     8,     8,     8,
-       5,     8,     8,    64,    68,    69,   193,     8,     8,     4,
-      14,    64,     5,    16,     8,    64,     8,   166,     8,    15,
-       8,     8,     8,   172,     8,   174,     8,   176,    17,    18,
-      19,    20,    21,    22,    23,    24,    25,    26,    27,    28,
-      29,    30,    31,    32,    33,    34,    35,    36,    37,    38,
-      39,    40,    41,    42,    43,    44,    45,    46,    47,    48,
-      49,    50,    51,    52,    53,    54,    55,    56,    57,    58,
-      59,    60,    61,    62,    63,     3,     5,     8,     5,    64,
-      98,    13,   176,    -1,    -1,    -1,   152
+       6,   122,   181,     0,     6,     4,     5,    13,     6,     7,
+     176,    13,    18,   179,   180,     9,   182,   183,    10,   185,
+     186,   187,     4,     4,   190,    97,    98,    99,    10,     6,
+       7,     5,    11,    13,     5,   214,    12,     3,    96,    96,
+      96,   220,    96,    96,    96,    96,   212,    96,    96,    96,
+      96,    96,    96,    96,     8,     8,     8,     8,     8,     8,
+     181,     8,     8,     5,     8,     8,    14,     8,     8,     8,
+       8,     4,    96,   239,    96,    96,    96,     5,     8,    16,
+      15,     8,     8,     8,     8,     8,     8,   208,     8,     8,
+       8,     3,    96,   214,     5,   216,    96,   218,     5,   220,
+      96,   134,   100,   101,    17,    18,    19,    20,    21,    22,
+      23,    24,    25,    26,    27,    28,    29,    30,    31,    32,
+      33,    34,    35,    36,    37,    38,    39,    40,    41,    42,
+      43,    44,    45,    46,    47,    48,    49,    50,    51,    52,
+      53,    54,    55,    56,    57,    58,    59,    60,    61,    62,
+      63,    64,    65,    66,    67,    68,    69,    70,    71,    72,
+      73,    74,    75,    76,    77,    78,    79,    80,    81,    82,
+      83,    84,    85,    86,    87,    88,    89,    90,    91,    92,
+      93,    94,    95,     8,    13,    -1,   192,   218
 };
 
 /* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
    state STATE-NUM.  */
 static const yytype_uint8 yystos[] =
 {
-       0,     9,    71,    72,     4,     5,    73,    74,    75,     0,
-      10,   123,    75,    76,    77,    78,    79,     5,   124,    11,
-     129,    13,    77,    17,    18,    19,    20,    21,    22,    23,
+       0,     9,   103,   104,     4,     5,   105,   106,   107,     0,
+      10,   159,   107,   108,   109,   110,   111,     5,   160,    11,
+     165,    13,   109,    17,    18,    19,    20,    21,    22,    23,
       24,    25,    26,    27,    28,    29,    30,    31,    32,    33,
       34,    35,    36,    37,    38,    39,    40,    41,    42,    43,
       44,    45,    46,    47,    48,    49,    50,    51,    52,    53,
       54,    55,    56,    57,    58,    59,    60,    61,    62,    63,
-      80,    81,    82,    83,    84,    88,    89,    90,    91,    92,
-      93,    94,    95,    97,    98,    99,   100,   101,   102,   104,
-     105,   106,   107,   109,   110,   112,   113,   114,   115,   116,
-     117,   118,   119,   120,   121,   122,    79,   125,     5,   130,
-      12,     3,    64,    64,    64,    64,    64,    64,    64,    64,
-       6,     7,    79,    86,    87,    96,    64,    64,    64,    74,
-      85,    86,    64,    65,    66,    67,   126,   127,     8,     8,
-       8,     8,     8,     8,     8,     8,     5,     8,     8,     8,
-       8,    14,     4,    85,    64,    64,    85,    85,    96,    85,
-      85,    85,    85,    85,    85,     5,    16,    79,   128,     8,
-       8,     8,     8,     8,     8,     8,     8,    15,    68,    69,
-      86,     3,    64,    85,    64,    96,     5,   103,    86,   108,
-       5,   111,   108,     8,    85
+      64,    65,    66,    67,    68,    69,    70,    71,    72,    73,
+      74,    75,    76,    77,    78,    79,    80,    81,    82,    83,
+      84,    85,    86,    87,    88,    89,    90,    91,    92,    93,
+      94,    95,   112,   113,   114,   115,   116,   120,   121,   122,
+     123,   124,   125,   126,   127,   129,   130,   131,   132,   133,
+     134,   136,   137,   138,   139,   141,   142,   144,   145,   146,
+     147,   148,   149,   150,   151,   152,   153,   154,   155,   156,
+     157,   158,   111,   161,     5,   166,    12,     3,    96,    96,
+      96,    96,    96,    96,    96,    96,     6,     7,   111,   118,
+     119,   128,    96,    96,    96,    96,    96,   106,   117,   118,
+      96,    97,    98,    99,   162,   163,     8,     8,     8,     8,
+       8,     8,     8,     8,     5,     8,     8,     8,     8,     8,
+       8,    14,     4,   117,    96,    96,   117,   117,   128,   117,
+     117,   117,   117,   117,    96,    96,   117,     5,    16,   111,
+     164,     8,     8,     8,     8,     8,     8,     8,     8,     8,
+       8,    15,   100,   101,   118,     3,    96,   117,    96,   128,
+       5,   135,   118,   140,     5,   143,   140,    96,   128,     8,
+     117
 };
 
 /* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
 static const yytype_uint8 yyr1[] =
 {
-       0,    70,    71,    72,    73,    74,    74,    75,    76,    76,
-      77,    78,    78,    79,    80,    80,    80,    80,    80,    80,
-      80,    80,    80,    80,    80,    80,    80,    80,    80,    81,
-      82,    82,    83,    84,    84,    84,    84,    84,    84,    84,
-      84,    84,    84,    85,    86,    87,    87,    87,    88,    89,
-      90,    91,    92,    93,    94,    95,    96,    97,    98,    98,
-      99,   100,   100,   100,   100,   100,   100,   101,   102,   102,
-     103,   104,   105,   106,   107,   108,   109,   110,   110,   110,
-     110,   111,   112,   113,   113,   113,   113,   113,   113,   114,
-     115,   115,   116,   116,   116,   117,   118,   119,   120,   120,
-     120,   120,   121,   122,   122,   123,   124,   125,   125,   126,
-     127,   127,   127,   128,   128,   128,   128,   129,   130
+       0,   102,   103,   104,   105,   106,   106,   107,   108,   108,
+     109,   110,   110,   111,   112,   112,   112,   112,   112,   112,
+     112,   112,   112,   112,   112,   112,   112,   112,   112,   112,
+     112,   113,   114,   114,   115,   116,   116,   116,   116,   116,
+     116,   116,   116,   116,   116,   116,   117,   118,   119,   119,
+     119,   120,   121,   122,   123,   124,   125,   126,   127,   127,
+     128,   129,   130,   130,   131,   132,   132,   132,   132,   132,
+     132,   133,   134,   134,   135,   136,   137,   138,   139,   140,
+     141,   142,   142,   142,   142,   143,   144,   145,   145,   145,
+     145,   145,   145,   146,   147,   147,   147,   147,   147,   147,
+     147,   147,   148,   149,   149,   149,   149,   149,   149,   150,
+     151,   151,   152,   152,   152,   153,   154,   155,   156,   156,
+     156,   156,   156,   156,   156,   156,   156,   156,   156,   156,
+     156,   156,   156,   156,   156,   156,   156,   157,   158,   158,
+     158,   159,   160,   161,   161,   162,   163,   163,   163,   164,
+     164,   164,   164,   165,   166
 };
 
 /* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
@@ -850,15 +920,19 @@ static const yytype_int8 yyr2[] =
        0,     2,     4,     3,     1,     1,     1,     1,     1,     2,
        3,     2,     1,     0,     1,     1,     1,     1,     1,     1,
        1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     8,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     1,     1,     2,     1,     1,     1,     4,     1,
-       6,     1,     6,     1,     6,     1,     1,     4,     1,     1,
-       4,     1,     1,     1,     1,     1,     1,     6,     1,     1,
-       1,     2,     1,     6,     1,     1,     6,     1,     1,     1,
+       1,     1,     1,     1,     8,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     2,     1,     1,
+       1,     4,     1,     6,     1,     6,     1,     6,     1,     1,
+       1,     4,     1,     1,     4,     1,     1,     1,     1,     1,
+       1,     6,     1,     1,     1,     2,     1,     6,     1,     1,
+       6,     1,     1,     1,     1,     1,     6,     1,     1,     1,
+       1,     1,     1,     6,     1,     1,     1,     1,     1,     1,
        1,     1,     6,     1,     1,     1,     1,     1,     1,     2,
        1,     1,     1,     1,     1,     2,     1,     4,     1,     1,
-       1,     1,     1,     1,     1,     3,     1,     1,     2,     4,
-       1,     1,     4,     2,     2,     2,     1,     2,     1
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     3,     1,     1,     2,     4,     1,     1,     4,     2,
+       2,     2,     1,     2,     1
 };
 
 
@@ -888,7 +962,7 @@ enum { YYENOMEM = -2 };
       }                                                           \
     else                                                          \
       {                                                           \
-        yyerror (file_name, YY_("syntax error: cannot back up")); \
+        yyerror (&yylloc, file_name, scanner, progast, YY_("syntax error: cannot back up")); \
         YYERROR;                                                  \
       }                                                           \
   while (0)
@@ -1004,7 +1078,7 @@ do {                                                                      \
     {                                                                     \
       YYFPRINTF (stderr, "%s ", Title);                                   \
       yy_symbol_print (stderr,                                            \
-                  Kind, Value, Location, file_name); \
+                  Kind, Value, Location, file_name, scanner, progast); \
       YYFPRINTF (stderr, "\n");                                           \
     }                                                                     \
 } while (0)
@@ -1016,12 +1090,14 @@ do {                                                                      \
 
 static void
 yy_symbol_value_print (FILE *yyo,
-                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, char const *file_name)
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, char const *file_name, yyscan_t scanner, ast_program_t *progast)
 {
   FILE *yyoutput = yyo;
   YY_USE (yyoutput);
   YY_USE (yylocationp);
   YY_USE (file_name);
+  YY_USE (scanner);
+  YY_USE (progast);
   if (!yyvaluep)
     return;
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
@@ -1036,14 +1112,14 @@ yy_symbol_value_print (FILE *yyo,
 
 static void
 yy_symbol_print (FILE *yyo,
-                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, char const *file_name)
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, char const *file_name, yyscan_t scanner, ast_program_t *progast)
 {
   YYFPRINTF (yyo, "%s %s (",
              yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
   YYLOCATION_PRINT (yyo, yylocationp);
   YYFPRINTF (yyo, ": ");
-  yy_symbol_value_print (yyo, yykind, yyvaluep, yylocationp, file_name);
+  yy_symbol_value_print (yyo, yykind, yyvaluep, yylocationp, file_name, scanner, progast);
   YYFPRINTF (yyo, ")");
 }
 
@@ -1077,7 +1153,7 @@ do {                                                            \
 
 static void
 yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp,
-                 int yyrule, char const *file_name)
+                 int yyrule, char const *file_name, yyscan_t scanner, ast_program_t *progast)
 {
   int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
@@ -1091,7 +1167,7 @@ yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp,
       yy_symbol_print (stderr,
                        YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
                        &yyvsp[(yyi + 1) - (yynrhs)],
-                       &(yylsp[(yyi + 1) - (yynrhs)]), file_name);
+                       &(yylsp[(yyi + 1) - (yynrhs)]), file_name, scanner, progast);
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -1099,7 +1175,7 @@ yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp,
 # define YY_REDUCE_PRINT(Rule)          \
 do {                                    \
   if (yydebug)                          \
-    yy_reduce_print (yyssp, yyvsp, yylsp, Rule, file_name); \
+    yy_reduce_print (yyssp, yyvsp, yylsp, Rule, file_name, scanner, progast); \
 } while (0)
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
@@ -1605,11 +1681,13 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
 
 static void
 yydestruct (const char *yymsg,
-            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, char const *file_name)
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, char const *file_name, yyscan_t scanner, ast_program_t *progast)
 {
   YY_USE (yyvaluep);
   YY_USE (yylocationp);
   YY_USE (file_name);
+  YY_USE (scanner);
+  YY_USE (progast);
   if (!yymsg)
     yymsg = "Deleting";
   YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
@@ -1620,30 +1698,38 @@ yydestruct (const char *yymsg,
 }
 
 
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (char const *file_name, yyscan_t scanner, ast_program_t *progast)
+{
 /* Lookahead token kind.  */
 int yychar;
 
+
 /* The semantic value of the lookahead symbol.  */
-YYSTYPE yylval;
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
+
 /* Location data for the lookahead symbol.  */
-YYLTYPE yylloc
+static YYLTYPE yyloc_default
 # if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
   = { 1, 1, 1, 1 }
 # endif
 ;
-/* Number of syntax errors so far.  */
-int yynerrs;
-
-
+YYLTYPE yylloc = yyloc_default;
 
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
 
-/*----------.
-| yyparse.  |
-`----------*/
-
-int
-yyparse (char const *file_name)
-{
     yy_state_fast_t yystate = 0;
     /* Number of tokens to shift before error messages enabled.  */
     int yyerrstatus = 0;
@@ -1820,7 +1906,7 @@ yybackup:
   if (yychar == YYEMPTY)
     {
       YYDPRINTF ((stderr, "Reading a token\n"));
-      yychar = yylex ();
+      yychar = yylex (&yylval, &yylloc, scanner);
     }
 
   if (yychar <= YYEOF)
@@ -1919,92 +2005,92 @@ yyreduce:
     switch (yyn)
       {
   case 2: /* program: textSection dataSection stackSection ".end"  */
-#line 176 "asm.y"
-           { setProgAST(ast_program((yyvsp[-3].text_section), (yyvsp[-2].data_section), (yyvsp[-1].stack_section))); }
-#line 1925 "asm.tab.c"
+#line 213 "asm.y"
+           { *progast = ast_program((yyvsp[-3].text_section), (yyvsp[-2].data_section), (yyvsp[-1].stack_section)); }
+#line 2011 "asm.tab.c"
     break;
 
   case 3: /* textSection: ".text" entryPoint asmInstrs  */
-#line 179 "asm.y"
+#line 216 "asm.y"
            { (yyval.text_section) = ast_text_section((yyvsp[-2].token),(yyvsp[-1].addr),(yyvsp[0].asm_instrs)); }
-#line 1931 "asm.tab.c"
+#line 2017 "asm.tab.c"
     break;
 
   case 5: /* addr: label  */
-#line 184 "asm.y"
+#line 221 "asm.y"
              { (yyval.addr) = ast_addr_label((yyvsp[0].ident)); }
-#line 1937 "asm.tab.c"
+#line 2023 "asm.tab.c"
     break;
 
   case 6: /* addr: unsignednumsym  */
-#line 185 "asm.y"
+#line 222 "asm.y"
                        { (yyval.addr) = ast_entry_addr((yyvsp[0].unsignednum)); }
-#line 1943 "asm.tab.c"
+#line 2029 "asm.tab.c"
     break;
 
   case 8: /* asmInstrs: asmInstr  */
-#line 191 "asm.y"
+#line 228 "asm.y"
                      { (yyval.asm_instrs) = ast_asm_instrs_singleton((yyvsp[0].asm_instr)); }
-#line 1949 "asm.tab.c"
+#line 2035 "asm.tab.c"
     break;
 
   case 9: /* asmInstrs: asmInstrs asmInstr  */
-#line 192 "asm.y"
+#line 229 "asm.y"
                            { (yyval.asm_instrs) = ast_asm_instrs_add((yyvsp[-1].asm_instrs),(yyvsp[0].asm_instr)); }
-#line 1955 "asm.tab.c"
+#line 2041 "asm.tab.c"
     break;
 
   case 10: /* asmInstr: labelOpt instr eolsym  */
-#line 195 "asm.y"
+#line 232 "asm.y"
                                  { (yyval.asm_instr) = ast_asm_instr((yyvsp[-2].label_opt),(yyvsp[-1].instr)); }
-#line 1961 "asm.tab.c"
+#line 2047 "asm.tab.c"
     break;
 
   case 11: /* labelOpt: label ":"  */
-#line 197 "asm.y"
+#line 234 "asm.y"
                      { (yyval.label_opt) = ast_label_opt_label((yyvsp[-1].ident)); }
-#line 1967 "asm.tab.c"
+#line 2053 "asm.tab.c"
     break;
 
   case 12: /* labelOpt: empty  */
-#line 198 "asm.y"
+#line 235 "asm.y"
               { (yyval.label_opt) = ast_label_opt_empty((yyvsp[0].empty)); }
-#line 1973 "asm.tab.c"
+#line 2059 "asm.tab.c"
     break;
 
   case 13: /* empty: %empty  */
-#line 201 "asm.y"
-               { (yyval.empty) = ast_empty(lexer_filename(), lexer_line()); }
-#line 1979 "asm.tab.c"
+#line 238 "asm.y"
+               { (yyval.empty) = ast_empty(lexer_filename(scanner), lexer_line(scanner)); }
+#line 2065 "asm.tab.c"
     break;
 
-  case 29: /* noArgInstr: noArgOp  */
-#line 212 "asm.y"
+  case 31: /* noArgInstr: noArgOp  */
+#line 249 "asm.y"
                      { (yyval.instr) = ast_0arg_instr((yyvsp[0].token)); }
-#line 1985 "asm.tab.c"
+#line 2071 "asm.tab.c"
     break;
 
-  case 32: /* twoRegCompInstr: twoRegCompOp regsym "," offset "," regsym "," offset  */
-#line 218 "asm.y"
+  case 34: /* twoRegCompInstr: twoRegCompOp regsym "," offset "," regsym "," offset  */
+#line 255 "asm.y"
            {
 	       (yyval.instr) = ast_2reg_instr((yyvsp[-7].token), (yyvsp[-6].reg).number, (yyvsp[-4].number).value,
 				   (yyvsp[-2].reg).number, (yyvsp[0].number).value,
 				   lexer_token2func((yyvsp[-7].token).toknum));
 	   }
-#line 1995 "asm.tab.c"
+#line 2081 "asm.tab.c"
     break;
 
-  case 43: /* offset: number  */
-#line 230 "asm.y"
+  case 46: /* offset: number  */
+#line 268 "asm.y"
            {
 	       machine_types_check_fits_in_offset((yyvsp[0].number).value);
 	       (yyval.number) = (yyvsp[0].number);
 	   }
-#line 2004 "asm.tab.c"
+#line 2090 "asm.tab.c"
     break;
 
-  case 44: /* number: sign unsignednumsym  */
-#line 237 "asm.y"
+  case 47: /* number: sign unsignednumsym  */
+#line 275 "asm.y"
            {
 	       word_type val = (yyvsp[0].unsignednum).value;
                if ((yyvsp[-1].token).toknum == minussym) {
@@ -2012,164 +2098,182 @@ yyreduce:
                }
                (yyval.number) = ast_number((yyvsp[-1].token), val);
 	   }
-#line 2016 "asm.tab.c"
+#line 2102 "asm.tab.c"
     break;
 
-  case 47: /* sign: empty  */
-#line 247 "asm.y"
-             { (yyval.token) = ast_token(lexer_filename(), lexer_line(), plussym); }
-#line 2022 "asm.tab.c"
+  case 50: /* sign: empty  */
+#line 285 "asm.y"
+             { (yyval.token) = ast_token(lexer_filename(scanner), lexer_line(scanner),
+			       plussym); }
+#line 2109 "asm.tab.c"
     break;
 
-  case 48: /* twoRegNoOffsetsInstr: twoRegNoOffsetsOp regsym "," regsym  */
-#line 252 "asm.y"
+  case 51: /* twoRegNoOffsetsInstr: twoRegNoOffsetsOp regsym "," regsym  */
+#line 291 "asm.y"
            {
 	       (yyval.instr) = ast_2reg_instr((yyvsp[-3].token), (yyvsp[-2].reg).number, 0, (yyvsp[0].reg).number, 0,
 				   lexer_token2func((yyvsp[-3].token).toknum));
 	   }
-#line 2031 "asm.tab.c"
+#line 2118 "asm.tab.c"
     break;
 
-  case 50: /* noTargetOffsetInstr: noTargetOffsetOp regsym "," regsym "," offset  */
-#line 262 "asm.y"
+  case 53: /* noTargetOffsetInstr: noTargetOffsetOp regsym "," regsym "," offset  */
+#line 301 "asm.y"
            {
 	       (yyval.instr) = ast_2reg_instr((yyvsp[-5].token), (yyvsp[-4].reg).number, 0, (yyvsp[-2].reg).number, (yyvsp[0].number).value,
 				   lexer_token2func((yyvsp[-5].token).toknum));
 	   }
-#line 2040 "asm.tab.c"
+#line 2127 "asm.tab.c"
     break;
 
-  case 52: /* noSourceOffsetInstr: noSourceOffsetOp regsym "," offset "," regsym  */
-#line 272 "asm.y"
+  case 55: /* noSourceOffsetInstr: noSourceOffsetOp regsym "," offset "," regsym  */
+#line 311 "asm.y"
            {
 	       (yyval.instr) = ast_2reg_instr((yyvsp[-5].token), (yyvsp[-4].reg).number, (yyvsp[-2].number).value, (yyvsp[0].reg).number, 0,
 				   lexer_token2func((yyvsp[-5].token).toknum));
 	   }
-#line 2049 "asm.tab.c"
+#line 2136 "asm.tab.c"
     break;
 
-  case 54: /* oneRegOffsetArgInstr: oneRegOffsetArgOp regsym "," offset "," arg  */
-#line 282 "asm.y"
+  case 57: /* oneRegOffsetArgInstr: oneRegOffsetArgOp regsym "," offset "," arg  */
+#line 321 "asm.y"
            {
 	       (yyval.instr) = ast_1reg_instr((yyvsp[-5].token), other_comp_instr_type,
 				   1, (yyvsp[-4].reg).number, (yyvsp[-2].number).value,
 				   lexer_token2func((yyvsp[-5].token).toknum),
 				   ast_immed_number((yyvsp[0].number).value));
 	   }
-#line 2060 "asm.tab.c"
+#line 2147 "asm.tab.c"
     break;
 
-  case 56: /* arg: number  */
-#line 293 "asm.y"
+  case 60: /* arg: number  */
+#line 332 "asm.y"
            {   /* the number is signed */
 	       machine_types_check_fits_in_arg((yyvsp[0].number).value);
 	       (yyval.number) = (yyvsp[0].number);
 	   }
-#line 2069 "asm.tab.c"
+#line 2156 "asm.tab.c"
     break;
 
-  case 57: /* oneRegArgInstr: oneRegArgOp regsym "," arg  */
-#line 301 "asm.y"
+  case 61: /* oneRegArgInstr: oneRegArgOp regsym "," arg  */
+#line 340 "asm.y"
            {
 	       (yyval.instr) = ast_1reg_instr((yyvsp[-3].token), other_comp_instr_type,
 				   1, (yyvsp[-2].reg).number, 0,
 				   lexer_token2func((yyvsp[-3].token).toknum),
 				   ast_immed_number((yyvsp[0].number).value));
 	   }
-#line 2080 "asm.tab.c"
+#line 2167 "asm.tab.c"
     break;
 
-  case 60: /* oneRegOffsetInstr: oneRegOffsetOp regsym "," offset  */
-#line 313 "asm.y"
+  case 64: /* oneRegOffsetInstr: oneRegOffsetOp regsym "," offset  */
+#line 352 "asm.y"
            {
 	       (yyval.instr) = ast_1reg_instr((yyvsp[-3].token), other_comp_instr_type,
 				   1, (yyvsp[-2].reg).number, (yyvsp[0].number).value,
 				   lexer_token2func((yyvsp[-3].token).toknum),
 				   ast_immed_none());
 	   }
-#line 2091 "asm.tab.c"
+#line 2178 "asm.tab.c"
     break;
 
-  case 67: /* shiftInstr: shiftOp regsym "," offset "," shift  */
-#line 325 "asm.y"
+  case 71: /* shiftInstr: shiftOp regsym "," offset "," shift  */
+#line 364 "asm.y"
            {
 	       (yyval.instr) = ast_1reg_instr((yyvsp[-5].token), other_comp_instr_type,
 				   1, (yyvsp[-4].reg).number, (yyvsp[-2].number).value,
 				   lexer_token2func((yyvsp[-5].token).toknum),
 				   (yyvsp[0].immed));
 	   }
-#line 2102 "asm.tab.c"
+#line 2189 "asm.tab.c"
     break;
 
-  case 70: /* shift: unsignednumsym  */
-#line 336 "asm.y"
+  case 74: /* shift: unsignednumsym  */
+#line 375 "asm.y"
            {
 	       machine_types_check_fits_in_shift((yyvsp[0].unsignednum).value);
 	       (yyval.immed) = ast_immed_unsigned((yyvsp[0].unsignednum).value);
 	   }
-#line 2111 "asm.tab.c"
+#line 2198 "asm.tab.c"
     break;
 
-  case 71: /* argOnlyInstr: argOnlyOp arg  */
-#line 344 "asm.y"
+  case 75: /* argOnlyInstr: argOnlyOp arg  */
+#line 383 "asm.y"
            {
 	       (yyval.instr) = ast_1reg_instr((yyvsp[-1].token), other_comp_instr_type,
 				   0, 0, 0, lexer_token2func((yyvsp[-1].token).toknum),
 				   ast_immed_number((yyvsp[0].number).value));
 	   }
-#line 2121 "asm.tab.c"
+#line 2208 "asm.tab.c"
     break;
 
-  case 73: /* immedArithInstr: immedArithOp regsym "," offset "," immed  */
-#line 355 "asm.y"
+  case 77: /* immedArithInstr: immedArithOp regsym "," offset "," immed  */
+#line 394 "asm.y"
            {
 	       (yyval.instr) = ast_1reg_instr((yyvsp[-5].token), immed_instr_type,
 				   1, (yyvsp[-4].reg).number, (yyvsp[-2].number).value,
 				   0, (yyvsp[0].immed));
 	   }
-#line 2131 "asm.tab.c"
+#line 2218 "asm.tab.c"
     break;
 
-  case 75: /* immed: number  */
-#line 365 "asm.y"
+  case 79: /* immed: number  */
+#line 404 "asm.y"
        {
 	   machine_types_check_fits_in_immed((yyvsp[0].number).value);
            (yyval.immed) = ast_immed_number((yyvsp[0].number).value);
        }
-#line 2140 "asm.tab.c"
+#line 2227 "asm.tab.c"
     break;
 
-  case 76: /* immedBoolInstr: immedBoolOp regsym "," offset "," uimmed  */
-#line 373 "asm.y"
+  case 80: /* immedBoolInstr: immedBoolOp regsym "," offset "," uimmed  */
+#line 412 "asm.y"
        {
 	   (yyval.instr) = ast_1reg_instr((yyvsp[-5].token), immed_instr_type,
 			       1, (yyvsp[-4].reg).number, (yyvsp[-2].number).value,
 			       0, (yyvsp[0].immed));
        }
-#line 2150 "asm.tab.c"
+#line 2237 "asm.tab.c"
     break;
 
-  case 81: /* uimmed: unsignednumsym  */
-#line 383 "asm.y"
+  case 85: /* uimmed: unsignednumsym  */
+#line 422 "asm.y"
        {
 	   machine_types_check_fits_in_uimmed((yyvsp[0].unsignednum).value);
            (yyval.immed) = ast_immed_unsigned((yyvsp[0].unsignednum).value);
        }
-#line 2159 "asm.tab.c"
+#line 2246 "asm.tab.c"
     break;
 
-  case 82: /* branchTestInstr: branchTestOp regsym "," offset "," immed  */
-#line 391 "asm.y"
+  case 86: /* branchTestInstr: branchTestOp regsym "," offset "," immed  */
+#line 430 "asm.y"
        {
 	   (yyval.instr) = ast_1reg_instr((yyvsp[-5].token), immed_instr_type,
 			       1, (yyvsp[-4].reg).number, (yyvsp[-2].number).value,
 			       0, (yyvsp[0].immed));
        }
-#line 2169 "asm.tab.c"
+#line 2256 "asm.tab.c"
     break;
 
-  case 89: /* jumpInstr: jumpOp addr  */
-#line 402 "asm.y"
+  case 93: /* regCompInstr: regCompOp regsym "," regsym "," regsym  */
+#line 441 "asm.y"
+       {
+	   (yyval.instr) = ast_3reg_instr((yyvsp[-5].token), (yyvsp[-4].reg).number, (yyvsp[-2].reg).number, (yyvsp[0].reg).number);
+       }
+#line 2264 "asm.tab.c"
+    break;
+
+  case 102: /* regBranchInstr: regBranchOp regsym "," regsym "," arg  */
+#line 451 "asm.y"
+       {
+	   (yyval.instr) = ast_reg_branch_instr((yyvsp[-5].token), (yyvsp[-4].reg).number, (yyvsp[-2].reg).number,
+				     ast_immed_number((yyvsp[0].number).value));
+       }
+#line 2273 "asm.tab.c"
+    break;
+
+  case 109: /* jumpInstr: jumpOp addr  */
+#line 461 "asm.y"
             {
 		if ((yyvsp[0].addr).address_defined) {
 		    machine_types_check_fits_in_addr((yyvsp[0].addr).addr);
@@ -2178,115 +2282,115 @@ yyreduce:
 				    0, 0, 0,
 				    0, ast_immed_addr((yyvsp[0].addr)));
 	    }
-#line 2182 "asm.tab.c"
+#line 2286 "asm.tab.c"
     break;
 
-  case 95: /* offsetOnlySyscall: offsetOnlySyscallOp offset  */
-#line 418 "asm.y"
+  case 115: /* offsetOnlySyscall: offsetOnlySyscallOp offset  */
+#line 477 "asm.y"
             {
 		(yyval.instr) = ast_1reg_instr((yyvsp[-1].token), syscall_instr_type,
 				    1, 0, (yyvsp[0].number).value, 
 				    SYS_F, ast_syscall_code_for((yyvsp[-1].token).toknum));
 	    }
-#line 2192 "asm.tab.c"
+#line 2296 "asm.tab.c"
     break;
 
-  case 97: /* regOffsetSyscall: regOffsetSyscallOp regsym "," offset  */
-#line 429 "asm.y"
+  case 117: /* regOffsetSyscall: regOffsetSyscallOp regsym "," offset  */
+#line 488 "asm.y"
             {
 		(yyval.instr) = ast_1reg_instr((yyvsp[-3].token), syscall_instr_type,
 				    1, (yyvsp[-2].reg).number, (yyvsp[0].number).value, 
 				    SYS_F, ast_syscall_code_for((yyvsp[-3].token).toknum));
 	    }
-#line 2202 "asm.tab.c"
+#line 2306 "asm.tab.c"
     break;
 
-  case 102: /* noArgSyscall: noArgSyscallOp  */
-#line 440 "asm.y"
+  case 137: /* noArgSyscall: noArgSyscallOp  */
+#line 504 "asm.y"
             {
 		(yyval.instr) = ast_1reg_instr((yyvsp[0].token), syscall_instr_type,
 				    0, 0, 0,
 				    SYS_F, ast_syscall_code_for((yyvsp[0].token).toknum));
 	    }
-#line 2212 "asm.tab.c"
+#line 2316 "asm.tab.c"
     break;
 
-  case 105: /* dataSection: ".data" staticStartAddr staticDecls  */
-#line 452 "asm.y"
+  case 141: /* dataSection: ".data" staticStartAddr staticDecls  */
+#line 516 "asm.y"
               { (yyval.data_section) = ast_data_section((yyvsp[-2].token), (yyvsp[-1].unsignednum).value, (yyvsp[0].static_decls)); }
-#line 2218 "asm.tab.c"
+#line 2322 "asm.tab.c"
     break;
 
-  case 107: /* staticDecls: empty  */
-#line 458 "asm.y"
+  case 143: /* staticDecls: empty  */
+#line 522 "asm.y"
                     { (yyval.static_decls) = ast_static_decls_empty((yyvsp[0].empty)); }
-#line 2224 "asm.tab.c"
+#line 2328 "asm.tab.c"
     break;
 
-  case 108: /* staticDecls: staticDecls staticDecl  */
-#line 459 "asm.y"
+  case 144: /* staticDecls: staticDecls staticDecl  */
+#line 523 "asm.y"
                                      { (yyval.static_decls) = ast_static_decls_add((yyvsp[-1].static_decls),(yyvsp[0].static_decl)); }
-#line 2230 "asm.tab.c"
+#line 2334 "asm.tab.c"
     break;
 
-  case 109: /* staticDecl: dataSize identsym initializerOpt eolsym  */
-#line 463 "asm.y"
+  case 145: /* staticDecl: dataSize identsym initializerOpt eolsym  */
+#line 527 "asm.y"
             { (yyval.static_decl) = ast_static_decl((yyvsp[-3].data_size), (yyvsp[-2].ident), (yyvsp[-1].initializer)); }
-#line 2236 "asm.tab.c"
+#line 2340 "asm.tab.c"
     break;
 
-  case 110: /* dataSize: "WORD"  */
-#line 465 "asm.y"
+  case 146: /* dataSize: "WORD"  */
+#line 529 "asm.y"
                   { (yyval.data_size) = ast_data_size((yyvsp[0].token), ds_word, 1); }
-#line 2242 "asm.tab.c"
+#line 2346 "asm.tab.c"
     break;
 
-  case 111: /* dataSize: "CHAR"  */
-#line 466 "asm.y"
+  case 147: /* dataSize: "CHAR"  */
+#line 530 "asm.y"
                   { (yyval.data_size) = ast_data_size((yyvsp[0].token), ds_char, 1); }
-#line 2248 "asm.tab.c"
+#line 2352 "asm.tab.c"
     break;
 
-  case 112: /* dataSize: "STRING" "[" unsignednumsym "]"  */
-#line 468 "asm.y"
+  case 148: /* dataSize: "STRING" "[" unsignednumsym "]"  */
+#line 532 "asm.y"
                   { (yyval.data_size) = ast_data_size((yyvsp[-3].token), ds_string,
 				       /* declared size is in words! */
 				       (yyvsp[-1].unsignednum).value); }
-#line 2256 "asm.tab.c"
+#line 2360 "asm.tab.c"
     break;
 
-  case 113: /* initializerOpt: "=" number  */
-#line 472 "asm.y"
+  case 149: /* initializerOpt: "=" number  */
+#line 536 "asm.y"
                             { (yyval.initializer) = ast_initializer_number((yyvsp[-1].token), (yyvsp[0].number).value); }
-#line 2262 "asm.tab.c"
+#line 2366 "asm.tab.c"
     break;
 
-  case 114: /* initializerOpt: "=" charliteralsym  */
-#line 474 "asm.y"
+  case 150: /* initializerOpt: "=" charliteralsym  */
+#line 538 "asm.y"
                   { (yyval.initializer) = ast_initializer_char((yyvsp[-1].token), (yyvsp[0].charlit).value); }
-#line 2268 "asm.tab.c"
+#line 2372 "asm.tab.c"
     break;
 
-  case 115: /* initializerOpt: "=" stringliteralsym  */
-#line 476 "asm.y"
+  case 151: /* initializerOpt: "=" stringliteralsym  */
+#line 540 "asm.y"
                   { (yyval.initializer) = ast_initializer_string((yyvsp[-1].token), (yyvsp[0].stringlit).pointer); }
-#line 2274 "asm.tab.c"
+#line 2378 "asm.tab.c"
     break;
 
-  case 116: /* initializerOpt: empty  */
-#line 477 "asm.y"
+  case 152: /* initializerOpt: empty  */
+#line 541 "asm.y"
                        { (yyval.initializer) = ast_initializer_empty((yyvsp[0].empty)); }
-#line 2280 "asm.tab.c"
+#line 2384 "asm.tab.c"
     break;
 
-  case 117: /* stackSection: ".stack" stackBottomAddr  */
-#line 482 "asm.y"
+  case 153: /* stackSection: ".stack" stackBottomAddr  */
+#line 546 "asm.y"
               { (yyval.stack_section) = ast_stack_section((yyvsp[-1].token), (yyvsp[0].unsignednum).value); }
-#line 2286 "asm.tab.c"
+#line 2390 "asm.tab.c"
     break;
 
 
-#line 2290 "asm.tab.c"
+#line 2394 "asm.tab.c"
 
         default: break;
       }
@@ -2366,7 +2470,7 @@ yyerrlab:
                 yysyntax_error_status = YYENOMEM;
               }
           }
-        yyerror (file_name, yymsgp);
+        yyerror (&yylloc, file_name, scanner, progast, yymsgp);
         if (yysyntax_error_status == YYENOMEM)
           YYNOMEM;
       }
@@ -2387,7 +2491,7 @@ yyerrlab:
       else
         {
           yydestruct ("Error: discarding",
-                      yytoken, &yylval, &yylloc, file_name);
+                      yytoken, &yylval, &yylloc, file_name, scanner, progast);
           yychar = YYEMPTY;
         }
     }
@@ -2443,7 +2547,7 @@ yyerrlab1:
 
       yyerror_range[1] = *yylsp;
       yydestruct ("Error: popping",
-                  YY_ACCESSING_SYMBOL (yystate), yyvsp, yylsp, file_name);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, yylsp, file_name, scanner, progast);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -2488,7 +2592,7 @@ yyabortlab:
 | yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
 `-----------------------------------------------------------*/
 yyexhaustedlab:
-  yyerror (file_name, YY_("memory exhausted"));
+  yyerror (&yylloc, file_name, scanner, progast, YY_("memory exhausted"));
   yyresult = 2;
   goto yyreturnlab;
 
@@ -2503,7 +2607,7 @@ yyreturnlab:
          user semantic actions for why this is necessary.  */
       yytoken = YYTRANSLATE (yychar);
       yydestruct ("Cleanup: discarding lookahead",
-                  yytoken, &yylval, &yylloc, file_name);
+                  yytoken, &yylval, &yylloc, file_name, scanner, progast);
     }
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYABORT or YYACCEPT.  */
@@ -2512,7 +2616,7 @@ yyreturnlab:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, yylsp, file_name);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, yylsp, file_name, scanner, progast);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
@@ -2526,8 +2630,12 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 486 "asm.y"
+#line 550 "asm.y"
 
 
-// Set the program's ast to be t
-void setProgAST(ast_program_t t) { progast = t; }
+// Report an error to the user on stderr (see lexer_error)
+static void yyerror(YYLTYPE *llocp, char const *file_name, yyscan_t scanner,
+		    ast_program_t *progast, const char *msg)
+{
+    lexer_error(scanner, msg);
+}
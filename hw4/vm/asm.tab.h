@@ -52,13 +52,15 @@ extern int yydebug;
 #include "ast.h"
 #include "machine_types.h"
 #include "parser_types.h"
-#include "lexer.h"
 // #include "utilities.h" // only needed for debugging
 
-    /* Report an error to the user on stderr */
-extern void yyerror(const char *filename, const char *msg);
+ /* The scanner that the parser reads from (see lexer.h) */
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void *yyscan_t;
+#endif
 
-#line 62 "asm.tab.h"
+#line 64 "asm.tab.h"
 
 /* Token kinds.  */
 #ifndef YYTOKENTYPE
@@ -97,45 +99,77 @@ extern void yyerror(const char *filename, const char *msg);
     scaopsym = 283,                /* "SCA"  */
     lwiopsym = 284,                /* "LWI"  */
     negopsym = 285,                /* "NEG"  */
-    litopsym = 286,                /* "LIT"  */
-    ariopsym = 287,                /* "ARI"  */
-    sriopsym = 288,                /* "SRI"  */
-    mulopsym = 289,                /* "MUL"  */
-    divopsym = 290,                /* "DIV"  */
-    cfhiopsym = 291,               /* "CFHI"  */
-    cfloopsym = 292,               /* "CFLO"  */
-    sllopsym = 293,                /* "SLL"  */
-    srlopsym = 294,                /* "SRL"  */
-    jmpopsym = 295,                /* "JMP"  */
-    jrelopsym = 296,               /* "JREL"  */
-    addiopsym = 297,               /* "ADDI"  */
-    andiopsym = 298,               /* "ANDI"  */
-    boriopsym = 299,               /* "BORI"  */
-    noriopsym = 300,               /* "NORI"  */
-    xoriopsym = 301,               /* "XORI"  */
-    beqopsym = 302,                /* "BEQ"  */
-    bgezopsym = 303,               /* "BGEZ"  */
-    blezopsym = 304,               /* "BLEZ"  */
-    bgtzopsym = 305,               /* "BGTZ"  */
-    bltzopsym = 306,               /* "BLTZ"  */
-    bneopsym = 307,                /* "BNE"  */
-    csiopsym = 308,                /* "CSI"  */
-    jmpaopsym = 309,               /* "JMPA"  */
-    callopsym = 310,               /* "CALL"  */
-    rtnopsym = 311,                /* "RTN"  */
-    exitopsym = 312,               /* "EXIT"  */
-    pstropsym = 313,               /* "PSTR"  */
-    pintopsym = 314,               /* "PINT"  */
-    pchopsym = 315,                /* "PCH"  */
-    rchopsym = 316,                /* "RCH"  */
-    straopsym = 317,               /* "STRA"  */
-    notropsym = 318,               /* "NOTR"  */
-    regsym = 319,                  /* regsym  */
-    wordsym = 320,                 /* "WORD"  */
-    charsym = 321,                 /* "CHAR"  */
-    stringsym = 322,               /* "STRING"  */
-    charliteralsym = 323,          /* charliteralsym  */
-    stringliteralsym = 324         /* stringliteralsym  */
+    bcpopsym = 286,                /* "BCP"  */
+    litopsym = 287,                /* "LIT"  */
+    ariopsym = 288,                /* "ARI"  */
+    sriopsym = 289,                /* "SRI"  */
+    mulopsym = 290,                /* "MUL"  */
+    divopsym = 291,                /* "DIV"  */
+    cfhiopsym = 292,               /* "CFHI"  */
+    cfloopsym = 293,               /* "CFLO"  */
+    sllopsym = 294,                /* "SLL"  */
+    srlopsym = 295,                /* "SRL"  */
+    jmpopsym = 296,                /* "JMP"  */
+    jrelopsym = 297,               /* "JREL"  */
+    bflopsym = 298,                /* "BFL"  */
+    addiopsym = 299,               /* "ADDI"  */
+    andiopsym = 300,               /* "ANDI"  */
+    boriopsym = 301,               /* "BORI"  */
+    noriopsym = 302,               /* "NORI"  */
+    xoriopsym = 303,               /* "XORI"  */
+    beqopsym = 304,                /* "BEQ"  */
+    bgezopsym = 305,               /* "BGEZ"  */
+    blezopsym = 306,               /* "BLEZ"  */
+    bgtzopsym = 307,               /* "BGTZ"  */
+    bltzopsym = 308,               /* "BLTZ"  */
+    bneopsym = 309,                /* "BNE"  */
+    raddopsym = 310,               /* "RADD"  */
+    rsubopsym = 311,               /* "RSUB"  */
+    rmulopsym = 312,               /* "RMUL"  */
+    rdivopsym = 313,               /* "RDIV"  */
+    randopsym = 314,               /* "RAND"  */
+    rboropsym = 315,               /* "RBOR"  */
+    rxoropsym = 316,               /* "RXOR"  */
+    rsltopsym = 317,               /* "RSLT"  */
+    breqopsym = 318,               /* "BREQ"  */
+    brneopsym = 319,               /* "BRNE"  */
+    brltopsym = 320,               /* "BRLT"  */
+    brleopsym = 321,               /* "BRLE"  */
+    brgtopsym = 322,               /* "BRGT"  */
+    brgeopsym = 323,               /* "BRGE"  */
+    csiopsym = 324,                /* "CSI"  */
+    jmpaopsym = 325,               /* "JMPA"  */
+    callopsym = 326,               /* "CALL"  */
+    rtnopsym = 327,                /* "RTN"  */
+    exitopsym = 328,               /* "EXIT"  */
+    pstropsym = 329,               /* "PSTR"  */
+    pintopsym = 330,               /* "PINT"  */
+    pchopsym = 331,                /* "PCH"  */
+    rchopsym = 332,                /* "RCH"  */
+    rlnopsym = 333,                /* "RLN"  */
+    rbytopsym = 334,               /* "RBYT"  */
+    pchsopsym = 335,               /* "PCHS"  */
+    pbytopsym = 336,               /* "PBYT"  */
+    spwnopsym = 337,               /* "SPWN"  */
+    joinopsym = 338,               /* "JOIN"  */
+    casopsym = 339,                /* "CAS"  */
+    faddopsym = 340,               /* "FADD"  */
+    cocropsym = 341,               /* "COCR"  */
+    yldopsym = 342,                /* "YLD"  */
+    rsmopsym = 343,                /* "RSM"  */
+    mbegopsym = 344,               /* "MBEG"  */
+    mendopsym = 345,               /* "MEND"  */
+    alocopsym = 346,               /* "ALOC"  */
+    freeopsym = 347,               /* "FREE"  */
+    rszopsym = 348,                /* "RSZ"  */
+    straopsym = 349,               /* "STRA"  */
+    notropsym = 350,               /* "NOTR"  */
+    regsym = 351,                  /* regsym  */
+    wordsym = 352,                 /* "WORD"  */
+    charsym = 353,                 /* "CHAR"  */
+    stringsym = 354,               /* "STRING"  */
+    charliteralsym = 355,          /* charliteralsym  */
+    stringliteralsym = 356         /* stringliteralsym  */
   };
   typedef enum yytokentype yytoken_kind_t;
 #endif
@@ -157,10 +191,9 @@ struct YYLTYPE
 #endif
 
 
-extern YYSTYPE yylval;
-extern YYLTYPE yylloc;
 
-int yyparse (char const *file_name);
+
+int yyparse (char const *file_name, yyscan_t scanner, ast_program_t *progast);
 
 
 #endif /* !YY_YY_ASM_TAB_H_INCLUDED  */
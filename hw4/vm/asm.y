@@ -10,18 +10,23 @@
 #include "ast.h"
 #include "machine_types.h"
 #include "parser_types.h"
-#include "lexer.h"
 // #include "utilities.h" // only needed for debugging
 
-    /* Report an error to the user on stderr */
-extern void yyerror(const char *filename, const char *msg);
+ /* The scanner that the parser reads from (see lexer.h) */
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void *yyscan_t;
+#endif
 }    
 
 %verbose
 %define parse.lac full
 %define parse.error detailed
+%define api.pure full
 
-%parse-param { char const *file_name }
+%lex-param { yyscan_t scanner }
+%parse-param { char const *file_name } { yyscan_t scanner }
+%parse-param { ast_program_t *progast }
 
 %token eolsym
 %token <ident> identsym
@@ -51,6 +56,7 @@ extern void yyerror(const char *filename, const char *msg);
 %token <token> scaopsym   "SCA"
 %token <token> lwiopsym   "LWI"
 %token <token> negopsym   "NEG"
+%token <token> bcpopsym   "BCP"
 %token <token> litopsym   "LIT"
 %token <token> ariopsym   "ARI"
 %token <token> sriopsym   "SRI"
@@ -62,6 +68,7 @@ extern void yyerror(const char *filename, const char *msg);
 %token <token> srlopsym   "SRL"
 %token <token> jmpopsym   "JMP"
 %token <token> jrelopsym  "JREL"
+%token <token> bflopsym   "BFL"
 %token <token> addiopsym  "ADDI"
 %token <token> andiopsym  "ANDI"
 %token <token> boriopsym  "BORI"
@@ -73,6 +80,20 @@ extern void yyerror(const char *filename, const char *msg);
 %token <token> bgtzopsym  "BGTZ"
 %token <token> bltzopsym  "BLTZ"
 %token <token> bneopsym   "BNE"
+%token <token> raddopsym  "RADD"
+%token <token> rsubopsym  "RSUB"
+%token <token> rmulopsym  "RMUL"
+%token <token> rdivopsym  "RDIV"
+%token <token> randopsym  "RAND"
+%token <token> rboropsym  "RBOR"
+%token <token> rxoropsym  "RXOR"
+%token <token> rsltopsym  "RSLT"
+%token <token> breqopsym  "BREQ"
+%token <token> brneopsym  "BRNE"
+%token <token> brltopsym  "BRLT"
+%token <token> brleopsym  "BRLE"
+%token <token> brgtopsym  "BRGT"
+%token <token> brgeopsym  "BRGE"
 %token <token> csiopsym   "CSI"
 %token <token> jmpaopsym  "JMPA"
 %token <token> callopsym  "CALL"
@@ -82,6 +103,22 @@ extern void yyerror(const char *filename, const char *msg);
 %token <token> pintopsym  "PINT"
 %token <token> pchopsym   "PCH"
 %token <token> rchopsym   "RCH"
+%token <token> rlnopsym   "RLN"
+%token <token> rbytopsym  "RBYT"
+%token <token> pchsopsym  "PCHS"
+%token <token> pbytopsym  "PBYT"
+%token <token> spwnopsym  "SPWN"
+%token <token> joinopsym  "JOIN"
+%token <token> casopsym   "CAS"
+%token <token> faddopsym  "FADD"
+%token <token> cocropsym  "COCR"
+%token <token> yldopsym   "YLD"
+%token <token> rsmopsym   "RSM"
+%token <token> mbegopsym  "MBEG"
+%token <token> mendopsym  "MEND"
+%token <token> alocopsym  "ALOC"
+%token <token> freeopsym  "FREE"
+%token <token> rszopsym   "RSZ"
 %token <token> straopsym  "STRA"
 %token <token> notropsym  "NOTR"
 
@@ -137,6 +174,10 @@ extern void yyerror(const char *filename, const char *msg);
 %type <immed> uimmed
 %type <instr> branchTestInstr
 %type <token> branchTestOp
+%type <instr> regCompInstr
+%type <token> regCompOp
+%type <instr> regBranchInstr
+%type <token> regBranchOp
 %type <instr> jumpInstr
 %type <token> jumpOp
 %type <instr> syscallInstr
@@ -159,21 +200,17 @@ extern void yyerror(const char *filename, const char *msg);
 
 %code {
  /* extern declarations provided by the lexer */
-extern int yylex(void);
-
- /* extern void yyerror(char const *msg); */
-
- /* The AST for the program, set by the semantic action for program. */
-ast_program_t progast; 
+#include "lexer.h"
 
- /* Set the program's ast to be t */
-extern void setProgAST(ast_program_t t);
+ /* Report an error to the user on stderr (see lexer_error) */
+static void yyerror(YYLTYPE *llocp, char const *file_name, yyscan_t scanner,
+		    ast_program_t *progast, const char *msg);
 }
 
 %%
 
 program : textSection dataSection stackSection ".end"
-           { setProgAST(ast_program($1, $2, $3)); } ;
+           { *progast = ast_program($1, $2, $3); } ;
 
 textSection : ".text" entryPoint asmInstrs 
            { $$ = ast_text_section($1,$2,$3); } ;
@@ -198,14 +235,14 @@ labelOpt : label ":" { $$ = ast_label_opt_label($1); }
       | empty { $$ = ast_label_opt_empty($1); }
       ;
 
-empty : %empty { $$ = ast_empty(lexer_filename(), lexer_line()); } ;
+empty : %empty { $$ = ast_empty(lexer_filename(scanner), lexer_line(scanner)); } ;
 
 
 instr : noArgInstr | twoRegCompInstr | twoRegNoOffsetsInstr
       | noTargetOffsetInstr | noSourceOffsetInstr | oneRegOffsetArgInstr
       | oneRegArgInstr | oneRegOffsetInstr | shiftInstr | argOnlyInstr
       | immedArithInstr | immedBoolInstr | branchTestInstr | jumpInstr
-      | syscallInstr
+      | syscallInstr | regCompInstr | regBranchInstr
       ;
 
 
@@ -223,7 +260,8 @@ twoRegCompInstr : twoRegCompOp regsym "," offset "," regsym "," offset
            ;
 
 twoRegCompOp : "ADD" | "SUB" | "CPW" 
-               | "AND" | "BOR" | "NOR" | "XOR" | "SCA" | "LWI" | "NEG" ;
+               | "AND" | "BOR" | "NOR" | "XOR" | "SCA" | "LWI" | "NEG"
+               | "BCP" ;
 
 
 offset : number 
@@ -244,7 +282,8 @@ number : sign unsignednumsym
            ;
 
 sign : "+" | "-"
-     | empty { $$ = ast_token(lexer_filename(), lexer_line(), plussym); }
+     | empty { $$ = ast_token(lexer_filename(scanner), lexer_line(scanner),
+			       plussym); }
      ; 
 
 
@@ -287,7 +326,7 @@ oneRegOffsetArgInstr : oneRegOffsetArgOp regsym "," offset "," arg
 	   }
            ;
 
-oneRegOffsetArgOp : "LIT" ;
+oneRegOffsetArgOp : "LIT" | "BFL" ;
 
 arg : number 
            {   /* the number is signed */
@@ -398,6 +437,26 @@ branchTestInstr : branchTestOp regsym "," offset "," immed
 branchTestOp : "BEQ" | "BGEZ" | "BGTZ" | "BLEZ" | "BLTZ" | "BNE" ;
 
 
+regCompInstr : regCompOp regsym "," regsym "," regsym
+       {
+	   $$ = ast_3reg_instr($1, $2.number, $4.number, $6.number);
+       }
+       ;
+
+regCompOp : "RADD" | "RSUB" | "RMUL" | "RDIV"
+          | "RAND" | "RBOR" | "RXOR" | "RSLT" ;
+
+
+regBranchInstr : regBranchOp regsym "," regsym "," arg
+       {
+	   $$ = ast_reg_branch_instr($1, $2.number, $4.number,
+				     ast_immed_number($6.value));
+       }
+       ;
+
+regBranchOp : "BREQ" | "BRNE" | "BRLT" | "BRLE" | "BRGT" | "BRGE" ;
+
+
 jumpInstr : jumpOp addr
             {
 		if ($2.address_defined) {
@@ -433,7 +492,12 @@ regOffsetSyscall : regOffsetSyscallOp regsym "," offset
 	    }
             ;
 
-regOffsetSyscallOp : "PSTR" | "PINT" | "PCH" | "RCH" ;
+regOffsetSyscallOp : "PSTR" | "PINT" | "PCH" | "RCH"
+                   | "RLN" | "RBYT" | "PCHS" | "PBYT"
+                   | "SPWN" | "JOIN" | "CAS" | "FADD"
+                   | "COCR" | "RSM"
+                   | "MBEG" | "MEND"
+                   | "ALOC" | "FREE" | "RSZ" ;
 
 
 noArgSyscall : noArgSyscallOp 
@@ -444,7 +508,7 @@ noArgSyscall : noArgSyscallOp
 	    }
             ;
 
-noArgSyscallOp : "STRA" | "NOTR" ;
+noArgSyscallOp : "STRA" | "NOTR" | "YLD" ;
 
 
 
@@ -485,5 +549,9 @@ stackBottomAddr : unsignednumsym ;
 
 %%
 
-// Set the program's ast to be t
-void setProgAST(ast_program_t t) { progast = t; }
+// Report an error to the user on stderr (see lexer_error)
+static void yyerror(YYLTYPE *llocp, char const *file_name, yyscan_t scanner,
+		    ast_program_t *progast, const char *msg)
+{
+    lexer_error(scanner, msg);
+}
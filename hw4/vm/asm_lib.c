@@ -0,0 +1,88 @@
+/* $Id$ */
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ast.h"
+#include "parser_types.h"
+#include "lexer.h"
+#include "asm.tab.h"
+#include "arena.h"
+#include "bof.h"
+#include "symtab.h"
+#include "pass1.h"
+#include "assemble.h"
+#include "asm_lib.h"
+
+// Requires: name != NULL and src holds len chars
+// Assemble the program whose text is the len chars starting at src,
+// calling it name in error messages (and in debugging information),
+// with the given options, putting what happened in *res,
+// and return res->ok.
+// Any error noted in the program makes the assembly fail.
+bool asm_lib_assemble(const char *name, const char *src, size_t len,
+		      asm_lib_options opts, asm_lib_result *res)
+{
+    res->ok = false;
+    res->bof = NULL;
+    res->bof_bytes = 0;
+    res->status = EXIT_SUCCESS;
+    res->message[0] = '\0';
+
+    // this call's scanner and symbol table,
+    // and its tokens and AST (in the arena)
+    symtab_t *table = symtab_create();
+    yyscan_t scanner = lexer_init_buffer(name, src, len);
+    arena_start();
+    if (opts.debug_info) {
+	assemble_enable_debug_info();
+    } else {
+	assemble_disable_debug_info();
+    }
+    BOFFILE bf = bof_write_open_memory(name, &res->bof, &res->bof_bytes);
+
+    error_context ec;
+    error_context_enter(&ec);
+    if (setjmp(ec.env) == 0) {
+	// errors are reported with the description of errno (see utilities.h),
+	// which may be left over from an earlier call
+	errno = 0;
+	ast_program_t progast;
+	if (yyparse(name, scanner, &progast) == 0
+	    && !lexer_errors_noted(scanner)) {
+	    pass1(table, progast);
+	    if (opts.optimize) {
+		assemble_optimize(table, &progast);
+	    }
+	    assembleProgram(bf, table, progast);
+	    res->ok = true;
+	} else {
+	    // the parser's errors were kept by the lexer
+	    res->status = EXIT_FAILURE;
+	    strcpy(res->message, lexer_first_error(scanner));
+	}
+	error_context_leave(&ec);
+    } else {
+	res->status = ec.status;
+	strcpy(res->message, ec.message);
+    }
+
+    bof_close(bf);
+    if (!res->ok) {
+	free(res->bof);
+	res->bof = NULL;
+	res->bof_bytes = 0;
+    }
+    lexer_close(scanner);
+    assemble_disable_debug_info();
+    arena_release();
+    symtab_destroy(table);
+    return res->ok;
+}
+
+// Release the storage of res (i.e., its binary object file)
+void asm_lib_free(asm_lib_result *res)
+{
+    free(res->bof);
+    res->bof = NULL;
+    res->bof_bytes = 0;
+}
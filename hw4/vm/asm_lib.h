@@ -0,0 +1,46 @@
+/* $Id$ */
+// The assembler as a library, which assembles a program held in memory
+// into a binary object file held in memory
+#ifndef _ASM_LIB_H
+#define _ASM_LIB_H
+#include <stdbool.h>
+#include <stddef.h>
+#include "utilities.h"
+
+// Each call of asm_lib_assemble has its own scanner and symbol table,
+// and all of the space for the program's tokens and AST is freed
+// before it returns, so a program (e.g., a test generator or benchmark)
+// can assemble many programs, one after another, without running
+// the assembler for each. Errors are returned in the result
+// instead of being printed or exiting the program.
+// Calls share no state (what the assembler keeps between its steps
+// is kept per thread), so calls in different threads may overlap.
+
+// options for asm_lib_assemble (all false gives what asm gives)
+typedef struct {
+    bool debug_info;    // include debugging information (like asm -g)
+    bool optimize;      // do peephole optimization (like asm -O)
+} asm_lib_options;
+
+// the result of asm_lib_assemble
+typedef struct {
+    bool ok;            // was the program assembled?
+    char *bof;          // if so, the binary object file (malloc-allocated)
+    size_t bof_bytes;   // and the number of bytes in it
+    int status;         // if not, the exit code that asm would give
+    char message[ERROR_MESSAGE_SIZE];  // and the (first) error's message
+} asm_lib_result;
+
+// Requires: name != NULL and src holds len chars
+// Assemble the program whose text is the len chars starting at src,
+// calling it name in error messages (and in debugging information),
+// with the given options, putting what happened in *res,
+// and return res->ok.
+// Any error noted in the program makes the assembly fail.
+extern bool asm_lib_assemble(const char *name, const char *src, size_t len,
+			     asm_lib_options opts, asm_lib_result *res);
+
+// Release the storage of res (i.e., its binary object file)
+extern void asm_lib_free(asm_lib_result *res);
+
+#endif
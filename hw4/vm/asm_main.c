@@ -12,13 +12,12 @@
 #include "asm_unparser.h"
 #include "pass1.h"
 #include "assemble.h"
+#include "symtab.h"
+#include "bof_cache.h"
 
 // strdup seems to be in the string library but not in the header...
 extern char *strdup(const char *s);
 
-/* The program's AST, set by the parser */
-extern ast_program_t progast;
-
 // Requires: fn is a name that ends in .asm
 // Modify fn to have the extension .bof
 static void change_to_bof_ext(char *fn) {
@@ -41,11 +40,18 @@ char * cmdname;
 static const char *typicalFile = "file.asm";
 
 void usage() {
-    bail_with_error("Usage: %s %s\n       %s %s %s\n       %s %s %s\n       %s %s %s",
+    bail_with_error("Usage: %s %s\n       %s %s %s\n       %s %s %s\n       %s %s %s\n       %s %s %s\n       %s %s %s\n       %s %s %s\n       %s %s %s\n       %s %s %s\n       %s",
 		    cmdname, typicalFile,
 		    cmdname, "-l", typicalFile,
 		    cmdname, "-u", typicalFile,
-		    cmdname, "-s", typicalFile);
+		    cmdname, "-s", typicalFile,
+		    cmdname, "-c", typicalFile,
+		    cmdname, "-g", typicalFile,
+		    cmdname, "-k", typicalFile,
+		    cmdname, "-1", typicalFile,
+		    cmdname, "-O", typicalFile,
+		    "(with -O, a return address saved by SWR must not be changed"
+		    " in memory\n        before LWR reloads it into $ra)");
     exit(EXIT_FAILURE);
 }
 
@@ -58,12 +64,24 @@ int main(int argc, char *argv[]) {
     bool parser_unparse = false;
     // should the symbol table be printed after pass 1?
     bool symbol_table_print = false;
+    // should a relocatable object (file.obj) be made instead of file.bof?
+    bool make_object = false;
+    // should file.bof have debugging information?
+    bool debug_info = false;
+    // should the BOF cache's statistics be printed (see bof_cache.h)?
+    bool cache_statistics_print = false;
+    // should the program be assembled in one pass, as it is parsed,
+    // without keeping its AST?
+    bool one_pass = false;
+    // should the program be improved by peephole optimization
+    // (and statistics about that be printed)?
+    bool optimize = false;
 
     cmdname = argv[0];
     argc--;
     argv++;
 
-    // possible options: -l, -u, and -s
+    // possible options: -l, -u, -s, -c, -g, -k, -1, and -O
     while (argc > 0 && strlen(argv[0]) >= 2 && argv[0][0] == '-') {
 	if (strcmp(argv[0],"-l") == 0) {
 	    lexer_print_output = true;
@@ -77,6 +95,26 @@ int main(int argc, char *argv[]) {
 	    symbol_table_print = true;
 	    argc--;
 	    argv++;
+	} else if (strcmp(argv[0],"-c") == 0) {
+	    make_object = true;
+	    argc--;
+	    argv++;
+	} else if (strcmp(argv[0],"-g") == 0) {
+	    debug_info = true;
+	    argc--;
+	    argv++;
+	} else if (strcmp(argv[0],"-k") == 0) {
+	    cache_statistics_print = true;
+	    argc--;
+	    argv++;
+	} else if (strcmp(argv[0],"-1") == 0) {
+	    one_pass = true;
+	    argc--;
+	    argv++;
+	} else if (strcmp(argv[0],"-O") == 0) {
+	    optimize = true;
+	    argc--;
+	    argv++;
 	} else {
 	    // bad option!
 	    usage();
@@ -93,6 +131,22 @@ int main(int argc, char *argv[]) {
 	usage();
     }
 
+    // relocatable objects do not have debugging information
+    if ( make_object && debug_info ) {
+	usage();
+    }
+
+    // assembling in one pass keeps no AST to unparse or make an object from
+    if ( one_pass && (parser_unparse || symbol_table_print || make_object) ) {
+	usage();
+    }
+
+    // optimization needs the AST and the addresses of all the labels,
+    // which relocatable objects do not have
+    if ( optimize && (one_pass || make_object) ) {
+	usage();
+    }
+
     // must have a file name
     if (argc <= 0 || (strlen(argv[0]) >= 2 && argv[0][0] == '-')) {
 	usage();
@@ -103,20 +157,60 @@ int main(int argc, char *argv[]) {
 
     if (lexer_print_output) {
 	// with the lexer_print_output option, nothing else is done
-	lexer_init(file_name);
-	lexer_output();
-	if (errors_noted) {
+	yyscan_t scanner = lexer_init(file_name);
+	lexer_output(scanner);
+	if (lexer_errors_noted(scanner)) {
 	    return EXIT_FAILURE;
 	} else {
 	    return EXIT_SUCCESS;
 	}
     }
 
+    char *bfn = strdup(file_name);
+    change_to_bof_ext(bfn);
+    if (make_object) {
+	strcpy(strrchr(bfn, '.'), ".obj");
+    }
+
+    // if the output is in the BOF cache, use it and skip all the work;
+    // the key includes the options that change the output
+    // (and the file's name when it is recorded in debugging information)
+    BOFCache cache;
+    bool caching = !parser_unparse && !symbol_table_print
+	&& bof_cache_open(&cache, cmdname);
+    if (caching) {
+	char options[BOF_CACHE_PATH_SIZE];
+	snprintf(options, sizeof(options), "%s%s%s%s",
+		 make_object ? "-c " : "", debug_info ? "-g " : "",
+		 optimize ? "-O " : "", debug_info ? file_name : "");
+	caching = bof_cache_set_key(&cache, file_name, options);
+    }
+    if (caching && bof_cache_fetch(&cache, bfn)) {
+	if (cache_statistics_print) {
+	    bof_cache_print_statistics(stderr, &cache);
+	}
+	return EXIT_SUCCESS;
+    }
+
+    // the program's symbol table
+    symtab_t *tab = symtab_create();
+
+    // when assembling in one pass, the parser hands each instruction
+    // and static declaration to the assembler as it is parsed
+    if (one_pass) {
+	if (debug_info) {
+	    assemble_enable_debug_info();
+	}
+	assemble_stream_start(tab);
+    }
+
     // otherwise (if not lexer_print_outout) continue to parse etc.
-    lexer_init(file_name);
-    int parser_ret = yyparse(file_name);
+    yyscan_t scanner = lexer_init(file_name);
+    ast_program_t progast;
+    int parser_ret = yyparse(file_name, scanner, &progast);
+    lexer_close(scanner);
     if (parser_ret != 0) {
-	exit(EXIT_FAILURE);
+	bail_with_exit_code(EXIT_FAILURE);
     }
 
     if (parser_unparse) {
@@ -128,21 +222,53 @@ int main(int argc, char *argv[]) {
     }
 
     // check for duplicate declarations of labels/names and build symbol table
-    pass1(progast);
+    // (which was done during parsing when assembling in one pass)
+    if (!one_pass) {
+	pass1(tab, progast);
+    }
+
+    // improve the program (changing the symbol table to match)
+    if (optimize) {
+	assemble_optimize(tab, &progast);
+	assemble_print_optimization_statistics(stderr);
+    }
 
     // print debugging information about the symbol table
     if (symbol_table_print) {
-	pass1_print(stdout);
+	pass1_print(stdout, tab);
     }
 
-    char *bfn = strdup(file_name);
-    change_to_bof_ext(bfn);
-    
     BOFFILE bf = bof_write_open(bfn);
+    if (debug_info) {
+	assemble_enable_debug_info();
+    }
 
-    // generate code from the ASTs
-    assembleProgram(bf, progast);
+    // generate code from the ASTs,
+    // removing the partly written BOF file if that fails
+    error_context ec;
+    error_context_enter(&ec);
+    if (setjmp(ec.env) == 0) {
+	if (make_object) {
+	    assembleObject(bf, bfn, tab, progast);
+	} else if (one_pass) {
+	    assembleStreamedProgram(bf, tab, progast);
+	} else {
+	    assembleProgram(bf, tab, progast);
+	}
+	error_context_leave(&ec);
+    } else {
+	bof_close(bf);
+	remove(bfn);
+	error_context_propagate(&ec);
+    }
     bof_close(bf);
 
+    if (caching) {
+	bof_cache_store(&cache, bfn);
+	if (cache_statistics_print) {
+	    bof_cache_print_statistics(stderr, &cache);
+	}
+    }
+
     return EXIT_SUCCESS;
 }
@@ -97,6 +97,11 @@ void unparseInstr(FILE *out, ast_instr_t instr)
 		    unparseReg(instr.reg), instr.offset,
 		    unparseReg(instr.reg2));
 	    break;
+	case REG_F:
+	    fprintf(out, "%s, %s, %s",
+		    unparseReg(instr.reg), unparseReg(instr.reg2),
+		    unparseReg(instr.reg3));
+	    break;
 	default:    // all the rest of these instructions
 	    fprintf(out, "%s, %hd, %s, %hd",
 		    unparseReg(instr.reg), instr.offset,
@@ -106,7 +111,7 @@ void unparseInstr(FILE *out, ast_instr_t instr)
 	break;
     case OTHC_O:
 	switch (instr.func) {
-	case LIT_F:
+	case LIT_F: case BFL_F:
 	    fprintf(out, "%s, %hd, %hd",
 		    unparseReg(instr.reg), instr.offset,
 		    instr.immed_data.data.immed);
@@ -124,14 +129,28 @@ void unparseInstr(FILE *out, ast_instr_t instr)
 	case JREL_F:
 	    fprintf(out, "%hd", instr.immed_data.data.immed);
 	    break;
+	case RBR_F:
+	    fprintf(out, "%s, %s, %hd",
+		    unparseReg(instr.reg), unparseReg(instr.reg2),
+		    instr.immed_data.data.immed);
+	    break;
 	case SYS_F:
 	    switch (instr.immed_data.data.syscall_code) {
 	    case exit_sc:
 		fprintf(out, "%hd", instr.offset);
 		break;
 	    case print_str_sc: case print_char_sc: case read_char_sc:
+	    case read_line_sc: case read_bytes_sc:
+	    case print_chars_sc: case print_bytes_sc:
+	    case spawn_thread_sc: case join_thread_sc:
+	    case compare_and_swap_sc: case fetch_and_add_sc:
+	    case create_coroutine_sc: case resume_sc:
+	    case begin_region_sc: case end_region_sc:
+	    case allocate_sc: case free_sc:
+	    case resize_sc:
 		fprintf(out, "%s, %hd", unparseReg(instr.reg), instr.offset);
 		break;
+	    case yield_sc:
 	    case start_tracing_sc: case stop_tracing_sc:
 		// no arguments!
 		break;
@@ -0,0 +1,191 @@
+/* $Id$ */
+// Assembles programs using the assembler as a library (see asm_lib.h),
+// each from its text read into memory, writing each one's file.bof
+// as asm would, and optionally assembling each many times
+// (in several threads at once, which must all give the same result)
+// to measure how many programs can be assembled per second
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bof.h"
+#include "asm_lib.h"
+#include "utilities.h"
+
+static char *progname;
+
+// the most threads that may assemble a program at once
+#define MAX_THREADS 16
+
+void usage() {
+    bail_with_error("Usage: %s [-g] [-O] [-n count] [-t threads] file.asm ...",
+		    progname);
+}
+
+// Read the file named filename into a newly allocated buffer,
+// setting *bytesp to its size and returning the buffer
+static char *read_file(const char *filename, size_t *bytesp)
+{
+    *bytesp = 0;
+    FILE *f = fopen(filename, "rb");
+    if (f == NULL) {
+	bail_with_error("Cannot open %s!", filename);
+    }
+    size_t capacity = BUFSIZ;
+    char *buf = (char *) malloc(capacity);
+    size_t n;
+    while (buf != NULL
+	   && (n = fread(buf + *bytesp, 1, capacity - *bytesp, f)) > 0) {
+	*bytesp += n;
+	if (*bytesp == capacity) {
+	    capacity *= 2;
+	    buf = (char *) realloc(buf, capacity);
+	}
+    }
+    if (buf == NULL || ferror(f)) {
+	bail_with_error("Cannot read %s!", filename);
+    }
+    fclose(f);
+    return buf;
+}
+
+// the work of one thread that assembles a program (see assemble_file)
+typedef struct {
+    const char *filename;
+    const char *src;      // the program's text
+    size_t bytes;         // and the number of chars in it
+    asm_lib_options opts;
+    int count;            // the number of times to assemble it
+    asm_lib_result res;   // the result of the last time
+} assembly_job;
+
+// Assemble the job's program count times (stopping at an error),
+// leaving the last result in job->res
+static void *assemble_job(void *arg)
+{
+    assembly_job *job = (assembly_job *) arg;
+    for (int i = 0; i < job->count; i++) {
+	if (!asm_lib_assemble(job->filename, job->src, job->bytes, job->opts,
+			      &job->res)) {
+	    break;
+	}
+	if (i + 1 < job->count) {
+	    asm_lib_free(&job->res);
+	}
+    }
+    return NULL;
+}
+
+// Are the results r1 and r2 the same?
+static bool same_result(const asm_lib_result *r1, const asm_lib_result *r2)
+{
+    return r1->ok == r2->ok && r1->bof_bytes == r2->bof_bytes
+	&& (r1->bof_bytes == 0 || memcmp(r1->bof, r2->bof, r1->bof_bytes) == 0)
+	&& r1->status == r2->status && strcmp(r1->message, r2->message) == 0;
+}
+
+// Requires: 0 < threads <= MAX_THREADS
+// Assemble the program in the file named filename count times
+// in each of the given number of threads at once (with the given options)
+// and write its binary object file to the file whose name has
+// the extension .bof instead of .asm.
+// Exit the program with the assembler's error if it cannot be assembled,
+// or with an error if the threads' results are not all the same.
+static void assemble_file(const char *filename, asm_lib_options opts,
+			  int count, int threads)
+{
+    const char *dot = strrchr(filename, '.');
+    if (dot == NULL || strcmp(dot, ".asm") != 0) {
+	bail_with_error("File name %s does not end in .asm!", filename);
+    }
+    char bfn[BUFSIZ];
+    snprintf(bfn, sizeof(bfn), "%.*s.bof", (int) (dot - filename), filename);
+
+    size_t bytes;
+    char *src = read_file(filename, &bytes);
+    assembly_job jobs[MAX_THREADS];
+    pthread_t ids[MAX_THREADS];
+    for (int t = 0; t < threads; t++) {
+	jobs[t] = (assembly_job) { filename, src, bytes, opts, count };
+    }
+    // the first job is done by this thread, while the others run
+    for (int t = 1; t < threads; t++) {
+	if (pthread_create(&ids[t], NULL, assemble_job, &jobs[t]) != 0) {
+	    bail_with_error("Cannot start a thread to assemble %s!", filename);
+	}
+    }
+    assemble_job(&jobs[0]);
+    for (int t = 1; t < threads; t++) {
+	pthread_join(ids[t], NULL);
+	bool same = same_result(&jobs[t].res, &jobs[0].res);
+	asm_lib_free(&jobs[t].res);
+	if (!same) {
+	    bail_with_error("Threads assembled %s differently!", filename);
+	}
+    }
+    free(src);
+
+    asm_lib_result res = jobs[0].res;
+    if (!res.ok) {
+	fflush(stdout);
+	fprintf(stderr, "%s\n", res.message);
+	exit(res.status);
+    }
+
+    BOFFILE bf = bof_write_open(bfn);
+    bof_write_bytes(bf, res.bof_bytes, res.bof);
+    bof_close(bf);
+    asm_lib_free(&res);
+}
+
+int main(int argc, char *argv[]) {
+    progname = argv[0];
+    argc--;
+    argv++;
+
+    asm_lib_options opts = { false, false };
+    int count = 1;
+    int threads = 1;
+    bool timing = false;
+    // possible options: -g, -O, -n count, and -t threads
+    while (argc > 0 && strlen(argv[0]) >= 2 && argv[0][0] == '-') {
+	if (strcmp(argv[0], "-g") == 0) {
+	    opts.debug_info = true;
+	} else if (strcmp(argv[0], "-O") == 0) {
+	    opts.optimize = true;
+	} else if (strcmp(argv[0], "-n") == 0 && argc > 1) {
+	    count = atoi(argv[1]);
+	    timing = true;
+	    argc--;
+	    argv++;
+	} else if (strcmp(argv[0], "-t") == 0 && argc > 1) {
+	    threads = atoi(argv[1]);
+	    argc--;
+	    argv++;
+	} else {
+	    usage();
+	}
+	argc--;
+	argv++;
+    }
+    if (argc <= 0 || count <= 0 || threads <= 0 || threads > MAX_THREADS) {
+	usage();
+    }
+
+    clock_t start = clock();
+    for (int i = 0; i < argc; i++) {
+	assemble_file(argv[i], opts, count, threads);
+    }
+    if (timing) {
+	double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+	int programs = argc * count * threads;
+	fprintf(stderr, "Assembled %d programs in %.3f seconds", programs,
+		seconds);
+	if (seconds > 0) {
+	    fprintf(stderr, " (%.0f per second)", programs / seconds);
+	}
+	fprintf(stderr, "\n");
+    }
+    return EXIT_SUCCESS;
+}
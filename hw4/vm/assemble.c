@@ -6,20 +6,116 @@
 #include "utilities.h"
 #include "assemble.h"
 #include "bof.h"
+#include "bof_object.h"
+#include "bof_debug.h"
 #include "symtab.h"
 #include "id_attrs_assoc.h"
 #include "regname.h"
+#include "pass1.h"
 
-// Return the address associated with the addr l
-static address_type addr2address(ast_addr_t addr)
+// The state of an assembly (below) is kept per thread,
+// so programs can be assembled in several threads at once.
+
+// the relocatable object being assembled,
+// or NULL if an executable program is being assembled
+static _Thread_local BOFObject *object = NULL;
+
+// should programs be assembled with debugging information?
+static _Thread_local bool debug_info_enabled = false;
+// the debugging information being gathered,
+// or NULL if there is none being gathered
+static _Thread_local BOFDebugInfo *debug = NULL;
+
+// a use of a label in an instruction that was assembled in one pass
+// before the label was defined, so its address is patched in later
+typedef struct {
+    int word;                // the instruction's index in the text section
+    char *label;
+    file_location file_loc;  // where the label was used
+} label_fixup;
+
+// is a program being assembled in one pass?
+static _Thread_local bool streaming = false;
+// the binary object file and debugging information being built
+// when assembling in one pass
+static _Thread_local BOFBuffer stream_bb;
+static _Thread_local BOFDebugInfo stream_dbg;
+// the offset of the next static declaration in the data section
+static _Thread_local address_type stream_data_offset;
+// the symbol table of the program being assembled in one pass
+static _Thread_local symtab_t *stream_tab = NULL;
+// the uses of labels waiting for their addresses
+static _Thread_local label_fixup *fixups = NULL;
+static _Thread_local int fixup_count = 0;
+static _Thread_local int fixup_capacity = 0;
+
+// Assemble programs with debugging information (see bof_debug.h)
+void assemble_enable_debug_info()
+{
+    debug_info_enabled = true;
+}
+
+// Assemble programs without debugging information (as is the default)
+void assemble_disable_debug_info()
+{
+    debug_info_enabled = false;
+}
+
+// Note that the instruction being added to the text section of stream_bb
+// uses the label of addr, which is not defined yet
+static void add_fixup(ast_addr_t addr)
+{
+    if (fixup_count == fixup_capacity) {
+	int cap = (fixup_capacity == 0) ? 64 : 2 * fixup_capacity;
+	label_fixup *p = (label_fixup *) realloc(fixups,
+						  cap * sizeof(label_fixup));
+	if (p == NULL) {
+	    bail_with_error("No space for uses of undefined labels!");
+	}
+	fixups = p;
+	fixup_capacity = cap;
+    }
+    label_fixup *f = &fixups[fixup_count];
+    f->label = (char *) malloc(strlen(addr.label) + 1);
+    if (f->label == NULL) {
+	bail_with_error("No space for uses of undefined labels!");
+    }
+    strcpy(f->label, addr.label);
+    f->word = bof_buffer_text_words(&stream_bb);
+    f->file_loc = *(addr.file_loc);
+    fixup_count++;
+}
+
+// Release the fixups
+static void free_fixups()
+{
+    for (int i = 0; i < fixup_count; i++) {
+	free(fixups[i].label);
+    }
+    free(fixups);
+    fixups = NULL;
+    fixup_count = 0;
+    fixup_capacity = 0;
+}
+
+// Return the address associated with the addr l (using the symbol table tab)
+// (in an object, an undefined label is imported, and its address is 0
+// until the linker relocates it; when assembling in one pass,
+// an undefined label's address is 0 until its fixup is patched)
+static address_type addr2address(symtab_t *tab, ast_addr_t addr)
 {
     address_type ret = addr.addr;
     if (addr.address_defined) {
 	return ret;
     } else {
 	// the address is not defined yet
-	id_attrs_assoc *ida = symtab_lookup(addr.label);
-	if (ida == NULL) {
+	id_attrs_assoc *ida = symtab_lookup(tab, addr.label);
+	if (ida == NULL && object != NULL) {
+	    return 0;
+	} else if (ida == NULL && streaming) {
+	    add_fixup(addr);
+	    return 0;
+	} else if (ida == NULL) {
 	    bail_with_prog_error(*(addr.file_loc),
 				 "Label \"%s\" was never defined!",
 				 addr.label);
@@ -28,48 +124,317 @@ static address_type addr2address(ast_addr_t addr)
     }
 }
 
-// Assemble the code for prog, with output going to bf
-void assembleProgram(BOFFILE bf, ast_program_t prog)
+// Add the binary instruction bi to the end of the text section in bb,
+// and, in an object, relocations for its $gp-relative operands
+static void add_instr(BOFBuffer *bb, bin_instr_t bi)
+{
+    if (object != NULL) {
+	reg_num_type regs[2];
+	offset_type offsets[2];
+	int n = instruction_memory_operands(bi, regs, offsets);
+	for (int i = 0; i < n; i++) {
+	    if (regs[i] == GP) {
+		bof_object_add_reloc(object, bof_buffer_text_words(bb),
+				     (i == 0) ? obj_reloc_gp1 : obj_reloc_gp2,
+				     -1);
+	    }
+	}
+    }
+    bof_buffer_add_word(bb, (word_type) instruction_encode(bi));
+}
+
+// Compare the addresses pointed to by a and b (for qsort)
+static int compare_addresses(const void *a, const void *b)
+{
+    address_type x = *(const address_type *) a;
+    address_type y = *(const address_type *) b;
+    return (x < y) ? -1 : (x > y);
+}
+
+// Requires: starts holds count addresses in increasing order
+// Return the first of the starts that is greater than addr,
+// or limit if there is none (or it is not less than limit)
+static address_type next_start(const address_type *starts, int count,
+			       address_type addr, address_type limit)
+{
+    int lo = 0, hi = count;
+    while (lo < hi) {
+	int mid = lo + (hi - lo) / 2;
+	if (starts[mid] <= addr) {
+	    lo = mid + 1;
+	} else {
+	    hi = mid;
+	}
+    }
+    return (lo < count && starts[lo] < limit) ? starts[lo] : limit;
+}
+
+// Add the labels of the symbol table tab to dbg, each with the range
+// of addresses from it up to the next label (or the end of the text_words
+// of text), and its data names, as static variables
+static void add_debug_symbols(BOFDebugInfo *dbg, symtab_t *tab,
+			      int text_words)
+{
+    // the label addresses, sorted, give the ends of the ranges
+    int count = symtab_size(tab);
+    address_type *starts = (address_type *)
+	malloc((count > 0 ? count : 1) * sizeof(address_type));
+    if (starts == NULL) {
+	bail_with_error("No space for the labels' debugging information!");
+    }
+    int labels = 0;
+    const char *name = symtab_first_name(tab);
+    while (symtab_more_after(tab, name)) {
+	id_attrs_assoc *ida = symtab_lookup(tab, name);
+	if (ida->kind == id_label) {
+	    starts[labels++] = ida->addr;
+	}
+	name = symtab_next_name(tab, name);
+    }
+    qsort(starts, labels, sizeof(address_type), compare_addresses);
+    name = symtab_first_name(tab);
+    while (symtab_more_after(tab, name)) {
+	id_attrs_assoc *ida = symtab_lookup(tab, name);
+	if (ida->kind == id_label) {
+	    address_type end = next_start(starts, labels, ida->addr,
+					  text_words);
+	    bof_debug_add_symbol(dbg, name, debug_sym_label, ida->addr, end);
+	} else {
+	    bof_debug_add_variable(dbg, name, DEBUG_STATIC_LEVEL, ida->addr);
+	}
+	name = symtab_next_name(tab, name);
+    }
+    free(starts);
+}
+
+// Assemble the code for prog, whose symbol table is tab,
+// with output going to bf.
+// The program is built in memory and then written all at once,
+// so the header's section lengths come from what was built.
+// If debugging information is enabled, it follows the data section.
+void assembleProgram(BOFFILE bf, symtab_t *tab, ast_program_t prog)
 {
     BOFHeader bh;
-    bof_write_magic_to_header(&bh);
-    bh.text_start_address = addr2address(prog.textSection.entryPoint);
-    bh.text_length = ast_list_length(prog.textSection.instrs.instrs);
+    bh.text_start_address = addr2address(tab, prog.textSection.entryPoint);
     bh.data_start_address = prog.dataSection.static_start_addr;
-    // have to write the header first, so need to know the true size
-    // of the data section before writing the header
-    bh.data_length = assemble_dataSection_words(prog.dataSection);
     bh.stack_bottom_addr = prog.stackSection.stack_bottom_addr;
-    bof_write_header(bf, bh);
-    assembleTextSection(bf, prog.textSection);
-    assembleDataSection(bf, prog.dataSection);
+
+    BOFBuffer bb;
+    bof_buffer_initialize(&bb);
+    BOFDebugInfo dbg;
+    bof_debug_initialize(&dbg);
+    // release the buffer if assembly fails (e.g., for an undefined label)
+    error_context ec;
+    error_context_enter(&ec);
+    if (setjmp(ec.env) != 0) {
+	bof_buffer_free(&bb);
+	bof_debug_free(&dbg);
+	debug = NULL;
+	error_context_propagate(&ec);
+    }
+    if (debug_info_enabled) {
+	debug = &dbg;
+    }
+    assembleTextSection(&bb, tab, prog.textSection);
+    bof_buffer_end_text(&bb);
+    assembleDataSection(&bb, prog.dataSection);
+    if (debug != NULL) {
+	add_debug_symbols(&dbg, tab, bof_buffer_text_words(&bb));
+	bof_debug_add_to_buffer(&bb, &dbg);
+	debug = NULL;
+    }
+    error_context_leave(&ec);
+    bof_debug_free(&dbg);
     // nothing to do for the stack section, as it's all in the header
+    bof_buffer_write(bf, &bb, bh);
+}
+
+// Assemble instr, which has just been parsed, when assembling in one pass
+static void stream_asm_instr(ast_asm_instr_t instr)
+{
+    pass1AsmInstr(stream_tab, instr, bof_buffer_text_words(&stream_bb));
+    assembleAsmInstr(&stream_bb, stream_tab, instr);
+}
+
+// Assemble dcl, which has just been parsed, when assembling in one pass
+static void stream_static_decl(ast_static_decl_t dcl)
+{
+    if (stream_bb.text_end == 0) {
+	bof_buffer_end_text(&stream_bb);
+    }
+    pass1StaticDecl(stream_tab, dcl, stream_data_offset);
+    stream_data_offset += dcl.size_in_words;
+    assembleStaticDecl(&stream_bb, dcl);
+}
+
+// Start assembling the program that is about to be parsed in one pass,
+// building its symbol table in tab
+void assemble_stream_start(symtab_t *tab)
+{
+    symtab_initialize(tab);
+    stream_tab = tab;
+    bof_buffer_initialize(&stream_bb);
+    bof_debug_initialize(&stream_dbg);
+    if (debug_info_enabled) {
+	debug = &stream_dbg;
+    }
+    stream_data_offset = 0;
+    streaming = true;
+    ast_stream_handler_t handler;
+    handler.asm_instr = stream_asm_instr;
+    handler.static_decl = stream_static_decl;
+    ast_stream_start(handler);
+}
+
+// Put the address of each label that was used before it was defined
+// (from the symbol table tab) into the instruction in bb's text section
+// that used it (which is a jump, as only jumps use labels)
+static void patch_fixups(BOFBuffer *bb, symtab_t *tab)
+{
+    for (int i = 0; i < fixup_count; i++) {
+	const label_fixup *f = &fixups[i];
+	id_attrs_assoc *ida = symtab_lookup(tab, f->label);
+	if (ida == NULL) {
+	    bail_with_prog_error(f->file_loc,
+				 "Label \"%s\" was never defined!", f->label);
+	}
+	word_type *wp = bof_buffer_text_word(bb, f->word);
+	bin_instr_t bi = instruction_decode(*wp);
+	if (instruction_type(bi) != jump_instr_type) {
+	    bail_with_error("Bad instr_type in patch_fixups (%d)!",
+			    instruction_type(bi));
+	}
+	bi.jump.addr = (address_type) ida->addr;
+	*wp = instruction_encode(bi);
+    }
+}
+
+// Requires: assemble_stream_start(tab) was called before prog was parsed
+// Finish assembling prog in one pass, with output going to bf.
+// The instructions and static declarations have been assembled already,
+// so what is left is to patch the uses of labels that were defined
+// after them and to fill in the header.
+void assembleStreamedProgram(BOFFILE bf, symtab_t *tab, ast_program_t prog)
+{
+    assert(streaming && tab == stream_tab);
+    streaming = false;
+    stream_tab = NULL;
+    // release what was built if assembly fails (e.g., for an undefined label)
+    error_context ec;
+    error_context_enter(&ec);
+    if (setjmp(ec.env) != 0) {
+	bof_buffer_free(&stream_bb);
+	bof_debug_free(&stream_dbg);
+	free_fixups();
+	debug = NULL;
+	error_context_propagate(&ec);
+    }
+    BOFHeader bh;
+    bh.text_start_address = addr2address(tab, prog.textSection.entryPoint);
+    bh.data_start_address = prog.dataSection.static_start_addr;
+    bh.stack_bottom_addr = prog.stackSection.stack_bottom_addr;
+    patch_fixups(&stream_bb, tab);
+    if (stream_bb.text_end == 0) {
+	bof_buffer_end_text(&stream_bb);
+    }
+    if (debug != NULL) {
+	add_debug_symbols(&stream_dbg, tab, bof_buffer_text_words(&stream_bb));
+	bof_debug_add_to_buffer(&stream_bb, &stream_dbg);
+	debug = NULL;
+    }
+    error_context_leave(&ec);
+    bof_debug_free(&stream_dbg);
+    free_fixups();
+    bof_buffer_write(bf, &stream_bb, bh);
+}
+
+// Add the symbols defined in the symbol table tab to obj
+static void define_symbols(BOFObject *obj, symtab_t *tab)
+{
+    const char *name = symtab_first_name(tab);
+    while (symtab_more_after(tab, name)) {
+	id_attrs_assoc *ida = symtab_lookup(tab, name);
+	bof_object_define(obj, name,
+			  (ida->kind == id_label) ? obj_sym_text : obj_sym_data,
+			  ida->addr);
+	name = symtab_next_name(tab, name);
+    }
 }
 
-// Assemble the code for the given AST, with output going to bf
-void assembleTextSection(BOFFILE bf, ast_text_section_t ts)
+// Assemble prog, whose symbol table is tab, as a relocatable object,
+// with output going to bf, whose name is filename (in error messages).
+// The object exports all of prog's labels and data names,
+// and imports the labels it uses but does not define;
+// its jumps to its own labels are resolved in place
+// (and only moved by the linker to where its text lands).
+void assembleObject(BOFFILE bf, const char *filename, symtab_t *tab,
+		    ast_program_t prog)
 {
-    assembleAsmInstrs(bf, ts.instrs);
+    BOFObject obj;
+    bof_object_initialize(&obj, filename);
+    define_symbols(&obj, tab);
+
+    BOFHeader bh;
+    ast_addr_t entry = prog.textSection.entryPoint;
+    if (!entry.address_defined && !symtab_defined(tab, entry.label)) {
+	bail_with_prog_error(*(entry.file_loc),
+			     "Entry point label \"%s\" was never defined!",
+			     entry.label);
+    }
+    bh.text_start_address = addr2address(tab, entry);
+    bh.data_start_address = prog.dataSection.static_start_addr;
+    bh.stack_bottom_addr = prog.stackSection.stack_bottom_addr;
+
+    BOFBuffer bb;
+    bof_buffer_initialize(&bb);
+    error_context ec;
+    error_context_enter(&ec);
+    if (setjmp(ec.env) != 0) {
+	bof_buffer_free(&bb);
+	bof_object_free(&obj);
+	object = NULL;
+	error_context_propagate(&ec);
+    }
+    object = &obj;
+    assembleTextSection(&bb, tab, prog.textSection);
+    bof_buffer_end_text(&bb);
+    assembleDataSection(&bb, prog.dataSection);
+    object = NULL;
+    error_context_leave(&ec);
+    bof_object_write(bf, &obj, &bb, bh);
+    bof_object_free(&obj);
 }
 
-// Assemble the code for the given AST, with output going to bf
-void assembleAsmInstrs(BOFFILE bf, ast_asm_instrs_t instrs)
+// Assemble the code for the given AST, adding its output to bb
+void assembleTextSection(BOFBuffer *bb, symtab_t *tab, ast_text_section_t ts)
+{
+    assembleAsmInstrs(bb, tab, ts.instrs);
+}
+
+// Assemble the code for the given AST, adding its output to bb
+void assembleAsmInstrs(BOFBuffer *bb, symtab_t *tab, ast_asm_instrs_t instrs)
 {
     ast_asm_instr_t *ip = instrs.instrs;
     while (ip != NULL) {
-	assembleAsmInstr(bf, *ip);
+	assembleAsmInstr(bb, tab, *ip);
 	ip = ip->next;
     }
 }
 
-// Assemble the code for the given AST, with output going to bf
-void assembleAsmInstr(BOFFILE bf, ast_asm_instr_t instr)
+// Assemble the code for the given AST, adding its output to bb
+void assembleAsmInstr(BOFBuffer *bb, symtab_t *tab, ast_asm_instr_t instr)
 {
-    assembleInstr(bf, instr.instr);
+    if (debug != NULL) {
+	bof_debug_add_line(debug, bof_buffer_text_words(bb),
+			   instr.instr.file_loc->filename,
+			   instr.instr.file_loc->line);
+    }
+    assembleInstr(bb, tab, instr.instr);
 }
 
 // Return the value of the immedidate data AST immed
-static unsigned int immedData_value(ast_immedData_t immed)
+// (using the symbol table tab for the address of a label)
+static unsigned int immedData_value(symtab_t *tab, ast_immedData_t immed)
 {
     int ret = 0;
     switch (immed.id_data_kind) {
@@ -83,7 +448,7 @@ static unsigned int immedData_value(ast_immedData_t immed)
 	ret = immed.data.uimmed;
 	break;
     case id_addr:
-	return addr2address(immed.data.addr);
+	return addr2address(tab, immed.data.addr);
 	break;
     case id_empty:
 	ret = 0;
@@ -96,9 +461,10 @@ static unsigned int immedData_value(ast_immedData_t immed)
     return ret;
 }
 
-// Assemble the code for the given AST, with output going to bf
-void assembleInstr(BOFFILE bf, ast_instr_t instr)
+// Assemble the code for the given AST, adding its output to bb
+void assembleInstr(BOFBuffer *bb, symtab_t *tab, ast_instr_t instr)
 {
+    bin_instr_t bi;
     switch (instr.itype) {
     case comp_instr_type:
 	comp_instr_t ci;
@@ -109,7 +475,8 @@ void assembleInstr(BOFFILE bf, ast_instr_t instr)
 	ci.rs = instr.reg2;
 	ci.os = instr.offset2;
 	ci.func = instr.func;
-	instruction_write_compInstr(bf, ci);
+	bi.comp = ci;
+	add_instr(bb, bi);
 	break;
     case other_comp_instr_type:
 	other_comp_instr_t oci;
@@ -117,18 +484,20 @@ void assembleInstr(BOFFILE bf, ast_instr_t instr)
 	assert(oci.op == OTHC_O);
 	oci.reg = instr.reg;
 	oci.offset = instr.offset;
-	oci.arg = instr.immed_data.data.uimmed;
+	oci.arg = immedData_value(tab, instr.immed_data);
 	oci.func = instr.func;
-	instruction_write_otherCompInstr(bf, oci);
+	bi.othc = oci;
+	add_instr(bb, bi);
 	break;
     case syscall_instr_type:
 	syscall_instr_t si;
 	si.op = OTHC_O;
 	si.reg = instr.reg;
 	si.offset = instr.offset;
-	si.code = (syscall_type) immedData_value(instr.immed_data);
+	si.code = (syscall_type) immedData_value(tab, instr.immed_data);
 	si.func = SYS_F;
-	instruction_write_syscallInstr(bf, si);
+	bi.syscall = si;
+	add_instr(bb, bi);
 	break;
     case immed_instr_type:
 	switch (instr.opcode) {
@@ -137,24 +506,65 @@ void assembleInstr(BOFFILE bf, ast_instr_t instr)
 	    ui.op = instr.opcode;
 	    ui.reg = instr.reg;
 	    ui.offset = instr.offset;
-	    ui.uimmed = immedData_value(instr.immed_data);
-	    instruction_write_uimmedInstr(bf, ui);
+	    ui.uimmed = immedData_value(tab, instr.immed_data);
+	    bi.uimmed = ui;
+	    add_instr(bb, bi);
 	    break;
 	default:
 	    immed_instr_t ii;
 	    ii.op = instr.opcode;
 	    ii.reg = instr.reg;
 	    ii.offset = instr.offset;
-	    ii.immed = (immediate_type) immedData_value(instr.immed_data);
-	    instruction_write_immedInstr(bf, ii);
+	    ii.immed = (immediate_type) immedData_value(tab, instr.immed_data);
+	    bi.immed = ii;
+	    add_instr(bb, bi);
 	    break;
 	}
 	break;
+    case reg_comp_instr_type:
+	reg_comp_instr_t rci;
+	memset(&rci, 0, sizeof(rci));
+	rci.op = instr.opcode;
+	rci.rd = instr.reg;
+	rci.rop = (reg_op_code) instr.subfunc;
+	rci.rs = instr.reg2;
+	rci.rt = instr.reg3;
+	rci.func = instr.func;
+	bi.rcomp = rci;
+	add_instr(bb, bi);
+	break;
+    case reg_branch_instr_type:
+	reg_branch_instr_t rbi;
+	rbi.op = instr.opcode;
+	rbi.rs = instr.reg;
+	rbi.rt = instr.reg2;
+	rbi.cmp = (reg_branch_code) instr.subfunc;
+	rbi.offset = (arg_type) immedData_value(tab, instr.immed_data);
+	rbi.func = instr.func;
+	bi.rbranch = rbi;
+	add_instr(bb, bi);
+	break;
     case jump_instr_type:
 	jump_instr_t ji;
 	ji.op = instr.opcode;
-	ji.addr = (address_type) immedData_value(instr.immed_data);
-	instruction_write_jumpInstr(bf, ji);
+	if (object != NULL && instr.immed_data.id_data_kind == id_addr
+	    && !instr.immed_data.data.addr.address_defined) {
+	    const char *label = instr.immed_data.data.addr.label;
+	    id_attrs_assoc *ida = symtab_lookup(tab, label);
+	    if (ida != NULL && ida->kind == id_label) {
+		// the linker adds the start of this object's text
+		bof_object_add_reloc(object, bof_buffer_text_words(bb),
+				     obj_reloc_text, -1);
+	    } else {
+		// the linker puts in the label's address
+		bof_object_add_reloc(object, bof_buffer_text_words(bb),
+				     obj_reloc_jump,
+				     bof_object_symbol(object, label));
+	    }
+	}
+	ji.addr = (address_type) immedData_value(tab, instr.immed_data);
+	bi.jump = ji;
+	add_instr(bb, bi);
 	break;
     default:
 	bail_with_error("Bad instr_type in assembleInstr (%d)!", instr.itype);
@@ -162,75 +572,592 @@ void assembleInstr(BOFFILE bf, ast_instr_t instr)
     }
 }
 
-// return the size (in words) of the data section's declarations
-unsigned int assemble_dataSection_words(ast_data_section_t ds)
+// Assemble the code for the given AST, adding its output to bb
+void assembleDataSection(BOFBuffer *bb, ast_data_section_t ds)
 {
-    return assemble_staticDecls_words(ds.staticDecls);
+    assembleStaticDecls(bb, ds.staticDecls);
 }
 
-// return the size (in words) of the given static declarations
-unsigned int assemble_staticDecls_words(ast_static_decls_t sds)
+// Assemble the code for the given AST, adding its output to bb
+void assembleStaticDecls(BOFBuffer *bb, ast_static_decls_t sds)
 {
-    int ret = 0;
     ast_static_decl_t *dcl = sds.decls;
     while (dcl != NULL) {
-	ret += assemble_staticDecl_words(*dcl);
+	assembleStaticDecl(bb, *dcl);
 	dcl = dcl->next;
     }
-    return ret;
 }
 
-// return the size (in words) of the given static declarations
-unsigned int assemble_staticDecl_words(ast_static_decl_t sd)
+// Assemble the code for the given AST, adding its output to bb
+void assembleStaticDecl(BOFBuffer *bb, ast_static_decl_t dcl)
 {
-    return sd.size_in_words;
+    switch (dcl.initializer.kind) {
+    case initzlr_k_number: case initzlr_k_char:
+	bof_buffer_add_word(bb, dcl.initializer.num_value);
+	break;
+    case initzlr_k_string:
+	assert(dcl.initializer.byte_size <= dcl.size_in_words * BYTES_PER_WORD);
+	// the string's chars (but not its null char) are written,
+	// padded to a whole word, and the rest of its space is zeros
+	// (which are not written if they are trailing, see BOFZeroFill)
+	int len = dcl.initializer.byte_size - 1;
+	bof_buffer_add_bytes(bb, len, dcl.initializer.str_value);
+	if (len % BYTES_PER_WORD != 0) {
+	    static const char zeros[BYTES_PER_WORD] = { 0 };
+	    bof_buffer_add_bytes(bb, BYTES_PER_WORD - (len % BYTES_PER_WORD),
+				 zeros);
+	}
+	bof_buffer_add_zeros(bb, dcl.size_in_words
+			     - (len + BYTES_PER_WORD - 1) / BYTES_PER_WORD);
+	break;
+    case initzlr_k_none:
+	// trailing uninitialized data is not written (see BOFZeroFill)
+	bof_buffer_add_zeros(bb, dcl.size_in_words);
+	break;
+    default:
+	bail_with_error("Unknown declaration kind (%d) in assembleStaticDecl!",
+			dcl.initializer.kind);
+	break;
+    }
 }
 
-// Assemble the code for the given AST, with output going to bf
-void assembleDataSection(BOFFILE bf, ast_data_section_t ds)
+// Peephole optimization (see assemble_optimize).
+// The text section is viewed as an array of instructions, each with
+// the binary instruction it assembles to (found by assembling it),
+// which is matched against the patterns in peephole_patterns.
+// Instructions are deleted by marking them dead, and an instruction that
+// branches or jumps does so to an index in the array, so only at the end
+// are the addresses and offsets recomputed and written into the AST.
+
+// the text section being optimized
+typedef struct {
+    int count;                 // the number of instructions
+    ast_asm_instr_t **instrs;  // the AST of each instruction
+    bin_instr_t *bin;          // what each instruction assembles to
+    instr_id *ids;
+    bool *live;                // is the instruction still in the program?
+    bool *target;              // may control reach it other than
+                               // from the live instruction before it?
+    int *dest;                 // the index that a branch or jump goes to,
+                               // or -1 if it is not a branch or jump
+    int *next_live;            // used by resolve (see below)
+    int *walk;                 // used by end_of_jump_chain (see below)
+    int walks;
+    BOFBuffer scratch;         // where the instructions are assembled
+                               // (to find what they assemble to)
+    symtab_t *tab;             // the program's symbol table
+} peephole_text;
+
+// a pattern of length instructions in a row, which match recognizes
+// (given the indexes of the live instructions starting at a place)
+// and rewrite rewrites (by deleting instructions or changing them),
+// returning the number of instructions deleted
+typedef struct {
+    const char *description;
+    int length;
+    bool (*match)(peephole_text *pt, const int *w);
+    int (*rewrite)(peephole_text *pt, const int *w);
+} peephole_pattern;
+
+// the longest pattern's length
+#define PEEPHOLE_MAX_LENGTH 2
+
+// statistics about what assemble_optimize did
+static _Thread_local int instrs_before_optimization = 0;
+static _Thread_local int instrs_after_optimization = 0;
+static _Thread_local const char *optimization_skipped = NULL;
+
+// Return the index of the first live instruction at or after i
+// (which is pt->count if there is none)
+static int resolve(peephole_text *pt, int i)
 {
-    assembleStaticDecls(bf, ds.staticDecls);
+    int r = i;
+    while (r < pt->count && !pt->live[r]) {
+	r = pt->next_live[r];
+    }
+    // compress the path, so later calls are quick
+    while (i < pt->count && !pt->live[i] && pt->next_live[i] != r) {
+	int next = pt->next_live[i];
+	pt->next_live[i] = r;
+	i = next;
+    }
+    return r;
 }
 
-// Assemble the code for the given AST, with output going to bf
-void assembleStaticDecls(BOFFILE bf, ast_static_decls_t sds)
+// Requires: pt->live[i]
+// Delete instruction i from pt
+// (if it may be branched to, the live instruction after it may now be)
+static void delete_instr(peephole_text *pt, int i)
 {
-    ast_static_decl_t *dcl = sds.decls;
-    while (dcl != NULL) {
-	assembleStaticDecl(bf, *dcl);
-	dcl = dcl->next;
+    pt->live[i] = false;
+    int r = resolve(pt, i);
+    if (pt->target[i] && r < pt->count) {
+	pt->target[r] = true;
     }
 }
 
-// Assemble the code for the given AST, with output going to bf
-void assembleStaticDecl(BOFFILE bf, ast_static_decl_t dcl)
+// Is instruction i an ARI or SRI that adds or subtracts 0,
+// an ADDI that adds 0, or a BORI or XORI with 0
+// (each of which changes nothing)?
+static bool match_no_effect(peephole_text *pt, const int *w)
 {
-    switch (dcl.initializer.kind) {
-    case initzlr_k_number: case initzlr_k_char:
-	bof_write_word(bf, dcl.initializer.num_value);
-	break;
-    case initzlr_k_string:
-	bof_write_bytes(bf, dcl.initializer.byte_size,
-			dcl.initializer.str_value);
-	// pad to word-align the space for the string
-	int padding_needed = ((dcl.size_in_words * BYTES_PER_WORD)
-			      - dcl.initializer.byte_size);
-	assert(padding_needed >= 0);
-	assert(((dcl.initializer.byte_size + padding_needed)
-		% BYTES_PER_WORD) == 0);
-	int zeros[2] = {0, 0};
-	for (int i = 0; i < padding_needed; i++) {
-	    bof_write_bytes(bf, 1, zeros);
+    const bin_instr_t *bi = &pt->bin[w[0]];
+    switch (pt->ids[w[0]]) {
+    case ARI_I: case SRI_I:
+	return bi->othc.arg == 0;
+    case ADDI_I:
+	return bi->immed.immed == 0;
+    case BORI_I: case XORI_I:
+	return bi->uimmed.uimmed == 0;
+    default:
+	return false;
+    }
+}
+
+// Delete the first instruction of w
+static int delete_first(peephole_text *pt, const int *w)
+{
+    delete_instr(pt, w[0]);
+    return 1;
+}
+
+// Delete the second instruction of w
+static int delete_second(peephole_text *pt, const int *w)
+{
+    delete_instr(pt, w[1]);
+    return 1;
+}
+
+// Delete both instructions of w
+static int delete_both(peephole_text *pt, const int *w)
+{
+    // the second goes first, so that if the first is a target,
+    // what follows both becomes one
+    delete_instr(pt, w[1]);
+    delete_instr(pt, w[0]);
+    return 2;
+}
+
+// Is w an ARI followed by an SRI (or the reverse)
+// of the same register and amount?
+static bool match_add_then_subtract(peephole_text *pt, const int *w)
+{
+    instr_id a = pt->ids[w[0]], b = pt->ids[w[1]];
+    const other_comp_instr_t *x = &pt->bin[w[0]].othc;
+    const other_comp_instr_t *y = &pt->bin[w[1]].othc;
+    return ((a == ARI_I && b == SRI_I) || (a == SRI_I && b == ARI_I))
+	&& x->reg == y->reg && x->arg == y->arg;
+}
+
+// Is w an SWR followed by an LWR that loads the word just stored
+// back into the register it came from?
+static bool match_store_then_load(peephole_text *pt, const int *w)
+{
+    const comp_instr_t *s = &pt->bin[w[0]].comp;
+    const comp_instr_t *l = &pt->bin[w[1]].comp;
+    return pt->ids[w[0]] == SWR_I && pt->ids[w[1]] == LWR_I
+	&& l->rt == s->rs && l->rs == s->rt && l->os == s->ot;
+}
+
+// Is w a CPW followed by a CPW that copies the word just copied
+// back to where it came from?
+static bool match_copy_then_copy_back(peephole_text *pt, const int *w)
+{
+    const comp_instr_t *c = &pt->bin[w[0]].comp;
+    const comp_instr_t *d = &pt->bin[w[1]].comp;
+    return pt->ids[w[0]] == CPW_I && pt->ids[w[1]] == CPW_I
+	&& d->rt == c->rs && d->ot == c->os
+	&& d->rs == c->rt && d->os == c->ot;
+}
+
+// Is instruction i a branch or jump (that does nothing else)?
+static bool is_branch(const peephole_text *pt, int i)
+{
+    switch (pt->ids[i]) {
+    case BEQ_I: case BGEZ_I: case BGTZ_I: case BLEZ_I: case BLTZ_I:
+    case BNE_I: case BREQ_I: case BRNE_I: case BRLT_I: case BRLE_I:
+    case BRGT_I: case BRGE_I: case JREL_I: case JMPA_I:
+	return true;
+    default:
+	return false;
+    }
+}
+
+// Is the instruction of w a branch or jump to the live instruction
+// after it (so it does nothing whether it is taken or not)?
+static bool match_branch_to_next(peephole_text *pt, const int *w)
+{
+    return is_branch(pt, w[0])
+	&& resolve(pt, pt->dest[w[0]]) == resolve(pt, w[0] + 1);
+}
+
+// Return the index of the end of the chain of JMPAs starting at i,
+// (i.e., the first live instruction reached from i that is not a JMPA),
+// or -1 if the chain is a loop
+static int end_of_jump_chain(peephole_text *pt, int i)
+{
+    // each JMPA in the chain is marked with the number of this walk,
+    // so coming to one that is already marked means the chain is a loop
+    pt->walks++;
+    i = resolve(pt, i);
+    while (i < pt->count && pt->ids[i] == JMPA_I) {
+	if (pt->walk[i] == pt->walks) {
+	    return -1;
 	}
-	break;
-    case initzlr_k_none:
-	for (int i = 0; i < (dcl.size_in_words); i++) {
-	    bof_write_word(bf, 0);
+	pt->walk[i] = pt->walks;
+	i = resolve(pt, pt->dest[i]);
+    }
+    return i;
+}
+
+// Is the instruction of w a JMPA or CALL to a JMPA
+// (which could go straight to where the chain of JMPAs ends)?
+static bool match_jump_to_jump(peephole_text *pt, const int *w)
+{
+    instr_id id = pt->ids[w[0]];
+    if (id != JMPA_I && id != CALL_I) {
+	return false;
+    }
+    int d = resolve(pt, pt->dest[w[0]]);
+    return d < pt->count && pt->ids[d] == JMPA_I
+	&& end_of_jump_chain(pt, d) >= 0;
+}
+
+// Make the JMPA or CALL of w go to where the chain of JMPAs it goes to ends
+static int jump_to_end_of_chain(peephole_text *pt, const int *w)
+{
+    pt->dest[w[0]] = end_of_jump_chain(pt, pt->dest[w[0]]);
+    return 0;
+}
+
+// the patterns, tried in this order at each instruction
+static peephole_pattern peephole_patterns[] = {
+    { "ARI, SRI, ADDI, BORI, or XORI with 0",
+      1, match_no_effect, delete_first },
+    { "ARI and SRI of the same amount",
+      2, match_add_then_subtract, delete_both },
+    { "LWR of the word just stored by SWR",
+      2, match_store_then_load, delete_second },
+    { "CPW back of the word just copied",
+      2, match_copy_then_copy_back, delete_second },
+    { "JMPA or CALL to a JMPA",
+      1, match_jump_to_jump, jump_to_end_of_chain },
+    { "branch or jump to the next instruction",
+      1, match_branch_to_next, delete_first },
+};
+
+#define NUM_PEEPHOLE_PATTERNS \
+    (sizeof(peephole_patterns) / sizeof(peephole_patterns[0]))
+
+// how often each pattern was rewritten, and how many instructions
+// were deleted by doing so
+static _Thread_local int pattern_rewrites[NUM_PEEPHOLE_PATTERNS];
+static _Thread_local int pattern_deletions[NUM_PEEPHOLE_PATTERNS];
+
+// Requires: instruction i is a branch or jump, or a CALL
+// Return the index of the instruction that instruction i goes to
+// (which may be out of the text section)
+static int branch_dest(const peephole_text *pt, int i)
+{
+    const bin_instr_t *bi = &pt->bin[i];
+    switch (instruction_type(*bi)) {
+    case immed_instr_type:
+	return i + machine_types_formOffset(bi->immed.immed);
+    case other_comp_instr_type:
+	return i + machine_types_formOffset(bi->othc.arg);
+    case reg_branch_instr_type:
+	return i + machine_types_formOffset(bi->rbranch.offset);
+    default:
+	return machine_types_formAddress(i, bi->jump.addr);
+    }
+}
+
+// Return a new array of n elements of elem_size bytes each
+static void *peephole_array(int n, size_t elem_size)
+{
+    void *ret = malloc((n > 0 ? n : 1) * elem_size);
+    if (ret == NULL) {
+	bail_with_error("No space to optimize %d instructions!", n);
+    }
+    return ret;
+}
+
+// Return true if some SWR instruction of pt saves $ra
+// at the offset os from its base register.
+static bool saves_ra_at(const peephole_text *pt, offset_type os)
+{
+    for (int j = 0; j < pt->count; j++) {
+	if (pt->ids[j] == SWR_I && pt->bin[j].comp.rs == RA
+	    && pt->bin[j].comp.ot == os) {
+	    return true;
 	}
-	break;
+    }
+    return false;
+}
+
+// Return true if the instruction at index i of pt computes
+// a new value for $ra (other than by a call, which puts a return
+// address there, or by an LWR from an offset at which the program
+// saves $ra, which reloads a saved return address,
+// as the compiler's procedure epilogues do).
+// A saved return address that is changed in memory before it is
+// reloaded is not detected.
+static bool computes_ra(const peephole_text *pt, int i)
+{
+    bin_instr_t bi = pt->bin[i];
+    switch (pt->ids[i]) {
+    case LWR_I:
+	return bi.comp.rt == RA && !saves_ra_at(pt, bi.comp.os);
+    case CPR_I:
+	return bi.comp.rt == RA;
+    case RADD_I: case RSUB_I: case RMUL_I: case RDIV_I:
+    case RAND_I: case RBOR_I: case RXOR_I: case RSLT_I:
+	return bi.rcomp.rd == RA;
+    case ARI_I: case SRI_I:
+	return bi.othc.reg == RA;
     default:
-	bail_with_error("Unknown declaration kind (%d) in assembleStaticDecl!",
-			dcl.initializer.kind);
-	break;
+	return false;
+    }
+}
+
+// Set up pt for the instructions of ts, whose entry point is at entry,
+// in the program whose symbol table is tab.
+// Return NULL if they can be optimized,
+// or otherwise a message saying why not.
+static const char *peephole_setup(peephole_text *pt, symtab_t *tab,
+				  ast_text_section_t ts, address_type entry)
+{
+    pt->tab = tab;
+    int n = 0;
+    for (ast_asm_instr_t *ip = ts.instrs.instrs; ip != NULL; ip = ip->next) {
+	n++;
+    }
+    pt->count = n;
+    pt->instrs = (ast_asm_instr_t **)
+	peephole_array(n, sizeof(ast_asm_instr_t *));
+    pt->bin = (bin_instr_t *) peephole_array(n, sizeof(bin_instr_t));
+    pt->ids = (instr_id *) peephole_array(n, sizeof(instr_id));
+    pt->live = (bool *) peephole_array(n, sizeof(bool));
+    pt->target = (bool *) peephole_array(n, sizeof(bool));
+    pt->dest = (int *) peephole_array(n, sizeof(int));
+    pt->next_live = (int *) peephole_array(n, sizeof(int));
+    pt->walk = (int *) peephole_array(n, sizeof(int));
+    pt->walks = 0;
+
+    // find what each instruction assembles to
+    bof_buffer_initialize(&pt->scratch);
+    int i = 0;
+    for (ast_asm_instr_t *ip = ts.instrs.instrs; ip != NULL; ip = ip->next) {
+	assembleInstr(&pt->scratch, tab, ip->instr);
+	pt->instrs[i] = ip;
+	pt->bin[i] = instruction_decode(*bof_buffer_text_word(&pt->scratch, i));
+	pt->ids[i] = instruction_id(pt->bin[i]);
+	pt->live[i] = true;
+	pt->target[i] = (ip->label_opt.name != NULL);
+	pt->next_live[i] = i + 1;
+	pt->walk[i] = 0;
+	i++;
+    }
+    bof_buffer_free(&pt->scratch);
+
+    // find where control can go other than to the next instruction
+    if (entry >= n) {
+	return "its entry point is not an instruction";
+    }
+    pt->target[entry] = true;
+    bool returns = false;
+    bool ra_computed = false;
+    for (i = 0; i < n; i++) {
+	pt->dest[i] = -1;
+	ra_computed = ra_computed || computes_ra(pt, i);
+	switch (pt->ids[i]) {
+	case SPWN_I: case COCR_I: case CSI_I: case JMP_I:
+	    return "it starts threads, coroutines, calls, or jumps at addresses it computes";
+	case RTN_I:
+	    returns = true;
+	    break;
+	case CALL_I:
+	    if (i + 1 < n) {
+		pt->target[i + 1] = true;  // where it returns to
+	    }
+	    pt->dest[i] = branch_dest(pt, i);
+	    break;
+	default:
+	    if (is_branch(pt, i)) {
+		pt->dest[i] = branch_dest(pt, i);
+	    }
+	    break;
+	}
+	if (pt->dest[i] >= 0 && pt->dest[i] < n) {
+	    pt->target[pt->dest[i]] = true;
+	} else if (pt->dest[i] != -1) {
+	    return "it branches outside of its text section";
+	}
+    }
+    if (returns && ra_computed) {
+	return "it returns to addresses it computes";
+    }
+    return NULL;
+}
+
+// Apply the patterns to pt until none match, counting what they do
+static void peephole_rewrite(peephole_text *pt)
+{
+    bool changed = true;
+    while (changed) {
+	changed = false;
+	for (int i = resolve(pt, 0); i < pt->count; i = resolve(pt, i + 1)) {
+	    for (size_t p = 0; p < NUM_PEEPHOLE_PATTERNS; p++) {
+		// the window is the pattern's length of live instructions,
+		// and control can only enter it at its start
+		const peephole_pattern *pat = &peephole_patterns[p];
+		int w[PEEPHOLE_MAX_LENGTH];
+		int len = 0;
+		for (int j = i; j < pt->count && len < pat->length;
+		     j = resolve(pt, j + 1)) {
+		    if (len > 0 && pt->target[j]) {
+			break;
+		    }
+		    w[len++] = j;
+		}
+		if (len == pat->length && pat->match(pt, w)) {
+		    pattern_rewrites[p]++;
+		    pattern_deletions[p] += pat->rewrite(pt, w);
+		    changed = true;
+		    if (!pt->live[i]) {
+			break;
+		    }
+		}
+	    }
+	}
+    }
+}
+
+// Write the instructions that are left in pt into ts,
+// with the addresses and offsets of branches and jumps recomputed,
+// and update the symbol table's labels and the entry point to match
+static void peephole_finish(peephole_text *pt, ast_text_section_t *ts)
+{
+    symtab_t *tab = pt->tab;
+    // the new address of each instruction (an instruction that was
+    // deleted has the address of the live instruction after it)
+    int *addrs = (int *) peephole_array(pt->count + 1, sizeof(int));
+    int live_count = 0;
+    for (int i = 0; i < pt->count; i++) {
+	if (pt->live[i]) {
+	    addrs[i] = live_count++;
+	}
+    }
+    addrs[pt->count] = live_count;
+    for (int i = 0; i < pt->count; i++) {
+	if (!pt->live[i]) {
+	    addrs[i] = addrs[resolve(pt, i)];
+	}
+    }
+
+    ast_asm_instr_t *prev = NULL;
+    ts->instrs.instrs = NULL;
+    for (int i = 0; i < pt->count; i++) {
+	if (!pt->live[i]) {
+	    continue;
+	}
+	ast_instr_t *instr = &pt->instrs[i]->instr;
+	if (pt->dest[i] >= 0 && instr->itype == jump_instr_type) {
+	    // (a jump's immediate data is always an address)
+	    ast_addr_t a = instr->immed_data.data.addr;
+	    a.address_defined = true;
+	    a.label = NULL;
+	    a.addr = addrs[pt->dest[i]];
+	    instr->immed_data = ast_immed_addr(a);
+	} else if (pt->dest[i] >= 0) {
+	    instr->immed_data = ast_immed_number(addrs[pt->dest[i]] - addrs[i]);
+	}
+	if (prev == NULL) {
+	    ts->instrs.instrs = pt->instrs[i];
+	} else {
+	    prev->next = pt->instrs[i];
+	}
+	prev = pt->instrs[i];
+    }
+    if (prev != NULL) {
+	prev->next = NULL;
+    }
+    ts->instrs.last = prev;
+
+    const char *name = symtab_first_name(tab);
+    while (symtab_more_after(tab, name)) {
+	id_attrs_assoc *ida = symtab_lookup(tab, name);
+	if (ida->kind == id_label) {
+	    ida->addr = addrs[ida->addr];
+	}
+	name = symtab_next_name(tab, name);
+    }
+    if (ts->entryPoint.address_defined) {
+	ts->entryPoint.addr = addrs[ts->entryPoint.addr];
+    }
+    instrs_after_optimization = live_count;
+    free(addrs);
+}
+
+// Release the storage of pt
+static void peephole_free(peephole_text *pt)
+{
+    free(pt->instrs);
+    free(pt->bin);
+    free(pt->ids);
+    free(pt->live);
+    free(pt->target);
+    free(pt->dest);
+    free(pt->next_live);
+    free(pt->walk);
+    bof_buffer_free(&pt->scratch);
+}
+
+// Requires: pass1 has built the symbol table tab for prog
+// Improve the text section of prog by rewriting the instructions
+// that match the peephole patterns above (deleting those that do nothing),
+// updating the addresses of the labels in tab to match
+void assemble_optimize(symtab_t *tab, ast_program_t *prog)
+{
+    peephole_text pt;
+    memset(&pt, 0, sizeof(pt));
+    // release pt if assembling an instruction fails
+    // (e.g., for an undefined label)
+    error_context ec;
+    error_context_enter(&ec);
+    if (setjmp(ec.env) != 0) {
+	peephole_free(&pt);
+	error_context_propagate(&ec);
+    }
+    address_type entry = addr2address(tab, prog->textSection.entryPoint);
+    memset(pattern_rewrites, 0, sizeof(pattern_rewrites));
+    memset(pattern_deletions, 0, sizeof(pattern_deletions));
+    optimization_skipped = peephole_setup(&pt, tab, prog->textSection,
+					  entry);
+    instrs_before_optimization = pt.count;
+    instrs_after_optimization = pt.count;
+    if (optimization_skipped == NULL) {
+	peephole_rewrite(&pt);
+	peephole_finish(&pt, &prog->textSection);
+    }
+    error_context_leave(&ec);
+    peephole_free(&pt);
+}
+
+// Print, on out, statistics about what assemble_optimize did
+void assemble_print_optimization_statistics(FILE *out)
+{
+    if (optimization_skipped != NULL) {
+	fprintf(out, "Not optimized, as %s\n", optimization_skipped);
+	return;
+    }
+    fprintf(out, "Optimization removed %d of %d instructions\n",
+	    instrs_before_optimization - instrs_after_optimization,
+	    instrs_before_optimization);
+    for (size_t p = 0; p < NUM_PEEPHOLE_PATTERNS; p++) {
+	if (pattern_rewrites[p] > 0) {
+	    fprintf(out, "%6d %s (%d removed)\n", pattern_rewrites[p],
+		    peephole_patterns[p].description, pattern_deletions[p]);
+	}
     }
 }
@@ -4,38 +4,79 @@
 #include <stdio.h>
 #include "ast.h"
 #include "bof.h"
+#include "symtab.h"
 
-// Generate code for prog, with output going to bf
-extern void assembleProgram(BOFFILE bf, ast_program_t prog);
+// Assemble programs with debugging information (see bof_debug.h),
+// which gives the source line of each instruction,
+// the range of addresses of each label, and the data names
+extern void assemble_enable_debug_info();
 
-// Generate code for the given AST, with output going to bf
-extern void assembleTextSection(BOFFILE bf, ast_text_section_t ts);
+// Assemble programs without debugging information (as is the default)
+extern void assemble_disable_debug_info();
 
-// Generate code for the given AST, with output going to bf
-extern void assembleAsmInstrs(BOFFILE bf, ast_asm_instrs_t instrs);
+// Generate code for prog, whose symbol table is tab, with output going to bf
+extern void assembleProgram(BOFFILE bf, symtab_t *tab, ast_program_t prog);
 
-// Generate code for the given AST, with output going to bf
-extern void assembleAsmInstr(BOFFILE bf, ast_asm_instr_t instr);
+// Requires: pass1 has built the symbol table tab for prog
+// Improve the text section of prog with peephole optimizations:
+// instructions that do nothing (such as an ADDI of 0, an ARI followed by
+// an SRI of the same amount, or a branch to the next instruction)
+// are deleted, and jumps to jumps go straight to where they end up.
+// The addresses of labels in tab and the offsets
+// of branches are changed to match.
+// (This assumes that control only goes to the labels, entry point,
+// targets of branches and jumps, and return addresses of calls,
+// so it does nothing to programs with SPWN, COCR, or CSI instructions.)
+extern void assemble_optimize(symtab_t *tab, ast_program_t *prog);
 
-// Generate code for the given AST, with output going to bf
-extern void assembleInstr(BOFFILE bf, ast_instr_t instr);
+// Print, on out, statistics about what assemble_optimize did
+// (how many instructions each pattern removed)
+extern void assemble_print_optimization_statistics(FILE *out);
 
-// return the size (in words) of the data section's declarations
-extern unsigned int assemble_dataSection_words(ast_data_section_t ds);
+// Start assembling the program that is about to be parsed in one pass:
+// each instruction and static declaration is assembled as soon as
+// it is parsed (see ast_stream_start), so the program's AST is not kept,
+// and the uses of labels that were not yet defined are patched
+// when the whole program has been parsed; its symbol table is built in tab
+extern void assemble_stream_start(symtab_t *tab);
 
-// return the size (in words) of the given static declarations
-extern unsigned int assemble_staticDecls_words(ast_static_decls_t sds);
+// Requires: assemble_stream_start(tab) was called before prog was parsed
+// Finish assembling prog in one pass, with output going to bf
+extern void assembleStreamedProgram(BOFFILE bf, symtab_t *tab,
+				    ast_program_t prog);
 
-// return the size (in words) of the given static declaration
-extern unsigned int assemble_staticDecl_words(ast_static_decl_t sd);
+// Generate a relocatable object (see bof_object.h) for prog,
+// whose symbol table is tab,
+// with output going to bf, whose name is filename (in error messages)
+extern void assembleObject(BOFFILE bf, const char *filename, symtab_t *tab,
+			   ast_program_t prog);
 
-// Generate code for the given AST, with output going to bf
-extern void assembleDataSection(BOFFILE bf, ast_data_section_t ds);
+// Generate code for the given AST, adding its output to bb
+// (tab is the program's symbol table)
+extern void assembleTextSection(BOFBuffer *bb, symtab_t *tab,
+				ast_text_section_t ts);
 
-// Generate code for the given AST, with output going to bf
-extern void assembleStaticDecls(BOFFILE bf, ast_static_decls_t sds);
+// Generate code for the given AST, adding its output to bb
+// (tab is the program's symbol table)
+extern void assembleAsmInstrs(BOFBuffer *bb, symtab_t *tab,
+			      ast_asm_instrs_t instrs);
 
-// Generate code for the given AST, with output going to bf
-extern void assembleStaticDecl(BOFFILE bf, ast_static_decl_t dcl);
+// Generate code for the given AST, adding its output to bb
+// (tab is the program's symbol table)
+extern void assembleAsmInstr(BOFBuffer *bb, symtab_t *tab,
+			     ast_asm_instr_t instr);
+
+// Generate code for the given AST, adding its output to bb
+// (tab is the program's symbol table)
+extern void assembleInstr(BOFBuffer *bb, symtab_t *tab, ast_instr_t instr);
+
+// Generate code for the given AST, adding its output to bb
+extern void assembleDataSection(BOFBuffer *bb, ast_data_section_t ds);
+
+// Generate code for the given AST, adding its output to bb
+extern void assembleStaticDecls(BOFBuffer *bb, ast_static_decls_t sds);
+
+// Generate code for the given AST, adding its output to bb
+extern void assembleStaticDecl(BOFBuffer *bb, ast_static_decl_t dcl);
 
 #endif
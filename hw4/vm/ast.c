@@ -2,9 +2,39 @@
 #include <string.h>
 #include <stdlib.h>
 #include "utilities.h"
+#include "arena.h"
 #include "ast.h"
 #include "lexer.h"
 
+// the handler given the instructions and static declarations
+// as they are parsed, if assembling in one pass (kept per thread)
+static _Thread_local ast_stream_handler_t stream_handler;
+static _Thread_local bool streaming = false;
+
+// Make the AST constructors give each instruction and static declaration
+// to handler instead of adding it to its list (so the text and data
+// sections' lists are empty), and allocate the space for
+// the tokens and ASTs within the lists from the arena (see arena.h)
+void ast_stream_start(ast_stream_handler_t handler)
+{
+    stream_handler = handler;
+    streaming = true;
+}
+
+// Requires: streaming
+// Note that a statement of a list has been given to the stream handler.
+// The first statement of a list (and what comes before it) is not
+// allocated from the arena, so it is kept; each statement after that
+// frees the space of the ones before the statement before it.
+static void stream_next()
+{
+    if (arena_started()) {
+	arena_flip();
+    } else {
+	arena_start();
+    }
+}
+
 // Return (a pointer to) the file location from an AST
 const file_location *ast_file_loc(AST t) {
     return t.generic.file_loc;
@@ -45,6 +75,11 @@ ast_program_t ast_program(ast_text_section_t textSec,
 ast_text_section_t ast_text_section(ast_token_t tok, ast_addr_t entryPoint,
 				    ast_asm_instrs_t instrs)
 {
+    if (streaming) {
+	// keep what has not been freed of the list's space, which includes
+	// the token after it (that the parser has already read)
+	arena_stop();
+    }
     ast_text_section_t ret;
     ret.file_loc = file_location_copy(tok.file_loc);
     ret.type_tag = text_section_ast;
@@ -99,13 +134,19 @@ ast_asm_instrs_t ast_asm_instrs_singleton(ast_asm_instr_t asminstr)
     ast_asm_instrs_t ret;
     ret.file_loc = asminstr.file_loc;
     ret.type_tag = asm_instrs_ast;
-    ast_asm_instr_t *p = (ast_asm_instr_t *)malloc(sizeof(ast_asm_instr_t));
-    if (p == NULL) {
-	bail_with_error("Cannot allocate space for an asm_instr!");
+    if (streaming) {
+	stream_handler.asm_instr(asminstr);
+	stream_next();
+	ret.instrs = NULL;
+	ret.last = NULL;
+	return ret;
     }
+    ast_asm_instr_t *p =
+	(ast_asm_instr_t *) arena_alloc(sizeof(ast_asm_instr_t));
     *p = asminstr;
     p->next = NULL;
     ret.instrs = p;
+    ret.last = p;
     return ret;
 }
 
@@ -113,19 +154,22 @@ ast_asm_instrs_t ast_asm_instrs_singleton(ast_asm_instr_t asminstr)
 ast_asm_instrs_t ast_asm_instrs_add(ast_asm_instrs_t lst, ast_asm_instr_t asminstr)
 {
     ast_asm_instrs_t ret = lst;
-    ast_asm_instr_t *p = (ast_asm_instr_t *)malloc(sizeof(ast_asm_instr_t));
-    if (p == NULL) {
-	bail_with_error("Cannot allocate space for an asm_instr!");
+    if (streaming) {
+	stream_handler.asm_instr(asminstr);
+	stream_next();
+	return ret;
     }
+    ast_asm_instr_t *p =
+	(ast_asm_instr_t *) arena_alloc(sizeof(ast_asm_instr_t));
     *p = asminstr;
     p->next = NULL;
     // splice p onto the end of lst.instrs
-    ast_asm_instr_t *last = ast_last_list_elem(lst.instrs);
-    if (last == NULL) {
+    if (lst.last == NULL) {
 	ret.instrs = p;
     } else {
-	last->next = p;
+	lst.last->next = p;
     }
+    ret.last = p;
     return ret;
 }
 
@@ -283,11 +327,62 @@ ast_instr_t ast_1reg_instr(ast_token_t op, instr_type itype,
     return ret;
 }
 
+// Return an instruction AST
+// for a register computational instruction (rd = rs op rt)
+ast_instr_t ast_3reg_instr(ast_token_t op, unsigned short rd,
+			   unsigned short rs, unsigned short rt)
+{
+    ast_instr_t ret;
+    ret.file_loc = file_location_copy(op.file_loc);
+    ret.type_tag = instr_ast;
+    ret.next = NULL;
+    ret.itype = reg_comp_instr_type;
+    ret.opname = op.text;
+    ret.opcode = lexer_token2opcode(op.toknum);
+    ret.func = lexer_token2func(op.toknum);
+    ret.subfunc = lexer_token2regop(op.toknum);
+    ret.regs_used = 3;
+    ret.reg = rd;
+    ret.offset = 0;  // offsets are not used
+    ret.reg2 = rs;
+    ret.offset2 = 0;
+    ret.reg3 = rt;
+    ret.immed_data = ast_immed_none();
+    return ret;
+}
+
+// Return an instruction AST for a register branch instruction
+// that compares registers rs and rt and branches by the offset in im
+ast_instr_t ast_reg_branch_instr(ast_token_t op, unsigned short rs,
+				 unsigned short rt, ast_immedData_t im)
+{
+    ast_instr_t ret;
+    ret.file_loc = file_location_copy(op.file_loc);
+    ret.type_tag = instr_ast;
+    ret.next = NULL;
+    ret.itype = reg_branch_instr_type;
+    ret.opname = op.text;
+    ret.opcode = lexer_token2opcode(op.toknum);
+    ret.func = lexer_token2func(op.toknum);
+    ret.subfunc = lexer_token2regcmp(op.toknum);
+    ret.regs_used = 2;
+    ret.reg = rs;
+    ret.offset = 0;  // offsets are not used
+    ret.reg2 = rt;
+    ret.offset2 = 0;
+    ret.reg3 = 0;    // reg3 is not used
+    ret.immed_data = im;
+    return ret;
+}
+
 // Return an AST for the data section AST
 // with the given list of static declarations.
 ast_data_section_t ast_data_section(ast_token_t kw, unsigned int static_start,
 				    ast_static_decls_t staticDecls)
 {
+    if (streaming) {
+	arena_stop();
+    }
     ast_data_section_t ret;
     ret.file_loc = file_location_copy(kw.file_loc);
     ret.type_tag = data_section_ast;
@@ -303,6 +398,7 @@ ast_static_decls_t ast_static_decls_empty(ast_empty_t e)
     ret.file_loc = file_location_copy(e.file_loc);
     ret.type_tag = static_decls_ast;
     ret.decls = NULL;
+    ret.last = NULL;
     return ret;
 }
 
@@ -312,19 +408,22 @@ ast_static_decls_t ast_static_decls_add(ast_static_decls_t sds,
 				    ast_static_decl_t sd)
 {
     ast_static_decls_t ret = sds;
-    ast_static_decl_t *p = (ast_static_decl_t *)malloc(sizeof(ast_static_decl_t));
-    if (p == NULL) {
-	bail_with_error("Cannot allocate space for a static_decl!");
+    if (streaming) {
+	stream_handler.static_decl(sd);
+	stream_next();
+	return ret;
     }
+    ast_static_decl_t *p =
+	(ast_static_decl_t *) arena_alloc(sizeof(ast_static_decl_t));
     *p = sd;
     p->next = NULL;
     // splice p onto the end of sds.decls
-    ast_static_decl_t *last = ast_last_list_elem(sds.decls);
-    if (last == NULL) {
+    if (sds.last == NULL) {
 	ret.decls = p;
     } else {
-	last->next = p;
+	sds.last->next = p;
     }
+    ret.last = p;
     return ret;
 }
 
@@ -333,12 +432,11 @@ ast_static_decls_t ast_static_decls_add(ast_static_decls_t sds,
 ast_data_size_t ast_data_size(ast_token_t kw, data_size_e dse,
 			      unsigned short words)
 {
-    extern char *strdup(const char *s);
     ast_data_size_t ret;
     ret.file_loc = file_location_copy(kw.file_loc);
     ret.type_tag = data_size_ast;
     ret.dse = dse;
-    ret.size_name = strdup(kw.text);
+    ret.size_name = arena_strdup(kw.text);
     ret.size_in_words = words;
     return ret;
 }
@@ -151,6 +151,8 @@ typedef struct ast_instr_s {
     offset_type offset;
     reg_num_type reg2;  // if there are two of registers
     offset_type offset2;
+    reg_num_type reg3;  // if there are three registers
+    unsigned short subfunc; // register operation or comparison code
     ast_immedData_t immed_data; // includes arg (the number alternative)
 } ast_instr_t;
 
@@ -168,6 +170,7 @@ typedef struct {
     file_location *file_loc;
     AST_type type_tag;
     ast_asm_instr_t *instrs;
+    ast_asm_instr_t *last;  // the last of instrs, so adding is quick
 } ast_asm_instrs_t;
 
 // initializer kinds
@@ -202,6 +205,7 @@ typedef struct {
     file_location *file_loc;
     AST_type type_tag;
     ast_static_decl_t *decls;
+    ast_static_decl_t *last;  // the last of decls (NULL if there are none)
 } ast_static_decls_t;
 
 // text-section ::= entry-point asmInstr*
@@ -275,6 +279,21 @@ extern unsigned int ast_line(AST t);
 // Return the type tag of the AST t
 extern AST_type ast_type_tag(AST t);
 
+// A stream handler is given each instruction and each static declaration
+// as soon as it is parsed, when assembling in one pass.
+// What it is given (and the tokens it was made from) is freed soon after
+// (see arena.h), so it must copy anything it keeps.
+typedef struct {
+    void (*asm_instr)(ast_asm_instr_t instr);
+    void (*static_decl)(ast_static_decl_t dcl);
+} ast_stream_handler_t;
+
+// Make the AST constructors give each instruction and static declaration
+// to handler instead of adding it to its list (so the text and data
+// sections' lists are empty), and allocate the space for
+// the tokens and ASTs within the lists from the arena (see arena.h)
+extern void ast_stream_start(ast_stream_handler_t handler);
+
 // Return an AST for a program,
 // which contains the given ASTs.
 extern ast_program_t ast_program(ast_text_section_t textSec,
@@ -347,6 +366,17 @@ extern ast_instr_t ast_1reg_instr(ast_token_t op, instr_type itype,
 				  unsigned short reg, offset_type offset,
 				  func_type func, ast_immedData_t im);
 
+// Return an instruction AST
+// for a register computational instruction (rd = rs op rt)
+extern ast_instr_t ast_3reg_instr(ast_token_t op, unsigned short rd,
+				  unsigned short rs, unsigned short rt);
+
+// Return an instruction AST for a register branch instruction
+// that compares registers rs and rt and branches by the offset in im
+extern ast_instr_t ast_reg_branch_instr(ast_token_t op, unsigned short rs,
+					unsigned short rt,
+					ast_immedData_t im);
+
 // Return an AST for the data section AST
 // with the given list of static declarations.
 extern ast_data_section_t ast_data_section(ast_token_t kw, unsigned int static_start, ast_static_decls_t staticDecls);
@@ -0,0 +1,306 @@
+/* $Id$ */
+#define _POSIX_C_SOURCE 200809L
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bof_archive.h"
+#include "utilities.h"
+
+// Return bytes rounded up to a whole number of words
+static size_t round_to_words(size_t bytes)
+{
+    return (bytes + BYTES_PER_WORD - 1) / BYTES_PER_WORD * BYTES_PER_WORD;
+}
+
+// Return true if the bytes bytes at offset lie within the size bytes
+// of an archive, starting on a word boundary
+static bool part_fits(word_type offset, word_type bytes, size_t size)
+{
+    return offset >= 0 && bytes >= 0
+	&& offset % BYTES_PER_WORD == 0
+	&& (size_t) offset <= size && (size_t) bytes <= size - offset;
+}
+
+// Check that ar's header, index, and names fit in it and make sense,
+// and that each member's contents fit in it.
+// If any errors are encountered, release ar and exit with an error message.
+static void check_archive(BOFArchive *ar)
+{
+    const char *msg = NULL;
+    const BOFArchiveHeader *hdr = (const BOFArchiveHeader *) ar->bytes;
+    size_t after_header = ar->size - sizeof(BOFArchiveHeader);
+    if (ar->size < sizeof(BOFArchiveHeader)) {
+	msg = "it is too small to have an archive header";
+    } else if (strncmp(hdr->magic, ARCHIVE_MAGIC, MAGIC_BUFFER_SIZE) != 0) {
+	msg = "it does not have an archive's magic number";
+    } else if (hdr->member_count < 0 || hdr->names_bytes <= 0
+	       || hdr->names_bytes % BYTES_PER_WORD != 0
+	       || (size_t) hdr->member_count
+	          > after_header / sizeof(BOFArchiveMember)
+	       || (size_t) hdr->names_bytes
+	          > after_header - hdr->member_count * sizeof(BOFArchiveMember)) {
+	msg = "its index does not fit in it";
+    }
+    if (msg == NULL) {
+	ar->member_count = hdr->member_count;
+	ar->members = (const BOFArchiveMember *) (hdr + 1);
+	ar->names = (const char *) (ar->members + ar->member_count);
+	ar->names_bytes = hdr->names_bytes;
+	if (ar->names[ar->names_bytes - 1] != '\0') {
+	    msg = "its names are not terminated";
+	}
+    }
+    for (int i = 0; msg == NULL && i < ar->member_count; i++) {
+	const BOFArchiveMember *m = &ar->members[i];
+	if (m->name < 0 || m->name >= ar->names_bytes
+	    || !part_fits(m->bof_offset, m->bof_bytes, ar->size)
+	    || !part_fits(m->input_offset, m->input_bytes, ar->size)
+	    || !part_fits(m->output_offset, m->output_bytes, ar->size)) {
+	    msg = "a member of its index does not fit in it";
+	}
+    }
+    if (msg != NULL) {
+	bof_archive_unmap(*ar);
+	bail_with_error("Bad archive %s: %s!", ar->filename, msg);
+    }
+}
+
+// Map the archive named filename into memory,
+// check that its header has the right magic number
+// and that its index and members fit in the file,
+// and return the BOFArchive for it.
+// Exit the program with an error if this fails.
+BOFArchive bof_archive_map(const char *filename)
+{
+    BOFArchive ar;
+    memset(&ar, 0, sizeof(ar));
+    ar.filename = filename;
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+	bail_with_error("Error opening file for reading: %s", filename);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+	close(fd);
+	bail_with_error("Cannot get the size of %s", filename);
+    }
+    ar.size = st.st_size;
+    if (ar.size > 0) {
+	void *p = mmap(NULL, ar.size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (p == MAP_FAILED) {
+	    close(fd);
+	    bail_with_error("Cannot map %s into memory", filename);
+	}
+	ar.bytes = p;
+    }
+    // the mapping stays valid after the file is closed
+    close(fd);
+    check_archive(&ar);
+    return ar;
+}
+
+// Release the given archive (unmapping its file)
+void bof_archive_unmap(BOFArchive ar)
+{
+    if (ar.bytes != NULL) {
+	munmap((void *) ar.bytes, ar.size);
+    }
+}
+
+// Return the name of member n of ar
+const char *bof_archive_member_name(const BOFArchive *ar, int n)
+{
+    assert(0 <= n && n < ar->member_count);
+    return ar->names + ar->members[n].name;
+}
+
+// Return the number of the member of ar named by which,
+// which is either a member's number (counting from 0) or its name.
+// Exit the program with an error if there is no such member.
+int bof_archive_find(const BOFArchive *ar, const char *which)
+{
+    if (which[0] != '\0' && strspn(which, "0123456789") == strlen(which)) {
+	long n = strtol(which, NULL, 10);
+	if (n >= ar->member_count) {
+	    bail_with_error("Archive %s has only %d members, not member %s!",
+			    ar->filename, ar->member_count, which);
+	}
+	return (int) n;
+    }
+    for (int i = 0; i < ar->member_count; i++) {
+	if (strcmp(bof_archive_member_name(ar, i), which) == 0) {
+	    return i;
+	}
+    }
+    bail_with_error("Archive %s has no member named %s!", ar->filename, which);
+    return -1;
+}
+
+// Requires: 0 <= n < ar->member_count
+// Check member n of ar and return the BOFImage for it
+// (which is not copied, so it is valid until ar is unmapped)
+// Exit the program with an error if the member is malformed.
+BOFImage bof_archive_image(const BOFArchive *ar, int n)
+{
+    assert(0 <= n && n < ar->member_count);
+    const BOFArchiveMember *m = &ar->members[n];
+    return bof_map_memory(bof_archive_member_name(ar, n),
+			  (const char *) ar->bytes + m->bof_offset,
+			  m->bof_bytes);
+}
+
+// Requires: 0 <= n < ar->member_count
+// Return the input of member n of ar, setting *bytesp to its size
+const char *bof_archive_input(const BOFArchive *ar, int n, size_t *bytesp)
+{
+    assert(0 <= n && n < ar->member_count);
+    *bytesp = ar->members[n].input_bytes;
+    return (const char *) ar->bytes + ar->members[n].input_offset;
+}
+
+// Requires: 0 <= n < ar->member_count
+// Return the expected output of member n of ar, setting *bytesp to its size
+const char *bof_archive_output(const BOFArchive *ar, int n, size_t *bytesp)
+{
+    assert(0 <= n && n < ar->member_count);
+    *bytesp = ar->members[n].output_bytes;
+    return (const char *) ar->bytes + ar->members[n].output_offset;
+}
+
+// Make sure that the array *arrp, which has room for *capp elements
+// of elem_size bytes each, has room for at least need elements
+static void grow(void **arrp, int *capp, int need, size_t elem_size)
+{
+    if (need <= *capp) {
+	return;
+    }
+    int cap = (*capp == 0) ? 16 : *capp;
+    while (cap < need) {
+	cap *= 2;
+    }
+    void *p = realloc(*arrp, cap * elem_size);
+    if (p == NULL) {
+	bail_with_error("No space to grow an archive's index!");
+    }
+    *arrp = p;
+    *capp = cap;
+}
+
+// Add the given number of bytes from buf to the contents of ab,
+// padded to a whole number of words, and return their offset
+// in the contents
+static word_type add_contents(BOFArchiveBuilder *ab, const void *buf,
+			      size_t bytes)
+{
+    size_t offset = ab->contents_bytes;
+    size_t padded = round_to_words(bytes);
+    if (offset + padded > ARCHIVE_MAX_BYTES) {
+	bail_with_error("Archive contents would be more than %lu bytes!",
+			(unsigned long) ARCHIVE_MAX_BYTES);
+    }
+    if (offset + padded > ab->contents_capacity) {
+	size_t cap = (ab->contents_capacity == 0)
+	    ? BUFSIZ : ab->contents_capacity;
+	while (offset + padded > cap) {
+	    cap *= 2;
+	}
+	char *p = (char *) realloc(ab->contents, cap);
+	if (p == NULL) {
+	    bail_with_error("No space to grow an archive to %lu bytes!",
+			    (unsigned long) cap);
+	}
+	ab->contents = p;
+	ab->contents_capacity = cap;
+    }
+    if (bytes > 0) {
+	memcpy(ab->contents + offset, buf, bytes);
+    }
+    memset(ab->contents + offset + bytes, 0, padded - bytes);
+    ab->contents_bytes += padded;
+    return (word_type) offset;
+}
+
+// Initialize ab to hold an empty archive
+void bof_archive_initialize(BOFArchiveBuilder *ab)
+{
+    memset(ab, 0, sizeof(BOFArchiveBuilder));
+}
+
+// Add a member named name to ab, whose binary object file
+// is the bof_bytes bytes starting at bof, with the given input
+// and expected output (each of which may be NULL if its size is 0).
+// Exit the program with an error if the binary object file is malformed.
+void bof_archive_add(BOFArchiveBuilder *ab, const char *name,
+		     const void *bof, size_t bof_bytes,
+		     const void *input, size_t input_bytes,
+		     const void *output, size_t output_bytes)
+{
+    grow((void **) &ab->members, &ab->member_capacity, ab->member_count + 1,
+	 sizeof(BOFArchiveMember));
+    BOFArchiveMember *m = &ab->members[ab->member_count];
+    // check the file where it will be kept (which is aligned for words)
+    m->bof_offset = add_contents(ab, bof, bof_bytes);
+    m->bof_bytes = bof_bytes;
+    bof_unmap(bof_map_memory(name, ab->contents + m->bof_offset, bof_bytes));
+    m->input_offset = add_contents(ab, input, input_bytes);
+    m->input_bytes = input_bytes;
+    m->output_offset = add_contents(ab, output, output_bytes);
+    m->output_bytes = output_bytes;
+
+    int len = strlen(name) + 1;
+    grow((void **) &ab->names, &ab->names_capacity, ab->names_bytes + len, 1);
+    m->name = ab->names_bytes;
+    memcpy(ab->names + ab->names_bytes, name, len);
+    ab->names_bytes += len;
+    ab->member_count++;
+}
+
+// Write the archive built in ab to the file named filename all at once,
+// then release ab's storage.
+// Exit the program with an error if this fails.
+void bof_archive_write(const char *filename, BOFArchiveBuilder *ab)
+{
+    // the names are padded to a whole number of words (at least one)
+    int names_bytes = round_to_words(ab->names_bytes + 1);
+    grow((void **) &ab->names, &ab->names_capacity, names_bytes, 1);
+    memset(ab->names + ab->names_bytes, 0, names_bytes - ab->names_bytes);
+
+    BOFArchiveHeader hdr;
+    memcpy(hdr.magic, ARCHIVE_MAGIC, MAGIC_BUFFER_SIZE);
+    hdr.member_count = ab->member_count;
+    hdr.names_bytes = names_bytes;
+
+    // make the members' offsets relative to the start of the archive
+    size_t base = sizeof(BOFArchiveHeader)
+	+ ab->member_count * sizeof(BOFArchiveMember) + names_bytes;
+    if (base + ab->contents_bytes > ARCHIVE_MAX_BYTES) {
+	bail_with_error("Archive %s would be more than %lu bytes!",
+			filename, (unsigned long) ARCHIVE_MAX_BYTES);
+    }
+    for (int i = 0; i < ab->member_count; i++) {
+	ab->members[i].bof_offset += base;
+	ab->members[i].input_offset += base;
+	ab->members[i].output_offset += base;
+    }
+
+    BOFFILE bf = bof_write_open(filename);
+    bof_write_bytes(bf, sizeof(hdr), &hdr);
+    if (ab->member_count > 0) {
+	bof_write_bytes(bf, ab->member_count * sizeof(BOFArchiveMember),
+			ab->members);
+    }
+    bof_write_bytes(bf, names_bytes, ab->names);
+    if (ab->contents_bytes > 0) {
+	bof_write_bytes(bf, ab->contents_bytes, ab->contents);
+    }
+    bof_close(bf);
+
+    free(ab->members);
+    free(ab->names);
+    free(ab->contents);
+    bof_archive_initialize(ab);
+}
@@ -0,0 +1,119 @@
+/* $Id$ */
+// Archives of binary object files (for the SSM)
+#ifndef _BOF_ARCHIVE_H
+#define _BOF_ARCHIVE_H
+#include <stdbool.h>
+#include <stddef.h>
+#include "machine_types.h"
+#include "bof.h"
+
+// An archive packs many binary object files (its members) into one file,
+// each with the input to run it on and the output it is expected to give
+// (either of which may be empty), so that a whole test corpus
+// can be mapped into memory at once and its members used in place.
+// It starts with a BOFArchiveHeader, whose magic number is ARCHIVE_MAGIC,
+// followed by the index (member_count BOFArchiveMembers),
+// then the members' names (names_bytes bytes, each name followed
+// by a null char, padded to a whole number of words),
+// and then the members' contents.
+// All offsets are in bytes from the start of the archive,
+// and each part of a member's contents starts on a word boundary
+// (so its binary object file can be used where it lies).
+#define ARCHIVE_MAGIC "BA32"
+
+// the most bytes an archive can have (as its offsets are words)
+#define ARCHIVE_MAX_BYTES ((size_t) 0x7fffffff)
+
+typedef struct {
+    char magic[MAGIC_BUFFER_SIZE];  // ARCHIVE_MAGIC (with no null char)
+    word_type member_count;
+    word_type names_bytes;
+} BOFArchiveHeader;
+
+// an entry in an archive's index
+typedef struct {
+    word_type name;             // offset of its name in the names
+    word_type bof_offset;       // where its binary object file is
+    word_type bof_bytes;        // and how many bytes it has
+    word_type input_offset;     // where the input to run it on is
+    word_type input_bytes;
+    word_type output_offset;    // where its expected output is
+    word_type output_bytes;
+} BOFArchiveMember;
+
+// an archive held in memory (mapped from its file),
+// whose index has been checked against its size
+typedef struct {
+    const char *filename;
+    int member_count;
+    const BOFArchiveMember *members;
+    const char *names;
+    int names_bytes;
+    const void *bytes;          // all of the file's bytes
+    size_t size;                // the size of the file in bytes
+} BOFArchive;
+
+// an archive being built up in memory, to be written by bof_archive_write
+typedef struct {
+    int member_count;
+    BOFArchiveMember *members;  // with offsets relative to contents
+    char *names;
+    int names_bytes;
+    char *contents;
+    size_t contents_bytes;
+    int member_capacity, names_capacity;
+    size_t contents_capacity;
+} BOFArchiveBuilder;
+
+// Map the archive named filename into memory,
+// check that its header has the right magic number
+// and that its index and members fit in the file,
+// and return the BOFArchive for it.
+// Exit the program with an error if this fails.
+extern BOFArchive bof_archive_map(const char *filename);
+
+// Release the given archive (unmapping its file)
+extern void bof_archive_unmap(BOFArchive ar);
+
+// Return the name of member n of ar
+extern const char *bof_archive_member_name(const BOFArchive *ar, int n);
+
+// Return the number of the member of ar named by which,
+// which is either a member's number (counting from 0) or its name.
+// Exit the program with an error if there is no such member.
+extern int bof_archive_find(const BOFArchive *ar, const char *which);
+
+// Requires: 0 <= n < ar->member_count
+// Check member n of ar and return the BOFImage for it
+// (which is not copied, so it is valid until ar is unmapped)
+// Exit the program with an error if the member is malformed.
+extern BOFImage bof_archive_image(const BOFArchive *ar, int n);
+
+// Requires: 0 <= n < ar->member_count
+// Return the input of member n of ar, setting *bytesp to its size
+extern const char *bof_archive_input(const BOFArchive *ar, int n,
+				     size_t *bytesp);
+
+// Requires: 0 <= n < ar->member_count
+// Return the expected output of member n of ar, setting *bytesp to its size
+extern const char *bof_archive_output(const BOFArchive *ar, int n,
+				      size_t *bytesp);
+
+// Initialize ab to hold an empty archive
+extern void bof_archive_initialize(BOFArchiveBuilder *ab);
+
+// Add a member named name to ab, whose binary object file
+// is the bof_bytes bytes starting at bof, with the given input
+// and expected output (each of which may be NULL if its size is 0).
+// Exit the program with an error if the binary object file is malformed.
+extern void bof_archive_add(BOFArchiveBuilder *ab, const char *name,
+			    const void *bof, size_t bof_bytes,
+			    const void *input, size_t input_bytes,
+			    const void *output, size_t output_bytes);
+
+// Write the archive built in ab to the file named filename all at once,
+// then release ab's storage.
+// Exit the program with an error if this fails.
+extern void bof_archive_write(const char *filename, BOFArchiveBuilder *ab);
+
+#endif
@@ -41,21 +41,21 @@ static void usage(const char *cmdname)
 
 int main(int argc, char *argv[]) {
     if (argc >= 2) {
-	BOFFILE bf = bof_read_open(argv[1]);
-	size_t siz = bof_file_bytes(bf); // size in bytes
 	char *suffix = strchr(argv[1], '.');
 	if (suffix == NULL || strncmp(suffix, ".bof", 4) != 0) {
 	    usage(argv[0]);
 	}
+	BOFImage img = bof_map(argv[1]);
+	const word_type *words = (const word_type *) img.bytes;
+	size_t siz = img.size; // size in bytes
 
 	char bits_buff[BUFF_SIZE];
 	printf("Addr\t= Binary\t\t\t\t= Unsigned\t= Signed\t= Hexadecimal\n");
-	for (address_type a = 0;
-	    a*BYTES_PER_WORD < siz && !bof_at_eof(bf); a++) {
+	for (address_type a = 0; (a+1)*BYTES_PER_WORD <= siz; a++) {
 	    if (a == sizeof(BOFHeader) / BYTES_PER_WORD) {
 		printf("---- end of header ----\n");
 	    }
-	    word_type w = bof_read_word(bf);
+	    word_type w = words[a];
 	    printf("%hu:", a / BYTES_PER_WORD);
 	    printf("\t= %s", binrep((unsigned int) w,
 				      bits_buff));
@@ -63,6 +63,7 @@ int main(int argc, char *argv[]) {
 	    printf("\t= %10d", w);
 	    printf("\t= 0x%x\n", w);
 	}
+	bof_unmap(img);
     } else {
 	bail_with_error("Cannot read %s!", argv[1]);
     }
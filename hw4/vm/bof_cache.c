@@ -0,0 +1,576 @@
+/* $Id$ */
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include "bof_cache.h"
+
+// the name of the statistics file in the cache's directory
+#define STATISTICS_NAME "statistics"
+// the extension of the entries' names
+#define ENTRY_EXT ".bof"
+// the prefix of the names of temporary files
+#define TEMP_PREFIX ".tmp."
+
+/*** SHA-256 (see FIPS 180-4) ***/
+
+typedef struct {
+    uint32_t state[8];
+    uint64_t length;            // bytes hashed so far
+    unsigned char block[64];
+    size_t used;                // bytes in block
+} sha256_context;
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+// Initialize ctx to hash nothing yet
+static void sha256_init(sha256_context *ctx)
+{
+    static const uint32_t initial[8] = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    memcpy(ctx->state, initial, sizeof(initial));
+    ctx->length = 0;
+    ctx->used = 0;
+}
+
+// Hash the 64 byte block in ctx->block into ctx's state
+static void sha256_transform(sha256_context *ctx)
+{
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+	const unsigned char *p = &ctx->block[4*i];
+	w[i] = ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16)
+	    | ((uint32_t) p[2] << 8) | (uint32_t) p[3];
+    }
+    for (int i = 16; i < 64; i++) {
+	uint32_t s0 = ROTR(w[i-15], 7) ^ ROTR(w[i-15], 18) ^ (w[i-15] >> 3);
+	uint32_t s1 = ROTR(w[i-2], 17) ^ ROTR(w[i-2], 19) ^ (w[i-2] >> 10);
+	w[i] = w[i-16] + s0 + w[i-7] + s1;
+    }
+    uint32_t a = ctx->state[0], b = ctx->state[1], c = ctx->state[2],
+	d = ctx->state[3], e = ctx->state[4], f = ctx->state[5],
+	g = ctx->state[6], h = ctx->state[7];
+    for (int i = 0; i < 64; i++) {
+	uint32_t t1 = h + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25))
+	    + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+	uint32_t t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22))
+	    + ((a & b) ^ (a & c) ^ (b & c));
+	h = g;
+	g = f;
+	f = e;
+	e = d + t1;
+	d = c;
+	c = b;
+	b = a;
+	a = t1 + t2;
+    }
+    ctx->state[0] += a;
+    ctx->state[1] += b;
+    ctx->state[2] += c;
+    ctx->state[3] += d;
+    ctx->state[4] += e;
+    ctx->state[5] += f;
+    ctx->state[6] += g;
+    ctx->state[7] += h;
+}
+
+// Add the size bytes starting at data to what ctx has hashed
+static void sha256_update(sha256_context *ctx, const void *data, size_t size)
+{
+    const unsigned char *p = (const unsigned char *) data;
+    ctx->length += size;
+    while (size > 0) {
+	size_t n = sizeof(ctx->block) - ctx->used;
+	if (n > size) {
+	    n = size;
+	}
+	memcpy(&ctx->block[ctx->used], p, n);
+	ctx->used += n;
+	p += n;
+	size -= n;
+	if (ctx->used == sizeof(ctx->block)) {
+	    sha256_transform(ctx);
+	    ctx->used = 0;
+	}
+    }
+}
+
+// Finish hashing with ctx, putting the hash in result
+static void sha256_final(sha256_context *ctx,
+			 unsigned char result[BOF_CACHE_HASH_SIZE])
+{
+    uint64_t bits = ctx->length * 8;
+    static const unsigned char pad = 0x80;
+    static const unsigned char zero = 0;
+    sha256_update(ctx, &pad, 1);
+    while (ctx->used != 56) {
+	sha256_update(ctx, &zero, 1);
+    }
+    unsigned char len[8];
+    for (int i = 0; i < 8; i++) {
+	len[i] = (unsigned char) (bits >> (56 - 8*i));
+    }
+    sha256_update(ctx, len, sizeof(len));
+    for (int i = 0; i < 8; i++) {
+	result[4*i] = (unsigned char) (ctx->state[i] >> 24);
+	result[4*i+1] = (unsigned char) (ctx->state[i] >> 16);
+	result[4*i+2] = (unsigned char) (ctx->state[i] >> 8);
+	result[4*i+3] = (unsigned char) ctx->state[i];
+    }
+}
+
+/*** files ***/
+
+// Read the whole file named filename into a newly allocated buffer,
+// setting *sizep to its size and returning the buffer,
+// or return NULL if that cannot be done
+static unsigned char *read_file(const char *filename, size_t *sizep)
+{
+    FILE *f = fopen(filename, "rb");
+    if (f == NULL) {
+	return NULL;
+    }
+    size_t capacity = BUFSIZ;
+    size_t size = 0;
+    unsigned char *buf = (unsigned char *) malloc(capacity);
+    while (buf != NULL) {
+	size += fread(buf + size, 1, capacity - size, f);
+	if (size < capacity) {
+	    break;
+	}
+	capacity *= 2;
+	unsigned char *bigger = (unsigned char *) realloc(buf, capacity);
+	if (bigger == NULL) {
+	    free(buf);
+	}
+	buf = bigger;
+    }
+    if (buf != NULL && ferror(f)) {
+	free(buf);
+	buf = NULL;
+    }
+    fclose(f);
+    *sizep = size;
+    return buf;
+}
+
+// Write the size bytes in buf to the file named filename atomically,
+// by writing them to a temporary file in the same directory
+// and then renaming it, returning true if that worked
+static bool write_file_atomically(const char *filename,
+				  const unsigned char *buf, size_t size)
+{
+    char temp[BOF_CACHE_PATH_SIZE];
+    const char *slash = strrchr(filename, '/');
+    int dirlen = (slash == NULL) ? 0 : (int) (slash - filename + 1);
+    int n = snprintf(temp, sizeof(temp), "%.*s%sXXXXXX", dirlen, filename,
+		     TEMP_PREFIX);
+    if (n < 0 || n >= (int) sizeof(temp)) {
+	return false;
+    }
+    int fd = mkstemp(temp);
+    if (fd < 0) {
+	return false;
+    }
+    bool ok = true;
+    size_t written = 0;
+    while (ok && written < size) {
+	ssize_t w = write(fd, buf + written, size - written);
+	if (w < 0 && errno != EINTR) {
+	    ok = false;
+	} else if (w > 0) {
+	    written += w;
+	}
+    }
+    // outputs are made readable by others (as fopen would make them)
+    mode_t mask = umask(0);
+    umask(mask);
+    ok = ok && fchmod(fd, 0666 & ~mask) == 0;
+    ok = (close(fd) == 0) && ok;
+    ok = ok && rename(temp, filename) == 0;
+    if (!ok) {
+	unlink(temp);
+    }
+    return ok;
+}
+
+// Put the name of the file called name followed by ext
+// in cache's directory into buf (of size BOF_CACHE_PATH_SIZE),
+// returning false if it does not fit
+static bool cache_path(char *buf, const BOFCache *cache, const char *name,
+		       const char *ext)
+{
+    int n = snprintf(buf, BOF_CACHE_PATH_SIZE, "%s/%s%s", cache->dir,
+		     name, ext);
+    return n >= 0 && n < BOF_CACHE_PATH_SIZE;
+}
+
+/*** statistics ***/
+
+typedef struct {
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long evictions;
+} cache_statistics;
+
+// Lock (if type is F_WRLCK) or unlock (if it is F_UNLCK) the file open
+// as fd, waiting until that can be done, and return true if it was
+static bool lock_file(int fd, short type)
+{
+    struct flock fl;
+    memset(&fl, 0, sizeof(fl));
+    fl.l_type = type;
+    fl.l_whence = SEEK_SET;
+    int r;
+    do {
+	r = fcntl(fd, F_SETLKW, &fl);
+    } while (r != 0 && errno == EINTR);
+    return r == 0;
+}
+
+// Add the given counts to the statistics file of cache
+// (locking it, as other tools may be using the cache),
+// and put the resulting counts in *result if it is not NULL
+static void update_statistics(const BOFCache *cache, unsigned long hits,
+			      unsigned long misses, unsigned long evictions,
+			      cache_statistics *result)
+{
+    cache_statistics stats = {0, 0, 0};
+    char path[BOF_CACHE_PATH_SIZE];
+    int fd = -1;
+    if (cache_path(path, cache, STATISTICS_NAME, "")) {
+	fd = open(path, O_RDWR | O_CREAT, 0666);
+    }
+    if (fd >= 0 && lock_file(fd, F_WRLCK)) {
+	char buf[BUFSIZ];
+	ssize_t n = read(fd, buf, sizeof(buf) - 1);
+	buf[(n > 0) ? n : 0] = '\0';
+	if (sscanf(buf, "hits %lu\nmisses %lu\nevictions %lu",
+		   &stats.hits, &stats.misses, &stats.evictions) != 3) {
+	    stats.hits = stats.misses = stats.evictions = 0;
+	}
+	stats.hits += hits;
+	stats.misses += misses;
+	stats.evictions += evictions;
+	if (hits + misses + evictions > 0) {
+	    int len = snprintf(buf, sizeof(buf),
+			       "hits %lu\nmisses %lu\nevictions %lu\n",
+			       stats.hits, stats.misses, stats.evictions);
+	    // the counts are only advisory, so failing to write them is ignored
+	    if (ftruncate(fd, 0) == 0) {
+		ssize_t w = pwrite(fd, buf, len, 0);
+		(void) w;
+	    }
+	}
+	lock_file(fd, F_UNLCK);
+    }
+    if (fd >= 0) {
+	close(fd);
+    }
+    if (result != NULL) {
+	*result = stats;
+    }
+}
+
+/*** entries ***/
+
+// an entry of the cache, as found in its directory
+typedef struct {
+    char name[2 * BOF_CACHE_HASH_SIZE + sizeof(ENTRY_EXT)];
+    struct timespec used;       // when it was last used
+    off_t size;
+} cache_entry;
+
+// Return true if name is the name of a cache entry
+static bool is_entry_name(const char *name)
+{
+    size_t len = strlen(name);
+    return len == 2 * BOF_CACHE_HASH_SIZE + strlen(ENTRY_EXT)
+	&& strcmp(name + 2 * BOF_CACHE_HASH_SIZE, ENTRY_EXT) == 0
+	&& strspn(name, "0123456789abcdef") == 2 * BOF_CACHE_HASH_SIZE;
+}
+
+// Compare the entries pointed to by a and b by when they were used
+// (for qsort), least recently used first
+static int compare_entries(const void *a, const void *b)
+{
+    const struct timespec *ua = &((const cache_entry *) a)->used;
+    const struct timespec *ub = &((const cache_entry *) b)->used;
+    if (ua->tv_sec != ub->tv_sec) {
+	return (ua->tv_sec < ub->tv_sec) ? -1 : 1;
+    }
+    return (ua->tv_nsec < ub->tv_nsec) ? -1 : (ua->tv_nsec > ub->tv_nsec);
+}
+
+// Return a newly allocated array of the entries in cache,
+// setting *countp to its size and *totalp to their total size,
+// or return NULL if the directory cannot be read
+static cache_entry *list_entries(const BOFCache *cache, int *countp,
+				 long *totalp)
+{
+    DIR *d = opendir(cache->dir);
+    if (d == NULL) {
+	return NULL;
+    }
+    int count = 0, capacity = 16;
+    long total = 0;
+    cache_entry *entries = (cache_entry *) malloc(capacity
+						  * sizeof(cache_entry));
+    struct dirent *de;
+    while (entries != NULL && (de = readdir(d)) != NULL) {
+	char path[BOF_CACHE_PATH_SIZE];
+	struct stat st;
+	if (!is_entry_name(de->d_name)
+	    || !cache_path(path, cache, de->d_name, "")
+	    || stat(path, &st) != 0) {
+	    continue;
+	}
+	if (count == capacity) {
+	    capacity *= 2;
+	    cache_entry *bigger = (cache_entry *)
+		realloc(entries, capacity * sizeof(cache_entry));
+	    if (bigger == NULL) {
+		free(entries);
+	    }
+	    entries = bigger;
+	    if (entries == NULL) {
+		break;
+	    }
+	}
+	strcpy(entries[count].name, de->d_name);
+	entries[count].used = st.st_mtim;
+	entries[count].size = st.st_size;
+	total += st.st_size;
+	count++;
+    }
+    closedir(d);
+    *countp = count;
+    *totalp = total;
+    return entries;
+}
+
+// Remove the least recently used entries of cache
+// until they fit in its size bound, and return how many were removed
+static unsigned long evict(const BOFCache *cache)
+{
+    int count;
+    long total;
+    cache_entry *entries = list_entries(cache, &count, &total);
+    if (entries == NULL) {
+	return 0;
+    }
+    unsigned long evicted = 0;
+    if (total > cache->max_bytes) {
+	qsort(entries, count, sizeof(cache_entry), compare_entries);
+	for (int i = 0; i < count && total > cache->max_bytes; i++) {
+	    char path[BOF_CACHE_PATH_SIZE];
+	    if (cache_path(path, cache, entries[i].name, "")
+		&& unlink(path) == 0) {
+		total -= entries[i].size;
+		evicted++;
+	    }
+	}
+    }
+    free(entries);
+    return evicted;
+}
+
+/*** the cache ***/
+
+// Set up cache to use the directory named by BOF_CACHE_DIR_ENV
+// (creating it if need be), for outputs made by the running program,
+// whose name is cmdname, and return true,
+// or return false if there is to be no caching
+bool bof_cache_open(BOFCache *cache, const char *cmdname)
+{
+    const char *dir = getenv(BOF_CACHE_DIR_ENV);
+    if (dir == NULL || dir[0] == '\0' || strlen(dir) >= sizeof(cache->dir)) {
+	return false;
+    }
+    strcpy(cache->dir, dir);
+    if (mkdir(dir, 0777) != 0 && errno != EEXIST) {
+	return false;
+    }
+    cache->max_bytes = BOF_CACHE_DEFAULT_MAX_BYTES;
+    const char *max = getenv(BOF_CACHE_MAX_BYTES_ENV);
+    if (max != NULL && max[0] != '\0') {
+	char *end;
+	long m = strtol(max, &end, 10);
+	if (*end == '\0' && m >= 0) {
+	    cache->max_bytes = m;
+	}
+    }
+    // the tool is identified by its executable's contents,
+    // so that outputs of a different version are never used
+    size_t size;
+    unsigned char *exe = read_file("/proc/self/exe", &size);
+    if (exe == NULL) {
+	exe = read_file(cmdname, &size);
+    }
+    if (exe == NULL) {
+	return false;
+    }
+    sha256_context ctx;
+    sha256_init(&ctx);
+    sha256_update(&ctx, exe, size);
+    sha256_final(&ctx, cache->tool_hash);
+    free(exe);
+    cache->have_key = false;
+    return true;
+}
+
+// Make cache's current key the one for output made from the source file
+// named source_filename with the given options, and return true,
+// or return false if the source file cannot be read
+bool bof_cache_set_key(BOFCache *cache, const char *source_filename,
+		       const char *options)
+{
+    size_t size;
+    unsigned char *source = read_file(source_filename, &size);
+    if (source == NULL) {
+	return false;
+    }
+    sha256_context ctx;
+    sha256_init(&ctx);
+    sha256_update(&ctx, cache->tool_hash, sizeof(cache->tool_hash));
+    sha256_update(&ctx, options, strlen(options) + 1);
+    sha256_update(&ctx, source, size);
+    free(source);
+    unsigned char hash[BOF_CACHE_HASH_SIZE];
+    sha256_final(&ctx, hash);
+    for (int i = 0; i < BOF_CACHE_HASH_SIZE; i++) {
+	sprintf(&cache->key[2*i], "%02x", hash[i]);
+    }
+    cache->have_key = true;
+    return true;
+}
+
+// Requires: cache has a current key
+// If cache holds the output for its current key, copy it to the file
+// named output_filename, count a hit, and return true;
+// otherwise count a miss and return false
+bool bof_cache_fetch(BOFCache *cache, const char *output_filename)
+{
+    char path[BOF_CACHE_PATH_SIZE];
+    size_t size;
+    unsigned char *buf = NULL;
+    if (cache->have_key && cache_path(path, cache, cache->key, ENTRY_EXT)) {
+	buf = read_file(path, &size);
+    }
+    bool hit = buf != NULL && write_file_atomically(output_filename, buf, size);
+    free(buf);
+    if (hit) {
+	// mark the entry as just used (for the LRU eviction)
+	utimensat(AT_FDCWD, path, NULL, 0);
+    }
+    update_statistics(cache, hit, !hit, 0, NULL);
+    return hit;
+}
+
+// Write the size bytes in buf to the entry whose file is named path,
+// then remove the least recently used entries
+// if the entries use more than the cache's size bound
+static void store_entry(const BOFCache *cache, const char *path,
+			const unsigned char *buf, size_t size)
+{
+    if (write_file_atomically(path, buf, size)) {
+	unsigned long evicted = evict(cache);
+	if (evicted > 0) {
+	    update_statistics(cache, 0, 0, evicted, NULL);
+	}
+    }
+}
+
+// Requires: cache has a current key
+// Store the contents of the file named output_filename in cache
+// under its current key, then remove the least recently used entries
+// if the entries use more than the cache's size bound
+void bof_cache_store(BOFCache *cache, const char *output_filename)
+{
+    char path[BOF_CACHE_PATH_SIZE];
+    if (!cache->have_key || !cache_path(path, cache, cache->key, ENTRY_EXT)) {
+	return;
+    }
+    size_t size;
+    unsigned char *buf = read_file(output_filename, &size);
+    if (buf == NULL) {
+	return;
+    }
+    store_entry(cache, path, buf, size);
+    free(buf);
+}
+
+// Requires: cache has a current key
+// If cache holds the output for its current key, put a copy of it
+// in a newly allocated buffer, setting *bytesp to that buffer
+// and *sizep to its size, count a hit, and return true;
+// otherwise count a miss and return false
+bool bof_cache_fetch_memory(BOFCache *cache, char **bytesp, size_t *sizep)
+{
+    char path[BOF_CACHE_PATH_SIZE];
+    unsigned char *buf = NULL;
+    if (cache->have_key && cache_path(path, cache, cache->key, ENTRY_EXT)) {
+	buf = read_file(path, sizep);
+    }
+    bool hit = buf != NULL;
+    if (hit) {
+	// mark the entry as just used (for the LRU eviction)
+	utimensat(AT_FDCWD, path, NULL, 0);
+    }
+    update_statistics(cache, hit, !hit, 0, NULL);
+    *bytesp = (char *) buf;
+    return hit;
+}
+
+// Requires: cache has a current key
+// Store the size bytes starting at bytes in cache under its current key,
+// then remove the least recently used entries
+// if the entries use more than the cache's size bound
+void bof_cache_store_memory(BOFCache *cache, const char *bytes, size_t size)
+{
+    char path[BOF_CACHE_PATH_SIZE];
+    if (!cache->have_key || !cache_path(path, cache, cache->key, ENTRY_EXT)) {
+	return;
+    }
+    store_entry(cache, path, (const unsigned char *) bytes, size);
+}
+
+// Print the cache's statistics (hits, misses, evictions, and size) on out
+void bof_cache_print_statistics(FILE *out, const BOFCache *cache)
+{
+    cache_statistics stats;
+    update_statistics(cache, 0, 0, 0, &stats);
+    int count = 0;
+    long total = 0;
+    cache_entry *entries = list_entries(cache, &count, &total);
+    free(entries);
+    unsigned long lookups = stats.hits + stats.misses;
+    fprintf(out, "BOF cache %s: %lu hits, %lu misses (%.1f%% hits), "
+	    "%lu evictions, %d entries using %ld of %ld bytes\n",
+	    cache->dir, stats.hits, stats.misses,
+	    (lookups > 0) ? (100.0 * stats.hits) / lookups : 0.0,
+	    stats.evictions, count, total, cache->max_bytes);
+}
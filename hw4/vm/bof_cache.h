@@ -0,0 +1,83 @@
+/* $Id$ */
+// An on-disk cache of the binary object files made from source files,
+// so that tools can skip making one they have made before
+#ifndef _BOF_CACHE_H
+#define _BOF_CACHE_H
+#include <stdbool.h>
+#include <stdio.h>
+
+// The cache is a directory holding one file for each output,
+// named by its key (in hex), and a file of statistics.
+// The key of an output is the SHA-256 hash of the tool that made it
+// (the contents of its executable, so a rebuilt tool has new keys),
+// the options that affect its output, and its source file's contents.
+// Entries are written atomically (to a temporary file that is renamed),
+// so tools running at the same time never see partial entries.
+// When the entries take up more than the cache's size bound,
+// the least recently used ones (by modification time) are removed.
+
+// the environment variable naming the cache's directory
+// (if it is not set, there is no caching)
+#define BOF_CACHE_DIR_ENV "BOF_CACHE_DIR"
+// the environment variable giving the most bytes the entries may use
+#define BOF_CACHE_MAX_BYTES_ENV "BOF_CACHE_MAX_BYTES"
+#define BOF_CACHE_DEFAULT_MAX_BYTES (64L * 1024 * 1024)
+
+// the size of a SHA-256 hash in bytes
+#define BOF_CACHE_HASH_SIZE 32
+// the size of a buffer for a path name in the cache
+#define BOF_CACHE_PATH_SIZE 4096
+
+typedef struct {
+    char dir[BOF_CACHE_PATH_SIZE];
+    long max_bytes;
+    unsigned char tool_hash[BOF_CACHE_HASH_SIZE];
+    char key[2 * BOF_CACHE_HASH_SIZE + 1];  // the current key, in hex
+    bool have_key;
+} BOFCache;
+
+// Set up cache to use the directory named by BOF_CACHE_DIR_ENV
+// (creating it if need be), for outputs made by the running program,
+// whose name is cmdname, and return true,
+// or return false if there is to be no caching
+extern bool bof_cache_open(BOFCache *cache, const char *cmdname);
+
+// Make cache's current key the one for output made from the source file
+// named source_filename with the given options (which are those that
+// affect the output), and return true,
+// or return false if the source file cannot be read
+extern bool bof_cache_set_key(BOFCache *cache, const char *source_filename,
+			      const char *options);
+
+// Requires: cache has a current key
+// If cache holds the output for its current key, copy it to the file
+// named output_filename, count a hit, and return true;
+// otherwise count a miss and return false
+extern bool bof_cache_fetch(BOFCache *cache, const char *output_filename);
+
+// Requires: cache has a current key
+// Store the contents of the file named output_filename in cache
+// under its current key, then remove the least recently used entries
+// if the entries use more than the cache's size bound.
+// (As the cache only saves work, failures here are ignored.)
+extern void bof_cache_store(BOFCache *cache, const char *output_filename);
+
+// Requires: cache has a current key
+// If cache holds the output for its current key, put a copy of it
+// in a newly allocated buffer (which the caller frees), setting *bytesp
+// to that buffer and *sizep to its size, count a hit, and return true;
+// otherwise count a miss and return false
+// (for tools that keep their output in memory, not in a file)
+extern bool bof_cache_fetch_memory(BOFCache *cache, char **bytesp,
+				   size_t *sizep);
+
+// Requires: cache has a current key
+// Store the size bytes starting at bytes in cache under its current key,
+// as bof_cache_store does with the contents of a file
+extern void bof_cache_store_memory(BOFCache *cache, const char *bytes,
+				   size_t size);
+
+// Print the cache's statistics (hits, misses, evictions, and size) on out
+extern void bof_cache_print_statistics(FILE *out, const BOFCache *cache);
+
+#endif
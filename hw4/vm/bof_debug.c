@@ -0,0 +1,422 @@
+/* $Id$ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bof_debug.h"
+#include "utilities.h"
+
+// Make sure that the array *arrp, which has room for *capp elements
+// of elem_size bytes each, has room for at least need elements
+static void grow(void **arrp, int *capp, int need, size_t elem_size)
+{
+    if (need <= *capp) {
+	return;
+    }
+    int cap = (*capp == 0) ? 16 : *capp;
+    while (cap < need) {
+	cap *= 2;
+    }
+    void *p = realloc(*arrp, cap * elem_size);
+    if (p == NULL) {
+	bail_with_error("No space to grow the debugging information's tables!");
+    }
+    *arrp = p;
+    *capp = cap;
+}
+
+// Initialize dbg to hold no debugging information
+void bof_debug_initialize(BOFDebugInfo *dbg)
+{
+    memset(dbg, 0, sizeof(BOFDebugInfo));
+}
+
+// Add name to dbg's names and return its offset there
+static word_type add_name(BOFDebugInfo *dbg, const char *name)
+{
+    int len = strlen(name) + 1;
+    grow((void **) &dbg->names, &dbg->names_capacity,
+	 dbg->names_bytes + len, 1);
+    memcpy(dbg->names + dbg->names_bytes, name, len);
+    word_type ret = dbg->names_bytes;
+    dbg->names_bytes += len;
+    return ret;
+}
+
+// Return the name at offset name in dbg's names
+const char *bof_debug_name(const BOFDebugInfo *dbg, word_type name)
+{
+    return dbg->names + name;
+}
+
+// Return the index of the file named filename in dbg,
+// adding it if it is not there
+static int file_index(BOFDebugInfo *dbg, const char *filename)
+{
+    for (int i = 0; i < dbg->file_count; i++) {
+	if (strcmp(bof_debug_name(dbg, dbg->files[i]), filename) == 0) {
+	    return i;
+	}
+    }
+    grow((void **) &dbg->files, &dbg->file_capacity, dbg->file_count + 1,
+	 sizeof(word_type));
+    dbg->files[dbg->file_count] = add_name(dbg, filename);
+    return dbg->file_count++;
+}
+
+// Requires: addr is not less than the address of any line already added
+// Record that the code starting at addr comes from the given line
+// of the source file named filename
+// (an entry is only added if that changes the file or the line)
+void bof_debug_add_line(BOFDebugInfo *dbg, address_type addr,
+			const char *filename, unsigned int line)
+{
+    int file = file_index(dbg, filename);
+    if (dbg->line_count > 0) {
+	debug_line *last = &dbg->lines[dbg->line_count - 1];
+	assert(addr >= last->addr);
+	if (last->file == file && last->line == line) {
+	    return;
+	}
+	if (last->addr == addr) {
+	    // the last entry covered no code, so this one replaces it
+	    last->file = file;
+	    last->line = line;
+	    return;
+	}
+    }
+    grow((void **) &dbg->lines, &dbg->line_capacity, dbg->line_count + 1,
+	 sizeof(debug_line));
+    debug_line *dl = &dbg->lines[dbg->line_count++];
+    dl->addr = addr;
+    dl->file = file;
+    dl->line = line;
+}
+
+// Record that the addresses from start up to (but not including) end
+// are the symbol of the given kind named name
+void bof_debug_add_symbol(BOFDebugInfo *dbg, const char *name,
+			  debug_sym_kind kind,
+			  address_type start, address_type end)
+{
+    word_type n = add_name(dbg, name);
+    grow((void **) &dbg->symbols, &dbg->symbol_capacity,
+	 dbg->symbol_count + 1, sizeof(BOFDebugSymbol));
+    BOFDebugSymbol *sym = &dbg->symbols[dbg->symbol_count++];
+    sym->name = n;
+    sym->kind = kind;
+    sym->start = start;
+    sym->end = end;
+}
+
+// Record that the variable named name has the lexical address
+// given by level and offset (see BOFDebugVariable)
+void bof_debug_add_variable(BOFDebugInfo *dbg, const char *name,
+			    int level, int offset)
+{
+    word_type n = add_name(dbg, name);
+    grow((void **) &dbg->variables, &dbg->variable_capacity,
+	 dbg->variable_count + 1, sizeof(BOFDebugVariable));
+    BOFDebugVariable *var = &dbg->variables[dbg->variable_count++];
+    var->name = n;
+    var->level = level;
+    var->offset = offset;
+}
+
+// Add v to the end of bb as an unsigned varint
+static void add_varint(BOFBuffer *bb, uword_type v)
+{
+    while (v >= 0x80) {
+	unsigned char b = (v & 0x7f) | 0x80;
+	bof_buffer_add_bytes(bb, 1, &b);
+	v >>= 7;
+    }
+    unsigned char b = v;
+    bof_buffer_add_bytes(bb, 1, &b);
+}
+
+// Add zeros to the end of bb until its size is a whole number of words
+static void pad_to_word(BOFBuffer *bb)
+{
+    static const char zeros[BYTES_PER_WORD] = { 0 };
+    int extra = bb->size % BYTES_PER_WORD;
+    if (extra != 0) {
+	bof_buffer_add_bytes(bb, BYTES_PER_WORD - extra, zeros);
+    }
+}
+
+// Requires: the data section in bb is complete
+// Add the debugging section for dbg to the end of bb,
+// after its data section
+void bof_debug_add_to_buffer(BOFBuffer *bb, const BOFDebugInfo *dbg)
+{
+    bof_buffer_end_data(bb);
+    BOFDebugHeader dh;
+    memcpy(dh.magic, DEBUG_MAGIC, MAGIC_BUFFER_SIZE);
+    dh.file_count = dbg->file_count;
+    dh.line_count = dbg->line_count;
+    dh.symbol_count = dbg->symbol_count;
+    dh.variable_count = dbg->variable_count;
+    dh.names_bytes = ((dbg->names_bytes + BYTES_PER_WORD - 1)
+		      / BYTES_PER_WORD) * BYTES_PER_WORD;
+    // the line table's size is only known once it is encoded,
+    // so the header is filled in afterwards
+    size_t header_at = bb->size;
+    bof_buffer_add_bytes(bb, sizeof(dh), &dh);
+    if (dbg->file_count > 0) {
+	bof_buffer_add_bytes(bb, dbg->file_count * sizeof(word_type),
+			     dbg->files);
+    }
+
+    size_t lines_at = bb->size;
+    debug_line prev = { 0, 0, 0 };
+    for (int i = 0; i < dbg->line_count; i++) {
+	const debug_line *dl = &dbg->lines[i];
+	bool new_file = (dl->file != prev.file);
+	add_varint(bb, ((uword_type) (dl->addr - prev.addr) << 1) | new_file);
+	if (new_file) {
+	    add_varint(bb, dl->file);
+	}
+	word_type delta = (word_type) (dl->line - prev.line);
+	add_varint(bb, ((uword_type) delta << 1) ^ (uword_type) (delta >> 31));
+	prev = *dl;
+    }
+    pad_to_word(bb);
+    dh.line_bytes = bb->size - lines_at;
+    memcpy(bb->bytes + header_at, &dh, sizeof(dh));
+
+    if (dbg->symbol_count > 0) {
+	bof_buffer_add_bytes(bb, dbg->symbol_count * sizeof(BOFDebugSymbol),
+			     dbg->symbols);
+    }
+    if (dbg->variable_count > 0) {
+	bof_buffer_add_bytes(bb,
+			     dbg->variable_count * sizeof(BOFDebugVariable),
+			     dbg->variables);
+    }
+    if (dbg->names_bytes > 0) {
+	bof_buffer_add_bytes(bb, dbg->names_bytes, dbg->names);
+    }
+    pad_to_word(bb);
+}
+
+// Allocate a copy of the given number of bytes from buf
+static void *copy_bytes(const void *buf, size_t bytes)
+{
+    void *ret = malloc(bytes > 0 ? bytes : 1);
+    if (ret == NULL) {
+	bail_with_error("No space to allocate %lu bytes for debugging information!",
+			(unsigned long) bytes);
+    }
+    memcpy(ret, buf, bytes);
+    return ret;
+}
+
+// Read an unsigned varint from the bytes from *pp up to end into *vp,
+// advancing *pp past it, and return true,
+// or return false if it does not fit
+static bool read_varint(const unsigned char **pp, const unsigned char *end,
+			uword_type *vp)
+{
+    uword_type v = 0;
+    for (int shift = 0; *pp < end && shift < 8 * BYTES_PER_WORD; shift += 7) {
+	unsigned char b = *(*pp)++;
+	v |= (uword_type) (b & 0x7f) << shift;
+	if ((b & 0x80) == 0) {
+	    *vp = v;
+	    return true;
+	}
+    }
+    return false;
+}
+
+// Decode the line table of dbg (with line_count entries)
+// from the bytes from p up to end, returning false if it is malformed
+static bool decode_lines(BOFDebugInfo *dbg, int line_count,
+			 const unsigned char *p, const unsigned char *end)
+{
+    grow((void **) &dbg->lines, &dbg->line_capacity, line_count,
+	 sizeof(debug_line));
+    debug_line cur = { 0, 0, 0 };
+    for (int i = 0; i < line_count; i++) {
+	uword_type v;
+	if (!read_varint(&p, end, &v)) {
+	    return false;
+	}
+	cur.addr += v >> 1;
+	if (v & 1) {
+	    uword_type file;
+	    if (!read_varint(&p, end, &file) || file >= dbg->file_count) {
+		return false;
+	    }
+	    cur.file = file;
+	}
+	if (!read_varint(&p, end, &v)) {
+	    return false;
+	}
+	cur.line += (word_type) ((v >> 1) ^ -(v & 1));
+	dbg->lines[dbg->line_count++] = cur;
+    }
+    return true;
+}
+
+// Is the name at offset name in the names of dbg well-formed?
+static bool good_name(const BOFDebugInfo *dbg, word_type name)
+{
+    return name >= 0 && name < dbg->names_bytes
+	&& memchr(dbg->names + name, '\0', dbg->names_bytes - name) != NULL;
+}
+
+// Read the debugging section of img into dbg, returning true,
+// or, if img has no debugging section, leave dbg empty and return false.
+// Exit the program with an error if the debugging section is malformed.
+bool bof_debug_read(BOFImage img, BOFDebugInfo *dbg)
+{
+    bof_debug_initialize(dbg);
+    size_t start = img.sections_end;
+    BOFDebugHeader dh;
+    if (img.size < start + sizeof(dh)) {
+	return false;
+    }
+    const char *p = (const char *) img.bytes + start;
+    memcpy(&dh, p, sizeof(dh));
+    if (strncmp(dh.magic, DEBUG_MAGIC, MAGIC_BUFFER_SIZE) != 0) {
+	return false;
+    }
+    p += sizeof(dh);
+    uint64_t files_bytes = (uint64_t) dh.file_count * sizeof(word_type);
+    uint64_t sym_bytes = (uint64_t) dh.symbol_count * sizeof(BOFDebugSymbol);
+    uint64_t var_bytes = (uint64_t) dh.variable_count
+	* sizeof(BOFDebugVariable);
+    if (dh.file_count < 0 || dh.line_count < 0 || dh.line_bytes < 0
+	|| dh.symbol_count < 0 || dh.variable_count < 0 || dh.names_bytes < 0
+	|| dh.line_count > dh.line_bytes
+	|| start + sizeof(dh) + files_bytes + dh.line_bytes + sym_bytes
+	   + var_bytes + dh.names_bytes > img.size) {
+	bail_with_error("The sizes of the debugging information in %s are wrong!",
+			img.filename);
+    }
+    dbg->file_count = dbg->file_capacity = dh.file_count;
+    dbg->files = (word_type *) copy_bytes(p, files_bytes);
+    p += files_bytes;
+    const char *lines = p;
+    p += dh.line_bytes;
+    dbg->symbol_count = dbg->symbol_capacity = dh.symbol_count;
+    dbg->symbols = (BOFDebugSymbol *) copy_bytes(p, sym_bytes);
+    p += sym_bytes;
+    dbg->variable_count = dbg->variable_capacity = dh.variable_count;
+    dbg->variables = (BOFDebugVariable *) copy_bytes(p, var_bytes);
+    p += var_bytes;
+    dbg->names_bytes = dbg->names_capacity = dh.names_bytes;
+    dbg->names = (char *) copy_bytes(p, dh.names_bytes);
+
+    bool ok = decode_lines(dbg, dh.line_count,
+			   (const unsigned char *) lines,
+			   (const unsigned char *) lines + dh.line_bytes);
+    for (int i = 0; ok && i < dbg->file_count; i++) {
+	ok = good_name(dbg, dbg->files[i]);
+    }
+    for (int i = 0; ok && i < dbg->symbol_count; i++) {
+	ok = good_name(dbg, dbg->symbols[i].name);
+    }
+    for (int i = 0; ok && i < dbg->variable_count; i++) {
+	ok = good_name(dbg, dbg->variables[i].name);
+    }
+    if (!ok) {
+	bof_debug_free(dbg);
+	bail_with_error("The debugging information in %s is malformed!",
+			img.filename);
+    }
+    return true;
+}
+
+// Find the source location of the code at addr,
+// setting *filename and *line and returning true,
+// or return false if dbg does not know it
+bool bof_debug_find_line(const BOFDebugInfo *dbg, address_type addr,
+			 const char **filename, unsigned int *line)
+{
+    // binary search for the last entry whose address is at most addr
+    int lo = 0, hi = dbg->line_count;
+    while (lo < hi) {
+	int mid = lo + (hi - lo) / 2;
+	if (dbg->lines[mid].addr <= addr) {
+	    lo = mid + 1;
+	} else {
+	    hi = mid;
+	}
+    }
+    if (lo == 0) {
+	return false;
+    }
+    const debug_line *dl = &dbg->lines[lo - 1];
+    *filename = bof_debug_name(dbg, dbg->files[dl->file]);
+    *line = dl->line;
+    return true;
+}
+
+// Return the innermost symbol whose range contains addr,
+// or NULL if there is none
+const BOFDebugSymbol *bof_debug_find_symbol(const BOFDebugInfo *dbg,
+					    address_type addr)
+{
+    const BOFDebugSymbol *ret = NULL;
+    for (int i = 0; i < dbg->symbol_count; i++) {
+	const BOFDebugSymbol *sym = &dbg->symbols[i];
+	if (sym->start <= (word_type) addr && (word_type) addr < sym->end
+	    && (ret == NULL || sym->end - sym->start < ret->end - ret->start)) {
+	    ret = sym;
+	}
+    }
+    return ret;
+}
+
+// Return the variable whose lexical address is (level, offset),
+// or NULL if there is none
+const BOFDebugVariable *bof_debug_find_variable(const BOFDebugInfo *dbg,
+						int level, int offset)
+{
+    for (int i = 0; i < dbg->variable_count; i++) {
+	const BOFDebugVariable *var = &dbg->variables[i];
+	if (var->level == level && var->offset == offset) {
+	    return var;
+	}
+    }
+    return NULL;
+}
+
+// Format a description of addr, as "name+offset (file:line)",
+// leaving out what dbg does not know, into buf (of size size).
+// Return the number of chars written (0 if dbg knows nothing about addr).
+int bof_debug_format_location(char *buf, size_t size,
+			      const BOFDebugInfo *dbg, address_type addr)
+{
+    int len = 0;
+    buf[0] = '\0';
+    const BOFDebugSymbol *sym = bof_debug_find_symbol(dbg, addr);
+    if (sym != NULL) {
+	len += snprintf(buf, size, "%s", bof_debug_name(dbg, sym->name));
+	if ((word_type) addr != sym->start && len < (int) size) {
+	    len += snprintf(buf + len, size - len, "+%d",
+			    (word_type) addr - sym->start);
+	}
+    }
+    const char *filename;
+    unsigned int line;
+    if (bof_debug_find_line(dbg, addr, &filename, &line)
+	&& len < (int) size) {
+	len += snprintf(buf + len, size - len, "%s(%s:%u)",
+			(len > 0) ? " " : "", filename, line);
+    }
+    return (len < (int) size) ? len : (int) size - 1;
+}
+
+// Release the storage held by dbg
+void bof_debug_free(BOFDebugInfo *dbg)
+{
+    free(dbg->files);
+    free(dbg->lines);
+    free(dbg->symbols);
+    free(dbg->variables);
+    free(dbg->names);
+    bof_debug_initialize(dbg);
+}
@@ -0,0 +1,153 @@
+/* $Id$ */
+// Debugging information in binary object files (for the SSM)
+#ifndef _BOF_DEBUG_H
+#define _BOF_DEBUG_H
+#include <stdbool.h>
+#include "machine_types.h"
+#include "bof.h"
+
+// The debugging information is an optional section that follows
+// the data section of a binary object file (and its zero-fill record,
+// if it has one, see bof.h), so programs without it
+// are unchanged (and loaders that do not look for it ignore it).
+// It starts with a BOFDebugHeader, whose magic number is DEBUG_MAGIC,
+// and then has, in order:
+//   the source files (file_count words, each the offset of a name),
+//   the line table (line_bytes bytes, see below),
+//   the symbols (symbol_count BOFDebugSymbols),
+//   the variables (variable_count BOFDebugVariables),
+//   the names (names_bytes bytes, each name followed by a null char).
+// The line table and the names are padded to a whole number of words.
+// The line table has line_count entries, each saying that the code
+// starting at an address (up to the next entry's address) comes
+// from a line of a source file.  The entries are in address order,
+// and each is encoded relative to the one before it
+// (which for the first is address 0, file 0, line 0) as
+//   an unsigned varint: (address change << 1) | (1 if the file changed),
+//   the new file's number (an unsigned varint, only if it changed),
+//   the line change (a zigzag-encoded signed varint).
+// A varint has 7 bits per byte, least significant first,
+// with the high bit set in all bytes but the last.
+#define DEBUG_MAGIC "BDBG"
+
+typedef struct {
+    char magic[MAGIC_BUFFER_SIZE];  // DEBUG_MAGIC (with no null char)
+    word_type file_count;
+    word_type line_count;
+    word_type line_bytes;
+    word_type symbol_count;
+    word_type variable_count;
+    word_type names_bytes;
+} BOFDebugHeader;
+
+// kinds of symbols
+typedef enum {debug_sym_label = 0, debug_sym_procedure = 1} debug_sym_kind;
+
+// a named range of addresses in the text section
+typedef struct {
+    word_type name;     // offset of its name in the names
+    word_type kind;     // a debug_sym_kind
+    word_type start;    // the first address in the range
+    word_type end;      // the address just past the range
+} BOFDebugSymbol;
+
+// the level of static data, which is addressed from $gp
+#define DEBUG_STATIC_LEVEL (-1)
+
+// a variable and its lexical address: either static data
+// (level DEBUG_STATIC_LEVEL) at word offset offset from $gp,
+// or a variable declared in a block nested level blocks
+// inside the program (level 0), at word offset offset
+// from the $fp of that block's activation record
+typedef struct {
+    word_type name;     // offset of its name in the names
+    word_type level;
+    word_type offset;
+} BOFDebugVariable;
+
+// an entry in the (decoded) line table
+typedef struct {
+    address_type addr;
+    int file;           // index in the files
+    unsigned int line;
+} debug_line;
+
+// the debugging information for a program, held in memory
+// (either being built, to be written, or read from a file)
+typedef struct {
+    int file_count;
+    word_type *files;           // offsets of the files' names
+    int line_count;
+    debug_line *lines;          // in order of their addresses
+    int symbol_count;
+    BOFDebugSymbol *symbols;
+    int variable_count;
+    BOFDebugVariable *variables;
+    char *names;
+    int names_bytes;
+    int file_capacity, line_capacity, symbol_capacity,
+	variable_capacity, names_capacity;
+} BOFDebugInfo;
+
+// Initialize dbg to hold no debugging information
+extern void bof_debug_initialize(BOFDebugInfo *dbg);
+
+// Requires: addr is not less than the address of any line already added
+// Record that the code starting at addr comes from the given line
+// of the source file named filename
+// (an entry is only added if that changes the file or the line)
+extern void bof_debug_add_line(BOFDebugInfo *dbg, address_type addr,
+			       const char *filename, unsigned int line);
+
+// Record that the addresses from start up to (but not including) end
+// are the symbol of the given kind named name
+extern void bof_debug_add_symbol(BOFDebugInfo *dbg, const char *name,
+				 debug_sym_kind kind,
+				 address_type start, address_type end);
+
+// Record that the variable named name has the lexical address
+// given by level and offset (see BOFDebugVariable)
+extern void bof_debug_add_variable(BOFDebugInfo *dbg, const char *name,
+				   int level, int offset);
+
+// Requires: the data section in bb is complete
+// Add the debugging section for dbg to the end of bb,
+// after its data section
+extern void bof_debug_add_to_buffer(BOFBuffer *bb, const BOFDebugInfo *dbg);
+
+// Read the debugging section of img into dbg, returning true,
+// or, if img has no debugging section, leave dbg empty and return false.
+// Exit the program with an error if the debugging section is malformed.
+extern bool bof_debug_read(BOFImage img, BOFDebugInfo *dbg);
+
+// Find the source location of the code at addr,
+// setting *filename and *line and returning true,
+// or return false if dbg does not know it
+extern bool bof_debug_find_line(const BOFDebugInfo *dbg, address_type addr,
+				const char **filename, unsigned int *line);
+
+// Return the innermost symbol whose range contains addr,
+// or NULL if there is none
+extern const BOFDebugSymbol *bof_debug_find_symbol(const BOFDebugInfo *dbg,
+						   address_type addr);
+
+// Return the variable whose lexical address is (level, offset),
+// or NULL if there is none
+extern const BOFDebugVariable *bof_debug_find_variable(
+					      const BOFDebugInfo *dbg,
+					      int level, int offset);
+
+// Return the name at offset name in dbg's names
+extern const char *bof_debug_name(const BOFDebugInfo *dbg, word_type name);
+
+// Format a description of addr, as "name+offset (file:line)",
+// leaving out what dbg does not know, into buf (of size size).
+// Return the number of chars written (0 if dbg knows nothing about addr).
+extern int bof_debug_format_location(char *buf, size_t size,
+				     const BOFDebugInfo *dbg,
+				     address_type addr);
+
+// Release the storage held by dbg
+extern void bof_debug_free(BOFDebugInfo *dbg);
+
+#endif
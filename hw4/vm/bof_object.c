@@ -0,0 +1,277 @@
+/* $Id$ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bof_object.h"
+#include "utilities.h"
+
+// Allocate a copy of the given number of bytes from buf
+static void *copy_bytes(const void *buf, size_t bytes)
+{
+    void *ret = malloc(bytes > 0 ? bytes : 1);
+    if (ret == NULL) {
+	bail_with_error("No space to allocate %lu bytes for an object file!",
+			(unsigned long) bytes);
+    }
+    memcpy(ret, buf, bytes);
+    return ret;
+}
+
+// Make sure that the array *arrp, which has room for *capp elements
+// of elem_size bytes each, has room for at least need elements
+static void grow(void **arrp, int *capp, int need, size_t elem_size)
+{
+    if (need <= *capp) {
+	return;
+    }
+    int cap = (*capp == 0) ? 16 : *capp;
+    while (cap < need) {
+	cap *= 2;
+    }
+    void *p = realloc(*arrp, cap * elem_size);
+    if (p == NULL) {
+	bail_with_error("No space to grow an object file's tables!");
+    }
+    *arrp = p;
+    *capp = cap;
+}
+
+// Initialize obj to be an empty object named filename (in error messages)
+void bof_object_initialize(BOFObject *obj, const char *filename)
+{
+    memset(obj, 0, sizeof(BOFObject));
+    obj->filename = filename;
+    obj->header.text_start_address = -1;
+}
+
+// Return the index of the symbol named name in obj, or -1 if there is none
+static int find_symbol(const BOFObject *obj, const char *name)
+{
+    for (int i = 0; i < obj->symbol_count; i++) {
+	if (strcmp(bof_object_symbol_name(obj, i), name) == 0) {
+	    return i;
+	}
+    }
+    return -1;
+}
+
+// Return the index of the symbol named name in obj,
+// adding it (as an undefined symbol) if it is not there
+int bof_object_symbol(BOFObject *obj, const char *name)
+{
+    int i = find_symbol(obj, name);
+    if (i >= 0) {
+	return i;
+    }
+    // names are kept in a whole number of words
+    int len = strlen(name) + 1;
+    int padded = ((len + BYTES_PER_WORD - 1) / BYTES_PER_WORD) * BYTES_PER_WORD;
+    grow((void **) &obj->names, &obj->names_capacity,
+	 obj->names_bytes + padded, 1);
+    memset(obj->names + obj->names_bytes, 0, padded);
+    strcpy(obj->names + obj->names_bytes, name);
+
+    grow((void **) &obj->symbols, &obj->symbol_capacity,
+	 obj->symbol_count + 1, sizeof(BOFObjectSymbol));
+    BOFObjectSymbol *sym = &obj->symbols[obj->symbol_count];
+    sym->name = obj->names_bytes;
+    sym->section = obj_sym_undefined;
+    sym->value = 0;
+    obj->names_bytes += padded;
+    return obj->symbol_count++;
+}
+
+// Define the symbol named name in obj
+// to be at word offset value in the given section, and return its index.
+// Exit with an error if it is already defined.
+int bof_object_define(BOFObject *obj, const char *name,
+		      obj_sym_section section, word_type value)
+{
+    int i = bof_object_symbol(obj, name);
+    if (obj->symbols[i].section != obj_sym_undefined) {
+	bail_with_error("Duplicate definition of \"%s\" in %s!",
+			name, obj->filename);
+    }
+    obj->symbols[i].section = section;
+    obj->symbols[i].value = value;
+    return i;
+}
+
+// Return the name of the symbol numbered i in obj
+const char *bof_object_symbol_name(const BOFObject *obj, int i)
+{
+    return obj->names + obj->symbols[i].name;
+}
+
+// Add a relocation of the given kind, for the instruction at offset
+// in obj's text section, which refers to the symbol numbered symbol
+// (or -1 for a $gp-relative relocation)
+void bof_object_add_reloc(BOFObject *obj, word_type offset,
+			  obj_reloc_kind kind, word_type symbol)
+{
+    grow((void **) &obj->relocs, &obj->reloc_capacity,
+	 obj->reloc_count + 1, sizeof(BOFObjectReloc));
+    BOFObjectReloc *r = &obj->relocs[obj->reloc_count++];
+    r->offset = offset;
+    r->kind = kind;
+    r->symbol = symbol;
+}
+
+// Requires: bf is open for writing in binary
+// Write obj to bf, with its sections taken from bb (see bof.h)
+// and the rest of its header from hdr, then release bb's storage.
+// Exit the program with an error if this fails.
+void bof_object_write(BOFFILE bf, const BOFObject *obj,
+		      BOFBuffer *bb, BOFHeader hdr)
+{
+    // objects hold all of their data, as the linker appends their sections
+    bof_buffer_flush_zeros(bb);
+    assert(bb->size % BYTES_PER_WORD == 0);
+    memcpy(hdr.magic, OBJECT_MAGIC, MAGIC_BUFFER_SIZE);
+    hdr.text_length = bof_buffer_text_words(bb);
+    hdr.data_length = bof_buffer_data_words(bb);
+    BOFObjectCounts counts;
+    counts.symbol_count = obj->symbol_count;
+    counts.reloc_count = obj->reloc_count;
+    counts.names_bytes = obj->names_bytes;
+
+    bof_write_header(bf, hdr);
+    bof_write_bytes(bf, sizeof(counts), &counts);
+    bof_write_bytes(bf, bb->size - sizeof(BOFHeader),
+		    bb->bytes + sizeof(BOFHeader));
+    bof_buffer_free(bb);
+    if (obj->symbol_count > 0) {
+	bof_write_bytes(bf, obj->symbol_count * sizeof(BOFObjectSymbol),
+			obj->symbols);
+    }
+    if (obj->reloc_count > 0) {
+	bof_write_bytes(bf, obj->reloc_count * sizeof(BOFObjectReloc),
+			obj->relocs);
+    }
+    if (obj->names_bytes > 0) {
+	bof_write_bytes(bf, obj->names_bytes, obj->names);
+    }
+}
+
+// Does the given header have the magic number of an object file?
+bool bof_object_has_magic_number(BOFHeader bh)
+{
+    return strncmp(bh.magic, OBJECT_MAGIC, MAGIC_BUFFER_SIZE) == 0;
+}
+
+// Requires: obj was read from its file
+// Check that the tables in obj (as read from its file) are consistent,
+// exiting with an error if they are not
+static void check_tables(const BOFObject *obj)
+{
+    for (int i = 0; i < obj->symbol_count; i++) {
+	const BOFObjectSymbol *sym = &obj->symbols[i];
+	if (sym->name < 0 || sym->name >= obj->names_bytes
+	    || memchr(obj->names + sym->name, '\0',
+		      obj->names_bytes - sym->name) == NULL) {
+	    bail_with_error("Bad name for symbol %d in %s!", i, obj->filename);
+	}
+	if (sym->section != obj_sym_undefined && sym->section != obj_sym_text
+	    && sym->section != obj_sym_data) {
+	    bail_with_error("Bad section (%d) for symbol \"%s\" in %s!",
+			    sym->section, bof_object_symbol_name(obj, i),
+			    obj->filename);
+	}
+    }
+    for (int i = 0; i < obj->reloc_count; i++) {
+	const BOFObjectReloc *r = &obj->relocs[i];
+	bool bad = r->offset < 0 || r->offset >= obj->header.text_length;
+	switch (r->kind) {
+	case obj_reloc_jump:
+	    bad = bad || r->symbol < 0 || r->symbol >= obj->symbol_count;
+	    break;
+	case obj_reloc_gp1: case obj_reloc_gp2: case obj_reloc_text:
+	    break;
+	default:
+	    bad = true;
+	    break;
+	}
+	if (bad) {
+	    bail_with_error("Bad relocation (number %d) in %s!",
+			    i, obj->filename);
+	}
+    }
+}
+
+// Read the relocatable object file named filename,
+// checking that its tables fit in it, and return it.
+// Exit the program with an error if this fails.
+BOFObject bof_object_read(const char *filename)
+{
+    BOFObject obj;
+    bof_object_initialize(&obj, filename);
+    BOFFILE bf = bof_read_open(filename);
+    size_t size = bof_file_bytes(bf);
+    char *buf = (char *) malloc(size > 0 ? size : 1);
+    if (buf == NULL) {
+	bof_close(bf);
+	bail_with_error("No space to read %s!", filename);
+    }
+    size_t rd = fread(buf, 1, size, bf.fileptr);
+    bof_close(bf);
+    const size_t head = sizeof(BOFHeader) + sizeof(BOFObjectCounts);
+    if (rd != size || size < head) {
+	free(buf);
+	bail_with_error("Cannot read the header of object file %s!", filename);
+    }
+    memcpy(&obj.header, buf, sizeof(BOFHeader));
+    BOFObjectCounts counts;
+    memcpy(&counts, buf + sizeof(BOFHeader), sizeof(counts));
+    if (!bof_object_has_magic_number(obj.header)) {
+	free(buf);
+	bail_with_error("File %s is not an object file (wrong magic number)!",
+			filename);
+    }
+    uint64_t text_bytes = (uint64_t) obj.header.text_length * BYTES_PER_WORD;
+    uint64_t data_bytes = (uint64_t) obj.header.data_length * BYTES_PER_WORD;
+    uint64_t sym_bytes = (uint64_t) counts.symbol_count
+	* sizeof(BOFObjectSymbol);
+    uint64_t reloc_bytes = (uint64_t) counts.reloc_count
+	* sizeof(BOFObjectReloc);
+    if (obj.header.text_length < 0 || obj.header.data_length < 0
+	|| counts.symbol_count < 0 || counts.reloc_count < 0
+	|| counts.names_bytes < 0
+	|| head + text_bytes + data_bytes + sym_bytes + reloc_bytes
+	   + counts.names_bytes != size) {
+	free(buf);
+	bail_with_error("The sizes in the header of object file %s are wrong!",
+			filename);
+    }
+    const char *p = buf + head;
+    obj.text = (uword_type *) copy_bytes(p, text_bytes);
+    p += text_bytes;
+    obj.data = (word_type *) copy_bytes(p, data_bytes);
+    p += data_bytes;
+    obj.symbol_count = obj.symbol_capacity = counts.symbol_count;
+    obj.symbols = (BOFObjectSymbol *) copy_bytes(p, sym_bytes);
+    p += sym_bytes;
+    obj.reloc_count = obj.reloc_capacity = counts.reloc_count;
+    obj.relocs = (BOFObjectReloc *) copy_bytes(p, reloc_bytes);
+    p += reloc_bytes;
+    obj.names_bytes = obj.names_capacity = counts.names_bytes;
+    obj.names = (char *) copy_bytes(p, counts.names_bytes);
+    free(buf);
+    check_tables(&obj);
+    return obj;
+}
+
+// Release the storage held by obj
+void bof_object_free(BOFObject *obj)
+{
+    free(obj->text);
+    free(obj->data);
+    free(obj->symbols);
+    free(obj->relocs);
+    free(obj->names);
+    obj->text = NULL;
+    obj->data = NULL;
+    obj->symbols = NULL;
+    obj->relocs = NULL;
+    obj->names = NULL;
+    obj->symbol_count = obj->reloc_count = obj->names_bytes = 0;
+}
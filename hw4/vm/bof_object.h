@@ -0,0 +1,120 @@
+/* $Id$ */
+// Relocatable object files (for the SSM)
+#ifndef _BOF_OBJECT_H
+#define _BOF_OBJECT_H
+#include <stdbool.h>
+#include "machine_types.h"
+#include "bof.h"
+
+// A relocatable object file is laid out like a binary object file,
+// except that its header's magic number is OBJECT_MAGIC,
+// its header's text_start_address is the entry point's offset
+// in its text section (or -1 if it has no entry point),
+// and the header is followed by the counts in a BOFObjectCounts.
+// After the text and data sections come the symbols (BOFObjectSymbol),
+// then the relocations (BOFObjectReloc), then the symbols' names
+// (each followed by a null char, and padded to a whole number of words).
+// Addresses in the text section that name a label,
+// and offsets from $gp, are all relative to the object's own sections
+// until they are relocated by the linker (bofld).
+// Jumps to the object's own labels are resolved in place,
+// so each object's labels are its own even if another object
+// defines a label of the same name.
+#define OBJECT_MAGIC "BR32"
+
+// the sizes of an object's tables, following its header in the file
+typedef struct {
+    word_type symbol_count;
+    word_type reloc_count;
+    word_type names_bytes;  // size of the names, a multiple of BYTES_PER_WORD
+} BOFObjectCounts;
+
+// where a symbol is defined
+typedef enum {obj_sym_undefined = 0, obj_sym_text = 1, obj_sym_data = 2
+} obj_sym_section;
+
+// a symbol: defined ones are exported (to the objects that import them),
+// undefined ones are imported
+typedef struct {
+    word_type name;             // offset of its name in the names
+    word_type section;          // an obj_sym_section
+    word_type value;            // word offset in its section (if defined)
+} BOFObjectSymbol;
+
+// kinds of relocations
+typedef enum {
+    // the address of a jump format instruction (CALL or JMPA)
+    // is the address of the symbol numbered symbol
+    obj_reloc_jump = 1,
+    // the first (obj_reloc_gp1) or second (obj_reloc_gp2)
+    // $gp-relative memory operand of the instruction
+    // has the start of the object's data added to its offset
+    obj_reloc_gp1 = 2, obj_reloc_gp2 = 3,
+    // the address of a jump format instruction, which is that of
+    // a label of the object's own, has the start of its text added to it
+    obj_reloc_text = 4
+} obj_reloc_kind;
+
+// a relocation for the instruction at word offset offset in the text
+typedef struct {
+    word_type offset;
+    word_type kind;             // an obj_reloc_kind
+    word_type symbol;           // for obj_reloc_jump (otherwise -1)
+} BOFObjectReloc;
+
+// a relocatable object file in memory
+typedef struct {
+    const char *filename;
+    BOFHeader header;           // with text_start_address as described above
+    uword_type *text;           // header.text_length words
+    word_type *data;            // header.data_length words
+    int symbol_count;
+    BOFObjectSymbol *symbols;
+    int reloc_count;
+    BOFObjectReloc *relocs;
+    char *names;                // the symbols' names
+    int names_bytes;
+    int symbol_capacity, reloc_capacity, names_capacity;
+} BOFObject;
+
+// Initialize obj to be an empty object named filename (in error messages)
+extern void bof_object_initialize(BOFObject *obj, const char *filename);
+
+// Return the index of the symbol named name in obj,
+// adding it (as an undefined symbol) if it is not there
+extern int bof_object_symbol(BOFObject *obj, const char *name);
+
+// Define the symbol named name in obj
+// to be at word offset value in the given section, and return its index.
+// Exit with an error if it is already defined.
+extern int bof_object_define(BOFObject *obj, const char *name,
+			     obj_sym_section section, word_type value);
+
+// Return the name of the symbol numbered i in obj
+extern const char *bof_object_symbol_name(const BOFObject *obj, int i);
+
+// Add a relocation of the given kind, for the instruction at offset
+// in obj's text section, which refers to the symbol numbered symbol
+// (or -1 for a $gp-relative relocation)
+extern void bof_object_add_reloc(BOFObject *obj, word_type offset,
+				 obj_reloc_kind kind, word_type symbol);
+
+// Requires: bf is open for writing in binary
+// Write obj to bf, with its sections taken from bb (see bof.h)
+// and the rest of its header from hdr, then release bb's storage.
+// Exit the program with an error if this fails.
+extern void bof_object_write(BOFFILE bf, const BOFObject *obj,
+			     BOFBuffer *bb, BOFHeader hdr);
+
+// Read the relocatable object file named filename,
+// checking that its tables fit in it, and return it.
+// Exit the program with an error if this fails.
+extern BOFObject bof_object_read(const char *filename);
+
+// Release the storage held by obj
+extern void bof_object_free(BOFObject *obj);
+
+// Does the given header have the magic number of an object file?
+extern bool bof_object_has_magic_number(BOFHeader bh);
+
+#endif
@@ -0,0 +1,131 @@
+/* $Id$ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bof.h"
+#include "bof_archive.h"
+#include "utilities.h"
+
+static char *progname;
+
+void usage() {
+    bail_with_error("Usage: %s -c file.boa file.bof ...\n       %s -t file.boa\n       %s -p file.boa member\n       %s -i file.boa member",
+		    progname, progname, progname, progname);
+}
+
+// Read the file named filename into a newly allocated buffer,
+// setting *bytesp to its size and returning the buffer,
+// or, if there is no such file, return NULL with *bytesp set to 0
+static char *read_optional_file(const char *filename, size_t *bytesp)
+{
+    *bytesp = 0;
+    FILE *f = fopen(filename, "rb");
+    if (f == NULL) {
+	return NULL;
+    }
+    size_t capacity = BUFSIZ;
+    char *buf = (char *) malloc(capacity);
+    size_t n;
+    while (buf != NULL
+	   && (n = fread(buf + *bytesp, 1, capacity - *bytesp, f)) > 0) {
+	*bytesp += n;
+	if (*bytesp == capacity) {
+	    capacity *= 2;
+	    buf = (char *) realloc(buf, capacity);
+	}
+    }
+    if (buf == NULL || ferror(f)) {
+	bail_with_error("Cannot read %s!", filename);
+    }
+    fclose(f);
+    return buf;
+}
+
+// Put into buf (of size size) the name of the file that goes with
+// the binary object file named bofname and has the extension ext
+static void companion_name(char *buf, size_t size, const char *bofname,
+			   const char *ext)
+{
+    const char *dot = strrchr(bofname, '.');
+    int stem = (dot == NULL) ? (int) strlen(bofname) : (int) (dot - bofname);
+    int len = snprintf(buf, size, "%.*s%s", stem, bofname, ext);
+    if (len < 0 || (size_t) len >= size) {
+	bail_with_error("File name %s is too long!", bofname);
+    }
+}
+
+// Make the archive named arname holding the count binary object files
+// named in bofnames, each with the input in the file whose name has
+// the extension .in instead of .bof and the expected output in the file
+// whose name has the extension .out (if those files exist)
+static void create_archive(const char *arname, char **bofnames, int count)
+{
+    BOFArchiveBuilder ab;
+    bof_archive_initialize(&ab);
+    for (int i = 0; i < count; i++) {
+	char name[BUFSIZ];
+	BOFImage img = bof_map(bofnames[i]);
+	size_t input_bytes, output_bytes;
+	companion_name(name, sizeof(name), bofnames[i], ".in");
+	char *input = read_optional_file(name, &input_bytes);
+	companion_name(name, sizeof(name), bofnames[i], ".out");
+	char *output = read_optional_file(name, &output_bytes);
+	bof_archive_add(&ab, bofnames[i], img.bytes, img.size,
+			input, input_bytes, output, output_bytes);
+	free(input);
+	free(output);
+	bof_unmap(img);
+    }
+    bof_archive_write(arname, &ab);
+}
+
+// Print a table of the members of ar on out
+static void list_archive(FILE *out, const BOFArchive *ar)
+{
+    fprintf(out, "%-6s %-24s %8s %8s %8s\n",
+	    "Member", "Name", "BOF", "Input", "Output");
+    for (int i = 0; i < ar->member_count; i++) {
+	const BOFArchiveMember *m = &ar->members[i];
+	fprintf(out, "%-6d %-24s %8d %8d %8d\n", i,
+		bof_archive_member_name(ar, i),
+		m->bof_bytes, m->input_bytes, m->output_bytes);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    // set the program's name
+    progname = argv[0];
+    argc--;
+    argv++;
+
+    // the options -c, -t, -p, and -i each take an archive's name
+    if (argc < 2 || strlen(argv[0]) != 2 || argv[0][0] != '-') {
+	usage();
+    }
+    char option = argv[0][1];
+    const char *arname = argv[1];
+    argc -= 2;
+    argv += 2;
+
+    if (option == 'c' && argc > 0) {
+	create_archive(arname, argv, argc);
+    } else if (option == 't' && argc == 0) {
+	BOFArchive ar = bof_archive_map(arname);
+	list_archive(stdout, &ar);
+	bof_archive_unmap(ar);
+    } else if ((option == 'p' || option == 'i') && argc == 1) {
+	// print a member's expected output or input
+	BOFArchive ar = bof_archive_map(arname);
+	int n = bof_archive_find(&ar, argv[0]);
+	size_t bytes;
+	const char *buf = (option == 'p')
+	    ? bof_archive_output(&ar, n, &bytes)
+	    : bof_archive_input(&ar, n, &bytes);
+	fwrite(buf, 1, bytes, stdout);
+	bof_archive_unmap(ar);
+    } else {
+	usage();
+    }
+
+    return EXIT_SUCCESS;
+}
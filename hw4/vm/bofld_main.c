@@ -0,0 +1,84 @@
+/* $Id$ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bof.h"
+#include "bof_object.h"
+#include "link.h"
+#include "utilities.h"
+
+// strdup seems to be in the string library but not in the header...
+extern char *strdup(const char *s);
+
+static char *progname;
+
+void usage() {
+    bail_with_error("Usage: %s [-o file.bof] [-e label] file.obj ...",
+		    progname);
+}
+
+int main(int argc, char *argv[]) {
+    // set the program's name
+    progname = argv[0];
+    argc--;
+    argv++;
+
+    // name of the file to write, and the label to start at
+    char *bofname = NULL;
+    const char *entry = NULL;
+
+    // possible options: -o and -e (each with an argument)
+    while (argc > 0 && strlen(argv[0]) >= 2 && argv[0][0] == '-') {
+	if (strcmp(argv[0], "-o") == 0 && argc > 1) {
+	    bofname = argv[1];
+	} else if (strcmp(argv[0], "-e") == 0 && argc > 1) {
+	    entry = argv[1];
+	} else {
+	    usage();
+	}
+	argc -= 2;
+	argv += 2;
+    }
+
+    if (argc < 1) {
+	usage();
+    }
+
+    // by default, the output is named after the first object
+    if (bofname == NULL) {
+	bofname = strdup(argv[0]);
+	char *suffix = strrchr(bofname, '.');
+	if (suffix == NULL || strcmp(suffix, ".obj") != 0) {
+	    usage();
+	}
+	strcpy(suffix, ".bof");
+    }
+
+    BOFObject *objs = (BOFObject *) malloc(argc * sizeof(BOFObject));
+    if (objs == NULL) {
+	bail_with_error("No space to read %d object files!", argc);
+    }
+    for (int i = 0; i < argc; i++) {
+	objs[i] = bof_object_read(argv[i]);
+    }
+
+    BOFFILE bf = bof_write_open(bofname);
+    // remove the partly written file if linking fails
+    error_context ec;
+    error_context_enter(&ec);
+    if (setjmp(ec.env) == 0) {
+	link_objects(bf, objs, argc, entry);
+	error_context_leave(&ec);
+    } else {
+	bof_close(bf);
+	remove(bofname);
+	error_context_propagate(&ec);
+    }
+    bof_close(bf);
+
+    for (int i = 0; i < argc; i++) {
+	bof_object_free(&objs[i]);
+    }
+    free(objs);
+    return EXIT_SUCCESS;
+}
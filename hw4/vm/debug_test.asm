@@ -0,0 +1,15 @@
+	# $Id$
+	# test of debugging information (assembled with asm -g):
+	# its disassembly should show the labels, source lines,
+	# and data names in comments
+	.text start
+start:	CALL greet
+	PSTR $gp, 1         # print bye
+	EXIT 0
+greet:	PSTR $gp, 0         # print hi
+	RTN
+	.data 1024
+	WORD hi = 0x0a6968
+	STRING[2] bye = "bye\n"
+	.stack 4096
+	.end
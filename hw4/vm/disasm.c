@@ -1,65 +1,104 @@
 /* $Id: disasm.c,v 1.14 2024/07/28 22:01:51 leavens Exp $ */
 #include <stdio.h>
+#include <string.h>
 #include "disasm.h"
 #include "bof.h"
+#include "bof_debug.h"
 #include "regname.h"
 #include "utilities.h"
 #include "instruction.h"
 
-// Disassemble code from bf,
+// the debugging information of the program being disassembled
+// (empty if it has none), which is shown in comments
+static BOFDebugInfo debug_info;
+
+// Disassemble the program in img,
 // with output going to the file out
-void disasmProgram(FILE *out, BOFFILE bf)
+void disasmProgram(FILE *out, BOFImage img)
 {
-    BOFHeader bh = bof_read_header(bf);
-    disasmTextSection(out, bf, bh);
-    disasmDataSection(out, bf, bh);
-    disasmStackSection(out, bh);
+    bof_debug_read(img, &debug_info);
+    disasmTextSection(out, img);
+    disasmDataSection(out, img);
+    disasmStackSection(out, img.header);
     fprintf(out, ".end");
     newline(out);
+    bof_debug_free(&debug_info);
 }
 
-// Disassemble the text section
+// Disassemble the text section of img
 // with output going to the file out
-void disasmTextSection(FILE *out, BOFFILE bf, BOFHeader bh)
+void disasmTextSection(FILE *out, BOFImage img)
 {
-    fprintf(out, ".text\t%u", bh.text_start_address);
+    fprintf(out, ".text\t%u", img.header.text_start_address);
     newline(out);
-    disasmInstrs(out, bf, bh.text_length);
+    disasmInstrs(out, img.text, img.header.text_length);
 }
 
-// Disassemble length instructions from bf
+// Disassemble the length instructions in text
 // with output going to the file out
-void disasmInstrs(FILE *out, BOFFILE bf, int length)
+void disasmInstrs(FILE *out, const uword_type *text, int length)
 {
     for (int i = 0; i < length; i++) {
-	disasmInstr(out, instruction_read(bf), i);
+	disasmInstr(out, instruction_decode(text[i]), i);
+    }
+}
+
+// Print comments on out for the symbols that start at address i
+// and for the source line of its code, if that differs from the
+// line of the code at address i-1
+static void disasmDebugComments(FILE *out, address_type i)
+{
+    for (int s = 0; s < debug_info.symbol_count; s++) {
+	const BOFDebugSymbol *sym = &debug_info.symbols[s];
+	if (sym->start == (word_type) i) {
+	    fprintf(out, "# %s %s:\n",
+		    (sym->kind == debug_sym_procedure) ? "procedure" : "label",
+		    bof_debug_name(&debug_info, sym->name));
+	}
+    }
+    const char *filename, *prev_filename;
+    unsigned int line, prev_line;
+    if (bof_debug_find_line(&debug_info, i, &filename, &line)
+	&& (i == 0
+	    || !bof_debug_find_line(&debug_info, i - 1, &prev_filename,
+				    &prev_line)
+	    || prev_line != line || strcmp(prev_filename, filename) != 0)) {
+	fprintf(out, "# %s:%u\n", filename, line);
     }
 }
 
 // Disassemble the binary instruction bi, which would go at address i
 // each instruction has a label of the form a%d:, where %d is the value of i
+// (preceded by comments giving its source, if there is debugging information)
 void disasmInstr(FILE *out, bin_instr_t bi, address_type i)
 {
-    fprintf(out, "a%d:\t%s", i, instruction_assembly_form(i, bi));
-    newline(out);
+    disasmDebugComments(out, i);
+    char buf[INSTR_FORMAT_BUF_SIZE];
+    instruction_format(buf, sizeof(buf), i, bi);
+    fprintf(out, "a%d:\t%s\n", i, buf);
 }
 
-// Disassemble the data section from bf, based on the information in bh,
+// Disassemble the data section of img,
 // with output going to out
-void disasmDataSection(FILE *out, BOFFILE bf, BOFHeader bh)
+void disasmDataSection(FILE *out, BOFImage img)
 {
-    fprintf(out, ".data\t%u", bh.data_start_address);
+    fprintf(out, ".data\t%u", img.header.data_start_address);
     newline(out);
-    disasmStaticDecls(out, bf, bh.data_length);
+    disasmStaticDecls(out, img.data, img.header.data_length);
+    disasmZeroFill(out, img.header.data_length, img.zero_length);
 }
 
-// Disassemble words_to_read static data words from bf,
+// Disassemble the words_to_read static data words in data,
 // with output going to out
-void disasmStaticDecls(FILE *out, BOFFILE bf, int words_to_read)
+void disasmStaticDecls(FILE *out, const word_type *data, int words_to_read)
 {
-    while (words_to_read >= 1) {
-	disasmStaticDecl(out, bof_read_word(bf));
-	words_to_read--;
+    for (int i = 0; i < words_to_read; i++) {
+	const BOFDebugVariable *var
+	    = bof_debug_find_variable(&debug_info, DEBUG_STATIC_LEVEL, i);
+	if (var != NULL) {
+	    fprintf(out, "# %s:\n", bof_debug_name(&debug_info, var->name));
+	}
+	disasmStaticDecl(out, data[i]);
     }
 }
 
@@ -83,6 +122,32 @@ void disasmStaticDecl(FILE *out, word_type w)
     newline(out);
 }
 
+// Disassemble the zero-filled words that follow the data section,
+// which start at $gp offset first and are words long,
+// as empty strings (which assemble to zero fill again),
+// split where the debugging information names a variable
+void disasmZeroFill(FILE *out, int first, int words)
+{
+    int start = first;
+    const int end = first + words;
+    while (start < end) {
+	const BOFDebugVariable *var
+	    = bof_debug_find_variable(&debug_info, DEBUG_STATIC_LEVEL, start);
+	if (var != NULL) {
+	    fprintf(out, "# %s:\n", bof_debug_name(&debug_info, var->name));
+	}
+	int next = start + 1;
+	while (next < end
+	       && bof_debug_find_variable(&debug_info, DEBUG_STATIC_LEVEL,
+					  next) == NULL) {
+	    next++;
+	}
+	fprintf(out, "STRING[%d] %s = \"\"", next - start, new_word_id());
+	newline(out);
+	start = next;
+    }
+}
+
 // Disassemble the stack section based on the given header information
 void disasmStackSection(FILE *out, BOFHeader bh)
 {
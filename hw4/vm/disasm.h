@@ -3,34 +3,40 @@
 #define _DISASM_H
 #include "instruction.h"
 
-// Disassemble code from bf,
+// Disassemble the program in img,
 // with output going to the file out
-extern void disasmProgram(FILE *out, BOFFILE bf);
+extern void disasmProgram(FILE *out, BOFImage img);
 
-// Disassemble the text section
+// Disassemble the text section of img
 // with output going to the file out
-extern void disasmTextSection(FILE *out, BOFFILE bf, BOFHeader bh);
+extern void disasmTextSection(FILE *out, BOFImage img);
 
-// Disassemble length instructions from bf
+// Disassemble the length instructions in text
 // with output going to the file out
-extern void disasmInstrs(FILE *out, BOFFILE bf, int length);
+extern void disasmInstrs(FILE *out, const uword_type *text, int length);
 
 // Disassemble the binary instruction bi, which would go at address i
 // each instruction has a label of the form a%d, where %d is the value of i
 extern void disasmInstr(FILE *out, bin_instr_t bi, address_type i);
 
-// Disassemble the data section from bf, based on the information in bh,
+// Disassemble the data section of img,
 // with output going to out
-extern void disasmDataSection(FILE *out, BOFFILE bf, BOFHeader bh);
+extern void disasmDataSection(FILE *out, BOFImage img);
 
-// Disassemble words_to_read static data words from bf,
+// Disassemble the words_to_read static data words in data,
 // with output going to out
-extern void disasmStaticDecls(FILE *out, BOFFILE bf, int words_to_read);
+extern void disasmStaticDecls(FILE *out, const word_type *data,
+			      int words_to_read);
 
 // Disassemble the the given word as a static data declaration,
 // with output going to out
 extern void disasmStaticDecl(FILE *out, word_type w);
 
+// Disassemble the words zero-filled words that follow the data section
+// (see BOFZeroFill), which start at $gp offset first,
+// with output going to out
+extern void disasmZeroFill(FILE *out, int first, int words);
+
 // Disassemble the stack section based on the given header information
 extern void disasmStackSection(FILE *out, BOFHeader bh);
 
@@ -2,13 +2,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "bof.h"
+#include "bof_archive.h"
 #include "disasm.h"
 #include "utilities.h"
 
 static char *progname;
 
 void usage() {
-    bail_with_error("Usage: %s file.bof", progname);
+    bail_with_error("Usage: %s file.bof\n       %s file.boa member",
+		    progname, progname);
 }
 
 int main(int argc, char *argv[]) {
@@ -17,16 +19,24 @@ int main(int argc, char *argv[]) {
     argc--;
     argv++;
 
-    if (argc != 1) {
+    if (argc != 1 && argc != 2) {
 	usage();
     }
 
     // name of the file to read
     const char *bofname = argv[0];
-    
-    BOFFILE bf = bof_read_open(bofname);
 
-    disasmProgram(stdout, bf);
+    if (argc == 1) {
+	BOFImage img = bof_map(bofname);
+	disasmProgram(stdout, img);
+	bof_unmap(img);
+    } else {
+	// disassemble a member (named or numbered by argv[1]) of an archive
+	BOFArchive ar = bof_archive_map(bofname);
+	int n = bof_archive_find(&ar, argv[1]);
+	disasmProgram(stdout, bof_archive_image(&ar, n));
+	bof_archive_unmap(ar);
+    }
     
     return EXIT_SUCCESS;
 }
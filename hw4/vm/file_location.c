@@ -2,7 +2,7 @@
 #include <stdlib.h>
 #include <stddef.h>
 #include "file_location.h"
-#include "utilities.h"
+#include "arena.h"
 
 // Requires: filename != NULL
 // Return a (pointer to a) fresh file_location with the given
@@ -10,10 +10,9 @@
 file_location *file_location_make(const char *filename,
 					 unsigned int line)
 {
-    file_location *ret = (file_location *) malloc(sizeof(file_location));
-    if (ret == NULL) {
-	bail_with_error("Could not allocate space for a file_location!");
-    }
+    file_location *ret = (file_location *) arena_alloc(sizeof(file_location));
+    ret->filename = filename;
+    ret->line = line;
     return ret;
 }
 
@@ -21,10 +20,7 @@ file_location *file_location_make(const char *filename,
 // Return a (pointer to a) fresh copy of fl
 file_location *file_location_copy(file_location *fl)
 {
-    file_location *ret = (file_location *) malloc(sizeof(file_location));
-    if (ret == NULL) {
-	bail_with_error("Could not allocate space for a file_location!");
-    }
+    file_location *ret = (file_location *) arena_alloc(sizeof(file_location));
     ret->filename = fl->filename;
     ret->line = fl->line;
     return ret;
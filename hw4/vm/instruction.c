@@ -8,26 +8,134 @@
 #include "machine_types.h"
 #include "asm.tab.h"
 
-#define INSTR_BUF_SIZE 512
+// space to hold one instruction's assembly language form
+// for instruction_assembly_form (one per thread)
+static _Thread_local char instr_buf[INSTR_FORMAT_BUF_SIZE];
 
-// the following declaration isn't in <string.h> everywhere ...
-extern char *strdup(const char *s);
+// The binary format of instructions, as the position of the least
+// significant bit of each field in an instruction word and its width.
+// The op field is in the low bits and the func field in the high bits;
+// the fields named here in comments are those of the structs
+// in instruction.h that use each position.
+#define OP_POS 0
+#define OP_BITS 4
+#define FUNC_POS 28
+#define FUNC_BITS 4
+#define REG_BITS 3
+#define REG1_POS 4       // rt, reg, rd, and the rs of register branches
+#define OFFSET_BITS 9
+#define OFFSET1_POS 7    // ot and offset
+#define REG2_POS 16      // rs
+#define OFFSET2_POS 19   // os
+#define ARG_POS 16       // arg, syscall code, and register branch offset
+#define ARG_BITS 12
+#define IMMED_POS 16     // immed and uimmed
+#define IMMED_BITS 16
+#define ADDR_POS 4       // addr
+#define ADDR_BITS 28
+#define ROP_POS 7        // rop of register computations
+#define ROP_BITS 9
+#define REG3_POS 19      // rt of register computations
+#define BRANCH_RT_POS 7  // rt of register branches
+#define CMP_POS 10       // cmp of register branches
+#define CMP_BITS 6
 
-// space to hold one instruction's assembly language form
-static char instr_buf[INSTR_BUF_SIZE];
+// Return the (unsigned) field of w that is width bits wide at bit pos
+static uword_type field(uword_type w, int pos, int width)
+{
+    return (w >> pos) & ((1u << width) - 1);
+}
 
-// Return the instruction type of the given opcode 
-instr_type instruction_type(bin_instr_t i) {
-    switch (i.comp.op) { // need to pretend a type to read the op field
+// Return the two's complement field of w that is width bits wide at bit pos
+static word_type signed_field(uword_type w, int pos, int width)
+{
+    word_type v = (word_type) field(w, pos, width);
+    if (v & (1 << (width - 1))) {
+	v -= (1 << width);
+    }
+    return v;
+}
+
+// Return v truncated to width bits and moved to bit pos
+static uword_type place(word_type v, int pos, int width)
+{
+    return ((uword_type) v & ((1u << width) - 1)) << pos;
+}
+
+// the information about each instruction, from instruction_table.h
+#define INSTR_INFO(NAME, name, type, op, func, sub, form) \
+    [NAME##_I] = {#NAME, type, op, func, sub, form##_form},
+const instr_info_t instruction_info[num_instr_ids] = {
+    [error_instr_id] = {"ERROR", error_instr_type, 0, 0, 0, no_arg_form},
+    SSM_INSTRUCTIONS(INSTR_INFO)
+};
+#undef INSTR_INFO
+
+// Dense decoding tables, from instruction_table.h.
+// Instructions are found by their op and func fields
+// (only the op field for immediate and jump format instructions),
+// except that register computations, register branches, and system calls
+// are found by their register operation, comparison, or system call codes.
+// Entries that are not instructions are 0 (i.e., error_instr_id).
+#define DECODE_KEY(op, func) \
+    ((op) <= OTHC_O ? ((op) << FUNC_BITS) | (func) : (2 << FUNC_BITS) + (op))
+#define NUM_DECODE_KEYS ((2 << FUNC_BITS) + (1 << OP_BITS))
+#define DECODE_ENTRY(key, id) [key] = id,
+
+#define MAIN_ID(NAME, name, type, op, func, sub, form) \
+    INSTR_TYPE_SELECT(type, DECODE_ENTRY, DECODE_ENTRY, DECODE_ENTRY, \
+		      DECODE_ENTRY, INSTR_SKIP, INSTR_SKIP, INSTR_SKIP) \
+    (DECODE_KEY(op, func), NAME##_I)
+static const unsigned char main_ids[NUM_DECODE_KEYS] = {
+    SSM_INSTRUCTIONS(MAIN_ID)
+};
+#undef MAIN_ID
+
+#define REG_OP_ID(NAME, name, type, op, func, sub, form) \
+    INSTR_TYPE_SELECT(type, INSTR_SKIP, INSTR_SKIP, INSTR_SKIP, \
+		      INSTR_SKIP, INSTR_SKIP, DECODE_ENTRY, INSTR_SKIP) \
+    (sub, NAME##_I)
+static const unsigned char reg_op_ids[1 << ROP_BITS] = {
+    SSM_INSTRUCTIONS(REG_OP_ID)
+};
+#undef REG_OP_ID
+
+#define CMP_ID(NAME, name, type, op, func, sub, form) \
+    INSTR_TYPE_SELECT(type, INSTR_SKIP, INSTR_SKIP, INSTR_SKIP, \
+		      INSTR_SKIP, INSTR_SKIP, INSTR_SKIP, DECODE_ENTRY) \
+    (sub, NAME##_I)
+static const unsigned char cmp_ids[1 << CMP_BITS] = {
+    SSM_INSTRUCTIONS(CMP_ID)
+};
+#undef CMP_ID
+
+#define SYSCALL_ID(NAME, name, type, op, func, sub, form) \
+    INSTR_TYPE_SELECT(type, INSTR_SKIP, INSTR_SKIP, INSTR_SKIP, \
+		      INSTR_SKIP, DECODE_ENTRY, INSTR_SKIP, INSTR_SKIP) \
+    (sub, NAME##_I)
+static const unsigned char syscall_ids[1 << ARG_BITS] = {
+    SSM_INSTRUCTIONS(SYSCALL_ID)
+};
+#undef SYSCALL_ID
+
+// Return the instruction type (binary format) of instructions
+// with the given op and func fields
+static instr_type type_of(unsigned int op, unsigned int func)
+{
+    switch (op) {
     case COMP_O:
+	if (func == REG_F) {
+	    return reg_comp_instr_type;
+	} else {
 	    return comp_instr_type;
+	}
 	break;
     case OTHC_O:
-	if (i.othc.func == SYS_F) {
+	if (func == SYS_F) {
 	    return syscall_instr_type;
+	} else if (func == RBR_F) {
+	    return reg_branch_instr_type;
 	} else {
-	    assert(i.othc.op != COMP_O);
-	    assert(i.othc.func != NOP_F);
 	    return other_comp_instr_type;
 	}
 	break;
@@ -45,18 +153,337 @@ instr_type instruction_type(bin_instr_t i) {
     }
 }
 
+// Return the instruction type of the given opcode 
+instr_type instruction_type(bin_instr_t i) {
+    // need to pretend a type to read the op and func fields
+    return type_of(i.comp.op, i.comp.func);
+}
+
+// Return the instr_id of the binary instruction given,
+// which is error_instr_id if it is not a valid instruction
+instr_id instruction_id(bin_instr_t bi)
+{
+    switch (instruction_type(bi)) {
+    case reg_comp_instr_type:
+	return reg_op_ids[bi.rcomp.rop];
+	break;
+    case reg_branch_instr_type:
+	return cmp_ids[bi.rbranch.cmp];
+	break;
+    case syscall_instr_type:
+	return syscall_ids[bi.syscall.code];
+	break;
+    default:
+	return main_ids[DECODE_KEY(bi.comp.op, bi.comp.func)];
+	break;
+    }
+}
+
+// Return the binary instruction encoded in the word w,
+// using the bit positions of the SSM's binary instruction format
+// (so this does not depend on how the compiler lays out bit-fields)
+bin_instr_t instruction_decode(uword_type w)
+{
+    bin_instr_t bi;
+    unsigned int op = field(w, OP_POS, OP_BITS);
+    unsigned int func = field(w, FUNC_POS, FUNC_BITS);
+    switch (type_of(op, func)) {
+    case comp_instr_type:
+	bi.comp.op = op;
+	bi.comp.rt = field(w, REG1_POS, REG_BITS);
+	bi.comp.ot = signed_field(w, OFFSET1_POS, OFFSET_BITS);
+	bi.comp.rs = field(w, REG2_POS, REG_BITS);
+	bi.comp.os = signed_field(w, OFFSET2_POS, OFFSET_BITS);
+	bi.comp.func = func;
+	break;
+    case other_comp_instr_type:
+	bi.othc.op = op;
+	bi.othc.reg = field(w, REG1_POS, REG_BITS);
+	bi.othc.offset = signed_field(w, OFFSET1_POS, OFFSET_BITS);
+	bi.othc.arg = signed_field(w, ARG_POS, ARG_BITS);
+	bi.othc.func = func;
+	break;
+    case syscall_instr_type:
+	bi.syscall.op = op;
+	bi.syscall.reg = field(w, REG1_POS, REG_BITS);
+	bi.syscall.offset = signed_field(w, OFFSET1_POS, OFFSET_BITS);
+	bi.syscall.code = field(w, ARG_POS, ARG_BITS);
+	bi.syscall.func = func;
+	break;
+    case immed_instr_type:
+	bi.immed.op = op;
+	bi.immed.reg = field(w, REG1_POS, REG_BITS);
+	bi.immed.offset = signed_field(w, OFFSET1_POS, OFFSET_BITS);
+	bi.immed.immed = signed_field(w, IMMED_POS, IMMED_BITS);
+	break;
+    case jump_instr_type:
+	bi.jump.op = op;
+	bi.jump.addr = field(w, ADDR_POS, ADDR_BITS);
+	break;
+    case reg_comp_instr_type:
+	bi.rcomp.op = op;
+	bi.rcomp.rd = field(w, REG1_POS, REG_BITS);
+	bi.rcomp.rop = field(w, ROP_POS, ROP_BITS);
+	bi.rcomp.rs = field(w, REG2_POS, REG_BITS);
+	bi.rcomp.rt = field(w, REG3_POS, REG_BITS);
+	bi.rcomp.func = func;
+	break;
+    case reg_branch_instr_type:
+	bi.rbranch.op = op;
+	bi.rbranch.rs = field(w, REG1_POS, REG_BITS);
+	bi.rbranch.rt = field(w, BRANCH_RT_POS, REG_BITS);
+	bi.rbranch.cmp = field(w, CMP_POS, CMP_BITS);
+	bi.rbranch.offset = signed_field(w, ARG_POS, ARG_BITS);
+	bi.rbranch.func = func;
+	break;
+    default:
+	bail_with_error("Bad op code (%u) in instruction_decode!", op);
+	break;
+    }
+    return bi;
+}
+
+// Return the word that encodes the binary instruction bi,
+// using the bit positions of the SSM's binary instruction format
+uword_type instruction_encode(bin_instr_t bi)
+{
+    uword_type w = 0;
+    switch (instruction_type(bi)) {
+    case comp_instr_type:
+	w = place(bi.comp.op, OP_POS, OP_BITS)
+	    | place(bi.comp.rt, REG1_POS, REG_BITS)
+	    | place(bi.comp.ot, OFFSET1_POS, OFFSET_BITS)
+	    | place(bi.comp.rs, REG2_POS, REG_BITS)
+	    | place(bi.comp.os, OFFSET2_POS, OFFSET_BITS)
+	    | place(bi.comp.func, FUNC_POS, FUNC_BITS);
+	break;
+    case other_comp_instr_type:
+	w = place(bi.othc.op, OP_POS, OP_BITS)
+	    | place(bi.othc.reg, REG1_POS, REG_BITS)
+	    | place(bi.othc.offset, OFFSET1_POS, OFFSET_BITS)
+	    | place(bi.othc.arg, ARG_POS, ARG_BITS)
+	    | place(bi.othc.func, FUNC_POS, FUNC_BITS);
+	break;
+    case syscall_instr_type:
+	w = place(bi.syscall.op, OP_POS, OP_BITS)
+	    | place(bi.syscall.reg, REG1_POS, REG_BITS)
+	    | place(bi.syscall.offset, OFFSET1_POS, OFFSET_BITS)
+	    | place(bi.syscall.code, ARG_POS, ARG_BITS)
+	    | place(bi.syscall.func, FUNC_POS, FUNC_BITS);
+	break;
+    case immed_instr_type:
+	w = place(bi.immed.op, OP_POS, OP_BITS)
+	    | place(bi.immed.reg, REG1_POS, REG_BITS)
+	    | place(bi.immed.offset, OFFSET1_POS, OFFSET_BITS)
+	    | place(bi.immed.immed, IMMED_POS, IMMED_BITS);
+	break;
+    case jump_instr_type:
+	w = place(bi.jump.op, OP_POS, OP_BITS)
+	    | place(bi.jump.addr, ADDR_POS, ADDR_BITS);
+	break;
+    case reg_comp_instr_type:
+	w = place(bi.rcomp.op, OP_POS, OP_BITS)
+	    | place(bi.rcomp.rd, REG1_POS, REG_BITS)
+	    | place(bi.rcomp.rop, ROP_POS, ROP_BITS)
+	    | place(bi.rcomp.rs, REG2_POS, REG_BITS)
+	    | place(bi.rcomp.rt, REG3_POS, REG_BITS)
+	    | place(bi.rcomp.func, FUNC_POS, FUNC_BITS);
+	break;
+    case reg_branch_instr_type:
+	w = place(bi.rbranch.op, OP_POS, OP_BITS)
+	    | place(bi.rbranch.rs, REG1_POS, REG_BITS)
+	    | place(bi.rbranch.rt, BRANCH_RT_POS, REG_BITS)
+	    | place(bi.rbranch.cmp, CMP_POS, CMP_BITS)
+	    | place(bi.rbranch.offset, ARG_POS, ARG_BITS)
+	    | place(bi.rbranch.func, FUNC_POS, FUNC_BITS);
+	break;
+    default:
+	bail_with_error("Unknown instruction type in instruction_encode (%d)",
+			instruction_type(bi));
+	break;
+    }
+    return w;
+}
+
+// Requires: id != error_instr_id
+// Return the binary instruction with the given id and operands.
+// The operands are used as the instruction's binary format needs them:
+// registers r, r2 and r3 and offsets o and o2 in the order they
+// are written in assembly language, and arg for any immediate argument,
+// shift, branch offset, or jump address.
+bin_instr_t instruction_make(instr_id id,
+			     reg_num_type r, offset_type o,
+			     reg_num_type r2, offset_type o2,
+			     reg_num_type r3, word_type arg)
+{
+    if (id <= error_instr_id || num_instr_ids <= id) {
+	bail_with_error("Bad instruction id (%d) in instruction_make!", id);
+    }
+    const instr_info_t *info = &instruction_info[id];
+    bin_instr_t bi;
+    // start with all bits zero, including any unused ones
+    bi.uimmed.op = 0;
+    bi.uimmed.reg = 0;
+    bi.uimmed.offset = 0;
+    bi.uimmed.uimmed = 0;
+    switch (info->type) {
+    case comp_instr_type:
+	bi.comp.op = info->op;
+	bi.comp.rt = r;
+	bi.comp.ot = o;
+	bi.comp.rs = r2;
+	bi.comp.os = o2;
+	bi.comp.func = info->func;
+	break;
+    case other_comp_instr_type:
+	bi.othc.op = info->op;
+	bi.othc.reg = r;
+	bi.othc.offset = o;
+	bi.othc.arg = arg;
+	bi.othc.func = info->func;
+	break;
+    case syscall_instr_type:
+	bi.syscall.op = info->op;
+	bi.syscall.reg = r;
+	bi.syscall.offset = o;
+	bi.syscall.code = info->sub;
+	bi.syscall.func = info->func;
+	break;
+    case immed_instr_type:
+	bi.immed.op = info->op;
+	bi.immed.reg = r;
+	bi.immed.offset = o;
+	bi.immed.immed = arg;
+	break;
+    case jump_instr_type:
+	bi.jump.op = info->op;
+	bi.jump.addr = arg;
+	break;
+    case reg_comp_instr_type:
+	bi.rcomp.op = info->op;
+	bi.rcomp.rd = r;
+	bi.rcomp.rop = info->sub;
+	bi.rcomp.rs = r2;
+	bi.rcomp.rt = r3;
+	bi.rcomp.func = info->func;
+	break;
+    case reg_branch_instr_type:
+	bi.rbranch.op = info->op;
+	bi.rbranch.rs = r;
+	bi.rbranch.rt = r2;
+	bi.rbranch.cmp = info->sub;
+	bi.rbranch.offset = arg;
+	bi.rbranch.func = info->func;
+	break;
+    default:
+	bail_with_error("Bad instruction type (%d) in instruction_make!",
+			info->type);
+	break;
+    }
+    return bi;
+}
+
+// Return the number (0, 1, or 2) of bi's operands that are a register
+// and an offset naming a memory location relative to that register
+// (for SCA, the address itself), such as $gp-relative data accesses.
+// Those operands' registers and offsets are put in regs and offsets,
+// in the order they are written in assembly language.
+int instruction_memory_operands(bin_instr_t bi, reg_num_type regs[2],
+				offset_type offsets[2])
+{
+    instr_id id = instruction_id(bi);
+    if (id == error_instr_id) {
+	return 0;
+    }
+    switch (instruction_info[id].form) {
+    case two_reg_comp_form:
+	regs[0] = bi.comp.rt;
+	offsets[0] = bi.comp.ot;
+	regs[1] = bi.comp.rs;
+	offsets[1] = bi.comp.os;
+	return 2;
+	break;
+    case no_target_offset_form:
+	regs[0] = bi.comp.rs;
+	offsets[0] = bi.comp.os;
+	return 1;
+	break;
+    case no_source_offset_form:
+	regs[0] = bi.comp.rt;
+	offsets[0] = bi.comp.ot;
+	return 1;
+	break;
+    case one_reg_offset_arg_form: case one_reg_offset_form: case shift_form:
+	if (instruction_info[id].type == syscall_instr_type) {
+	    regs[0] = bi.syscall.reg;
+	    offsets[0] = bi.syscall.offset;
+	} else {
+	    regs[0] = bi.othc.reg;
+	    offsets[0] = bi.othc.offset;
+	}
+	return 1;
+	break;
+    case immed_arith_form: case immed_bool_form: case branch_test_form:
+	regs[0] = bi.immed.reg;
+	offsets[0] = bi.immed.offset;
+	return 1;
+	break;
+    default:
+	return 0;
+	break;
+    }
+}
+
+// Requires: 0 <= which < instruction_memory_operands(*bi, ...)
+// Change the offset of the operand numbered which
+// (as in instruction_memory_operands) of *bi to o
+void instruction_set_memory_offset(bin_instr_t *bi, int which, offset_type o)
+{
+    instr_id id = instruction_id(*bi);
+    assert(id != error_instr_id);
+    switch (instruction_info[id].form) {
+    case two_reg_comp_form:
+	if (which == 0) {
+	    bi->comp.ot = o;
+	} else {
+	    bi->comp.os = o;
+	}
+	break;
+    case no_target_offset_form:
+	bi->comp.os = o;
+	break;
+    case no_source_offset_form:
+	bi->comp.ot = o;
+	break;
+    case one_reg_offset_arg_form: case one_reg_offset_form: case shift_form:
+	if (instruction_info[id].type == syscall_instr_type) {
+	    bi->syscall.offset = o;
+	} else {
+	    bi->othc.offset = o;
+	}
+	break;
+    case immed_arith_form: case immed_bool_form: case branch_test_form:
+	bi->immed.offset = o;
+	break;
+    default:
+	bail_with_error("Instruction %s has no memory operand to change!",
+			instruction_info[id].mnemonic);
+	break;
+    }
+}
+
 // Requires: bof is open for reading in binary
 // Read a single instruction (in binary) from bf and return it,
 // but exit with an error if there is a problem.
 bin_instr_t instruction_read(BOFFILE bf)
 {
-    bin_instr_t bi;
-    size_t rd = fread(&bi, sizeof(bi), 1, bf.fileptr);
+    uword_type w;
+    size_t rd = fread(&w, sizeof(w), 1, bf.fileptr);
     if (rd != 1) {
 	bail_with_error("Cannot read instruction from %s (read %d instrs)",
 			bf.filename, rd);
     }
-    return bi;
+    return instruction_decode(w);
 }
 
 // Requires: bf is open for writing in binary
@@ -64,7 +491,8 @@ bin_instr_t instruction_read(BOFFILE bf)
 // but exit with an error if there is a problem.
 static void write_bin_instr(BOFFILE bf, bin_instr_t i)
 {
-    size_t wr = fwrite(&i, sizeof(i), 1, bf.fileptr);
+    uword_type w = instruction_encode(i);
+    size_t wr = fwrite(&w, sizeof(w), 1, bf.fileptr);
     if (wr != 1) {
 	bail_with_error("Cannot write binary instr to %s", bf.filename);
     }
@@ -91,6 +519,12 @@ void instruction_write_bin_instr(BOFFILE bf, bin_instr_t bi)
     case syscall_instr_type:
 	instruction_write_syscallInstr(bf, bi.syscall);
 	break;
+    case reg_comp_instr_type:
+	instruction_write_regCompInstr(bf, bi.rcomp);
+	break;
+    case reg_branch_instr_type:
+	instruction_write_regBranchInstr(bf, bi.rbranch);
+	break;
     default:
 	bail_with_error("Unknown instruction type in instruction_write_bin_instr (%d)",
 			instruction_type(bi));
@@ -150,6 +584,35 @@ void instruction_write_syscallInstr(BOFFILE bf, syscall_instr_t si)
     write_bin_instr(bf, bi);
 }
 
+// Requires: bof is open for writing in binary
+// Write the register computational instruction rci to bf in binary,
+// but exit with an error if there is a problem.
+void instruction_write_regCompInstr(BOFFILE bf, reg_comp_instr_t rci)
+{
+    bin_instr_t bi;
+    bi.rcomp = rci;
+
+    assert(bi.rcomp.op == COMP_O);
+    assert(bi.rcomp.func == REG_F);
+
+    write_bin_instr(bf, bi);
+}
+
+// Requires: bof is open for writing in binary
+// Write the register branch instruction rbi to bf in binary,
+// but exit with an error if there is a problem.
+void instruction_write_regBranchInstr(BOFFILE bf, reg_branch_instr_t rbi)
+{
+    bin_instr_t bi;
+    bi.rbranch = rbi;
+
+    assert(bi.rbranch.op == OTHC_O);
+    assert(bi.rbranch.func == RBR_F);
+    assert(bi.rbranch.offset == rbi.offset);
+
+    write_bin_instr(bf, bi);
+}
+
 // Requires: bof is open for writing in binary
 // Write the immediate instruction ii to bf in binary,
 // but exit with an error if there is a problem.
@@ -198,219 +661,275 @@ void instruction_write_jumpInstr(BOFFILE bf, jump_instr_t ji)
 
 // Return the assembly language name (mnemonic) for bi
 const char *instruction_mnemonic(bin_instr_t bi) {
-    switch (bi.comp.op) { // pretending a type is needed to get the op field
-    case COMP_O:
-	return instruction_compFunc2name(bi);
-	break;
-    case OTHC_O:
-	return instruction_otherCompFunc2name(bi);
-	break;
-    case ADDI_O:
-	return "ADDI";
-	break;
-    case ANDI_O:
-	return "ANDI";
-	break;
-    case BORI_O:
-	return "BORI";
-	break;
-    case NORI_O:
-	return "NORI";
-	break;
-    case XORI_O:
-	return "XORI";
-	break;
-    case BEQ_O:
-	return "BEQ";
-	break;
-    case BGEZ_O:
-	return "BGEZ";
-	break;
-    case BGTZ_O:
-	return "BGTZ";
-	break;
-    case BLEZ_O:
-	return "BLEZ";
-	break;
-    case BLTZ_O:
-	return "BLTZ";
-	break;
-    case BNE_O:
-	return "BNE";
-	break;
-    case JMPA_O:
-	return "JMPA";
-	break;
-    case CALL_O:
-	return "CALL";
-	break;
-    case RTN_O:
-	return "RTN";
-	break;
-    default:
-	bail_with_error("Unknown op code (%d) in instruction_mnemonic!",
-			bi.immed.op);
-	return NULL;   // should never happen
+    instr_id id = instruction_id(bi);
+    if (id == error_instr_id) {
+	bail_with_error("Unknown instruction (op %d, func %d) in instruction_mnemonic!",
+			bi.comp.op, bi.comp.func);
     }
-    return NULL;  // should never happen
+    return instruction_info[id].mnemonic;
 }
 
-static char address_comment_buf[512];
+// A place to format text into: chars go into buf[0..size-2]
+// and len counts the chars that have been put there so far
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;
+} fmt_out_t;
 
-// return a comment string of the form
-// "# target is word address %u"
-// that uses the formAddress function to get the proper address
-static const char *instruction_formAddress_comment(address_type addr,
-						   address_type a)
+// put the character c at the end of the text in out (if it fits)
+static void emit_char(fmt_out_t *out, char c)
 {
-    address_type actual = machine_types_formAddress(addr, a);
-    sprintf(address_comment_buf, "# target is word address %u",
-	    actual);
-    return strdup(address_comment_buf);
+    if (out->len + 1 < out->size) {
+	out->buf[out->len++] = c;
+    }
 }
 
+// put the string s at the end of the text in out (as much as fits)
+static void emit_str(fmt_out_t *out, const char *s)
+{
+    while (*s != '\0' && out->len + 1 < out->size) {
+	out->buf[out->len++] = *s++;
+    }
+}
 
-// Return a string containing the assembly language form of instr,
-// which is found at address addr
-const char *instruction_assembly_form(address_type addr,
-				      bin_instr_t instr)
+// put the decimal numeral for u at the end of the text in out
+static void emit_uint(fmt_out_t *out, unsigned int u)
 {
-    char *buf = instr_buf;
+    char digits[10];  // enough for 2^32-1
+    int n = 0;
+    do {
+	digits[n++] = '0' + (u % 10);
+	u /= 10;
+    } while (u != 0);
+    while (n > 0) {
+	emit_char(out, digits[--n]);
+    }
+}
 
+// put the decimal numeral for i (with a minus sign if i is negative)
+// at the end of the text in out
+static void emit_int(fmt_out_t *out, int i)
+{
+    if (i < 0) {
+	emit_char(out, '-');
+	emit_uint(out, - (unsigned int) i);
+    } else {
+	emit_uint(out, (unsigned int) i);
+    }
+}
+
+// put the lower case hexadecimal numeral for u
+// (without a leading "0x") at the end of the text in out
+static void emit_hex(fmt_out_t *out, unsigned int u)
+{
+    static const char hex_digits[] = "0123456789abcdef";
+    char digits[8];  // enough for 2^32-1
+    int n = 0;
+    do {
+	digits[n++] = hex_digits[u & 0xF];
+	u >>= 4;
+    } while (u != 0);
+    while (n > 0) {
+	emit_char(out, digits[--n]);
+    }
+}
+
+// put the name of register r at the end of the text in out
+static void emit_reg(fmt_out_t *out, reg_num_type r)
+{
+    emit_str(out, regname_get(r));
+}
+
+// put ", " at the end of the text in out
+static void emit_sep(fmt_out_t *out)
+{
+    emit_char(out, ',');
+    emit_char(out, ' ');
+}
+
+// put a comment of the form
+// "\t# target is word address %u"
+// at the end of the text in out, using the formAddress function
+// to get the proper address from addr and a
+static void emit_target_comment(fmt_out_t *out, address_type addr,
+				address_type a)
+{
+    emit_str(out, "\t# target is word address ");
+    emit_uint(out, machine_types_formAddress(addr, a));
+}
+
+// Requires: buf has room for size chars and size > 0.
+// Format the assembly language form of instr, which is found
+// at address addr, into buf, always followed by a null char,
+// and return the number of chars put into buf before that null char.
+// If size is at least INSTR_FORMAT_BUF_SIZE, the whole form fits.
+// This uses no static storage, so it may be called from several threads.
+size_t instruction_format(char *buf, size_t size,
+			  address_type addr, bin_instr_t instr)
+{
+    fmt_out_t fo = {buf, size, 0};
+    fmt_out_t *out = &fo;
+
+    const instr_info_t *info = &instruction_info[instruction_id(instr)];
+    if (info->type == error_instr_type) {
+	bail_with_error("Unknown instruction (op %d, func %d) in instruction_format!",
+			instr.comp.op, instr.comp.func);
+    }
     // put in the mnemonic for the instruction
-    int cwr = sprintf(buf, "%s ", instruction_mnemonic(instr));
-    // point buf to the null char that was printed into instr_buf
-    buf += cwr;
+    emit_str(out, info->mnemonic);
+    emit_char(out, ' ');
 
-    instr_type it = instruction_type(instr);
-    switch (it) {
-    case comp_instr_type:
-	switch (instr.comp.func) {
-	case NOP_F:
-	    // no arguments for NOP!
-	    break;
-	case ADD_F: case SUB_F: case CPW_F:
-	case AND_F: case BOR_F: case NOR_F: case XOR_F:
-	case SCA_F: case LWI_F: case NEG_F:
-	    sprintf(buf, "%s, %hd, %s, %hd",
-		    regname_get(instr.comp.rt),
-		    instr.comp.ot,
-		    regname_get(instr.comp.rs),
-		    instr.comp.os);
-	    break;
-	case CPR_F:
-	    sprintf(buf, "%s, %s",
-		    regname_get(instr.comp.rt),
-		    regname_get(instr.comp.rs));
-	    break;
-	case LWR_F: 
-	    sprintf(buf, "%s, %s, %hd",
-		    regname_get(instr.comp.rt),
-		    regname_get(instr.comp.rs),
-		    instr.comp.os);
-	    break;
-	case SWR_F: 
-	    sprintf(buf, "%s, %hd, %s",
-		    regname_get(instr.comp.rt),
-		    instr.comp.ot,
-		    regname_get(instr.comp.rs));
-	    break;
-	default:
-	    bail_with_error("Unknown computational instruction function (%d) for mnemonic %s!",
-			    instr.comp.func, buf);
-	    break;
-	}
-	break;
-    case other_comp_instr_type:
-	assert(instr.othc.op == OTHC_O);
-	switch (instr.othc.func) {
-	case LIT_F:
-	    sprintf(buf, "%s, %hd, %hd", regname_get(instr.othc.reg),
-		    instr.othc.offset, instr.othc.arg);
-	    break;
-	case ARI_F: case SRI_F:
-	    sprintf(buf, "%s, %hd", regname_get(instr.othc.reg),
-		    instr.othc.arg);
-	    break;
-	case MUL_F: case DIV_F: case CFHI_F: case CFLO_F: case JMP_F:
-	case CSI_F:
-	    sprintf(buf, "%s, %hd", regname_get(instr.othc.reg),
-		    instr.othc.offset);
-	    break;
-	case SLL_F: case SRL_F:
-	    sprintf(buf, "%s, %hd, %hu", regname_get(instr.othc.reg),
-		    instr.othc.offset, instr.othc.arg);
-	    break;
-	case JREL_F:
-	    sprintf(buf, "%hd\t%s", instr.othc.arg,
-		    instruction_formAddress_comment(addr,
-						    addr+instr.othc.arg));
-	    break;  
-	default:
-	    bail_with_error("Unknown other computational instruction function (%d)!",
-			    instr.comp.func);
-	    break;
-	}
-	break;
-    case immed_instr_type:
-	switch (instr.immed.op) {
-	case ADDI_O:
-	    sprintf(buf, "%s, %hd, %hd", regname_get(instr.immed.reg),
-		    instr.immed.offset, instr.immed.immed);
-	    break;
-	case ANDI_O: case BORI_O: case NORI_O: case XORI_O: 
-	    sprintf(buf, "%s, %hd, 0x%hx", regname_get(instr.immed.reg),
-		    instr.immed.offset, instr.immed.immed);
-	    break;
-	case BEQ_O: case BGEZ_O: case BGTZ_O:
-	case BLEZ_O: case BLTZ_O: case BNE_O:
-	    sprintf(buf, "%s, %hd, %hd\t%s", regname_get(instr.immed.reg),
-		    instr.immed.offset, instr.immed.immed,
-		    instruction_formAddress_comment(addr,
-						    addr+instr.immed.immed));
-	    break;
-	default:
-	    bail_with_error("Unknown immediate type instruction opcode (%d)!",
-			    instr.immed.op);
-	    break;
-	}
-	break;
-    case jump_instr_type:
-	switch (instr.jump.op) {
-	case JMPA_O: case CALL_O:
-	    sprintf(buf, "%u\t%s", instr.jump.addr,
-		    instruction_formAddress_comment(addr, instr.jump.addr));
-	    break;
-	case RTN_O:
-	    // no arguments in this case
-	    break;
-	default:
-	    bail_with_error("Unknown jump type instruction opcode (%d)!",
-			    instr.jump.op);
-	    break;
-	}
-	break;
-    case syscall_instr_type:
-	switch (instr.syscall.code) {
-	case exit_sc:
-	    sprintf(buf, "%hd", instr.syscall.offset);
-	    break;
-	case print_str_sc: case print_int_sc:
-	case print_char_sc: case read_char_sc:
-	    sprintf(buf, "%s, %hd", regname_get(instr.syscall.reg),
-		    instr.syscall.offset);
-	    break;
-	case start_tracing_sc: case stop_tracing_sc:
-	    // no arguments, so nothing to do!
-	    break;
-	}
+    switch (info->form) {
+    case no_arg_form:
+	// no arguments, so nothing to do!
+	break;
+    case two_reg_comp_form:
+	emit_reg(out, instr.comp.rt);
+	emit_sep(out);
+	emit_int(out, instr.comp.ot);
+	emit_sep(out);
+	emit_reg(out, instr.comp.rs);
+	emit_sep(out);
+	emit_int(out, instr.comp.os);
+	break;
+    case two_reg_no_offsets_form:
+	emit_reg(out, instr.comp.rt);
+	emit_sep(out);
+	emit_reg(out, instr.comp.rs);
+	break;
+    case no_target_offset_form:
+	emit_reg(out, instr.comp.rt);
+	emit_sep(out);
+	emit_reg(out, instr.comp.rs);
+	emit_sep(out);
+	emit_int(out, instr.comp.os);
+	break;
+    case no_source_offset_form:
+	emit_reg(out, instr.comp.rt);
+	emit_sep(out);
+	emit_int(out, instr.comp.ot);
+	emit_sep(out);
+	emit_reg(out, instr.comp.rs);
+	break;
+    case one_reg_offset_arg_form:
+	emit_reg(out, instr.othc.reg);
+	emit_sep(out);
+	emit_int(out, instr.othc.offset);
+	emit_sep(out);
+	emit_int(out, instr.othc.arg);
+	break;
+    case one_reg_arg_form:
+	emit_reg(out, instr.othc.reg);
+	emit_sep(out);
+	emit_int(out, instr.othc.arg);
+	break;
+    case one_reg_offset_form:
+	// the syscall format has its register and offset
+	// in the same places as the other computational format
+	emit_reg(out, instr.othc.reg);
+	emit_sep(out);
+	emit_int(out, instr.othc.offset);
+	break;
+    case shift_form:
+	emit_reg(out, instr.othc.reg);
+	emit_sep(out);
+	emit_int(out, instr.othc.offset);
+	emit_sep(out);
+	emit_uint(out, (unsigned short) instr.othc.arg);
+	break;
+    case arg_only_form:
+	emit_int(out, instr.othc.arg);
+	emit_target_comment(out, addr, addr+instr.othc.arg);
+	break;
+    case immed_arith_form:
+	emit_reg(out, instr.immed.reg);
+	emit_sep(out);
+	emit_int(out, instr.immed.offset);
+	emit_sep(out);
+	emit_int(out, instr.immed.immed);
+	break;
+    case immed_bool_form:
+	emit_reg(out, instr.immed.reg);
+	emit_sep(out);
+	emit_int(out, instr.immed.offset);
+	emit_sep(out);
+	emit_str(out, "0x");
+	emit_hex(out, (unsigned short) instr.immed.immed);
+	break;
+    case branch_test_form:
+	emit_reg(out, instr.immed.reg);
+	emit_sep(out);
+	emit_int(out, instr.immed.offset);
+	emit_sep(out);
+	emit_int(out, instr.immed.immed);
+	emit_target_comment(out, addr, addr+instr.immed.immed);
+	break;
+    case reg_comp_form:
+	emit_reg(out, instr.rcomp.rd);
+	emit_sep(out);
+	emit_reg(out, instr.rcomp.rs);
+	emit_sep(out);
+	emit_reg(out, instr.rcomp.rt);
+	break;
+    case reg_branch_form:
+	emit_reg(out, instr.rbranch.rs);
+	emit_sep(out);
+	emit_reg(out, instr.rbranch.rt);
+	emit_sep(out);
+	emit_int(out, instr.rbranch.offset);
+	emit_target_comment(out, addr, addr+instr.rbranch.offset);
+	break;
+    case jump_form:
+	emit_uint(out, instr.jump.addr);
+	emit_target_comment(out, addr, instr.jump.addr);
+	break;
+    case offset_only_form:
+	emit_int(out, instr.syscall.offset);
 	break;
     default:
-	bail_with_error("Unknown instruction type (%d) in instruction_assembly_form!",
-			it);
+	bail_with_error("Unknown instruction form (%d) in instruction_format!",
+			info->form);
 	break;
     }
 
+    buf[fo.len] = '\0';
+    return fo.len;
+}
+
+// Requires: buf has room for size chars and size > width + 3.
+// Format a line consisting of addr (right justified in width columns),
+// ": ", the assembly language form of instr (which is found at addr),
+// and a newline into buf, always followed by a null char,
+// and return the number of chars put into buf before that null char.
+// If size is at least width + INSTR_FORMAT_BUF_SIZE + 3, the whole line fits.
+size_t instruction_format_line(char *buf, size_t size, int width,
+			       address_type addr, bin_instr_t instr)
+{
+    fmt_out_t fo = {buf, size, 0};
+    int digits = 1;
+    for (address_type a = addr; a >= 10; a /= 10) {
+	digits++;
+    }
+    for (int i = digits; i < width; i++) {
+	emit_char(&fo, ' ');
+    }
+    emit_uint(&fo, addr);
+    emit_char(&fo, ':');
+    emit_char(&fo, ' ');
+    fo.len += instruction_format(buf + fo.len, size - fo.len, addr, instr);
+    emit_char(&fo, '\n');
+    buf[fo.len] = '\0';
+    return fo.len;
+}
+
+// Return a string containing the assembly language form of instr,
+// which is found at address addr.
+// The string is overwritten by the next call in the same thread.
+const char *instruction_assembly_form(address_type addr,
+				      bin_instr_t instr)
+{
+    instruction_format(instr_buf, sizeof(instr_buf), addr, instr);
     return instr_buf;
 }
 
@@ -424,40 +943,19 @@ void instruction_print_table_heading(FILE *out) {
 // Print addr on out, ": ", then the instruction's symbolic
 // (assembly language) form, and finally a newline character (all on one line)
 void instruction_print(FILE *out, address_type addr, bin_instr_t instr) {
-    fprintf(out, "%8u: %s\n", addr, instruction_assembly_form(addr, instr));
+    char line[INSTR_FORMAT_BUF_SIZE + 16];
+    size_t len = instruction_format_line(line, sizeof(line), 8, addr, instr);
+    fwrite(line, sizeof(char), len, out);
 }
 
 // Return the mnemonic for the given system call code
 const char *instruction_syscall_mnemonic(syscall_type code)
 {
-    switch (code) {
-    case exit_sc:
-	return "EXIT";
-	break;
-    case print_str_sc:
-	return "PSTR";
-	break;
-    case print_int_sc:
-	return "PINT";
-	break;
-    case print_char_sc:
-	return "PCH";
-	break;
-    case read_char_sc:
-	return "RCH";
-	break;
-    case start_tracing_sc:
-	return "STRA";
-	break;
-    case stop_tracing_sc:
-	return "NOTR";
-	break;
-    default:
+    if (code >= (1 << ARG_BITS) || syscall_ids[code] == error_instr_id) {
 	bail_with_error("Unknown code (%u) in instruction_syscall_mnemonic",
 			code);
-	return "NEVERHAPPENS";
-	break;
     }
+    return instruction_info[syscall_ids[code]].mnemonic;
 }
 
 // Requires: instr is a SYSCALL instruction
@@ -472,139 +970,33 @@ syscall_type instruction_syscall_number(bin_instr_t instr) {
 // Return a string giving the assembly language mnemonic for bi's operation
 const char *instruction_compFunc2name(bin_instr_t bi) {
     assert(bi.comp.op == COMP_O);
-    switch (bi.comp.func) {
-    case NOP_F:
-	return "NOP";
-	break;
-    case ADD_F:
-	return "ADD";
-	break;
-    case SUB_F:
-	return "SUB";
-	break;
-    case CPW_F:
-	return "CPW";
-	break;
-    case CPR_F:
-	return "CPR";
-	break;
-    case AND_F:
-	return "AND";
-	break;
-    case BOR_F:
-	return "BOR";
-	break;
-    case NOR_F:
-	return "NOR";
-	break;
-    case XOR_F:
-	return "XOR";
-	break;
-    case LWR_F:
-	return "LWR";
-	break;
-    case SWR_F:
-	return "SWR";
-	break;
-    case SCA_F:
-	return "SCA";
-	break;
-    case LWI_F:
-	return "LWI";
-	break;
-    case NEG_F:
-	return "NEG";
-	break;
-    default:
-	bail_with_error("Unknown function code (%d) in instruction_compFunc2name",
-			bi.comp.func);
-	break;
-    }
-    return NULL; // should never happen
+    return instruction_mnemonic(bi);
 }
 
 // Requires: bi is an other computational instruction (bi.othc.op == OTHC_O).
 // Return a string giving the assembly language mnemonic for bi's operation
 const char *instruction_otherCompFunc2name(bin_instr_t bi) {
     assert(bi.othc.op == OTHC_O);
-    switch (bi.othc.func) {
-    case LIT_F:
-	return "LIT";
-	break;
-    case ARI_F:
-	return "ARI";
-	break;
-    case SRI_F:
-	return "SRI";
-	break;
-    case MUL_F:
-	return "MUL";
-	break;
-    case DIV_F:
-	return "DIV";
-	break;
-    case CFHI_F:
-	return "CFHI";
-	break;
-    case CFLO_F:
-	return "CFLO";
-	break;
-    case SLL_F:
-	return "SLL";
-	break;
-    case SRL_F:
-	return "SRL";
-	break;
-    case JMP_F:
-	return "JMP";
-	break;
-    case CSI_F:
-	return "CSI";
-	break;
-    case JREL_F:
-	return "JREL";
-	break;
-    case SYS_F:
-	return instruction_syscall_mnemonic(instruction_syscall_number(bi));
-	break;
-    default:
-	bail_with_error("Unknown function code (%d) in instruction_otherCompFunc2name",
-			bi.comp.func);
-	break;
-    }
-    return NULL; // should never happen
+    return instruction_mnemonic(bi);
 }
 
 // Requires: toknum is the token number of a system call operation
 // Return the system call type corresponding to the given token number
 syscall_type instruction_token2SyscallCode(int toknum)
 {
+#define TOKEN2SYSCALL_CASE(NAME, name, type, op, func, sub, form) \
+    INSTR_TYPE_SELECT(type, INSTR_SKIP, INSTR_SKIP, INSTR_SKIP, \
+		      INSTR_SKIP, TOKEN2SYSCALL_RETURN, INSTR_SKIP, INSTR_SKIP) \
+    (name##opsym, sub)
+#define TOKEN2SYSCALL_RETURN(tok, code) case tok: return code;
     switch (toknum) {
-    case exitopsym:
-	return exit_sc;
-	break;
-    case pstropsym:
-	return print_str_sc;
-	break;
-    case pintopsym:
-	return print_int_sc;
-	break;
-    case pchopsym:
-	return print_char_sc;
-	break;
-    case rchopsym:
-	return read_char_sc;
-	break;
-    case straopsym:
-	return start_tracing_sc;
-	break;
-    case notropsym:
-	return stop_tracing_sc;
-	break;
+	SSM_INSTRUCTIONS(TOKEN2SYSCALL_CASE)
     default:
 	bail_with_error("Unknown token type in instruction_token2SyscallCode: %d",
 			toknum);
 	return 0; // should never happen
 	break;
     }
+#undef TOKEN2SYSCALL_RETURN
+#undef TOKEN2SYSCALL_CASE
 }
@@ -17,82 +17,31 @@
 // are defined in asm_lexer.l's user code section.
 
 
+// The cases of the switch statements below are generated from the
+// table in instruction_table.h; the token for an instruction is
+// its lower case name followed by "opsym" (e.g., addopsym for ADD),
+// except that NOP's token is noopsym
+#define nopopsym noopsym
+
+// a case of a switch statement that returns val for the token of name
+#define TOKEN_CASE(name, val) case name##opsym: return val;
+
 // Requires: toknum is a token number (from asm.tab.h)
 //           of an instruction
 // Return the opcode corresponding to the given opcode token number
 op_code lexer_token2opcode(int toknum)
 {
-    op_code ret;
-
+#define OPCODE_CASE(NAME, name, type, op, func, sub, form) \
+    TOKEN_CASE(name, op)
     switch (toknum) {
-    // register type op codes
-    case noopsym: case addopsym: case subopsym: case cpwopsym: case cpropsym:
-    case andopsym: case boropsym: case noropsym: case xoropsym:
-    case lwropsym: case swropsym: case scaopsym: case lwiopsym:
-    case negopsym:
-	ret = COMP_O;
-	break;
-    case litopsym: case ariopsym: case sriopsym:
-    case mulopsym: case divopsym: case cfhiopsym: case cfloopsym:
-    case sllopsym: case srlopsym: case jmpopsym: case csiopsym:
-    case jrelopsym:
-	ret = OTHC_O;
-	break;
-    // system call op codes
-    case exitopsym: case pstropsym: case pintopsym:
-    case pchopsym: case rchopsym: case straopsym: case notropsym:
-	ret = OTHC_O;  // opcode is OTHC_O for these
-	break;
-    // immedidate format op codes
-    case addiopsym:
-	ret = ADDI_O;
-	break;
-    case andiopsym:
-	ret = ANDI_O;
-	break;
-    case boriopsym:
-	ret = BORI_O;
-	break;
-    case noriopsym:
-	ret = NORI_O;
-	break;
-    case xoriopsym:
-	ret = XORI_O;
-	break;
-    case beqopsym:
-	ret = BEQ_O;
-	break;
-    case bgezopsym:
-	ret = BGEZ_O;
-	break;
-    case bgtzopsym:
-	ret = BGTZ_O;
-	break;
-    case blezopsym:
-	ret = BLEZ_O;
-	break;
-    case bltzopsym:
-	ret = BLTZ_O;
-	break;
-    case bneopsym:
-	ret = BNE_O;
-	break;
-	// jump format instructions
-    case jmpaopsym:
-	ret = JMPA_O;
-	break;
-    case callopsym:
-	ret = CALL_O;
-	break;
-    case rtnopsym:
-	ret = RTN_O;
-	break;
+	SSM_INSTRUCTIONS(OPCODE_CASE)
     default:
 	bail_with_error("Token number not of an op code (%d) in lexer_token2opcode!",
 			toknum);
 	break;
     }
-    return ret;
+#undef OPCODE_CASE
+    return 0;  // should never happen
 }
 
 // Requires: toknum is a token number (from asm.tab.h)
@@ -101,96 +50,18 @@ op_code lexer_token2opcode(int toknum)
 // Return the function code corresponding to the given opcode token number
 func_type lexer_token2func(int toknum)
 {
-    func_type ret;
-
+#define FUNC_CASE(NAME, name, type, op, func, sub, form) \
+    INSTR_TYPE_SELECT(type, TOKEN_CASE, TOKEN_CASE, INSTR_SKIP, INSTR_SKIP, \
+		      TOKEN_CASE, TOKEN_CASE, TOKEN_CASE) \
+    (name, func)
     switch (toknum) {
-    case noopsym:
-	ret = NOP_F;
-	break;
-    case addopsym:
-	ret = ADD_F;
-	break;
-    case subopsym:
-	ret = SUB_F;
-	break;
-    case cpwopsym:
-	ret = CPW_F;
-	break;
-    case cpropsym:
-	ret = CPR_F;
-	break;
-    case andopsym:
-	ret = AND_F;
-	break;
-    case boropsym:
-	ret = BOR_F;
-	break;
-    case noropsym:
-	ret = NOR_F;
-	break;
-    case xoropsym:
-	ret = XOR_F;
-	break;
-    case lwropsym:
-	ret = LWR_F;
-	break;
-    case swropsym:
-	ret = SWR_F;
-	break;
-    case scaopsym:
-	ret = SCA_F;
-	break;
-    case lwiopsym:
-	ret = LWI_F;
-	break;
-    case negopsym:
-	ret = NEG_F;
-	break;
-    case litopsym:
-	ret = LIT_F;
-	break;
-    case ariopsym:
-	ret = ARI_F;
-	break;
-    case sriopsym:
-	ret = SRI_F;
-	break;
-    case mulopsym:
-	ret = MUL_F;
-	break;
-    case divopsym:
-	ret = DIV_F;
-	break;
-    case cfhiopsym:
-	ret = CFHI_F;
-	break;
-    case cfloopsym:
-	ret = CFLO_F;
-	break;
-    case sllopsym:
-	ret = SLL_F;
-        break;
-    case srlopsym:
-	ret = SRL_F;
-	break;
-    case jmpopsym:
-	ret = JMP_F;
-	break;
-    case csiopsym:
-	ret = CSI_F;
-	break;
-    case jrelopsym:
-	ret = JREL_F;
-	break;
-    case exitopsym: case pstropsym: case pintopsym: case pchopsym:
-    case rchopsym: case straopsym: case notropsym:
-	ret = SYS_F;
-	break;
+	SSM_INSTRUCTIONS(FUNC_CASE)
     default:
 	bail_with_error("Unhandled token (%d) in lexer_token2func", toknum);
 	break;
     }
-    return ret;
+#undef FUNC_CASE
+    return 0;  // should never happen
 }
 
 // Requires: toknum is a token number (from asm.tab.h)
@@ -198,33 +69,57 @@ func_type lexer_token2func(int toknum)
 // Return the system call code that corresponds to that token
 syscall_type lexer_token2syscall_code(int toknum)
 {
-    syscall_type ret;
+#define SYSCALL_CASE(NAME, name, type, op, func, sub, form) \
+    INSTR_TYPE_SELECT(type, INSTR_SKIP, INSTR_SKIP, INSTR_SKIP, INSTR_SKIP, \
+		      TOKEN_CASE, INSTR_SKIP, INSTR_SKIP) \
+    (name, sub)
     switch (toknum) {
-    case exitopsym:
-	ret = exit_sc;
-	break;
-    case pstropsym:
-	ret = print_str_sc;
-	break;
-    case pintopsym:
-	ret = print_int_sc;
-	break;
-    case pchopsym:
-	ret = print_char_sc;
-	break;
-    case rchopsym:
-	ret = read_char_sc;
-	break;
-    case straopsym:
-	ret = start_tracing_sc;
+	SSM_INSTRUCTIONS(SYSCALL_CASE)
+    default:
+	bail_with_error("Unknown token (%d) given to lexer_token2syscall_code!",
+			toknum);
 	break;
-    case notropsym:
-	ret = stop_tracing_sc;
+    }
+#undef SYSCALL_CASE
+    return 0;  // should never happen
+}
+
+// Requires: toknum is a token number (from asm.tab.h)
+//           that corresponds to a register computational instruction
+// Return the register operation code that corresponds to that token
+reg_op_code lexer_token2regop(int toknum)
+{
+#define REG_OP_CASE(NAME, name, type, op, func, sub, form) \
+    INSTR_TYPE_SELECT(type, INSTR_SKIP, INSTR_SKIP, INSTR_SKIP, INSTR_SKIP, \
+		      INSTR_SKIP, TOKEN_CASE, INSTR_SKIP) \
+    (name, sub)
+    switch (toknum) {
+	SSM_INSTRUCTIONS(REG_OP_CASE)
+    default:
+	bail_with_error("Unknown token (%d) given to lexer_token2regop!",
+			toknum);
 	break;
+    }
+#undef REG_OP_CASE
+    return 0;  // should never happen
+}
+
+// Requires: toknum is a token number (from asm.tab.h)
+//           that corresponds to a register branch instruction
+// Return the comparison code that corresponds to that token
+reg_branch_code lexer_token2regcmp(int toknum)
+{
+#define CMP_CASE(NAME, name, type, op, func, sub, form) \
+    INSTR_TYPE_SELECT(type, INSTR_SKIP, INSTR_SKIP, INSTR_SKIP, INSTR_SKIP, \
+		      INSTR_SKIP, INSTR_SKIP, TOKEN_CASE) \
+    (name, sub)
+    switch (toknum) {
+	SSM_INSTRUCTIONS(CMP_CASE)
     default:
-	bail_with_error("Unknown token (%d) given to lexer_token2syscall_code!",
+	bail_with_error("Unknown token (%d) given to lexer_token2regcmp!",
 			toknum);
-	ret = 0;
+	break;
     }
-    return ret;
+#undef CMP_CASE
+    return 0;  // should never happen
 }
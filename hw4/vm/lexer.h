@@ -8,44 +8,64 @@
 #include "asm.tab.h"
 #include "instruction.h"
 
-// Have any error messages been printed?
-extern bool errors_noted;
-
-// The current input file
-// extern FILE *yyin;
-// The input line number of the current or next input line
-// extern int yylineno;
-// The value of the current token
-// extern YYSTYPE yylval;
+// A scanner, which reads one input and keeps its own state
+// (its position, its errors, and so on), so scanners of different
+// inputs are independent; it is passed to the parser (see asm.y)
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void *yyscan_t;
+#endif
 
 // Requires: fname != NULL
 // Requires: fname is the name of a readable file
-// Initialize the lexer and start it reading
-// from the given file name
-extern void lexer_init(char *fname);
+// Return a new scanner that reads from the given file name
+extern yyscan_t lexer_init(char *fname);
+
+// Requires: name != NULL and buf holds len chars
+// Return a new scanner that reads the len chars starting at buf
+// (which it copies), calling them name in error messages.
+// Errors are then kept (see lexer_first_error) instead of being printed.
+extern yyscan_t lexer_init_buffer(const char *name, const char *buf,
+				  size_t len);
+
+// Have any errors been noted in the scanner's input?
+extern bool lexer_errors_noted(yyscan_t scanner);
+
+// Return the message of the first error noted in the input
+// given to lexer_init_buffer, or the empty string if there was none
+extern const char *lexer_first_error(yyscan_t scanner);
+
+// Release the scanner and its input file, if it is still open
+// (as it is when parsing stops before the end of the file),
+// or its input in memory
+extern void lexer_close(yyscan_t scanner);
 
-// Return the next token in the input
-extern int yylex();
+// Return the next token in the scanner's input, putting its value in *lvalp
+extern int yylex(YYSTYPE *lvalp, YYLTYPE *llocp, yyscan_t scanner);
 
-// Return the name of the current file
-extern const char *lexer_filename();
+// Return the name of the scanner's input file
+extern const char *lexer_filename(yyscan_t scanner);
 
-// Return the line number of the next token
-extern unsigned int lexer_line();
+// Return the line number of the scanner's next token
+extern unsigned int lexer_line(yyscan_t scanner);
+
+// Report an error in the scanner's input to the user on stderr
+// (or keep it, if it is the first in input in memory; see lexer_init_buffer)
+extern void lexer_error(yyscan_t scanner, const char *msg);
 
 // On standard output:
-// Print a message about the file name of the lexer's input
+// Print a message about the file name of the scanner's input
 // and then print a heading for the lexer's output.
-extern void lexer_print_output_header();
+extern void lexer_print_output_header(yyscan_t scanner);
 
 // Print information about the token t to stdout
 // followed by a newline
 extern void lexer_print_token(int t, unsigned int tline,
 			      const char *txt);
 
-// On standard output, print each token
+// On standard output, print each token of the scanner's input
 // using the format in lexer_print_token
-extern void lexer_output();
+extern void lexer_output(yyscan_t scanner);
 
 // Requires: toknum is a token number (from asm.tab.h)
 //           of an instruction
@@ -60,4 +80,14 @@ extern func_type lexer_token2func(int toknum);
 // Return the system call code that corresponds to that token
 extern syscall_type lexer_token2syscall_code(int toknum);
 
+// Requires: toknum is a token number (from asm.tab.h)
+//           that corresponds to a register computational instruction
+// Return the register operation code that corresponds to that token
+extern reg_op_code lexer_token2regop(int toknum);
+
+// Requires: toknum is a token number (from asm.tab.h)
+//           that corresponds to a register branch instruction
+// Return the comparison code that corresponds to that token
+extern reg_branch_code lexer_token2regcmp(int toknum);
+
 #endif
@@ -20,7 +20,8 @@ int main(int argc, char *argv[]) {
 	usage(cmdname);
     }
 
-    lexer_init(argv[0]);
-    lexer_output();
+    yyscan_t scanner = lexer_init(argv[0]);
+    lexer_output(scanner);
+    lexer_close(scanner);
     return EXIT_SUCCESS;
 }
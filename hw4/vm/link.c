@@ -0,0 +1,260 @@
+/* $Id$ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "link.h"
+#include "instruction.h"
+#include "utilities.h"
+
+// the data section starts at a multiple of this, if it has to be moved
+#define DATA_ALIGNMENT 1024
+
+// a symbol defined by one of the objects being linked
+typedef struct {
+    const char *name;
+    int obj;                    // index of the defining object
+    int other_obj;              // index of another object that defines it
+                                // (or -1 if there is none)
+    obj_sym_section section;
+    word_type addr;             // address (text) or $gp offset (data)
+} definition;
+
+// Compare the definitions pointed to by a and b by name,
+// and then by the index of their objects (for qsort)
+static int compare_definitions(const void *a, const void *b)
+{
+    const definition *da = (const definition *) a;
+    const definition *db = (const definition *) b;
+    int cmp = strcmp(da->name, db->name);
+    return (cmp != 0) ? cmp : da->obj - db->obj;
+}
+
+// Compare the definitions pointed to by a and b by name (for bsearch)
+static int compare_definition_names(const void *a, const void *b)
+{
+    return strcmp(((const definition *) a)->name,
+		  ((const definition *) b)->name);
+}
+
+// Return the definition of name in the sorted array defs of count
+// definitions, or NULL if there is none
+static const definition *find_definition(const definition *defs, int count,
+					 const char *name)
+{
+    definition key;
+    key.name = name;
+    return (const definition *) bsearch(&key, defs, count,
+					sizeof(definition),
+					compare_definition_names);
+}
+
+// Return the definition of name in the sorted array defs of count
+// definitions of the symbols of the objects in objs, or NULL if there is none.
+// The name is used in the object named used_in,
+// or is the entry point if used_in is NULL.
+// Exit with an error if more than one object defines it,
+// as then which of them is meant is not known.
+static const definition *find_unique_definition(const BOFObject *objs,
+						const definition *defs,
+						int count, const char *name,
+						const char *used_in)
+{
+    const definition *d = find_definition(defs, count, name);
+    if (d != NULL && d->other_obj >= 0) {
+	const char *f1 = objs[d->obj].filename;
+	const char *f2 = objs[d->other_obj].filename;
+	if (used_in != NULL) {
+	    bail_with_error("Label \"%s\" (used in %s) is defined in both %s and %s!",
+			    name, used_in, f1, f2);
+	}
+	bail_with_error("Entry point label \"%s\" is defined in both %s and %s!",
+			name, f1, f2);
+    }
+    return d;
+}
+
+// Return a sorted array of the symbols defined in the n objects in objs,
+// whose sections start at the given bases, and set *countp to its size.
+// A symbol defined in more than one object is only in it once,
+// marked with the first two objects that define it,
+// as that is only an error if the symbol is used by name
+// (each object's jumps to its own labels being resolved in place).
+static definition *collect_definitions(const BOFObject *objs, int n,
+				       const word_type *text_base,
+				       const word_type *data_base,
+				       int *countp)
+{
+    int total = 0;
+    for (int i = 0; i < n; i++) {
+	total += objs[i].symbol_count;
+    }
+    definition *defs = (definition *) malloc((total > 0 ? total : 1)
+					     * sizeof(definition));
+    if (defs == NULL) {
+	bail_with_error("No space for the linker's symbol table!");
+    }
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+	for (int s = 0; s < objs[i].symbol_count; s++) {
+	    const BOFObjectSymbol *sym = &objs[i].symbols[s];
+	    if (sym->section == obj_sym_undefined) {
+		continue;
+	    }
+	    definition *d = &defs[count++];
+	    d->name = bof_object_symbol_name(&objs[i], s);
+	    d->obj = i;
+	    d->other_obj = -1;
+	    d->section = (obj_sym_section) sym->section;
+	    d->addr = sym->value + ((sym->section == obj_sym_text)
+				    ? text_base[i] : data_base[i]);
+	}
+    }
+    qsort(defs, count, sizeof(definition), compare_definitions);
+    int kept = 0;
+    for (int k = 0; k < count; k++) {
+	if (kept > 0 && strcmp(defs[kept-1].name, defs[k].name) == 0) {
+	    if (defs[kept-1].other_obj < 0) {
+		defs[kept-1].other_obj = defs[k].obj;
+	    }
+	} else {
+	    defs[kept++] = defs[k];
+	}
+    }
+    *countp = kept;
+    return defs;
+}
+
+// Apply the relocations of objs[i], whose text and data start at
+// text_base and data_base in the combined sections,
+// to its text section, in place.
+// Its jumps to labels it imports are resolved using the count
+// definitions in defs (of the symbols of the objects in objs).
+static void relocate(BOFObject *objs, int i, word_type text_base,
+		     word_type data_base, const definition *defs, int count)
+{
+    BOFObject *obj = &objs[i];
+    for (int k = 0; k < obj->reloc_count; k++) {
+	const BOFObjectReloc *r = &obj->relocs[k];
+	bin_instr_t bi = instruction_decode(obj->text[r->offset]);
+	if (r->kind == obj_reloc_text) {
+	    if (instruction_type(bi) != jump_instr_type) {
+		bail_with_error("Bad text relocation at offset %d in %s!",
+				r->offset, obj->filename);
+	    }
+	    word_type a = bi.jump.addr + text_base;
+	    if (a < 0 || a > TWENTYEIGHTBITSMAXUNSIGNED) {
+		bail_with_error("Relocated jump address %d (at offset %d in %s) %s",
+				a, r->offset, obj->filename,
+				"does not fit in an instruction!");
+	    }
+	    bi.jump.addr = a;
+	} else if (r->kind == obj_reloc_jump) {
+	    const char *name = bof_object_symbol_name(obj, r->symbol);
+	    const definition *d = find_unique_definition(objs, defs, count,
+							 name, obj->filename);
+	    if (d == NULL) {
+		bail_with_error("Label \"%s\" (used in %s) was never defined!",
+				name, obj->filename);
+	    }
+	    if (d->section != obj_sym_text
+		|| instruction_type(bi) != jump_instr_type) {
+		bail_with_error("Cannot jump to \"%s\" (in %s), it is not a label!",
+				name, obj->filename);
+	    }
+	    if (d->addr < 0 || d->addr > TWENTYEIGHTBITSMAXUNSIGNED) {
+		bail_with_error("Address of \"%s\" (%d) is too large for a jump!",
+				name, d->addr);
+	    }
+	    bi.jump.addr = d->addr;
+	} else {
+	    int which = (r->kind == obj_reloc_gp1) ? 0 : 1;
+	    reg_num_type regs[2];
+	    offset_type offsets[2];
+	    if (instruction_memory_operands(bi, regs, offsets) <= which) {
+		bail_with_error("Bad $gp relocation at offset %d in %s!",
+				r->offset, obj->filename);
+	    }
+	    int o = offsets[which] + data_base;
+	    if (o < -(NINEBITSMAXSIGNED+1) || o > NINEBITSMAXSIGNED) {
+		bail_with_error("Relocated $gp offset %d (at offset %d in %s) %s",
+				o, r->offset, obj->filename,
+				"does not fit in an instruction!");
+	    }
+	    instruction_set_memory_offset(&bi, which, o);
+	}
+	obj->text[r->offset] = instruction_encode(bi);
+    }
+}
+
+// Requires: n >= 1
+// Link the n relocatable objects in objs into one program,
+// with output going to bf (see link.h for the layout and errors)
+void link_objects(BOFFILE bf, BOFObject *objs, int n, const char *entry)
+{
+    word_type *text_base = (word_type *) malloc(n * sizeof(word_type));
+    word_type *data_base = (word_type *) malloc(n * sizeof(word_type));
+    if (text_base == NULL || data_base == NULL) {
+	bail_with_error("No space to link %d objects!", n);
+    }
+    word_type text_words = 0, data_words = 0;
+    for (int i = 0; i < n; i++) {
+	text_base[i] = text_words;
+	data_base[i] = data_words;
+	text_words += objs[i].header.text_length;
+	data_words += objs[i].header.data_length;
+    }
+
+    int count;
+    definition *defs = collect_definitions(objs, n, text_base, data_base,
+					   &count);
+    for (int i = 0; i < n; i++) {
+	relocate(objs, i, text_base[i], data_base[i], defs, count);
+    }
+
+    BOFHeader bh;
+    const BOFHeader *first = &objs[0].header;
+    if (entry != NULL) {
+	const definition *d = find_unique_definition(objs, defs, count,
+						     entry, NULL);
+	if (d == NULL || d->section != obj_sym_text) {
+	    bail_with_error("Entry point label \"%s\" is not defined!", entry);
+	}
+	bh.text_start_address = d->addr;
+    } else {
+	bh.text_start_address = (first->text_start_address >= 0)
+	    ? first->text_start_address : 0;
+    }
+    bh.data_start_address = first->data_start_address;
+    if (bh.data_start_address <= text_words) {
+	bh.data_start_address = (text_words / DATA_ALIGNMENT + 1)
+	    * DATA_ALIGNMENT;
+    }
+    word_type stack_words = first->stack_bottom_addr
+	- (first->data_start_address + first->data_length);
+    bh.stack_bottom_addr = bh.data_start_address + data_words + stack_words;
+    if (bh.stack_bottom_addr < first->stack_bottom_addr) {
+	bh.stack_bottom_addr = first->stack_bottom_addr;
+    }
+    free(defs);
+    free(text_base);
+    free(data_base);
+
+    BOFBuffer bb;
+    bof_buffer_initialize(&bb);
+    for (int i = 0; i < n; i++) {
+	bof_buffer_add_bytes(&bb, objs[i].header.text_length * BYTES_PER_WORD,
+			     objs[i].text);
+    }
+    bof_buffer_end_text(&bb);
+    // zeros are added as such, so that trailing ones become zero fill
+    for (int i = 0; i < n; i++) {
+	for (int k = 0; k < objs[i].header.data_length; k++) {
+	    if (objs[i].data[k] == 0) {
+		bof_buffer_add_zeros(&bb, 1);
+	    } else {
+		bof_buffer_add_word(&bb, objs[i].data[k]);
+	    }
+	}
+    }
+    bof_buffer_write(bf, &bb, bh);
+}
@@ -0,0 +1,27 @@
+/* $Id$ */
+#ifndef _LINK_H
+#define _LINK_H
+#include "bof.h"
+#include "bof_object.h"
+
+// Requires: n >= 1
+// Link the n relocatable objects in objs into one program,
+// with output going to bf.
+// The objects' text sections are placed one after another,
+// starting at address 0, and so are their data sections,
+// starting at the first object's data start address
+// (moved past the text if that has become too long).
+// Each object's jumps to its own labels are moved by the start of its text,
+// its other jump addresses are resolved against the symbols
+// the objects define, and its $gp-relative offsets are moved
+// by the start of its data in the combined data section.
+// The stack keeps the room that the first object gave it.
+// The program starts at the text label named entry if that is not NULL,
+// and otherwise at the first object's entry point.
+// Exit with an error if a symbol that is imported (or named as entry)
+// is defined by more than one object or never defined,
+// or if a relocated address or offset does not fit its instruction.
+extern void link_objects(BOFFILE bf, BOFObject *objs, int n,
+			 const char *entry);
+
+#endif
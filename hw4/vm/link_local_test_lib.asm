@@ -0,0 +1,21 @@
+	# $Id$
+	# library part of the linker test of local labels (linked with
+	# link_local_test_main.asm), whose loop and done are its own
+	.text stars
+stars:	SRI $sp, 1
+	LIT $sp, 0, 0
+loop:	BNE $gp, 0, 2       # while n != 0 (the top of stack is 0)
+	JMPA done
+	PCH $gp, 1          # print star
+	ADDI $gp, 0, -1     # n--
+	LIT $sp, 0, 0       # top of stack is 0 (PCH overwrote it)
+	JMPA loop
+done:	PCH $gp, 2          # print nl
+	ARI $sp, 1
+	RTN
+	.data 1024
+	WORD n = 2
+	CHAR star = '*'
+	CHAR nl = '\n'
+	.stack 4096
+	.end
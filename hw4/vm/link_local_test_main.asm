@@ -0,0 +1,21 @@
+	# $Id$
+	# main part of the linker test of local labels (linked with
+	# link_local_test_lib.asm): both parts have labels loop and done
+	# and a data name n, and each part uses its own
+	.text start
+start:	CALL stars          # print the library's stars
+	SRI $sp, 1
+	LIT $sp, 0, 0
+loop:	BNE $gp, 0, 2       # while n != 0 (the top of stack is 0)
+	JMPA done
+	PINT $gp, 0         # print n
+	ADDI $gp, 0, -1     # n--
+	LIT $sp, 0, 0       # top of stack is 0 (PINT overwrote it)
+	JMPA loop
+done:	PCH $gp, 1          # print nl
+	EXIT 0
+	.data 1024
+	WORD n = 3
+	CHAR nl = '\n'
+	.stack 4096
+	.end
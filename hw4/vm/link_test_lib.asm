@@ -0,0 +1,20 @@
+	# $Id$
+	# library part of the linker test (linked with link_test_main.asm);
+	# its data offsets from $gp are moved by the linker
+	# to where its data lands after the main part's data
+	.text greet
+greet:	PSTR $gp, 0         # print hello
+	RTN
+count:	PCH $gp, 2          # print star, times times
+	ADDI $gp, 3, -1     # times--
+	LIT $sp, 0, 0       # top of stack is 0 (PCH overwrote it)
+	BNE $gp, 3, -3      # repeat while times != 0
+	PCH $gp, 4          # print nl
+	RTN
+	.data 1024
+	STRING[2] hello = "hello\n"
+	CHAR star = '*'
+	WORD times = 3
+	CHAR nl = '\n'
+	.stack 4096
+	.end
@@ -0,0 +1,14 @@
+	# $Id$
+	# main part of the linker test (linked with link_test_lib.asm):
+	# it calls greet and count, which are defined in the library
+	# and use the library's own data, then prints its own message
+	.text start
+start:	CALL greet
+	CALL count
+	PSTR $gp, 1         # print done
+	EXIT 0
+	.data 1024
+	WORD n = 3
+	STRING[2] done = "done\n"
+	.stack 4096
+	.end
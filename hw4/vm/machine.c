@@ -1,28 +1,55 @@
 /* $Id: machine.c,v 1.49 2024/11/10 22:47:50 leavens Exp leavens $ */
+// for clock_gettime
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
 #include <assert.h>
+#include <setjmp.h>
+#include <pthread.h>
 #include "machine_types.h"
 #include "machine.h"
+#include "bof_debug.h"
 #include "regname.h"
 #include "utilities.h"
 
 #define MAX_PRINT_WIDTH 59
+// size of the buffer used by the bulk character printing system call
+#define PRINT_CHARS_BUF_SIZE 512
+// maximum number of VM threads, including the main thread (number 0)
+#define MAX_THREADS 64
+// maximum number of coroutines in each VM thread,
+// including the thread's main coroutine (number 0)
+#define MAX_COROUTINES 32
+// maximum number of distinct measurement regions
+#define MAX_REGIONS 32
+// maximum number of characters kept from a region's name
+#define MAX_REGION_NAME_LEN 32
+// number of heap size classes; blocks in class c have 2^c words
+#define HEAP_NUM_CLASSES 15
+// words in a slab, which is carved into blocks of one small size class
+#define HEAP_SLAB_WORDS 256
 
-// the VM's memory, in signed and unsigned word and binary instruction views.
+// The VM's memory is shared by all VM threads,
+// but each thread has its own registers and tracing state
+// (hence the _Thread_local declarations below).
+
+// the VM's memory, in signed and unsigned word views;
+// instructions are kept in their encoded form (see instruction_encode)
 static union mem_u {
     word_type words[MEMORY_SIZE_IN_WORDS];
     uword_type uwords[MEMORY_SIZE_IN_WORDS];
-    bin_instr_t instrs[MEMORY_SIZE_IN_WORDS];
 } memory;
 
 // general purpose registers
-static word_type GPR[NUM_REGISTERS];
+static _Thread_local word_type GPR[NUM_REGISTERS];
 // hi and lo registers used in multiplication and division.
 // A view as a (signed) long int (result, 64 bits)
 // and as an array (hilo) of 2 32-bit ints.
-static union longAs2words_u {
+static _Thread_local union longAs2words_u {
     long result;
     word_type hilo[2]; 
 } hilo_regs;
@@ -33,22 +60,200 @@ static union longAs2words_u {
 #define HI 1
 
 // the program counter
-static address_type PC;
+static _Thread_local address_type PC;
 
 // should the machine be printing tracing output?
-static bool tracing;
+static _Thread_local bool tracing;
 
 // initial_stack_bottom is used for tracing
-static address_type initial_stack_bottom;
+static _Thread_local address_type initial_stack_bottom;
 
 // words of instructions (based on the header)
 static unsigned short instruction_words;
 // words of global data (based on the header)
 static unsigned short global_data_words;
+// the loaded program's debugging information (empty if it has none)
+static BOFDebugInfo debug_info;
+// where the program's input comes from (stdin if this is NULL)
+static FILE *program_input = NULL;
+
+// the decoded form of a word of memory, so that running an instruction
+// does not have to decode it each time (see fetch_instr)
+typedef struct {
+    bool decoded;       // is this entry filled in?
+    uword_type word;    // the word that was decoded
+    bin_instr_t bi;     // what it decodes to
+    instr_id id;        // and that instruction's instr_id
+} decoded_instr_t;
+
+// the decoded instruction at each word address of the text;
+// the entries are only written by machine_load, so the threads
+// can share them without locking. A word whose entry is not filled in
+// or no longer matches the memory (because the program stored into it)
+// is decoded by the thread that runs it each time it is run.
+static decoded_instr_t decoded_instrs[MEMORY_SIZE_IN_WORDS];
 
 
 // should the machine be running? (default true)
-static bool running;
+static _Thread_local bool running;
+
+// where the main VM thread's EXIT instruction returns to (in machine_run)
+static jmp_buf exit_env;
+// the exit code of the main VM thread (set by its EXIT instruction)
+static word_type exit_code;
+
+// this VM thread's number (0 for the main thread)
+static _Thread_local int thread_id;
+// the exit code of this VM thread (if it is not the main thread)
+static _Thread_local word_type thread_exit_code;
+// a copy of this VM thread's $sp, kept up to date after each instruction,
+// that other VM threads read (atomically) to keep the heap below it
+static _Thread_local word_type stack_top;
+// the lowest $sp of this VM thread's suspended coroutines
+// (MEMORY_SIZE_IN_WORDS if it has none), which the other VM threads
+// also read (atomically) to keep the heap below those coroutines' stacks
+static _Thread_local word_type suspended_stack_top;
+
+// the starting state of a spawned VM thread
+typedef struct {
+    int id;
+    address_type PC;
+    word_type GPR[NUM_REGISTERS];
+    bool tracing;
+} thread_start_t;
+
+// the table of VM threads, indexed by thread number;
+// the main thread's entry is in use while machine_run runs
+static struct {
+    bool in_use;
+    pthread_t host_thread;
+    thread_start_t start;
+    // where the thread's stack_top and suspended_stack_top are
+    // while it runs (NULL before it starts)
+    word_type *stack_top;
+    word_type *suspended_stack_top;
+    // has the thread executed EXIT?
+    bool finished;
+    // is some VM thread (or stop_threads) waiting for it to finish?
+    bool joining;
+} threads[MAX_THREADS];
+
+// set when the main VM thread stops, or a spawned VM thread reports
+// an error, to stop the other VM threads
+static bool stopping_threads;
+// the first error reported by a spawned VM thread, if thread_failed
+// (both protected by threads_lock), which machine_run reports
+// once all of the VM threads have stopped
+static bool thread_failed;
+static error_context thread_error;
+
+// protects the threads table
+static pthread_mutex_t threads_lock = PTHREAD_MUTEX_INITIALIZER;
+// serializes the tracing output of different VM threads
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// the saved registers of a coroutine
+typedef struct {
+    bool in_use;
+    address_type PC;
+    word_type GPR[NUM_REGISTERS];
+    long hilo;
+    address_type stack_bottom;
+} coroutine_t;
+
+// the coroutines of this VM thread, indexed by coroutine number;
+// the entry for the running coroutine is only up to date
+// when it is not running
+static _Thread_local coroutine_t coroutines[MAX_COROUTINES];
+// the number of the coroutine that is running in this VM thread
+static _Thread_local int current_coroutine;
+
+// the number of instructions executed by this VM thread
+static _Thread_local unsigned long instructions_executed;
+// the number of instructions executed by VM threads that have finished
+// (other than the main VM thread)
+static unsigned long finished_threads_instructions;
+
+// the measurements of a named region of the program,
+// summed over all the times (in all VM threads) it was run
+typedef struct {
+    char name[MAX_REGION_NAME_LEN + 1];
+    unsigned long entries;
+    unsigned long instructions;
+    unsigned long long nanoseconds;
+} region_t;
+
+// the measurement regions, in the order they were first started
+static region_t regions[MAX_REGIONS];
+static int num_regions;
+// protects the regions table
+static pthread_mutex_t regions_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// when each region was started in this VM thread (if it is active)
+static _Thread_local struct {
+    bool active;
+    unsigned long instructions;
+    struct timespec time;
+} region_starts[MAX_REGIONS];
+
+// The heap lies between the end of the global data
+// and the stack, and grows upward from heap_start to heap_break.
+// Blocks are allocated from free lists, one for each size class,
+// that are linked through the first word of each free block.
+static address_type heap_start;
+static address_type heap_break;
+static address_type heap_free_lists[HEAP_NUM_CLASSES];
+// the number of words requested for the allocated block
+// that starts at each address (0 if no allocated block starts there)
+static word_type heap_block_words[MEMORY_SIZE_IN_WORDS];
+// protects the heap
+static pthread_mutex_t heap_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// heap statistics
+static struct {
+    unsigned long allocations;
+    unsigned long frees;
+    unsigned long live_requested_words;
+    unsigned long live_block_words;
+    unsigned long peak_block_words;
+} heap_stats;
+
+// Start this VM thread's coroutines with just its main coroutine
+static void initialize_coroutines()
+{
+    for (int i = 0; i < MAX_COROUTINES; i++) {
+	coroutines[i].in_use = false;
+    }
+    coroutines[0].in_use = true;
+    current_coroutine = 0;
+    suspended_stack_top = MEMORY_SIZE_IN_WORDS;
+}
+
+// Decode the word w into *d
+// (bailing with an error if it is not an instruction)
+static void decode_instr(uword_type w, decoded_instr_t *d)
+{
+    bin_instr_t bi = instruction_decode(w);
+    d->word = w;
+    d->bi = bi;
+    d->id = instruction_id(bi);
+    d->decoded = true;
+}
+
+// Return the decoded form of the instruction at word address wa:
+// its entry in decoded_instrs if that is valid,
+// and otherwise the one decoded into *local
+static const decoded_instr_t *fetch_instr(address_type wa,
+					  decoded_instr_t *local)
+{
+    uword_type w = memory.uwords[wa];
+    const decoded_instr_t *d = &decoded_instrs[wa];
+    if (d->decoded && d->word == w) {
+	return d;
+    }
+    decode_instr(w, local);
+    return local;
+}
 
 // set up the state of the machine
 static void initialize()
@@ -57,6 +262,20 @@ static void initialize()
     instruction_words = 0;
     global_data_words = 0;
     running = true;
+    thread_id = 0;
+    instructions_executed = 0;
+    exit_code = 0;
+    initialize_coroutines();
+
+    // forget the VM threads and measurement regions of any earlier run
+    // (whose reports were printed when it stopped)
+    memset(threads, 0, sizeof(threads));
+    stopping_threads = false;
+    thread_failed = false;
+    finished_threads_instructions = 0;
+    memset(regions, 0, sizeof(regions));
+    num_regions = 0;
+    memset(region_starts, 0, sizeof(region_starts));
 
     // zero the registers
     for (int j = 0; j < NUM_REGISTERS; j++) {
@@ -67,47 +286,30 @@ static void initialize()
     for (int i = 0; i < MEMORY_SIZE_IN_WORDS; i++) {
 	memory.words[i] = 0;
     }
+    memset(decoded_instrs, 0, sizeof(decoded_instrs));
 }
 
-// Requires: bf is a binary object file that is open for reading
-// Load count instructions from bf into the memory starting at address 0.
-// If any errors are encountered, exit with an error message.
-static void load_instructions(BOFFILE bf, int count)
-{
-    for (int wa = 0; wa < count; wa++) {
-	memory.instrs[wa] = instruction_read(bf);
-    }
-}
-
-// Requires: bf is a binary object file that is open for reading
-// Load count words from bf into the memory
-// starting at word address global_base.
-// If any errors are encountered, exit with an error message.
-static void load_data(BOFFILE bf, int count, unsigned int global_base)
-{
-    for (int wo = 0; wo < count; wo++) {
-	memory.words[global_base+wo] = bof_read_word(bf);
-    }
-}
-
-// Requires: bf is open for reading in binary
-// Load the binary object file bf, and get ready to run it
-void machine_load(BOFFILE bf)
+// Load the binary object file image img, and get ready to run it.
+// The sections are copied into the memory, so img may be released
+// once this returns.
+void machine_load(BOFImage img)
 {
     initialize();
 
-    // read and check the header
-    BOFHeader bh = bof_read_header(bf);
+    // check the header (bof_map has checked it against the file's size)
+    BOFHeader bh = img.header;
     if (bh.text_length >= bh.data_start_address) {
 	bail_with_error("%s (%u) %s (%u)!",
 			"Text, i.e., program length", bh.text_length,
 			"is not less than the start address of the global data",
 			bh.data_start_address);
     }
-    if (bh.data_start_address + bh.data_length >= bh.stack_bottom_addr) {
+    // the zero-filled words follow the data section in memory
+    word_type data_words = bh.data_length + img.zero_length;
+    if (bh.data_start_address + data_words >= bh.stack_bottom_addr) {
 	bail_with_error("%s (%u) + %s (%u) %s (%u)!",
 			"Global data start address", bh.data_start_address,
-			"global data length", bh.data_length,
+			"global data length", data_words,
 			"is not less than the stack bottom address",
 			bh.stack_bottom_addr);
     }
@@ -118,13 +320,29 @@ void machine_load(BOFFILE bf)
 			MEMORY_SIZE_IN_WORDS);
     }
 
-    // load the program
+    // keep any debugging information for the trace and the profile
+    bof_debug_free(&debug_info);
+    bof_debug_read(img, &debug_info);
+
+    // load the program, copying each section in one piece
     instruction_words = bh.text_length;
-    load_instructions(bf, instruction_words);
+    memcpy(memory.uwords, img.text, instruction_words * BYTES_PER_WORD);
+
+    // decode the text now, so that running it does no decoding;
+    // a word that is not an instruction is only reported if it is run
+    error_context ec;
+    error_context_enter(&ec);
+    if (setjmp(ec.env) == 0) {
+	for (int wa = 0; wa < instruction_words; wa++) {
+	    decode_instr(memory.uwords[wa], &decoded_instrs[wa]);
+	}
+	error_context_leave(&ec);
+    }
 
-    global_data_words = bh.data_length;
-    
-    load_data(bf, global_data_words, bh.data_start_address);
+    // the zero-filled words need no copying, as the memory is zeroed
+    global_data_words = data_words;
+    memcpy(&memory.words[bh.data_start_address], img.data,
+	   bh.data_length * BYTES_PER_WORD);
 
     // initialize the registers
     PC = bh.text_start_address;
@@ -133,6 +351,15 @@ void machine_load(BOFFILE bf)
     GPR[SP] = bh.stack_bottom_addr;
     GPR[FP] = bh.stack_bottom_addr;
     initial_stack_bottom = bh.stack_bottom_addr;
+
+    // the heap starts empty, just after the global data
+    heap_start = bh.data_start_address + data_words;
+    heap_break = heap_start;
+    for (int c = 0; c < HEAP_NUM_CLASSES; c++) {
+	heap_free_lists[c] = 0;
+    }
+    memset(heap_block_words, 0, sizeof(heap_block_words));
+    memset(&heap_stats, 0, sizeof(heap_stats));
 }
 
 // Requires: fmt == 'x' or fmt == 'd'
@@ -155,7 +382,9 @@ static int print_loc(FILE *out, address_type wa, char fmt)
 // print the word address given and the instruction's assembly form
 static void print_instruction(FILE *out, address_type wa, bin_instr_t bi)
 {
-    fprintf(out, "%6d: %s\n", wa, instruction_assembly_form(wa, bi));
+    char line[INSTR_FORMAT_BUF_SIZE + 16];
+    size_t len = instruction_format_line(line, sizeof(line), 6, wa, bi);
+    fwrite(line, sizeof(char), len, out);
 }
 
 // Print the word memory in hex or decimal based on the fmt argument
@@ -229,367 +458,2022 @@ void machine_print_loaded_program(FILE *out)
     instruction_print_table_heading(out);
     // instructions
     for (int wa = 0; wa < instruction_words; wa++) {
-	print_instruction(out, wa, memory.instrs[wa]);
+	print_instruction(out, wa, instruction_decode(memory.uwords[wa]));
     }
 
     print_global_data(out);
 }
 
-// Run the VM on the already loaded program,
-// producing any trace output called for by the program
-void machine_run(bool trace_execution)
+// Check that count words starting at word address wa are all in memory,
+// bailing with an error if they are not (or if count is negative)
+static void check_block_in_memory(address_type wa, word_type count)
 {
-    tracing = trace_execution;
-    if (tracing) {
-	machine_print_state(stdout);
+    if (count < 0) {
+	bail_with_error("Negative count (%d) for the block at address %u!",
+			count, wa);
     }
-    // execute the program
-    while (running) {
-	machine_okay(); // check the invariant
-	machine_trace_execute_instr(stdout, PC, memory.instrs[PC]);
+    if (wa >= MEMORY_SIZE_IN_WORDS
+	|| count > MEMORY_SIZE_IN_WORDS - wa) {
+	bail_with_error("Block of %d words at address %u is outside memory!",
+			count, wa);
     }
 }
 
-// Load the given binary object file and run it
-void machine_load_and_run(BOFFILE bf, bool trace_execution)
+// Requires: bytes >= 0
+// Return the number of words needed to hold the given number of bytes
+static word_type words_for_bytes(word_type bytes)
 {
-    machine_load(bf);
-    machine_run(trace_execution);
+    return bytes / BYTES_PER_WORD + (bytes % BYTES_PER_WORD != 0);
 }
 
-// Requires: addr == PC.
-// If tracing then print the given word address and the assembly form of bi,
-// then execute bi (always),
-// then if tracing print out the machine's state.
-// All tracing output goes to the FILE out
-void machine_trace_execute_instr(FILE *out, address_type addr,
-				 bin_instr_t bi)
+// Check that count bytes starting at word address wa are all in memory,
+// bailing with an error if they are not (or if count is negative)
+static void check_bytes_in_memory(address_type wa, word_type count)
 {
-    assert(addr == PC);
-    if (tracing) {
-	fprintf(out, "\n==> ");
-	print_instruction(out, PC, bi);
+    // a negative count would round to 0 words, so it is checked as is
+    check_block_in_memory(wa, count < 0 ? count : words_for_bytes(count));
+}
+
+// Make the program's input (read by the system calls) come from in
+// instead of stdin
+void machine_set_input(FILE *in)
+{
+    program_input = in;
+}
+
+// Return the file that the program's input comes from
+static FILE *input_file()
+{
+    return (program_input != NULL) ? program_input : stdin;
+}
+
+// Read characters from the input into the words starting at word address wa,
+// one character per word (as the RCH system call does),
+// stopping after a newline, at EOF, or when max words have been stored.
+// Return the number of words stored.
+static word_type read_line_into(address_type wa, word_type max)
+{
+    check_block_in_memory(wa, max);
+    word_type n = 0;
+    while (n < max) {
+	int c = getc(input_file());
+	if (c == EOF) {
+	    break;
+	}
+	memory.words[wa + n] = c;
+	n++;
+	if (c == '\n') {
+	    break;
+	}
     }
-    machine_execute_instr(addr, bi);
-    if (tracing) {
-	machine_print_state(out);
+    return n;
+}
+
+// Read up to count bytes from the input into the bytes
+// starting at word address wa, and return the number of bytes read
+static word_type read_bytes_into(address_type wa, word_type count)
+{
+    check_bytes_in_memory(wa, count);
+    return fread(&memory.words[wa], 1, count, input_file());
+}
+
+// Print the count words starting at word address wa on stdout,
+// each as a character (as the PCH system call does),
+// and return the number of characters printed
+static word_type print_chars_from(address_type wa, word_type count)
+{
+    check_block_in_memory(wa, count);
+    char buf[PRINT_CHARS_BUF_SIZE];
+    word_type done = 0;
+    while (done < count) {
+	int chunk = count - done;
+	if (chunk > PRINT_CHARS_BUF_SIZE) {
+	    chunk = PRINT_CHARS_BUF_SIZE;
+	}
+	for (int i = 0; i < chunk; i++) {
+	    buf[i] = (char) memory.words[wa + done + i];
+	}
+	size_t wr = fwrite(buf, 1, chunk, stdout);
+	done += wr;
+	if (wr < chunk) {
+	    break;
+	}
     }
+    return done;
 }
 
-// Requires: The instruction at memory.instrs[PC] is bi.
-// Execute the given instruction, which is found at word address addr,
-// in the machine's current state
-void machine_execute_instr(address_type addr, bin_instr_t bi)
+// Print the count bytes starting at word address wa on stdout
+// and return the number of bytes printed
+static word_type print_bytes_from(address_type wa, word_type count)
 {
-    // increment the PC (advance address by 1 word)
-    PC = PC + 1;
+    check_bytes_in_memory(wa, count);
+    return fwrite(&memory.words[wa], 1, count, stdout);
+}
 
-    // execute the actual instruction
-    instr_type it = instruction_type(bi);
-    switch (it) {
-    case comp_instr_type:
-	{
-	    comp_instr_t ci = bi.comp;
-	    switch (ci.func) {
-	    case NOP_F:
-		// do nothing
-		break;
-	    case ADD_F:
-		memory.words[GPR[ci.rt] + machine_types_formOffset(ci.ot)]
-		    = memory.words[GPR[SP]]
-			  + memory.words[GPR[ci.rs] + machine_types_formOffset(ci.os)];
-		break;
-	    case SUB_F:
-		memory.words[GPR[ci.rt] + machine_types_formOffset(ci.ot)]
-		    = memory.words[GPR[SP]]
-		    - memory.words[GPR[ci.rs]
-				   + machine_types_formOffset(ci.os)];
-		break;
-	    case CPW_F:
-		memory.words[GPR[ci.rt] + machine_types_formOffset(ci.ot)]
-		    = memory.words[GPR[ci.rs]
-				   + machine_types_formOffset(ci.os)];
-		break;
-	    case CPR_F:
-		GPR[ci.rt] = GPR[ci.rs];
-		break;
-	    case AND_F:
-		memory.uwords[GPR[ci.rt] + machine_types_formOffset(ci.ot)]
-		    = memory.uwords[GPR[SP]]
-		    & memory.uwords[GPR[ci.rs]
-				    + machine_types_formOffset(ci.os)];
-		break;
-	    case BOR_F:
-		memory.uwords[GPR[ci.rt] + machine_types_formOffset(ci.ot)]
-		    = memory.uwords[GPR[SP]]
-		    | memory.uwords[GPR[ci.rs]
-				    + machine_types_formOffset(ci.os)];
-		break;
-	    case NOR_F:
-		memory.uwords[GPR[ci.rt] + machine_types_formOffset(ci.ot)]
-		    = ~(memory.uwords[GPR[SP]]
-			| memory.uwords[GPR[ci.rs]
-					+ machine_types_formOffset(ci.os)]);
-		break;
-	    case XOR_F:
-		memory.uwords[GPR[ci.rt] + machine_types_formOffset(ci.ot)]
-		    = memory.uwords[GPR[SP]]
-		    ^ memory.uwords[GPR[ci.rs]
-				    + machine_types_formOffset(ci.os)];
-		break;
-	    case LWR_F:
-		GPR[ci.rt]
-		    = memory.words[GPR[ci.rs]
-				   + machine_types_formOffset(ci.os)];
-		break;
-	    case SWR_F:
-		memory.words[GPR[ci.rt]
-			     + machine_types_formOffset(ci.ot)]
-		    = GPR[ci.rs];
-		break;
-	    case SCA_F:
-		memory.words[GPR[ci.rt] + machine_types_formOffset(ci.ot)]
-		    = (GPR[ci.rs] + machine_types_formOffset(ci.os));
-		break;
-	    case LWI_F:
-		memory.words[GPR[ci.rt] + machine_types_formOffset(ci.ot)]
-		    = memory.words[memory.words
-				   [GPR[ci.rs] + machine_types_formOffset(ci.os)]];
-		    break;
-	    case NEG_F:
-		memory.words[GPR[ci.rt] + machine_types_formOffset(ci.ot)]
-		    = - (memory.words[GPR[ci.rs]
-				      + machine_types_formOffset(ci.os)]);
-		break;
-	    default:
-		bail_with_error("Invalid function code (%d) in machine_execute's COMP_O computational instruction case!",
-				ci.func);
-		break;
-	    }
+// Copy the count words starting at word address src
+// to the count words starting at word address dst
+// (the two blocks may overlap)
+static void block_copy(address_type dst, address_type src, word_type count)
+{
+    check_block_in_memory(dst, count);
+    check_block_in_memory(src, count);
+    memmove(&memory.words[dst], &memory.words[src],
+	    count * sizeof(word_type));
+}
+
+// Store val into each of the count words starting at word address wa
+static void block_fill(address_type wa, word_type count, word_type val)
+{
+    check_block_in_memory(wa, count);
+    if (val == 0 || val == -1) {
+	// all the bytes of val are the same, so memset can do it
+	memset(&memory.words[wa], val & 0xff, count * sizeof(word_type));
+    } else {
+	for (int i = 0; i < count; i++) {
+	    memory.words[wa + i] = val;
 	}
-	break;
-    case other_comp_instr_type:
-	{
-	    other_comp_instr_t oci = bi.othc;
-	    switch (oci.func) {
-	    case LIT_F:
-		memory.words[GPR[oci.reg] + machine_types_sgnExt(oci.offset)]
-			     = machine_types_sgnExt(oci.arg);
-	        break;
-	    case ARI_F:
-		GPR[oci.reg] = GPR[oci.reg] + machine_types_sgnExt(oci.arg);
-		break;
-	    case SRI_F:
-		GPR[oci.reg] = GPR[oci.reg] - machine_types_sgnExt(oci.arg);
-		break;
-	    case MUL_F:
-		hilo_regs.result
-		    = (long) memory.words[GPR[SP]]
-		      * (long) memory.words[GPR[oci.reg]
-				     + machine_types_formOffset(oci.offset)];
-		break;
-	    case DIV_F:
-		int divisor = memory.words[GPR[oci.reg]
-				     + machine_types_formOffset(oci.offset)];
-		if (divisor == 0) {
-		    bail_with_error("Error: Attempt to divide by zero!");
-		}
-		hilo_regs.hilo[HI] = memory.words[GPR[SP]] % divisor;
-		hilo_regs.hilo[LO] = memory.words[GPR[SP]] / divisor;
-		break;
-	    case CFHI_F:
-		memory.words[GPR[oci.reg]
-				 + machine_types_formOffset(oci.offset)]
-		    = hilo_regs.hilo[HI];
-		break;
-	    case CFLO_F:
-		memory.words[GPR[oci.reg]
-				 + machine_types_formOffset(oci.offset)]
-		    = hilo_regs.hilo[LO];
-		break;
-	    case SLL_F:
-		memory.uwords[GPR[oci.reg]
-			     + machine_types_formOffset(oci.offset)]
-		    = memory.uwords[GPR[SP]] << oci.arg;
-		break;
-	    case SRL_F:
-		memory.uwords[GPR[oci.reg]
-			     + machine_types_formOffset(oci.offset)]
-		    = memory.uwords[GPR[SP]] >> oci.arg;
-		break;
-	    case JMP_F:
-		PC = memory.uwords[GPR[oci.reg]
-				   + machine_types_formOffset(oci.offset)];
-		break;
-	    case CSI_F:
-		GPR[RA] = PC;
-		PC = memory.words[GPR[oci.reg]
-				  + machine_types_formOffset(oci.offset)];
-		break;
-	    case JREL_F:
-		PC = (PC - 1) + machine_types_formOffset(oci.arg);
-		break;
-	    default:
-		bail_with_error("Invalid function code (%d) in machine_execute's OTHC_O computational instruction case!",
-				oci.func);
-		break;
-	    }
+    }
+}
+
+// Requires: heap_lock is held
+// Check that stack_bottom can be the stack bottom address of a new
+// thread or coroutine (what), i.e., that it is in memory and above
+// the global data and the heap, releasing heap_lock and bailing
+// with an error if it is not
+static void check_stack_bottom_locked(address_type stack_bottom,
+				      const char *what)
+{
+    address_type heap_end = heap_break;
+    if (stack_bottom >= MEMORY_SIZE_IN_WORDS || stack_bottom <= heap_end) {
+	pthread_mutex_unlock(&heap_lock);
+	bail_with_error("Bad stack bottom address (%u) for a new %s (%s %u)!",
+			stack_bottom, what,
+			"the global data and heap end at", heap_end);
+    }
+}
+
+// Check that stack_bottom can be the stack bottom address of a new
+// thread or coroutine (what), as check_stack_bottom_locked does
+static void check_stack_bottom(address_type stack_bottom, const char *what)
+{
+    pthread_mutex_lock(&heap_lock);
+    check_stack_bottom_locked(stack_bottom, what);
+    pthread_mutex_unlock(&heap_lock);
+}
+
+// Trace and execute the instruction bi, whose instr_id is id, at the PC
+// (defined below, with machine_trace_execute_instr)
+static void trace_execute(FILE *out, bin_instr_t bi, instr_id id);
+
+// Run a spawned VM thread, starting in the state given by arg
+// (a pointer to a thread_start_t),
+// and return its exit code (cast to a pointer) when it executes EXIT.
+// If it reports an error, record that error (for machine_run),
+// stop the other VM threads, and return the error's exit code.
+static void *run_spawned_thread(void *arg)
+{
+    thread_start_t *st = (thread_start_t *) arg;
+    thread_id = st->id;
+    PC = st->PC;
+    for (int j = 0; j < NUM_REGISTERS; j++) {
+	GPR[j] = st->GPR[j];
+    }
+    hilo_regs.result = 0;
+    initial_stack_bottom = GPR[FP];
+    tracing = st->tracing;
+    thread_exit_code = 0;
+    running = true;
+    initialize_coroutines();
+    stack_top = GPR[SP];
+    pthread_mutex_lock(&threads_lock);
+    threads[thread_id].stack_top = &stack_top;
+    threads[thread_id].suspended_stack_top = &suspended_stack_top;
+    pthread_mutex_unlock(&threads_lock);
+    error_context ec;
+    error_context_enter(&ec);
+    if (setjmp(ec.env) == 0) {
+	while (running
+	       && !__atomic_load_n(&stopping_threads, __ATOMIC_RELAXED)) {
+	    machine_okay(); // check the invariant
+	    decoded_instr_t local;
+	    const decoded_instr_t *d = fetch_instr(PC, &local);
+	    trace_execute(stdout, d->bi, d->id);
 	}
-	break;
-    case syscall_instr_type:
-	{
-	    syscall_instr_t si = bi.syscall;
-	    switch (si.code) {
-	    case exit_sc:
-		running = false;
-		exit(machine_types_sgnExt(si.offset));
-		break;
-	    case print_str_sc:
-		memory.words[GPR[SP]]
-		    = printf("%s",
-			     (char *) &(memory.words[GPR[si.reg]
-						     + machine_types_formOffset(si.offset)]));
-		break;
-	    case print_int_sc:
-		memory.words[GPR[SP]]
-		    = printf("%d",
-			     memory.words[GPR[si.reg]
-					  + machine_types_formOffset(si.offset)]);
-		break;
-	    case print_char_sc:
-		memory.words[GPR[SP]]
-		    = fputc(memory.words[GPR[si.reg]
-					     + machine_types_formOffset(si.offset)],
-			    stdout);
-		break;
-	    case read_char_sc:
-		memory.words[GPR[si.reg] + machine_types_formOffset(si.offset)]
-		    = getc(stdin);
-		break;
-	    case start_tracing_sc:
-		tracing = true;
-		break;
-	    case stop_tracing_sc:
-		tracing = false;
-		break;
-	    default:
-		bail_with_error("Invalid system call type (%d) in machine_execute's syscall instruction case!",
-				instruction_syscall_number(bi));
-		break;
-	    }
+	error_context_leave(&ec);
+    } else {
+	pthread_mutex_lock(&threads_lock);
+	if (!thread_failed) {
+	    thread_failed = true;
+	    thread_error = ec;
 	}
-	break;
-    case immed_instr_type:
-	{
-	    immed_instr_t ii = bi.immed;
-	    uimmed_instr_t ui = bi.uimmed;
-	    switch (ii.op) {
-	    case ADDI_O:
-		memory.words[GPR[ii.reg] + machine_types_formOffset(ii.offset)]
-		    = memory.words[GPR[ii.reg] + machine_types_formOffset(ii.offset)]
-		      + machine_types_sgnExt(ii.immed);
-		break;
-	    case ANDI_O:
-		memory.uwords[GPR[ui.reg] + machine_types_formOffset(ui.offset)]
-		    = memory.uwords[GPR[ui.reg]
-				    + machine_types_formOffset(ui.offset)]
-		      & machine_types_zeroExt(ui.uimmed);
-		break;
-	    case BORI_O:
-		memory.uwords[GPR[ui.reg] + machine_types_formOffset(ui.offset)]
-		    = memory.uwords[GPR[ui.reg]
-				    + machine_types_formOffset(ui.offset)]
-		      | machine_types_zeroExt(ui.uimmed);
-		break;
-	    case NORI_O:
-		memory.uwords[GPR[ui.reg] + machine_types_formOffset(ui.offset)]
-		    = ~(memory.uwords[GPR[ui.reg]
-				      + machine_types_formOffset(ui.offset)]
-			| machine_types_zeroExt(ui.uimmed));
-		break;
-	    case XORI_O:
-		memory.uwords[GPR[ui.reg] + machine_types_formOffset(ui.offset)]
-		    = memory.uwords[GPR[ui.reg]
-				    + machine_types_formOffset(ui.offset)]
-		      ^ machine_types_zeroExt(ui.uimmed);
-		break;
-	    case BEQ_O:
-		if (memory.words[GPR[SP]]
-		    == memory.words[GPR[ii.reg]
-					+ machine_types_formOffset(ii.offset)]) {
-		    PC = (PC - 1) + machine_types_formOffset(ii.immed);
-		}
-		break;
-	    case BGEZ_O:
-		if (memory.words[GPR[ii.reg]
-				     + machine_types_formOffset(ii.offset)]
-		    >= 0) {
-		    PC = (PC - 1) + machine_types_formOffset(ii.immed);
-		}
-		break;
-	    case BGTZ_O:
-		if (memory.words[GPR[ii.reg]
-				     + machine_types_formOffset(ii.offset)]
-		    > 0) {
-		    PC = (PC - 1) + machine_types_formOffset(ii.immed);
-		}
-		break;
-	    case BLEZ_O:
-		if (memory.words[GPR[ii.reg]
-				     + machine_types_formOffset(ii.offset)]
-		    <= 0) {
-		    PC = (PC - 1) + machine_types_formOffset(ii.immed);
-		}
-		break;
-	    case BLTZ_O:
-		if (memory.words[GPR[ii.reg]
-				     + machine_types_formOffset(ii.offset)]
-		    < 0) {
-		    PC = (PC - 1) + machine_types_formOffset(ii.immed);
-		}
-		break;
-	    case BNE_O:
-		if (memory.words[GPR[SP]]
-		    != memory.words[GPR[ii.reg]
-					+ machine_types_formOffset(ii.offset)]) {
-		    PC = (PC - 1) + machine_types_formOffset(ii.immed);
-		}
-		break;
-	    default:
-		bail_with_error("Invalid opcode (%d) in machine_execute's immediate instruction case!",
-				ii.op);	    
-		break;
-	    }
+	pthread_mutex_unlock(&threads_lock);
+	__atomic_store_n(&stopping_threads, true, __ATOMIC_SEQ_CST);
+	thread_exit_code = ec.status;
+    }
+    pthread_mutex_lock(&threads_lock);
+    threads[thread_id].stack_top = NULL;
+    threads[thread_id].suspended_stack_top = NULL;
+    threads[thread_id].finished = true;
+    pthread_mutex_unlock(&threads_lock);
+    __atomic_fetch_add(&finished_threads_instructions, instructions_executed,
+		       __ATOMIC_SEQ_CST);
+    return (void *) (intptr_t) thread_exit_code;
+}
+
+// Start a new VM thread, whose starting address is memory[wa]
+// and whose stack bottom address is memory[wa+1].
+// The new thread starts with a copy of the current thread's registers,
+// except that its $sp and $fp hold the new stack bottom address.
+// Return the new thread's number.
+static word_type spawn_thread(address_type wa)
+{
+    check_block_in_memory(wa, 2);
+    address_type start = memory.uwords[wa];
+    address_type stack_bottom = memory.uwords[wa + 1];
+    check_stack_bottom(stack_bottom, "thread");
+    pthread_mutex_lock(&threads_lock);
+    int id = 1;
+    while (id < MAX_THREADS && threads[id].in_use) {
+	id++;
+    }
+    if (id == MAX_THREADS) {
+	pthread_mutex_unlock(&threads_lock);
+	bail_with_error("Cannot have more than %d threads!", MAX_THREADS);
+    }
+    threads[id].in_use = true;
+    threads[id].stack_top = NULL;
+    threads[id].suspended_stack_top = NULL;
+    threads[id].finished = false;
+    threads[id].joining = false;
+    thread_start_t *st = &threads[id].start;
+    st->id = id;
+    st->PC = start;
+    for (int j = 0; j < NUM_REGISTERS; j++) {
+	st->GPR[j] = GPR[j];
+    }
+    st->GPR[SP] = stack_bottom;
+    st->GPR[FP] = stack_bottom;
+    st->tracing = tracing;
+    if (pthread_create(&threads[id].host_thread, NULL,
+		       run_spawned_thread, st) != 0) {
+	threads[id].in_use = false;
+	pthread_mutex_unlock(&threads_lock);
+	bail_with_error("Could not create a host thread for VM thread %d!",
+			id);
+    }
+    pthread_mutex_unlock(&threads_lock);
+    return id;
+}
+
+// Wait for the VM thread numbered id to finish and return its exit code.
+// Each spawned thread must be joined exactly once.
+static word_type join_thread(word_type id)
+{
+    pthread_mutex_lock(&threads_lock);
+    if (id <= 0 || id >= MAX_THREADS || !threads[id].in_use) {
+	pthread_mutex_unlock(&threads_lock);
+	bail_with_error("Attempt to join a thread (%d) that is not running!",
+			id);
+    }
+    if (threads[id].joining) {
+	pthread_mutex_unlock(&threads_lock);
+	if (__atomic_load_n(&stopping_threads, __ATOMIC_RELAXED)) {
+	    // stop_threads is joining it, and this thread is stopping too
+	    return 0;
 	}
-	break;
-    case jump_instr_type:
-	{
-	    jump_instr_t ji = bi.jump;
-	    switch (ji.op) {
-	    case JMPA_O:
-		PC = machine_types_formAddress(PC-1, ji.addr);
-		break;
-	    case CALL_O:
-		GPR[RA] = PC;
-		PC = machine_types_formAddress(PC-1, ji.addr);
-		break;
-	    case RTN_O:
-		PC = GPR[RA];
-		break;
-	    default:
-		bail_with_error("Invalid opcode (%d) in machine_execute's jump instruction case!",
-				ji.op);	    
-		break;
+	bail_with_error("Attempt to join a thread (%d) that is already being joined!",
+			id);
+    }
+    threads[id].joining = true;
+    pthread_t host_thread = threads[id].host_thread;
+    pthread_mutex_unlock(&threads_lock);
+
+    void *res;
+    pthread_join(host_thread, &res);
+
+    pthread_mutex_lock(&threads_lock);
+    threads[id].in_use = false;
+    pthread_mutex_unlock(&threads_lock);
+    return (word_type) (intptr_t) res;
+}
+
+// Stop the VM threads that are still running (once the main VM thread
+// has stopped) and wait for all of the spawned threads to finish,
+// except those that other VM threads are already waiting for
+// (which finish before the threads that wait for them)
+static void stop_threads()
+{
+    __atomic_store_n(&stopping_threads, true, __ATOMIC_SEQ_CST);
+    for (int id = 1; id < MAX_THREADS; id++) {
+	pthread_mutex_lock(&threads_lock);
+	bool to_join = threads[id].in_use && !threads[id].joining;
+	threads[id].joining = threads[id].joining || to_join;
+	pthread_t host_thread = threads[id].host_thread;
+	pthread_mutex_unlock(&threads_lock);
+	if (to_join) {
+	    pthread_join(host_thread, NULL);
+	    pthread_mutex_lock(&threads_lock);
+	    threads[id].in_use = false;
+	    pthread_mutex_unlock(&threads_lock);
+	}
+    }
+}
+
+// Save this VM thread's registers in co
+static void save_context(coroutine_t *co)
+{
+    co->PC = PC;
+    memcpy(co->GPR, GPR, sizeof(GPR));
+    co->hilo = hilo_regs.result;
+    co->stack_bottom = initial_stack_bottom;
+}
+
+// Load this VM thread's registers from co
+static void load_context(const coroutine_t *co)
+{
+    PC = co->PC;
+    memcpy(GPR, co->GPR, sizeof(GPR));
+    hilo_regs.result = co->hilo;
+    initial_stack_bottom = co->stack_bottom;
+}
+
+// Return the number of the coroutine after the current one,
+// in round-robin order, that has not finished
+// (this is the current one if no other coroutine is ready)
+static int next_coroutine()
+{
+    int n = current_coroutine;
+    do {
+	n = (n + 1) % MAX_COROUTINES;
+    } while (!coroutines[n].in_use && n != current_coroutine);
+    return n;
+}
+
+// Requires: heap_lock is held
+// Make this VM thread's stack_top and suspended_stack_top
+// reflect its running and suspended coroutines.
+// Doing this (and changing the coroutines) with heap_lock held means that
+// the heap never sees a coroutine's stack as neither running nor suspended.
+static void update_stack_tops()
+{
+    word_type lowest = MEMORY_SIZE_IN_WORDS;
+    for (int n = 0; n < MAX_COROUTINES; n++) {
+	if (coroutines[n].in_use && n != current_coroutine
+	    && coroutines[n].GPR[SP] < lowest) {
+	    lowest = coroutines[n].GPR[SP];
+	}
+    }
+    __atomic_store_n(&stack_top, GPR[SP], __ATOMIC_RELAXED);
+    __atomic_store_n(&suspended_stack_top, lowest, __ATOMIC_RELAXED);
+}
+
+// Requires: coroutines[n].in_use
+// Suspend the current coroutine and continue running coroutine n
+static void switch_to_coroutine(int n)
+{
+    assert(coroutines[n].in_use);
+    if (n == current_coroutine) {
+	return;
+    }
+    pthread_mutex_lock(&heap_lock);
+    save_context(&coroutines[current_coroutine]);
+    load_context(&coroutines[n]);
+    current_coroutine = n;
+    update_stack_tops();
+    pthread_mutex_unlock(&heap_lock);
+}
+
+// Requires: current_coroutine != 0
+// Finish the current coroutine and continue running the next one
+static void end_coroutine()
+{
+    assert(current_coroutine != 0);
+    pthread_mutex_lock(&heap_lock);
+    coroutines[current_coroutine].in_use = false;
+    // the main coroutine never finishes this way, so there is a next one
+    int n = next_coroutine();
+    load_context(&coroutines[n]);
+    current_coroutine = n;
+    update_stack_tops();
+    pthread_mutex_unlock(&heap_lock);
+}
+
+// Create a new coroutine in this VM thread,
+// whose starting address is memory[wa]
+// and whose stack bottom address is memory[wa+1].
+// The new coroutine starts with a copy of the current registers,
+// except that its $sp and $fp hold the new stack bottom address,
+// and it does not run until it is resumed or yielded to.
+// Its stack is reserved at once, so the heap does not grow into it.
+// Return the new coroutine's number.
+static word_type create_coroutine(address_type wa)
+{
+    check_block_in_memory(wa, 2);
+    address_type start = memory.uwords[wa];
+    address_type stack_bottom = memory.uwords[wa + 1];
+    int n = 1;
+    while (n < MAX_COROUTINES && coroutines[n].in_use) {
+	n++;
+    }
+    if (n == MAX_COROUTINES) {
+	bail_with_error("Cannot have more than %d coroutines in a thread!",
+			MAX_COROUTINES);
+    }
+    pthread_mutex_lock(&heap_lock);
+    check_stack_bottom_locked(stack_bottom, "coroutine");
+    coroutine_t *co = &coroutines[n];
+    save_context(co);
+    co->in_use = true;
+    co->PC = start;
+    co->GPR[SP] = stack_bottom;
+    co->GPR[FP] = stack_bottom;
+    co->hilo = 0;
+    co->stack_bottom = stack_bottom;
+    update_stack_tops();
+    pthread_mutex_unlock(&heap_lock);
+    return n;
+}
+
+// Suspend the current coroutine and continue running coroutine n,
+// which must not have finished
+static void resume_coroutine(word_type n)
+{
+    if (n < 0 || n >= MAX_COROUTINES || !coroutines[n].in_use) {
+	bail_with_error("Attempt to resume a coroutine (%d) that is not ready!",
+			n);
+    }
+    switch_to_coroutine(n);
+}
+
+// Print a summary of the measurement regions on out
+static void print_region_summary(FILE *out)
+{
+    pthread_mutex_lock(&regions_lock);
+    fprintf(out, "%-*s %8s %14s %16s\n", MAX_REGION_NAME_LEN,
+	    "Region", "Entries", "Instructions", "Nanoseconds");
+    for (int i = 0; i < num_regions; i++) {
+	fprintf(out, "%-*s %8lu %14lu %16llu\n", MAX_REGION_NAME_LEN,
+		regions[i].name, regions[i].entries,
+		regions[i].instructions, regions[i].nanoseconds);
+    }
+    pthread_mutex_unlock(&regions_lock);
+}
+
+// Return the index in regions of the region whose name is
+// the string starting at word address wa
+// (of which only the first MAX_REGION_NAME_LEN chars are used),
+// adding it to the table if it is not already there
+static int region_index(address_type wa)
+{
+    // copy the name a word at a time, so it is never read past memory
+    char name[MAX_REGION_NAME_LEN + 1];
+    int len = 0;
+    bool ended = false;
+    for (address_type a = wa; !ended && len < MAX_REGION_NAME_LEN; a++) {
+	if (a >= MEMORY_SIZE_IN_WORDS) {
+	    bail_with_error("Region name at address %u runs past the end of memory!",
+			    wa);
+	}
+	const char *chars = (const char *) &memory.words[a];
+	for (int i = 0; i < BYTES_PER_WORD && !ended
+		 && len < MAX_REGION_NAME_LEN; i++) {
+	    ended = chars[i] == '\0';
+	    name[len] = chars[i];
+	    len += !ended;
+	}
+    }
+    name[len] = '\0';
+
+    pthread_mutex_lock(&regions_lock);
+    int i = 0;
+    while (i < num_regions && strcmp(regions[i].name, name) != 0) {
+	i++;
+    }
+    if (i == num_regions) {
+	if (num_regions == MAX_REGIONS) {
+	    pthread_mutex_unlock(&regions_lock);
+	    bail_with_error("Cannot have more than %d measurement regions!",
+			    MAX_REGIONS);
+	}
+	strcpy(regions[i].name, name);
+	num_regions++;
+    }
+    pthread_mutex_unlock(&regions_lock);
+    return i;
+}
+
+// Start measuring the region whose name is at word address wa
+static void begin_region(address_type wa)
+{
+    int i = region_index(wa);
+    if (region_starts[i].active) {
+	bail_with_error("Region \"%s\" was started again before it ended!",
+			regions[i].name);
+    }
+    region_starts[i].active = true;
+    region_starts[i].instructions = instructions_executed;
+    clock_gettime(CLOCK_MONOTONIC, &region_starts[i].time);
+}
+
+// Stop measuring the region whose name is at word address wa,
+// adding the instructions executed and time taken since it started
+// (not counting the instructions that start and end it)
+// to the region's totals
+static void end_region(address_type wa)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int i = region_index(wa);
+    if (!region_starts[i].active) {
+	bail_with_error("Region \"%s\" was ended but not started!",
+			regions[i].name);
+    }
+    region_starts[i].active = false;
+    long long ns = (now.tv_sec - region_starts[i].time.tv_sec) * 1000000000LL
+	+ (now.tv_nsec - region_starts[i].time.tv_nsec);
+
+    pthread_mutex_lock(&regions_lock);
+    regions[i].entries++;
+    regions[i].instructions
+	+= instructions_executed - region_starts[i].instructions - 1;
+    regions[i].nanoseconds += ns;
+    pthread_mutex_unlock(&regions_lock);
+}
+
+// Return the size class for blocks of the given number of words,
+// which is HEAP_NUM_CLASSES if words is too big for any class
+static int heap_class(word_type words)
+{
+    int c = 0;
+    while (c < HEAP_NUM_CLASSES && (1 << c) < words) {
+	c++;
+    }
+    return c;
+}
+
+// Return the lowest address that the stack of any running VM thread,
+// or of any of their suspended coroutines, reaches (i.e., the lowest
+// of their $sp registers, including the ones saved by the coroutines).
+// This takes threads_lock while heap_lock is held (in heap_refill),
+// so heap_lock must never be taken while threads_lock is held.
+static address_type lowest_stack_top()
+{
+    address_type lowest = GPR[SP];
+    if (suspended_stack_top < lowest) {
+	lowest = suspended_stack_top;
+    }
+    pthread_mutex_lock(&threads_lock);
+    for (int i = 0; i < MAX_THREADS; i++) {
+	if (!threads[i].in_use || threads[i].finished) {
+	    continue;
+	}
+	// a thread that has not started yet will start at its stack bottom
+	address_type sp = (threads[i].stack_top != NULL)
+	    ? __atomic_load_n(threads[i].stack_top, __ATOMIC_RELAXED)
+	    : threads[i].start.GPR[SP];
+	if (sp < lowest) {
+	    lowest = sp;
+	}
+	if (threads[i].suspended_stack_top != NULL) {
+	    sp = __atomic_load_n(threads[i].suspended_stack_top,
+				 __ATOMIC_RELAXED);
+	    if (sp < lowest) {
+		lowest = sp;
 	    }
 	}
-	break;
-    default:
-	bail_with_error("Invalid instruction type (%d) in machine_execute!",
-			it);
-	break;
     }
+    pthread_mutex_unlock(&threads_lock);
+    return lowest;
+}
+
+// Requires: heap_lock is held
+// Add free blocks of size class c to the heap by moving the heap break,
+// carving a whole slab into blocks if they are small.
+// Return false if that would run into the stack of any VM thread.
+static bool heap_refill(int c)
+{
+    word_type block_words = 1 << c;
+    word_type words = block_words;
+    if (block_words <= HEAP_SLAB_WORDS / 2) {
+	words = HEAP_SLAB_WORDS;
+    }
+    address_type limit = lowest_stack_top();
+    if (heap_break + words > limit) {
+	// a single block might still fit where a whole slab doesn't
+	words = block_words;
+	if (heap_break + words > limit) {
+	    return false;
+	}
+    }
+    // push the blocks so they are handed out in increasing address order
+    for (word_type off = words - block_words; off >= 0; off -= block_words) {
+	memory.uwords[heap_break + off] = heap_free_lists[c];
+	heap_free_lists[c] = heap_break + off;
+    }
+    heap_break += words;
+    return true;
+}
+
+// Requires: heap_lock is held and words >= 0
+// Allocate a block of the given number of words on the heap
+// and return its address, or 0 if there is no room for it
+static address_type heap_allocate_locked(word_type words)
+{
+    if (words == 0) {
+	words = 1;
+    }
+    int c = heap_class(words);
+    if (c == HEAP_NUM_CLASSES
+	|| (heap_free_lists[c] == 0 && !heap_refill(c))) {
+	return 0;
+    }
+    address_type ret = heap_free_lists[c];
+    heap_free_lists[c] = memory.uwords[ret];
+    memory.words[ret] = 0;
+    heap_block_words[ret] = words;
+    heap_stats.allocations++;
+    heap_stats.live_requested_words += words;
+    heap_stats.live_block_words += 1 << c;
+    if (heap_stats.live_block_words > heap_stats.peak_block_words) {
+	heap_stats.peak_block_words = heap_stats.live_block_words;
+    }
+    return ret;
+}
+
+// Allocate a block of the given number of words on the heap
+// and return its address, or 0 if there is no room for it
+static address_type heap_allocate(word_type words)
+{
+    if (words < 0) {
+	bail_with_error("Attempt to allocate a negative number (%d) of words!",
+			words);
+    }
+    pthread_mutex_lock(&heap_lock);
+    address_type ret = heap_allocate_locked(words);
+    pthread_mutex_unlock(&heap_lock);
+    return ret;
+}
+
+// Requires: heap_lock is held and an allocated block starts at addr
+// Free the heap block starting at addr
+static void heap_free_locked(address_type addr)
+{
+    word_type words = heap_block_words[addr];
+    int c = heap_class(words);
+    heap_block_words[addr] = 0;
+    memory.uwords[addr] = heap_free_lists[c];
+    heap_free_lists[c] = addr;
+    heap_stats.frees++;
+    heap_stats.live_requested_words -= words;
+    heap_stats.live_block_words -= 1 << c;
+}
+
+// Free the heap block starting at addr (doing nothing if addr is 0)
+static void heap_free(address_type addr)
+{
+    if (addr == 0) {
+	return;
+    }
+    pthread_mutex_lock(&heap_lock);
+    if (addr >= MEMORY_SIZE_IN_WORDS || heap_block_words[addr] == 0) {
+	pthread_mutex_unlock(&heap_lock);
+	bail_with_error("Attempt to free an address (%u) that is not an allocated block!",
+			addr);
+    }
+    heap_free_locked(addr);
+    pthread_mutex_unlock(&heap_lock);
+}
+
+// Change the size of the heap block starting at addr to the given
+// number of words, keeping its contents (up to the smaller size),
+// and return the block's (possibly new) address;
+// return 0 if there is no room, in which case the block is unchanged.
+// If addr is 0, this is the same as allocating a new block.
+static address_type heap_resize(address_type addr, word_type words)
+{
+    if (addr == 0) {
+	return heap_allocate(words);
+    }
+    if (words < 0) {
+	bail_with_error("Attempt to allocate a negative number (%d) of words!",
+			words);
+    }
+    // the lock is held throughout, so no other VM thread can see
+    // (or change) the block while it is being moved
+    pthread_mutex_lock(&heap_lock);
+    if (addr >= MEMORY_SIZE_IN_WORDS || heap_block_words[addr] == 0) {
+	pthread_mutex_unlock(&heap_lock);
+	bail_with_error("Attempt to resize an address (%u) that is not an allocated block!",
+			addr);
+    }
+    word_type old_words = heap_block_words[addr];
+    address_type ret = addr;
+    if (words > 0 && heap_class(words) == heap_class(old_words)) {
+	// the block is already the right size
+	heap_stats.live_requested_words += words - old_words;
+	heap_block_words[addr] = words;
+    } else {
+	ret = heap_allocate_locked(words);
+	if (ret != 0) {
+	    memcpy(&memory.words[ret], &memory.words[addr],
+		   (old_words < words ? old_words : words) * sizeof(word_type));
+	    heap_free_locked(addr);
+	}
+    }
+    pthread_mutex_unlock(&heap_lock);
+    return ret;
+}
+
+// Print the heap statistics on out
+static void print_heap_statistics(FILE *out)
+{
+    pthread_mutex_lock(&heap_lock);
+    unsigned long heap_words = heap_break - heap_start;
+    fprintf(out, "Heap: %lu allocations, %lu frees\n",
+	    heap_stats.allocations, heap_stats.frees);
+    fprintf(out, "Heap: %lu live words (%lu bytes) requested, %lu words in blocks\n",
+	    heap_stats.live_requested_words,
+	    heap_stats.live_requested_words * BYTES_PER_WORD,
+	    heap_stats.live_block_words);
+    fprintf(out, "Heap: peak of %lu words (%lu bytes) in blocks\n",
+	    heap_stats.peak_block_words,
+	    heap_stats.peak_block_words * BYTES_PER_WORD);
+    fprintf(out, "Heap: %lu words in the heap, fragmentation %.1f%%\n",
+	    heap_words,
+	    heap_words == 0 ? 0.0
+	    : 100.0 * (heap_words - heap_stats.live_requested_words)
+	      / heap_words);
+    pthread_mutex_unlock(&heap_lock);
+}
+
+// should the heap statistics be printed when the program stops?
+static bool heap_statistics = false;
+
+// Arrange for the heap statistics to be printed on stderr
+// when the program stops
+void machine_enable_heap_statistics()
+{
+    heap_statistics = true;
 }
 
+// The memory profile (see machine_enable_memory_profile)
+// and the execution counts (see machine_enable_execution_counts)
+// count the word accesses that each instruction makes,
+// as decoded from the instruction and the registers before it executes.
+// System calls are counted by the words they name and
+// the top of the stack, but the bulk I/O calls' buffers are not counted.
+
+// where code_utils.c saves the static link in an AR,
+// so LWR instructions with this offset are static link chain loads
+#define STATIC_LINK_OFFSET (-3)
+// number of buckets in the histograms, which are by powers of 2
+#define NUM_LOG2_BUCKETS 18
+// the number of most accessed addresses to report
+#define NUM_TOP_ADDRESSES 10
+// the size of a buffer for a name from the debugging information
+#define MAX_DEBUG_NAME_LENGTH 256
+// the range of clock values for computing reuse distances
+#define REUSE_WINDOW (2 * MEMORY_SIZE_IN_WORDS)
+
+// the kinds of memory traffic, by where the words are
+typedef enum {text_seg, global_seg, heap_seg, stack_seg, static_link_seg,
+	      other_seg, num_segs} mem_seg;
+static const char *seg_names[num_segs] = {
+    "text", "global data", "heap", "stack", "static links", "other"
+};
+
+// is the memory profile being gathered?
+static bool profiling_memory = false;
+// are only the execution counts being gathered?
+static bool counting_memory = false;
+// protects the memory profile
+static pthread_mutex_t profile_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// the memory profile's counts
+static struct {
+    unsigned long reads[num_segs];
+    unsigned long writes[num_segs];
+    unsigned long accesses[MEMORY_SIZE_IN_WORDS];
+    // reuse distances of data accesses; bucket 0 is for first accesses
+    unsigned long reuse[NUM_LOG2_BUCKETS + 1];
+    // stack depths in words, sampled at each instruction
+    unsigned long depths[NUM_LOG2_BUCKETS];
+    word_type max_depth;
+} mem_profile;
+
+// The reuse distance of an access is the number of distinct words
+// accessed since the last access to the same word.
+// It is computed from a logical clock that ticks at each data access:
+// reuse_last[wa] is the time of the last access to wa (0 if none),
+// reuse_time_addr[t] is the address accessed at time t,
+// and reuse_tree is a Fenwick tree counting the times
+// that are the last access to some word.
+static unsigned int reuse_clock;
+static unsigned int reuse_last[MEMORY_SIZE_IN_WORDS];
+static address_type reuse_time_addr[REUSE_WINDOW + 1];
+static unsigned int reuse_tree[REUSE_WINDOW + 1];
+
+// Add d to the count for time t in reuse_tree
+static void reuse_tree_add(unsigned int t, int d)
+{
+    for (; t <= REUSE_WINDOW; t += t & -t) {
+	reuse_tree[t] += d;
+    }
+}
+
+// Return the number of times from 1 to t (inclusive) counted in reuse_tree
+static unsigned int reuse_tree_sum(unsigned int t)
+{
+    unsigned int sum = 0;
+    for (; t > 0; t -= t & -t) {
+	sum += reuse_tree[t];
+    }
+    return sum;
+}
+
+// Renumber the last access times of all words as 1, 2, ...
+// (keeping their order), so that the clock can keep going
+static void reuse_compact()
+{
+    unsigned int old_clock = reuse_clock;
+    reuse_clock = 0;
+    memset(reuse_tree, 0, sizeof(reuse_tree));
+    for (unsigned int t = 1; t <= old_clock; t++) {
+	address_type wa = reuse_time_addr[t];
+	if (reuse_last[wa] == t) {
+	    reuse_clock++;
+	    reuse_last[wa] = reuse_clock;
+	    reuse_time_addr[reuse_clock] = wa;
+	    reuse_tree_add(reuse_clock, 1);
+	}
+    }
+}
+
+// Return the bucket for n in a histogram by powers of 2:
+// 0 for 0, 1 for 1, 2 for 2-3, 3 for 4-7, etc.
+static int log2_bucket(unsigned long n)
+{
+    int b = 0;
+    while (n > 0 && b < NUM_LOG2_BUCKETS - 1) {
+	b++;
+	n >>= 1;
+    }
+    return b;
+}
+
+// Record the reuse distance of a data access to wa
+static void record_reuse(address_type wa)
+{
+    if (reuse_clock == REUSE_WINDOW) {
+	reuse_compact();
+    }
+    unsigned int now = ++reuse_clock;
+    unsigned int last = reuse_last[wa];
+    if (last == 0) {
+	mem_profile.reuse[0]++;
+    } else {
+	unsigned int distance = reuse_tree_sum(now - 1) - reuse_tree_sum(last);
+	mem_profile.reuse[1 + log2_bucket(distance)]++;
+	reuse_tree_add(last, -1);
+    }
+    reuse_tree_add(now, 1);
+    reuse_last[wa] = now;
+    reuse_time_addr[now] = wa;
+}
+
+// Return the kind of memory that word address wa is in
+static mem_seg segment_of(address_type wa)
+{
+    if (wa < (address_type) instruction_words) {
+	return text_seg;
+    } else if ((address_type) GPR[GP] <= wa && wa < heap_start) {
+	return global_seg;
+    } else if (heap_start <= wa && wa < heap_break) {
+	return heap_seg;
+    } else if (heap_break <= wa && wa <= initial_stack_bottom) {
+	return stack_seg;
+    } else {
+	return other_seg;
+    }
+}
+
+// Record count data accesses to the words starting at wa,
+// which are writes if is_write is true and reads otherwise,
+// counting them as in seg if seg is not num_segs
+static void record_access(address_type wa, word_type count, bool is_write,
+			  mem_seg seg)
+{
+    for (word_type i = 0; i < count && wa + i < MEMORY_SIZE_IN_WORDS; i++) {
+	mem_seg s = (seg == num_segs) ? segment_of(wa + i) : seg;
+	if (is_write) {
+	    mem_profile.writes[s]++;
+	} else {
+	    mem_profile.reads[s]++;
+	}
+	if (profiling_memory) {
+	    mem_profile.accesses[wa + i]++;
+	    record_reuse(wa + i);
+	}
+    }
+}
+
+// Record a data read of the word at wa
+static void record_read(address_type wa)
+{
+    record_access(wa, 1, false, num_segs);
+}
+
+// Record a data write of the word at wa
+static void record_write(address_type wa)
+{
+    record_access(wa, 1, true, num_segs);
+}
+
+// Requires: bi is the instruction at PC, which has not yet executed,
+// and id is its instr_id.
+// Record the memory accesses that bi will make
+static void profile_memory_accesses(bin_instr_t bi, instr_id id)
+{
+    pthread_mutex_lock(&profile_lock);
+    // the instruction fetch
+    mem_profile.reads[text_seg]++;
+    if (profiling_memory) {
+	mem_profile.accesses[PC]++;
+	// the stack depth
+	word_type depth = initial_stack_bottom - GPR[SP];
+	mem_profile.depths[log2_bucket(depth < 0 ? 0 : depth)]++;
+	if (depth > mem_profile.max_depth) {
+	    mem_profile.max_depth = depth;
+	}
+    }
+
+    // the addresses named by each format's register and offset fields
+    address_type top = GPR[SP];
+    address_type ct = GPR[bi.comp.rt] + machine_types_formOffset(bi.comp.ot);
+    address_type cs = GPR[bi.comp.rs] + machine_types_formOffset(bi.comp.os);
+    address_type oa = GPR[bi.othc.reg]
+	              + machine_types_formOffset(bi.othc.offset);
+
+    switch (id) {
+    case ADD_I: case SUB_I: case AND_I: case BOR_I: case NOR_I: case XOR_I:
+	record_read(top);
+	record_read(cs);
+	record_write(ct);
+	break;
+    case CPW_I: case NEG_I:
+	record_read(cs);
+	record_write(ct);
+	break;
+    case LWR_I:
+	if (bi.comp.os == STATIC_LINK_OFFSET) {
+	    record_access(cs, 1, false, static_link_seg);
+	} else {
+	    record_read(cs);
+	}
+	break;
+    case SWR_I: case SCA_I:
+	record_write(ct);
+	break;
+    case LWI_I:
+	record_read(cs);
+	// the address read is only known if cs is in memory
+	if (cs < MEMORY_SIZE_IN_WORDS) {
+	    record_read(memory.uwords[cs]);
+	}
+	record_write(ct);
+	break;
+    case BCP_I:
+	record_read(top);
+	// as is the number of words copied if top is
+	if (top < MEMORY_SIZE_IN_WORDS) {
+	    record_access(cs, memory.words[top], false, num_segs);
+	    record_access(ct, memory.words[top], true, num_segs);
+	}
+	break;
+    case LIT_I: case CFHI_I: case CFLO_I:
+    case RCH_I:
+	record_write(oa);
+	break;
+    case MUL_I: case DIV_I: case BEQ_I: case BNE_I:
+	record_read(top);
+	record_read(oa);
+	break;
+    case SLL_I: case SRL_I:
+	record_read(top);
+	record_write(oa);
+	break;
+    case JMP_I: case CSI_I: case RSM_I: case MBEG_I: case MEND_I:
+    case FREE_I:
+    case BGEZ_I: case BGTZ_I: case BLEZ_I: case BLTZ_I:
+	record_read(oa);
+	break;
+    case BFL_I:
+	record_read(top);
+	record_access(oa, machine_types_sgnExt(bi.othc.arg), true, num_segs);
+	break;
+    case ADDI_I: case ANDI_I: case BORI_I: case NORI_I: case XORI_I:
+	record_read(oa);
+	record_write(oa);
+	break;
+    case PSTR_I: case PINT_I: case PCH_I: case JOIN_I: case ALOC_I:
+	record_read(oa);
+	record_write(top);
+	break;
+    case RLN_I: case RBYT_I:
+	record_read(top);
+	record_write(oa);
+	record_write(top);
+	break;
+    case PCHS_I: case PBYT_I: case RSZ_I:
+	record_read(top);
+	record_read(oa);
+	record_write(top);
+	break;
+    case SPWN_I: case COCR_I:
+	record_write(top);
+	break;
+    case CAS_I:
+	record_read(top);
+	record_read(top + 1);
+	record_read(oa);
+	record_write(oa);
+	record_write(top);
+	break;
+    case FADD_I:
+	record_read(top);
+	record_read(oa);
+	record_write(oa);
+	record_write(top);
+	break;
+    default:
+	// no data memory accesses
+	break;
+    }
+    pthread_mutex_unlock(&profile_lock);
+}
+
+// Print the range of values in bucket b of a histogram by powers of 2
+// to out, in a field of the given width
+static void print_log2_bucket(FILE *out, int width, int b)
+{
+    char range[48];
+    if (b <= 1) {
+	sprintf(range, "%d", b);
+    } else if (b == NUM_LOG2_BUCKETS - 1) {
+	sprintf(range, "%lu+", 1UL << (b - 1));
+    } else {
+	sprintf(range, "%lu-%lu", 1UL << (b - 1), (1UL << b) - 1);
+    }
+    fprintf(out, "%*s", width, range);
+}
+
+// Format the name that the debugging information gives
+// the word address wa (a label or a global variable) into buf,
+// and return the number of chars written (0 if it has none)
+static int format_debug_name(char *buf, size_t size, address_type wa)
+{
+    if (segment_of(wa) == text_seg) {
+	return bof_debug_format_location(buf, size, &debug_info, wa);
+    }
+    buf[0] = '\0';
+    word_type offset = wa - GPR[GP];
+    if (segment_of(wa) != global_seg || offset >= global_data_words) {
+	return 0;
+    }
+    // a static variable may span several words (e.g., a string)
+    const BOFDebugVariable *best = NULL;
+    for (int i = 0; i < debug_info.variable_count; i++) {
+	const BOFDebugVariable *var = &debug_info.variables[i];
+	if (var->level == DEBUG_STATIC_LEVEL && var->offset <= offset
+	    && (best == NULL || var->offset > best->offset)) {
+	    best = var;
+	}
+    }
+    if (best == NULL) {
+	return 0;
+    }
+    const char *name = bof_debug_name(&debug_info, best->name);
+    if (best->offset == offset) {
+	return snprintf(buf, size, "%s", name);
+    }
+    return snprintf(buf, size, "%s+%d", name, offset - best->offset);
+}
+
+// Print the memory profile on out
+static void print_memory_profile(FILE *out)
+{
+    pthread_mutex_lock(&profile_lock);
+    fprintf(out, "Memory: %-14s %12s %12s\n", "Segment", "Reads", "Writes");
+    for (int s = 0; s < num_segs; s++) {
+	fprintf(out, "Memory: %-14s %12lu %12lu\n", seg_names[s],
+		mem_profile.reads[s], mem_profile.writes[s]);
+    }
+
+    fprintf(out, "Memory: reuse distance (distinct words) of data accesses\n");
+    fprintf(out, "Memory: %14s %12lu\n", "first", mem_profile.reuse[0]);
+    for (int b = 0; b < NUM_LOG2_BUCKETS; b++) {
+	if (mem_profile.reuse[b + 1] != 0) {
+	    fprintf(out, "Memory: ");
+	    print_log2_bucket(out, 14, b);
+	    fprintf(out, " %12lu\n", mem_profile.reuse[b + 1]);
+	}
+    }
+
+    fprintf(out, "Memory: stack depth (words) at each instruction, max %d\n",
+	    mem_profile.max_depth);
+    for (int b = 0; b < NUM_LOG2_BUCKETS; b++) {
+	if (mem_profile.depths[b] != 0) {
+	    fprintf(out, "Memory: ");
+	    print_log2_bucket(out, 14, b);
+	    fprintf(out, " %12lu\n", mem_profile.depths[b]);
+	}
+    }
+
+    fprintf(out, "Memory: %-14s %12s  %s\n", "Address", "Accesses", "Segment");
+    bool shown[MEMORY_SIZE_IN_WORDS] = { false };
+    for (int n = 0; n < NUM_TOP_ADDRESSES; n++) {
+	int best = -1;
+	for (int wa = 0; wa < MEMORY_SIZE_IN_WORDS; wa++) {
+	    if (!shown[wa] && mem_profile.accesses[wa] != 0
+		&& (best < 0
+		    || mem_profile.accesses[wa] > mem_profile.accesses[best])) {
+		best = wa;
+	    }
+	}
+	if (best < 0) {
+	    break;
+	}
+	shown[best] = true;
+	char name[MAX_DEBUG_NAME_LENGTH];
+	if (format_debug_name(name, sizeof(name), best) > 0) {
+	    fprintf(out, "Memory: %14d %12lu  %-12s  %s\n", best,
+		    mem_profile.accesses[best], seg_names[segment_of(best)],
+		    name);
+	} else {
+	    fprintf(out, "Memory: %14d %12lu  %s\n", best,
+		    mem_profile.accesses[best], seg_names[segment_of(best)]);
+	}
+    }
+    pthread_mutex_unlock(&profile_lock);
+}
+
+// Gather a profile of the program's memory accesses
+// (by segment, reuse distance, stack depth, and address),
+// and arrange for it to be printed on stderr when the program stops
+void machine_enable_memory_profile()
+{
+    profiling_memory = true;
+}
+
+// Print the execution counts on out
+static void print_execution_counts(FILE *out)
+{
+    pthread_mutex_lock(&profile_lock);
+    unsigned long memory_operations = 0;
+    for (int s = 0; s < num_segs; s++) {
+	if (s != text_seg) {
+	    memory_operations += mem_profile.reads[s];
+	}
+	memory_operations += mem_profile.writes[s];
+    }
+    fprintf(out, "Counts: %lu instructions, %lu memory operations\n",
+	    instructions_executed
+	    + __atomic_load_n(&finished_threads_instructions,
+			      __ATOMIC_SEQ_CST),
+	    memory_operations);
+    pthread_mutex_unlock(&profile_lock);
+}
+
+// Count the instructions executed and the data memory operations
+// (reads and writes, not counting instruction fetches) they make,
+// and arrange for these counts to be printed on stderr
+// when the program stops
+void machine_enable_execution_counts()
+{
+    counting_memory = true;
+}
+
+// are the reports about the program (see print_reports) still to be
+// printed? (true while it runs)
+static bool reports_pending = false;
+// has print_pending_reports been registered with atexit?
+static bool exit_hook_registered = false;
+
+// Print the reports about the program that were asked for on stderr:
+// the summary of its measurement regions (if it started any),
+// its execution counts, its memory profile, and its heap statistics
+static void print_reports()
+{
+    fflush(stdout);
+    if (num_regions > 0) {
+	print_region_summary(stderr);
+    }
+    if (counting_memory) {
+	print_execution_counts(stderr);
+    }
+    if (profiling_memory) {
+	print_memory_profile(stderr);
+    }
+    if (heap_statistics) {
+	print_heap_statistics(stderr);
+    }
+}
+
+// Print the reports about the program if it is still running
+// (so they are printed even if an error in a spawned VM thread
+// exits the VM)
+static void print_pending_reports()
+{
+    if (reports_pending) {
+	reports_pending = false;
+	print_reports();
+    }
+}
+
+// Print the reports about the program, which has stopped,
+// and turn off gathering them, so the next program starts afresh
+static void finish_reports()
+{
+    reports_pending = false;
+    print_reports();
+    if (profiling_memory || counting_memory) {
+	memset(&mem_profile, 0, sizeof(mem_profile));
+	reuse_clock = 0;
+	memset(reuse_last, 0, sizeof(reuse_last));
+	memset(reuse_tree, 0, sizeof(reuse_tree));
+    }
+    profiling_memory = false;
+    counting_memory = false;
+    heap_statistics = false;
+}
+
+// Run the VM on the already loaded program,
+// producing any trace output called for by the program,
+// and return the program's exit code once its main thread executes EXIT.
+// Errors in any VM thread (e.g., an invalid instruction)
+// are reported by bail_with_error, and so go to the caller's error context
+// if there is one (an error in the main thread taking precedence).
+// Either way, the other VM threads are stopped and the reports
+// that were asked for are printed before this returns.
+int machine_run(bool trace_execution)
+{
+    if (!exit_hook_registered) {
+	atexit(print_pending_reports);
+	exit_hook_registered = true;
+    }
+    reports_pending = true;
+    tracing = trace_execution;
+    if (tracing) {
+	machine_print_state(stdout);
+    }
+    pthread_mutex_lock(&threads_lock);
+    threads[0].in_use = true;
+    threads[0].host_thread = pthread_self();
+    stack_top = GPR[SP];
+    threads[0].stack_top = &stack_top;
+    threads[0].suspended_stack_top = &suspended_stack_top;
+    threads[0].finished = false;
+    pthread_mutex_unlock(&threads_lock);
+    bool failed = false;
+    error_context ec;
+    error_context_enter(&ec);
+    if (setjmp(ec.env) == 0) {
+	// execute the program (until execute_exit returns here)
+	if (setjmp(exit_env) == 0) {
+	    // (a spawned thread's error stops this thread too)
+	    while (running
+		   && !__atomic_load_n(&stopping_threads, __ATOMIC_RELAXED)) {
+		machine_okay(); // check the invariant
+		decoded_instr_t local;
+		const decoded_instr_t *d = fetch_instr(PC, &local);
+		trace_execute(stdout, d->bi, d->id);
+	    }
+	}
+	error_context_leave(&ec);
+    } else {
+	failed = true;
+    }
+    stop_threads();
+    pthread_mutex_lock(&threads_lock);
+    threads[0].in_use = false;
+    threads[0].stack_top = NULL;
+    threads[0].suspended_stack_top = NULL;
+    pthread_mutex_unlock(&threads_lock);
+    finish_reports();
+    if (failed) {
+	error_context_propagate(&ec);
+    }
+    // all of the spawned threads have stopped, so none sets thread_failed
+    if (thread_failed) {
+	error_context_propagate(&thread_error);
+    }
+    return exit_code;
+}
+
+// Load the given binary object file, run it,
+// and return the program's exit code
+int machine_load_and_run(BOFImage img, bool trace_execution)
+{
+    machine_load(img);
+    return machine_run(trace_execution);
+}
+
+// Requires: addr == PC.
+// If tracing then print the given word address and the assembly form of bi,
+// then execute bi (always),
+// then if tracing print out the machine's state.
+// All tracing output goes to the FILE out
+void machine_trace_execute_instr(FILE *out, address_type addr,
+				 bin_instr_t bi)
+{
+    assert(addr == PC);
+    trace_execute(out, bi, instruction_id(bi));
+}
+
+// Execute bi, whose instr_id is id, at the PC
+// (defined below, with the handlers)
+static void execute(bin_instr_t bi, instr_id id);
+
+// Requires: id is the instr_id of bi, the instruction at the PC
+// Trace and execute bi as machine_trace_execute_instr does
+static void trace_execute(FILE *out, bin_instr_t bi, instr_id id)
+{
+    if (tracing) {
+	pthread_mutex_lock(&trace_lock);
+	char where[MAX_DEBUG_NAME_LENGTH];
+	if (bof_debug_format_location(where, sizeof(where), &debug_info, PC)
+	    > 0) {
+	    fprintf(out, "\n# %s", where);
+	}
+	fprintf(out, "\n==> ");
+	if (thread_id != 0) {
+	    fprintf(out, "[thread %d] ", thread_id);
+	}
+	if (current_coroutine != 0) {
+	    fprintf(out, "[coroutine %d] ", current_coroutine);
+	}
+	print_instruction(out, PC, bi);
+	pthread_mutex_unlock(&trace_lock);
+    }
+    execute(bi, id);
+    if (tracing) {
+	pthread_mutex_lock(&trace_lock);
+	machine_print_state(out);
+	pthread_mutex_unlock(&trace_lock);
+    }
+}
+
+// The interpreter has one handler for each row of SSM_INSTRUCTIONS
+// (in instruction_table.h), named execute_ followed by the row's
+// lower case name; machine_execute_instr finds the handler to call
+// by the instruction's instr_id.
+// Each handler is called after the PC has been advanced past
+// the instruction it executes.
+
+// Report a word that is not a valid instruction
+static void execute_error(bin_instr_t bi)
+{
+    bail_with_error("Invalid instruction (op %d, func %d) in machine_execute!",
+		    bi.comp.op, bi.comp.func);
+}
+
+// computational instructions
+
+static void execute_nop(bin_instr_t bi)
+{
+    // do nothing
+}
+
+static void execute_add(bin_instr_t bi)
+{
+    comp_instr_t ci = bi.comp;
+    memory.words[GPR[ci.rt] + machine_types_formOffset(ci.ot)]
+	= memory.words[GPR[SP]]
+	  + memory.words[GPR[ci.rs] + machine_types_formOffset(ci.os)];
+}
+
+static void execute_sub(bin_instr_t bi)
+{
+    comp_instr_t ci = bi.comp;
+    memory.words[GPR[ci.rt] + machine_types_formOffset(ci.ot)]
+	= memory.words[GPR[SP]]
+	- memory.words[GPR[ci.rs]
+		       + machine_types_formOffset(ci.os)];
+}
+
+static void execute_cpw(bin_instr_t bi)
+{
+    comp_instr_t ci = bi.comp;
+    memory.words[GPR[ci.rt] + machine_types_formOffset(ci.ot)]
+	= memory.words[GPR[ci.rs]
+		       + machine_types_formOffset(ci.os)];
+}
+
+static void execute_cpr(bin_instr_t bi)
+{
+    comp_instr_t ci = bi.comp;
+    GPR[ci.rt] = GPR[ci.rs];
+}
+
+static void execute_and(bin_instr_t bi)
+{
+    comp_instr_t ci = bi.comp;
+    memory.uwords[GPR[ci.rt] + machine_types_formOffset(ci.ot)]
+	= memory.uwords[GPR[SP]]
+	& memory.uwords[GPR[ci.rs]
+			+ machine_types_formOffset(ci.os)];
+}
+
+static void execute_bor(bin_instr_t bi)
+{
+    comp_instr_t ci = bi.comp;
+    memory.uwords[GPR[ci.rt] + machine_types_formOffset(ci.ot)]
+	= memory.uwords[GPR[SP]]
+	| memory.uwords[GPR[ci.rs]
+			+ machine_types_formOffset(ci.os)];
+}
+
+static void execute_nor(bin_instr_t bi)
+{
+    comp_instr_t ci = bi.comp;
+    memory.uwords[GPR[ci.rt] + machine_types_formOffset(ci.ot)]
+	= ~(memory.uwords[GPR[SP]]
+	    | memory.uwords[GPR[ci.rs]
+			    + machine_types_formOffset(ci.os)]);
+}
+
+static void execute_xor(bin_instr_t bi)
+{
+    comp_instr_t ci = bi.comp;
+    memory.uwords[GPR[ci.rt] + machine_types_formOffset(ci.ot)]
+	= memory.uwords[GPR[SP]]
+	^ memory.uwords[GPR[ci.rs]
+			+ machine_types_formOffset(ci.os)];
+}
+
+static void execute_lwr(bin_instr_t bi)
+{
+    comp_instr_t ci = bi.comp;
+    GPR[ci.rt]
+	= memory.words[GPR[ci.rs]
+		       + machine_types_formOffset(ci.os)];
+}
+
+static void execute_swr(bin_instr_t bi)
+{
+    comp_instr_t ci = bi.comp;
+    memory.words[GPR[ci.rt]
+		 + machine_types_formOffset(ci.ot)]
+	= GPR[ci.rs];
+}
+
+static void execute_sca(bin_instr_t bi)
+{
+    comp_instr_t ci = bi.comp;
+    memory.words[GPR[ci.rt] + machine_types_formOffset(ci.ot)]
+	= (GPR[ci.rs] + machine_types_formOffset(ci.os));
+}
+
+static void execute_lwi(bin_instr_t bi)
+{
+    comp_instr_t ci = bi.comp;
+    memory.words[GPR[ci.rt] + machine_types_formOffset(ci.ot)]
+	= memory.words[memory.words
+		       [GPR[ci.rs] + machine_types_formOffset(ci.os)]];
+}
+
+static void execute_neg(bin_instr_t bi)
+{
+    comp_instr_t ci = bi.comp;
+    memory.words[GPR[ci.rt] + machine_types_formOffset(ci.ot)]
+	= - (memory.words[GPR[ci.rs]
+			  + machine_types_formOffset(ci.os)]);
+}
+
+static void execute_bcp(bin_instr_t bi)
+{
+    comp_instr_t ci = bi.comp;
+    block_copy(GPR[ci.rt] + machine_types_formOffset(ci.ot),
+	       GPR[ci.rs] + machine_types_formOffset(ci.os),
+	       memory.words[GPR[SP]]);
+}
+
+// register computational instructions
+
+// The register arithmetic wraps around on overflow (as in two's complement
+// hardware), so it is done on unsigned words, where C defines overflow
+
+static void execute_radd(bin_instr_t bi)
+{
+    reg_comp_instr_t rci = bi.rcomp;
+    GPR[rci.rd] = (uword_type) GPR[rci.rs] + (uword_type) GPR[rci.rt];
+}
+
+static void execute_rsub(bin_instr_t bi)
+{
+    reg_comp_instr_t rci = bi.rcomp;
+    GPR[rci.rd] = (uword_type) GPR[rci.rs] - (uword_type) GPR[rci.rt];
+}
+
+static void execute_rmul(bin_instr_t bi)
+{
+    reg_comp_instr_t rci = bi.rcomp;
+    GPR[rci.rd] = (uword_type) GPR[rci.rs] * (uword_type) GPR[rci.rt];
+}
+
+static void execute_rdiv(bin_instr_t bi)
+{
+    reg_comp_instr_t rci = bi.rcomp;
+    if (GPR[rci.rt] == 0) {
+	bail_with_error("Error: Attempt to divide by zero!");
+    }
+    if (GPR[rci.rt] == -1) {
+	// the most negative word divided by -1 wraps around to itself
+	GPR[rci.rd] = 0U - (uword_type) GPR[rci.rs];
+    } else {
+	GPR[rci.rd] = GPR[rci.rs] / GPR[rci.rt];
+    }
+}
+
+static void execute_rand(bin_instr_t bi)
+{
+    reg_comp_instr_t rci = bi.rcomp;
+    GPR[rci.rd] = (uword_type) GPR[rci.rs] & (uword_type) GPR[rci.rt];
+}
+
+static void execute_rbor(bin_instr_t bi)
+{
+    reg_comp_instr_t rci = bi.rcomp;
+    GPR[rci.rd] = (uword_type) GPR[rci.rs] | (uword_type) GPR[rci.rt];
+}
+
+static void execute_rxor(bin_instr_t bi)
+{
+    reg_comp_instr_t rci = bi.rcomp;
+    GPR[rci.rd] = (uword_type) GPR[rci.rs] ^ (uword_type) GPR[rci.rt];
+}
+
+static void execute_rslt(bin_instr_t bi)
+{
+    reg_comp_instr_t rci = bi.rcomp;
+    GPR[rci.rd] = (GPR[rci.rs] < GPR[rci.rt]);
+}
+
+// other computational instructions
+
+static void execute_lit(bin_instr_t bi)
+{
+    other_comp_instr_t oci = bi.othc;
+    memory.words[GPR[oci.reg] + machine_types_sgnExt(oci.offset)]
+	= machine_types_sgnExt(oci.arg);
+}
+
+static void execute_ari(bin_instr_t bi)
+{
+    other_comp_instr_t oci = bi.othc;
+    GPR[oci.reg] = GPR[oci.reg] + machine_types_sgnExt(oci.arg);
+}
+
+static void execute_sri(bin_instr_t bi)
+{
+    other_comp_instr_t oci = bi.othc;
+    GPR[oci.reg] = GPR[oci.reg] - machine_types_sgnExt(oci.arg);
+}
+
+static void execute_mul(bin_instr_t bi)
+{
+    other_comp_instr_t oci = bi.othc;
+    hilo_regs.result
+	= (long) memory.words[GPR[SP]]
+	  * (long) memory.words[GPR[oci.reg]
+				+ machine_types_formOffset(oci.offset)];
+}
+
+static void execute_div(bin_instr_t bi)
+{
+    other_comp_instr_t oci = bi.othc;
+    int divisor = memory.words[GPR[oci.reg]
+			       + machine_types_formOffset(oci.offset)];
+    if (divisor == 0) {
+	bail_with_error("Error: Attempt to divide by zero!");
+    }
+    if (divisor == -1) {
+	// as in RDIV, the most negative word divided by -1 wraps around
+	hilo_regs.hilo[HI] = 0;
+	hilo_regs.hilo[LO] = 0U - memory.uwords[GPR[SP]];
+    } else {
+	hilo_regs.hilo[HI] = memory.words[GPR[SP]] % divisor;
+	hilo_regs.hilo[LO] = memory.words[GPR[SP]] / divisor;
+    }
+}
+
+static void execute_cfhi(bin_instr_t bi)
+{
+    other_comp_instr_t oci = bi.othc;
+    memory.words[GPR[oci.reg]
+		 + machine_types_formOffset(oci.offset)]
+	= hilo_regs.hilo[HI];
+}
+
+static void execute_cflo(bin_instr_t bi)
+{
+    other_comp_instr_t oci = bi.othc;
+    memory.words[GPR[oci.reg]
+		 + machine_types_formOffset(oci.offset)]
+	= hilo_regs.hilo[LO];
+}
+
+static void execute_sll(bin_instr_t bi)
+{
+    other_comp_instr_t oci = bi.othc;
+    memory.uwords[GPR[oci.reg]
+		  + machine_types_formOffset(oci.offset)]
+	= memory.uwords[GPR[SP]] << oci.arg;
+}
+
+static void execute_srl(bin_instr_t bi)
+{
+    other_comp_instr_t oci = bi.othc;
+    memory.uwords[GPR[oci.reg]
+		  + machine_types_formOffset(oci.offset)]
+	= memory.uwords[GPR[SP]] >> oci.arg;
+}
+
+static void execute_jmp(bin_instr_t bi)
+{
+    other_comp_instr_t oci = bi.othc;
+    PC = memory.uwords[GPR[oci.reg]
+		       + machine_types_formOffset(oci.offset)];
+}
+
+static void execute_csi(bin_instr_t bi)
+{
+    other_comp_instr_t oci = bi.othc;
+    GPR[RA] = PC;
+    PC = memory.words[GPR[oci.reg]
+		      + machine_types_formOffset(oci.offset)];
+}
+
+static void execute_jrel(bin_instr_t bi)
+{
+    other_comp_instr_t oci = bi.othc;
+    PC = (PC - 1) + machine_types_formOffset(oci.arg);
+}
+
+static void execute_bfl(bin_instr_t bi)
+{
+    other_comp_instr_t oci = bi.othc;
+    block_fill(GPR[oci.reg] + machine_types_formOffset(oci.offset),
+	       machine_types_sgnExt(oci.arg),
+	       memory.words[GPR[SP]]);
+}
+
+// register branch instructions
+
+// branch by rbi's offset if taken
+static void reg_branch(reg_branch_instr_t rbi, bool taken)
+{
+    if (taken) {
+	PC = (PC - 1) + machine_types_formOffset(rbi.offset);
+    }
+}
+
+static void execute_breq(bin_instr_t bi)
+{
+    reg_branch(bi.rbranch, GPR[bi.rbranch.rs] == GPR[bi.rbranch.rt]);
+}
+
+static void execute_brne(bin_instr_t bi)
+{
+    reg_branch(bi.rbranch, GPR[bi.rbranch.rs] != GPR[bi.rbranch.rt]);
+}
+
+static void execute_brlt(bin_instr_t bi)
+{
+    reg_branch(bi.rbranch, GPR[bi.rbranch.rs] < GPR[bi.rbranch.rt]);
+}
+
+static void execute_brle(bin_instr_t bi)
+{
+    reg_branch(bi.rbranch, GPR[bi.rbranch.rs] <= GPR[bi.rbranch.rt]);
+}
+
+static void execute_brgt(bin_instr_t bi)
+{
+    reg_branch(bi.rbranch, GPR[bi.rbranch.rs] > GPR[bi.rbranch.rt]);
+}
+
+static void execute_brge(bin_instr_t bi)
+{
+    reg_branch(bi.rbranch, GPR[bi.rbranch.rs] >= GPR[bi.rbranch.rt]);
+}
+
+// system calls
+
+// Return the word address that si's register and offset designate
+static address_type syscall_address(syscall_instr_t si)
+{
+    return GPR[si.reg] + machine_types_formOffset(si.offset);
+}
+
+static void execute_exit(bin_instr_t bi)
+{
+    syscall_instr_t si = bi.syscall;
+    if (current_coroutine != 0) {
+	// only the coroutine finishes
+	end_coroutine();
+	return;
+    }
+    running = false;
+    if (thread_id != 0) {
+	// only the spawned thread stops
+	thread_exit_code = machine_types_sgnExt(si.offset);
+	return;
+    }
+    exit_code = machine_types_sgnExt(si.offset);
+    longjmp(exit_env, 1);
+}
+
+static void execute_pstr(bin_instr_t bi)
+{
+    memory.words[GPR[SP]]
+	= printf("%s",
+		 (char *) &(memory.words[syscall_address(bi.syscall)]));
+}
+
+static void execute_pint(bin_instr_t bi)
+{
+    memory.words[GPR[SP]]
+	= printf("%d", memory.words[syscall_address(bi.syscall)]);
+}
+
+static void execute_pch(bin_instr_t bi)
+{
+    memory.words[GPR[SP]]
+	= fputc(memory.words[syscall_address(bi.syscall)], stdout);
+}
+
+static void execute_rch(bin_instr_t bi)
+{
+    memory.words[syscall_address(bi.syscall)] = getc(input_file());
+}
+
+static void execute_rln(bin_instr_t bi)
+{
+    memory.words[GPR[SP]]
+	= read_line_into(syscall_address(bi.syscall),
+			 memory.words[GPR[SP]]);
+}
+
+static void execute_rbyt(bin_instr_t bi)
+{
+    memory.words[GPR[SP]]
+	= read_bytes_into(syscall_address(bi.syscall),
+			  memory.words[GPR[SP]]);
+}
+
+static void execute_pchs(bin_instr_t bi)
+{
+    memory.words[GPR[SP]]
+	= print_chars_from(syscall_address(bi.syscall),
+			   memory.words[GPR[SP]]);
+}
+
+static void execute_pbyt(bin_instr_t bi)
+{
+    memory.words[GPR[SP]]
+	= print_bytes_from(syscall_address(bi.syscall),
+			   memory.words[GPR[SP]]);
+}
+
+static void execute_spwn(bin_instr_t bi)
+{
+    memory.words[GPR[SP]] = spawn_thread(syscall_address(bi.syscall));
+}
+
+static void execute_join(bin_instr_t bi)
+{
+    memory.words[GPR[SP]]
+	= join_thread(memory.words[syscall_address(bi.syscall)]);
+}
+
+static void execute_cas(bin_instr_t bi)
+{
+    // the expected value is on top of the stack,
+    // and the new value is just below it;
+    // the old value replaces the expected one
+    check_block_in_memory(GPR[SP], 2);
+    check_block_in_memory(syscall_address(bi.syscall), 1);
+    word_type expected = memory.words[GPR[SP]];
+    __atomic_compare_exchange_n(&memory.words[syscall_address(bi.syscall)],
+				&expected,
+				memory.words[GPR[SP] + 1],
+				false, __ATOMIC_SEQ_CST,
+				__ATOMIC_SEQ_CST);
+    memory.words[GPR[SP]] = expected;
+}
+
+static void execute_fadd(bin_instr_t bi)
+{
+    // the amount to add is on top of the stack,
+    // and the old value replaces it
+    check_block_in_memory(GPR[SP], 1);
+    check_block_in_memory(syscall_address(bi.syscall), 1);
+    memory.words[GPR[SP]]
+	= __atomic_fetch_add(&memory.words[syscall_address(bi.syscall)],
+			     memory.words[GPR[SP]],
+			     __ATOMIC_SEQ_CST);
+}
+
+static void execute_cocr(bin_instr_t bi)
+{
+    memory.words[GPR[SP]] = create_coroutine(syscall_address(bi.syscall));
+}
+
+static void execute_yld(bin_instr_t bi)
+{
+    switch_to_coroutine(next_coroutine());
+}
+
+static void execute_rsm(bin_instr_t bi)
+{
+    resume_coroutine(memory.words[syscall_address(bi.syscall)]);
+}
+
+static void execute_mbeg(bin_instr_t bi)
+{
+    begin_region(syscall_address(bi.syscall));
+}
+
+static void execute_mend(bin_instr_t bi)
+{
+    end_region(syscall_address(bi.syscall));
+}
+
+static void execute_aloc(bin_instr_t bi)
+{
+    memory.words[GPR[SP]]
+	= heap_allocate(memory.words[syscall_address(bi.syscall)]);
+}
+
+static void execute_free(bin_instr_t bi)
+{
+    heap_free(memory.uwords[syscall_address(bi.syscall)]);
+}
+
+static void execute_rsz(bin_instr_t bi)
+{
+    memory.words[GPR[SP]]
+	= heap_resize(memory.uwords[syscall_address(bi.syscall)],
+		      memory.words[GPR[SP]]);
+}
+
+static void execute_stra(bin_instr_t bi)
+{
+    tracing = true;
+}
+
+static void execute_notr(bin_instr_t bi)
+{
+    tracing = false;
+}
+
+// immediate format instructions
+
+// Return the word address that ii's register and offset designate
+static address_type immed_address(immed_instr_t ii)
+{
+    return GPR[ii.reg] + machine_types_formOffset(ii.offset);
+}
+
+// branch by ii's immediate offset if taken
+static void immed_branch(immed_instr_t ii, bool taken)
+{
+    if (taken) {
+	PC = (PC - 1) + machine_types_formOffset(ii.immed);
+    }
+}
+
+static void execute_addi(bin_instr_t bi)
+{
+    immed_instr_t ii = bi.immed;
+    memory.words[immed_address(ii)]
+	= memory.words[immed_address(ii)] + machine_types_sgnExt(ii.immed);
+}
+
+static void execute_andi(bin_instr_t bi)
+{
+    address_type wa = immed_address(bi.immed);
+    memory.uwords[wa] = memory.uwords[wa]
+			& machine_types_zeroExt(bi.uimmed.uimmed);
+}
+
+static void execute_bori(bin_instr_t bi)
+{
+    address_type wa = immed_address(bi.immed);
+    memory.uwords[wa] = memory.uwords[wa]
+			| machine_types_zeroExt(bi.uimmed.uimmed);
+}
+
+static void execute_nori(bin_instr_t bi)
+{
+    address_type wa = immed_address(bi.immed);
+    memory.uwords[wa] = ~(memory.uwords[wa]
+			  | machine_types_zeroExt(bi.uimmed.uimmed));
+}
+
+static void execute_xori(bin_instr_t bi)
+{
+    address_type wa = immed_address(bi.immed);
+    memory.uwords[wa] = memory.uwords[wa]
+			^ machine_types_zeroExt(bi.uimmed.uimmed);
+}
+
+static void execute_beq(bin_instr_t bi)
+{
+    immed_branch(bi.immed, memory.words[GPR[SP]]
+		 == memory.words[immed_address(bi.immed)]);
+}
+
+static void execute_bgez(bin_instr_t bi)
+{
+    immed_branch(bi.immed, memory.words[immed_address(bi.immed)] >= 0);
+}
+
+static void execute_bgtz(bin_instr_t bi)
+{
+    immed_branch(bi.immed, memory.words[immed_address(bi.immed)] > 0);
+}
+
+static void execute_blez(bin_instr_t bi)
+{
+    immed_branch(bi.immed, memory.words[immed_address(bi.immed)] <= 0);
+}
+
+static void execute_bltz(bin_instr_t bi)
+{
+    immed_branch(bi.immed, memory.words[immed_address(bi.immed)] < 0);
+}
+
+static void execute_bne(bin_instr_t bi)
+{
+    immed_branch(bi.immed, memory.words[GPR[SP]]
+		 != memory.words[immed_address(bi.immed)]);
+}
+
+// jump format instructions
+
+static void execute_jmpa(bin_instr_t bi)
+{
+    PC = machine_types_formAddress(PC-1, bi.jump.addr);
+}
+
+static void execute_call(bin_instr_t bi)
+{
+    GPR[RA] = PC;
+    PC = machine_types_formAddress(PC-1, bi.jump.addr);
+}
+
+static void execute_rtn(bin_instr_t bi)
+{
+    PC = GPR[RA];
+}
+
+// the handler for each instr_id
+#define HANDLER(NAME, name, type, op, func, sub, form) \
+    [NAME##_I] = execute_##name,
+static void (* const handlers[num_instr_ids])(bin_instr_t bi) = {
+    [error_instr_id] = execute_error,
+    SSM_INSTRUCTIONS(HANDLER)
+};
+#undef HANDLER
+
+// Requires: id is the instr_id of bi, the instruction at the PC
+// Execute bi in the machine's current state
+static void execute(bin_instr_t bi, instr_id id)
+{
+    if (profiling_memory || counting_memory) {
+	profile_memory_accesses(bi, id);
+    }
+
+    // increment the PC (advance address by 1 word)
+    PC = PC + 1;
+    instructions_executed++;
+
+    // execute the actual instruction
+    handlers[id](bi);
+    __atomic_store_n(&stack_top, GPR[SP], __ATOMIC_RELAXED);
+}
+
+// Requires: The instruction at memory.uwords[PC] encodes bi.
+// Execute the given instruction, which is found at word address addr,
+// in the machine's current state
+void machine_execute_instr(address_type addr, bin_instr_t bi)
+{
+    execute(bi, instruction_id(bi));
+}
+
+
 #define    REGFORMAT1 "GPR[%-3s]: %-5d"
 #define    REGFORMAT2 "\tGPR[%-3s]: %-5d"
 
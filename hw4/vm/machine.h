@@ -9,9 +9,12 @@
 // a size for the memory (2^16 = 32K words)
 #define MEMORY_SIZE_IN_WORDS 32768
 
-// Requires: bf is open for reading in binary
-// Load the binary object file bf, and get ready to run it
-extern void machine_load(BOFFILE bf);
+// Load the binary object file image img (see bof_map), and get ready to run it.
+// The sections are copied into the memory, so img may be released
+// once this returns.
+// Nothing from a program loaded (and run) before is kept,
+// so several programs can be loaded and run one after another.
+extern void machine_load(BOFImage img);
 
 // Requires: a program has been loaded into the computer's memory
 // print a heading and the program in the VM's memory to out
@@ -19,11 +22,41 @@ extern void machine_print_loaded_program(FILE *out);
 
 // Run the VM on the already loaded program,
 // producing any trace output called for by the program
-// if trace_execution is true
-extern void machine_run(bool trace_execution);
+// if trace_execution is true,
+// and return the program's exit code once its main thread executes EXIT.
+// Errors in any of its VM threads (e.g., an invalid instruction)
+// are reported by bail_with_error, and so go to the caller's error context
+// if there is one (see utilities.h); an error in a spawned thread stops
+// the program, and the first such error is reported unless the main
+// thread also reports one.
+// Either way, the program's other VM threads are stopped, and the reports
+// enabled for it (see below) are printed, before this returns.
+extern int machine_run(bool trace_execution);
 
-// Load the given binary object file and run it
-extern void machine_load_and_run(BOFFILE bf, bool trace_execution);
+// Load the given binary object file, run it,
+// and return the program's exit code
+extern int machine_load_and_run(BOFImage img, bool trace_execution);
+
+// Make the program's input (read by the system calls) come from in
+// instead of stdin
+extern void machine_set_input(FILE *in);
+
+// Arrange for the heap statistics to be printed on stderr
+// when the program stops.
+// This (like the other machine_enable_ functions) applies to the next
+// run of the loaded program, so it is called after machine_load
+extern void machine_enable_heap_statistics();
+
+// Gather a profile of the program's memory accesses
+// (by segment, reuse distance, stack depth, and address),
+// and arrange for it to be printed on stderr when the program stops
+extern void machine_enable_memory_profile();
+
+// Count the instructions executed and the data memory operations
+// (reads and writes, not counting instruction fetches) they make,
+// and arrange for these counts to be printed on stderr
+// when the program stops
+extern void machine_enable_execution_counts();
 
 // If tracing then print bi, execute bi (always),
 // then if tracing print out the machine's state.
@@ -1,8 +1,10 @@
 /* $Id: machine_main.c,v 1.6 2024/11/10 13:22:31 leavens Exp $ */
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "bof.h"
+#include "bof_archive.h"
 #include "machine.h"
 #include "utilities.h"
 
@@ -10,53 +12,110 @@
 static void usage(const char *cmdname)
 {
     bail_with_error(
-		    "Usage: %s [-p] file.bof\n        %s [-t] file.bof",
-		    cmdname, cmdname);
+		    "Usage: %s [-p] file.bof ...\n        %s [-t] [-s] [-m] [-i] file.bof ...\n        %s [-p | [-t] [-s] [-m] [-i]] file.boa member",
+		    cmdname, cmdname, cmdname);
 }
 
-// Run the VM on the .bof file name given in argv[1]
+// the options given on the command line
+static bool print_program = false;
+static bool trace_execution = false;
+static bool heap_statistics = false;
+static bool memory_profile = false;
+static bool execution_counts = false;
+
+// Requires: a program has been loaded (by machine_load)
+// Print or run the loaded program, as the options say,
+// and return its exit code
+static int print_or_run()
+{
+    // if printing, don't run the program
+    if (print_program) {
+	machine_print_loaded_program(stdout);
+	return EXIT_SUCCESS;
+    }
+    
+    if (heap_statistics) {
+	machine_enable_heap_statistics();
+    }
+    if (memory_profile) {
+	machine_enable_memory_profile();
+    }
+    if (execution_counts) {
+	machine_enable_execution_counts();
+    }
+    return machine_run(trace_execution);
+}
+
+// Run the VM on each .bof file named in argv[1], argv[2], ...,
+// one after another,
+// or on the member of the archive (see bof_archive.h) given in argv[1]
+// that is named (or numbered) by argv[2]
 int main(int argc, char *argv[])
 {
     const char *cmdname = argv[0];
     argc--;
     argv++;
 
-    bool print_program = false;
-    bool trace_execution = false;
-    if (argc == 2 && strcmp(argv[0], "-p") == 0) {
-	print_program = true;
-	argc--;
-	argv++;
-    } else if (argc == 2 && strcmp(argv[0], "-t") == 0) {
-	trace_execution = true;
+    while (argc > 1 && argv[0][0] == '-') {
+	if (strcmp(argv[0], "-p") == 0) {
+	    print_program = true;
+	} else if (strcmp(argv[0], "-t") == 0) {
+	    trace_execution = true;
+	} else if (strcmp(argv[0], "-s") == 0) {
+	    heap_statistics = true;
+	} else if (strcmp(argv[0], "-m") == 0) {
+	    memory_profile = true;
+	} else if (strcmp(argv[0], "-i") == 0) {
+	    execution_counts = true;
+	} else {
+	    usage(cmdname);
+	}
 	argc--;
 	argv++;
     }
-
-    // now there should be exactly 1 file argument
-    if (argc != 1 || argv[0][0] == '-') {
+    if (print_program && (trace_execution || heap_statistics
+			   || memory_profile || execution_counts)) {
 	usage(cmdname);
     }
 
-    char *suffix = strchr(argv[0], '.');
-    if (suffix == NULL || strncmp(suffix, ".bof", 4) != 0) {
+    // now there should be .bof files, or an archive and a member of it
+    if (argc < 1 || argv[0][0] == '-') {
 	usage(cmdname);
     }
-
-    BOFFILE bf = bof_read_open(argv[0]);
-
-    machine_load(bf);
-
-    // if printing, don't run the program
-    if (print_program) {
-	machine_print_loaded_program(stdout);
-	return EXIT_SUCCESS;
+    char *suffix = strrchr(argv[0], '.');
+    if (argc == 2 && suffix != NULL && strcmp(suffix, ".boa") == 0) {
+	// the archive stays mapped, as the member's input is read from it
+	BOFArchive ar = bof_archive_map(argv[0]);
+	int n = bof_archive_find(&ar, argv[1]);
+	machine_load(bof_archive_image(&ar, n));
+	size_t input_bytes;
+	const char *input = bof_archive_input(&ar, n, &input_bytes);
+	if (input_bytes > 0) {
+	    FILE *in = fmemopen((void *) input, input_bytes, "r");
+	    if (in == NULL) {
+		bail_with_error("Cannot read the input of member %s of %s!",
+				argv[1], argv[0]);
+	    }
+	    machine_set_input(in);
+	} else {
+	    machine_set_input(fopen("/dev/null", "r"));
+	}
+	return print_or_run();
     }
-    
-    machine_run(trace_execution);
 
-    // the following should never execute,
-    // as the exit system call will call exit(0),
-    // and if the machine goes into an infinite loop it never gets here!
-    return EXIT_SUCCESS;
+    for (int i = 0; i < argc; i++) {
+	suffix = strrchr(argv[i], '.');
+	if (suffix == NULL || strcmp(suffix, ".bof") != 0) {
+	    usage(cmdname);
+	}
+    }
+    // the VM's exit code is that of the last program
+    int ret = EXIT_SUCCESS;
+    for (int i = 0; i < argc; i++) {
+	BOFImage img = bof_map(argv[i]);
+	machine_load(img);
+	bof_unmap(img);
+	ret = print_or_run();
+    }
+    return ret;
 }
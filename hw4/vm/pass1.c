@@ -4,82 +4,83 @@
 #include "symtab.h"
 #include "utilities.h"
 
-// Build the symbol table and check for duplicate declarations in the given AST
-void pass1(ast_program_t progast)
+// Build the symbol table tab and check for duplicate declarations
+// in the given AST
+void pass1(symtab_t *tab, ast_program_t progast)
 {
-    symtab_initialize();
-    pass1TextSection(progast.textSection);
-    pass1DataSection(progast.dataSection);
+    symtab_initialize(tab);
+    pass1TextSection(tab, progast.textSection);
+    pass1DataSection(tab, progast.dataSection);
 }
 
-// Check the given AST and put its declarations in the symbol table
-void pass1TextSection(ast_text_section_t ts)
+// Check the given AST and put its declarations in tab
+void pass1TextSection(symtab_t *tab, ast_text_section_t ts)
 {
-    pass1AsmInstrs(ts.instrs);
+    pass1AsmInstrs(tab, ts.instrs);
 }
 
-// Check the given AST and put its declarations in the symbol table
-void pass1AsmInstrs(ast_asm_instrs_t instrs)
+// Check the given AST and put its declarations in tab
+void pass1AsmInstrs(symtab_t *tab, ast_asm_instrs_t instrs)
 {
     ast_asm_instr_t *ip = instrs.instrs;
     address_type count = 0;
     while (ip != NULL) {
-	pass1AsmInstr(*ip, count);
+	pass1AsmInstr(tab, *ip, count);
 	ip = ip->next;
 	count++;
     }
 }
 
-// Check the given AST and put its declarations in the symbol table
-void pass1AsmInstr(ast_asm_instr_t instr, address_type count)
+// Check the given AST and put its declarations in tab
+void pass1AsmInstr(symtab_t *tab, ast_asm_instr_t instr, address_type count)
 {
-    pass1LabelOpt(instr.label_opt, count);
+    pass1LabelOpt(tab, instr.label_opt, count);
 }
 
-// Check the given AST and put its declarations in the symbol table
-void pass1LabelOpt(ast_label_opt_t lopt, address_type count)
+// Check the given AST and put its declarations in tab
+void pass1LabelOpt(symtab_t *tab, ast_label_opt_t lopt, address_type count)
 {
     if (lopt.name != NULL) {
 	id_attrs_assoc attrs;
-	if (symtab_defined(lopt.name)) {
+	if (symtab_defined(tab, lopt.name)) {
 	    bail_with_error("Duplicate declaration of label \"%s\"",
 			    lopt.name);
 	}
 	attrs.name = lopt.name;
 	attrs.kind = id_label;
 	attrs.addr = count;
-	symtab_insert(attrs);
+	symtab_insert(tab, attrs);
     }
 }
 
-// Check the given AST and put its declarations in the symbol table
-void pass1DataSection(ast_data_section_t ds)
+// Check the given AST and put its declarations in tab
+void pass1DataSection(symtab_t *tab, ast_data_section_t ds)
 {
-    pass1StaticDecls(ds.staticDecls);
+    pass1StaticDecls(tab, ds.staticDecls);
 }
 
-// Check the given AST and put its declarations in the symbol table
-void pass1StaticDecls(ast_static_decls_t sds)
+// Check the given AST and put its declarations in tab
+void pass1StaticDecls(symtab_t *tab, ast_static_decls_t sds)
 {
     address_type offset = 0;
     ast_static_decl_t *dcl = sds.decls;
     while (dcl != NULL) {
-	pass1StaticDecl(*dcl, offset);
+	pass1StaticDecl(tab, *dcl, offset);
 	offset += dcl->size_in_words;
 	dcl = dcl->next;
     }
 }
 
-// Check the given AST and put its declarations in the symbol table
-void pass1StaticDecl(ast_static_decl_t dcl, address_type offset)
+// Check the given AST and put its declarations in tab
+void pass1StaticDecl(symtab_t *tab, ast_static_decl_t dcl, address_type offset)
 {
-    pass1DeclareIdent(dcl.ident, offset);
+    pass1DeclareIdent(tab, dcl.ident, offset);
 }
 
-// Check the given AST and put its declarations in the symbol table
-void pass1DeclareIdent(ast_ident_t id, address_type offset)
+// Check the given AST and put its declarations in tab
+void pass1DeclareIdent(symtab_t *tab, ast_ident_t id, address_type offset)
 {
-    if (symtab_defined(id.name)) {
+    if (symtab_defined(tab, id.name)) {
 	bail_with_error("Duplicate declaration of data name \"%s\"",
 			id.name);
     }
@@ -87,7 +88,7 @@ void pass1DeclareIdent(ast_ident_t id, address_type offset)
     assoc.name = id.name;
     assoc.kind = id_data;
     assoc.addr = offset;
-    symtab_insert(assoc);
+    symtab_insert(tab, assoc);
 }
 
 // Print, on out, the header line for the printed output
@@ -113,13 +114,14 @@ static const char *id_attr_kind_2_string(id_attr_kind k) {
     return NULL;
 }
 
-// Requires: symtab_defined(name);
+// Requires: symtab_defined(tab, name);
 // Print, on out, a line with the symbol table's information about name
 // followed by a newline
-static void pass1_print_name_info(FILE *out, const char *name)
+static void pass1_print_name_info(FILE *out, symtab_t *tab,
+				  const char *name)
 {
     id_attrs_assoc na, *assoc;
-    assoc = symtab_lookup(name);
+    assoc = symtab_lookup(tab, name);
     if (assoc == NULL) {
 	bail_with_error("pass1_print_name_info given NULL pointer!");
     } else {
@@ -131,13 +133,13 @@ static void pass1_print_name_info(FILE *out, const char *name)
 
 // Requires: out is a character file (like stdout)
 //           that is open for writing
-// Print debugging information about the symbol table on out
-void pass1_print(FILE *out)
+// Print debugging information about the symbol table tab on out
+void pass1_print(FILE *out, symtab_t *tab)
 {
     pass1_print_header(out);
-    const char *name = name = symtab_first_name();
-    while (symtab_more_after(name)) {
-	pass1_print_name_info(out, name);
-	name = symtab_next_name(name);
+    const char *name = name = symtab_first_name(tab);
+    while (symtab_more_after(tab, name)) {
+	pass1_print_name_info(out, tab, name);
+	name = symtab_next_name(tab, name);
     }
 }
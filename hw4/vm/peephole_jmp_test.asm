@@ -0,0 +1,15 @@
+	# $Id$
+	# test that a program with a JMP is not optimized (by asm -O),
+	# as its addresses would change under the address it jumps to:
+	# its listing should have every instruction, and it should print 5
+	.text start
+start:	ARI $sp, 0          # adds 0, but is not removed
+	SRI $sp, 1
+	LIT $sp, 0, 5       # the address of there
+	JMP $sp, 0
+	EXIT 1
+there:	PINT $sp, 0
+	EXIT 0
+	.data 1024
+	.stack 4096
+	.end
@@ -0,0 +1,17 @@
+	# $Id$
+	# test that a program that loads $ra with LWR from a word
+	# it did not save $ra in is not optimized (by asm -O):
+	# its listing should have every instruction, and it should print 7
+	.text start
+start:	ARI $sp, 0          # adds 0, but is not removed
+	SRI $sp, 1
+	LIT $sp, 0, 6       # the address of there
+	LWR $ra, $sp, 0
+	RTN
+	EXIT 1
+there:	LIT $sp, 0, 7
+	PINT $sp, 0
+	EXIT 0
+	.data 1024
+	.stack 4096
+	.end
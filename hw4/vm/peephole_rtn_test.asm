@@ -0,0 +1,20 @@
+	# $Id$
+	# test that a program that returns to an address it computes
+	# is not optimized (by asm -O), as that address would change:
+	# its listing should have every instruction, and it should print 5
+	# (asm -O treats an LWR into $ra from an offset at which the program
+	# saves $ra as reloading a return address; it does not detect
+	# one that is changed in memory before it is reloaded)
+	.text start
+start:	ARI $sp, 0          # adds 0, but is not removed
+	SRI $sp, 1
+	ARI $ra, 5          # the address of there
+	RTN
+	EXIT 1
+there:	CPR $r3, $ra
+	SWR $sp, 0, $r3
+	PINT $sp, 0
+	EXIT 0
+	.data 1024
+	.stack 4096
+	.end
@@ -0,0 +1,39 @@
+	# $Id$
+	# test of peephole optimization (assembled with asm -O):
+	# the instructions marked "removed" should not be in its listing,
+	# and it should print the same as it does without optimization
+	.text start
+start:	ARI $sp, 0          # adds 0, removed
+	ADDI $gp, 0, 0      # adds 0, removed
+	SRI $sp, 2          # allocate two words on the stack
+	ARI $r3, 5          # ARI and SRI of the same amount, both removed
+	SRI $r3, 5
+	LIT $sp, 0, 7
+	SWR $sp, 1, $r3     # store $r3
+	LWR $r3, $sp, 1     # and load it back, removed
+	CPW $gp, 1, $sp, 0  # copy the 7 to count
+	CPW $sp, 0, $gp, 1  # and back, removed
+	BEQ $gp, 1, 1       # branch to the next instruction, removed
+	JREL 1              # jump to the next instruction, removed
+	CALL hop            # goes straight to show
+	JMPA next           # jump to the next instruction, removed
+next:	LIT $gp, 2, 3       # count down from 3
+loop:	PINT $gp, 2
+	ADDI $gp, 2, -1
+	ADDI $gp, 2, 0      # adds 0, removed
+	BGTZ $gp, 2, -3     # back to loop (the offset becomes -2)
+	ARI $sp, 2          # deallocate the two words
+back:	SRI $sp, 2          # removed with the ARI after it (but not before,
+	ARI $sp, 2          # as it has a label)
+	JMPA done           # goes straight to the end
+hop:	JMPA show
+show:	PINT $gp, 1         # print the count
+	RTN
+done:	JMPA end
+end:	EXIT 0
+	.data 1024
+	WORD zero = 0
+	WORD count = 0
+	WORD n = 0
+	.stack 4096
+	.end
@@ -0,0 +1,29 @@
+	# $Id$
+	# tests the reports about a program: it sums an array in a loop
+	# that is a measurement region, then allocates and frees a heap block
+	.text start
+start:	SRI $sp, 1
+	MBEG $gp, 6         # start the region "sum"
+	CPR $r3, $gp        # $r3 points to a[0]
+loop:	CPW $sp, 0, $gp, 4
+	ADD $gp, 4, $r3, 0  # sum += a[$r3]
+	ARI $r3, 1
+	ADDI $gp, 5, -1     # i--
+	BGTZ $gp, 5, -4     # repeat while i > 0
+	MEND $gp, 6
+	ALOC $gp, 0         # allocate a block of a[0] words
+	FREE $sp, 0
+	PINT $gp, 4         # print the sum
+	PSTR $gp, 8
+	EXIT 0
+	.data 1024
+	WORD a0 = 1
+	WORD a1 = 2
+	WORD a2 = 3
+	WORD a3 = 4
+	WORD sum = 0
+	WORD i = 4
+	STRING[2] Name = "sum"
+	STRING[1] Newline = "\n"
+	.stack 4096
+	.end
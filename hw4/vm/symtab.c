@@ -1,94 +1,261 @@
 /* $Id: symtab.c,v 1.4 2024/07/26 12:44:46 leavens Exp $ */
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 #include "symtab.h"
 #include "utilities.h"
 
-// For a data structure, we use an array (for now),
-// although a hash table might be better...
+// The entries are kept in an array, in the order they were inserted
+// (which is the order of iterations), and found by name using
+// a hash table of slots, each of which holds the index of an entry
+// (and its name's hash) or is empty.
+// The table uses open addressing with linear probing,
+// and is doubled when it becomes more than 3/4 full.
 
-// size is also the index of the next element to allocate
-static int size;
-// The data structure is such that the first size entries contain actual data
-static id_attrs_assoc entries[MAX_SYMTAB_SIZE];
+// the number of slots the table starts with (a power of 2)
+#define INITIAL_SLOTS 64
+// the size of the blocks that the names are copied into
+#define NAME_BLOCK_SIZE 8192
+
+// a slot in the hash table
+typedef struct {
+    unsigned int hash;  // the hash of the entry's name
+    int index;          // index of the entry, or -1 if the slot is empty
+} slot;
+
+// a block of chars into which names are copied (interned);
+// blocks are never moved, so pointers to the names stay valid
+typedef struct name_block_s {
+    struct name_block_s *next;
+    size_t used;
+    size_t size;
+    char chars[];
+} name_block;
+
+// a symbol table
+struct symtab_s {
+    // size is also the index of the next element to allocate
+    int size;
+    // The data structure is such that the first size entries
+    // contain actual data
+    id_attrs_assoc *entries;
+    int entries_capacity;
+    // the hash table (num_slots is 0 or a power of 2)
+    slot *slots;
+    int num_slots;
+    // the blocks holding the names, the most recently allocated first
+    name_block *names;
+    // the index of the entry whose name was last given by an iteration,
+    // so that the next step does not need to search for it
+    int iteration_index;
+};
+
+// Return the hash of name (FNV-1a)
+static unsigned int hash_name(const char *name)
+{
+    unsigned int h = 2166136261u;
+    for (const unsigned char *p = (const unsigned char *) name;
+	 *p != '\0'; p++) {
+	h = (h ^ *p) * 16777619u;
+    }
+    return h;
+}
 
 // The symbol table's invariant
-void symtab_okay()
+void symtab_okay(const symtab_t *tab)
 {
-    assert(0 <= size);
-    assert(size < MAX_SYMTAB_SIZE);
-    for (int i = size; i < MAX_SYMTAB_SIZE; i++) {
-	assert(entries[i].name == NULL);
+    assert(0 <= tab->size);
+    assert(tab->size <= tab->entries_capacity);
+    assert(4 * tab->size <= 3 * tab->num_slots);
+    int used = 0;
+    for (int i = 0; i < tab->num_slots; i++) {
+	if (tab->slots[i].index >= 0) {
+	    assert(tab->slots[i].index < tab->size);
+	    used++;
+	}
     }
+    assert(used == tab->size);
 }
 
-// initialize the symbol table
-void symtab_initialize()
+// Release the storage of the symbol table t (leaving it empty)
+static void symtab_free(symtab_t *t)
 {
-    size = 0; // no data yet
-    id_attrs_assoc none;
-    none.name = NULL;
-    none.file_loc = NULL;
-    none.addr = 0;
-    for (int i = 0; i < MAX_SYMTAB_SIZE; i++) {
-	entries[i] = none;
+    free(t->entries);
+    free(t->slots);
+    while (t->names != NULL) {
+	name_block *next = t->names->next;
+	free(t->names);
+	t->names = next;
     }
-    symtab_okay();
+    t->entries = NULL;
+    t->slots = NULL;
+    t->entries_capacity = t->num_slots = 0;
+    t->size = 0;
+    t->iteration_index = -1;
+}
+
+// Make tab empty (forgetting all of its mappings)
+void symtab_initialize(symtab_t *tab)
+{
+    symtab_free(tab);
+    symtab_okay(tab);
+}
+
+// Return a new, empty, symbol table
+// Exit the program with an error if there is no space.
+symtab_t *symtab_create()
+{
+    symtab_t *t = (symtab_t *) malloc(sizeof(symtab_t));
+    if (t == NULL) {
+	bail_with_error("No space to create a symtab!");
+    }
+    memset(t, 0, sizeof(symtab_t));
+    t->iteration_index = -1;
+    return t;
+}
+
+// Requires: t was returned by symtab_create
+// Release t and all of its storage
+void symtab_destroy(symtab_t *t)
+{
+    symtab_free(t);
+    free(t);
 }
 
 // Return the number of mappings in this symbol table
-unsigned int symtab_size() { return size; }
+unsigned int symtab_size(const symtab_t *tab) { return tab->size; }
 
 // Is this symbol table empty? (I.e., does it have not mappings?)
-bool symtab_empty() { return size == 0; }
+bool symtab_empty(const symtab_t *tab) { return tab->size == 0; }
 
 // Is this symbol table full? (I.e., can it not hold more mappings?)
-// (i.e., is symtab_size() equal to MAX_SYMTAB_SIZE-1)?
-bool symtab_full() { return size >= MAX_SYMTAB_SIZE; }
+// (This is always false, as the table grows as needed.)
+bool symtab_full(const symtab_t *tab) { return false; }
 
-// Is the given name associated with some attributes?
-bool symtab_defined(const char *name)
+// Is the given name associated with some attributes in tab?
+bool symtab_defined(symtab_t *tab, const char *name)
 {
-    id_attrs_assoc *v = symtab_lookup(name);
+    id_attrs_assoc *v = symtab_lookup(tab, name);
     return v != NULL;
 }    
 
-// Requires: !symtab_full
-// Requires: !symtab_defined(attrs.name)
-// Remember the given attributes (i.e., an association from attrs.name
-// to the other parts of attrs)
-void symtab_insert(id_attrs_assoc attrs)
+// Return the index of the slot for name, whose hash is h:
+// in tab: the one holding its entry, or else the empty slot where it would go
+static int find_slot(const symtab_t *tab, const char *name, unsigned int h)
 {
-    if (symtab_full()) {
-	bail_with_error("The symtab is full!");
+    assert(tab->num_slots > 0);
+    int mask = tab->num_slots - 1;
+    int i = h & mask;
+    while (tab->slots[i].index >= 0
+	   && (tab->slots[i].hash != h
+	       || strcmp(tab->entries[tab->slots[i].index].name, name) != 0)) {
+	i = (i + 1) & mask;
     }
-    entries[size++] = attrs;
+    return i;
+}
+
+// Make tab's hash table have new_slots slots (a power of 2),
+// putting the entries into their slots in it
+static void rehash(symtab_t *tab, int new_slots)
+{
+    slot *old = tab->slots;
+    int old_slots = tab->num_slots;
+    tab->slots = (slot *) malloc(new_slots * sizeof(slot));
+    if (tab->slots == NULL) {
+	bail_with_error("No space to grow the symtab to %d slots!", new_slots);
+    }
+    tab->num_slots = new_slots;
+    for (int i = 0; i < tab->num_slots; i++) {
+	tab->slots[i].index = -1;
+    }
+    int mask = tab->num_slots - 1;
+    for (int i = 0; i < old_slots; i++) {
+	if (old[i].index >= 0) {
+	    int j = old[i].hash & mask;
+	    while (tab->slots[j].index >= 0) {
+		j = (j + 1) & mask;
+	    }
+	    tab->slots[j] = old[i];
+	}
+    }
+    free(old);
+}
+
+// Return tab's own copy of name
+static const char *intern_name(symtab_t *tab, const char *name)
+{
+    size_t len = strlen(name) + 1;
+    if (tab->names == NULL || tab->names->size - tab->names->used < len) {
+	size_t block_size = (len > NAME_BLOCK_SIZE) ? len : NAME_BLOCK_SIZE;
+	name_block *b = (name_block *) malloc(sizeof(name_block) + block_size);
+	if (b == NULL) {
+	    bail_with_error("No space to store the name \"%s\" in the symtab!",
+			    name);
+	}
+	b->next = tab->names;
+	b->used = 0;
+	b->size = block_size;
+	tab->names = b;
+    }
+    char *copy = tab->names->chars + tab->names->used;
+    memcpy(copy, name, len);
+    tab->names->used += len;
+    return copy;
+}
+
+// Requires: !symtab_defined(tab, attrs.name)
+// Remember in tab the given attributes (i.e., an association
+// from attrs.name to the other parts of attrs), with the name replaced by
+// the symbol table's own copy of it
+void symtab_insert(symtab_t *tab, id_attrs_assoc attrs)
+{
+    if (4 * (tab->size + 1) > 3 * tab->num_slots) {
+	rehash(tab, (tab->num_slots == 0) ? INITIAL_SLOTS : 2 * tab->num_slots);
+    }
+    if (tab->size == tab->entries_capacity) {
+	int cap = (tab->entries_capacity == 0) ? INITIAL_SLOTS
+	    : 2 * tab->entries_capacity;
+	id_attrs_assoc *p = (id_attrs_assoc *)
+	    realloc(tab->entries, cap * sizeof(id_attrs_assoc));
+	if (p == NULL) {
+	    bail_with_error("No space to grow the symtab to %d entries!", cap);
+	}
+	tab->entries = p;
+	tab->entries_capacity = cap;
+    }
+    unsigned int h = hash_name(attrs.name);
+    int i = find_slot(tab, attrs.name, h);
+    assert(tab->slots[i].index < 0);
+    attrs.name = intern_name(tab, attrs.name);
+    tab->slots[i].hash = h;
+    tab->slots[i].index = tab->size;
+    tab->entries[tab->size++] = attrs;
 }
 
 // if name == NULL or if name is not defined, return -1
-// if name is defined in the table, return its index
-static int find_index(const char *name)
+// if name is defined in tab, return its index
+static int find_index(const symtab_t *tab, const char *name)
 {
-    if (name == NULL) {
+    if (name == NULL || tab->size == 0) {
 	return -1;
     }
-    for (int i = 0; i < size; i++) {
-	if (strcmp(entries[i].name, name) == 0) {
-	    return i;
-	}
+    // iterations ask about the name they last gave out
+    if (0 <= tab->iteration_index && tab->iteration_index < tab->size
+	&& tab->entries[tab->iteration_index].name == name) {
+	return tab->iteration_index;
     }
-    return -1;
+    return tab->slots[find_slot(tab, name, hash_name(name))].index;
 }
 
 
-// Return (a pointer to) the attributes of the given name
+// Return (a pointer to) the attributes of the given name in tab
 // or NULL if there is no association for that name.
-id_attrs_assoc *symtab_lookup(const char *name)
+id_attrs_assoc *symtab_lookup(symtab_t *tab, const char *name)
 {
-    int i = find_index(name);
+    int i = find_index(tab, name);
     if (0 <= i) {
-	return &entries[i];
+	return &tab->entries[i];
     } else {
 	return NULL;
     }
@@ -97,35 +264,37 @@ id_attrs_assoc *symtab_lookup(const char *name)
 // iteration helpers
 // iterations use an external key which is a name
 
-// Start an iteration by returning the first name in the symbol table,
-// return NULL if symtab_empty()
-const char *symtab_first_name()
+// Start an iteration by returning the first name in tab,
+// return NULL if symtab_empty(tab)
+const char *symtab_first_name(symtab_t *tab)
 {
-    if (symtab_empty()) {
+    if (symtab_empty(tab)) {
 	return NULL;
     }
-    assert(0 < size);
-    return entries[0].name;
+    assert(0 < tab->size);
+    tab->iteration_index = 0;
+    return tab->entries[0].name;
 }
 
-// Are there more names defined in the symbol table after the given one?
+// Are there more names defined in tab after the given one?
 // This returns false if name is NULL, if name is not defined,
-// or if there are no more names following name in the symbol table
-bool symtab_more_after(const char *name)
+// or if there are no more names following name in tab
+bool symtab_more_after(const symtab_t *tab, const char *name)
 {
-    int i = find_index(name);
-    return (0 <= i && i < size);
+    int i = find_index(tab, name);
+    return (0 <= i && i < tab->size);
 }
 
-// Requires: symtab_more_after(name);
-// Return the next name defined in the symbol table after the given one,
+// Requires: symtab_more_after(tab, name);
+// Return the next name defined in tab after the given one,
 // but return NULL if there are no more names
-const char *symtab_next_name(const char *name)
+const char *symtab_next_name(symtab_t *tab, const char *name)
 {
-    int i = find_index(name);
-    if (i < 0 || i >= size) {
+    int i = find_index(tab, name);
+    if (i < 0 || i + 1 >= tab->size) {
 	return NULL;
     } else {
-	return entries[i+1].name;
+	tab->iteration_index = i + 1;
+	return tab->entries[i+1].name;
     }
 }
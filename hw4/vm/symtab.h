@@ -5,45 +5,63 @@
 #include <stdbool.h>
 #include "id_attrs_assoc.h"
 
-// Maximum number of names/attributes that can be stored in a symboltable
-#define MAX_SYMTAB_SIZE 1024
+// The symbol table is a hash table (with open addressing) that grows
+// as needed, so it has no fixed size, and whose lookups take
+// constant time (on average).  It keeps its own copies of the names
+// (interned, so each is stored once), and its iterations
+// give the names in the order they were inserted.
+// Each table is made by symtab_create and given to the functions below,
+// so a program can have many tables (e.g., one for each program it
+// assembles) and tables in different threads never share any state.
 
-// initialize the symbol table
-extern void symtab_initialize();
+// a symbol table
+typedef struct symtab_s symtab_t;
+
+// Make tab empty (forgetting all of its mappings)
+extern void symtab_initialize(symtab_t *tab);
 
 // Return the number of mappings in this symbol table
-extern unsigned int symtab_size();
+extern unsigned int symtab_size(const symtab_t *tab);
 
 // Is this symbol table empty? (I.e., does it have not mappings?)
-extern bool symtab_empty();
+extern bool symtab_empty(const symtab_t *tab);
 
 // Is this symbol table full? (I.e., can it not hold more mappings?)
-// (i.e., is symtab_size() equal to MAX_SYMTAB_SIZE-1)?
-extern bool symtab_full();
+// (This is always false, as the table grows as needed.)
+extern bool symtab_full(const symtab_t *tab);
 
-// Is the given name associated with some attributes?
-extern bool symtab_defined(const char *name);
+// Is the given name associated with some attributes in tab?
+extern bool symtab_defined(symtab_t *tab, const char *name);
 
-// Requires: !symtab_full
-// Requires: !symtab_defined(attrs.name)
-// Remember the given attributes (i.e., an association from attrs.name
-// to the other parts of attrs)
-extern void symtab_insert(id_attrs_assoc attrs);
+// Requires: !symtab_defined(tab, attrs.name)
+// Remember in tab the given attributes (i.e., an association
+// from attrs.name to the other parts of attrs), with the name replaced by
+// the symbol table's own copy of it
+extern void symtab_insert(symtab_t *tab, id_attrs_assoc attrs);
 
-// Return a pointer to the attributes of the given name
+// Return a pointer to the attributes of the given name in tab
 // or NULL if there is no association for that name.
-extern id_attrs_assoc *symtab_lookup(const char *name);
+// The pointer is valid until the next symtab_insert or symtab_initialize.
+extern id_attrs_assoc *symtab_lookup(symtab_t *tab, const char *name);
 
-// Start an iteration by returning the first name in the symbol table,
-// return NULL if symtab_empty()
-extern const char *symtab_first_name();
+// Start an iteration by returning the first name in tab,
+// return NULL if symtab_empty(tab)
+extern const char *symtab_first_name(symtab_t *tab);
 
-// Are there more names defined in the symbol table after the given one?
+// Are there more names defined in tab after the given one?
 // This returns false if name is NULL.
-extern bool symtab_more_after(const char *name);
+extern bool symtab_more_after(const symtab_t *tab, const char *name);
 
-// Requires: symtab_more_after(name);
-// Return the next name defined in the symbol table after the given one,
+// Requires: symtab_more_after(tab, name);
+// Return the next name defined in tab after the given one,
 // but return NULL if there are no more names
-extern const char *symtab_next_name(const char *name);
+extern const char *symtab_next_name(symtab_t *tab, const char *name);
+
+// Return a new, empty, symbol table
+// Exit the program with an error if there is no space.
+extern symtab_t *symtab_create();
+
+// Requires: t was returned by symtab_create
+// Release t and all of its storage
+extern void symtab_destroy(symtab_t *t);
 #endif
@@ -0,0 +1,22 @@
+	# $Id$
+	# tests that an error in a spawned thread stops the program,
+	# and is reported after the reports about the program are printed
+	# (so the main thread, which waits for the spawned one, does not go on)
+	.text start
+start:	SRI $sp, 1
+	ALOC $gp, 3         # allocate a block of 5 words, which is not freed
+	SPWN $gp, 0         # start the thread at thread, with its stack at 2000
+	CPW $gp, 2, $sp, 0  # save its thread number
+	JOIN $gp, 2
+	PSTR $gp, 4         # not reached
+	EXIT 0
+thread:	FREE $gp, 3         # 5 is not an allocated block
+	EXIT 0
+	.data 1024
+	WORD entry = 7
+	WORD stack = 2000
+	WORD tid = 0
+	WORD five = 5
+	STRING[2] Joined = "Joined\n"
+	.stack 4096
+	.end
@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <assert.h>
+#include <setjmp.h>
 #include "file_location.h"
 
 #define MAX(x,y) (((x)>(y))?(x):(y))
@@ -14,8 +15,53 @@
 // This function returns normally.
 void debug_print(const char *fmt, ...);
 
+// the size of an error context's buffer for an error message
+#define ERROR_MESSAGE_SIZE 2048
+
+// An error context lets a caller recover from the errors reported by
+// bail_with_error, bail_with_prog_error, and bail_with_exit_code,
+// which otherwise exit the program. It is used as follows:
+//     error_context ec;
+//     error_context_enter(&ec);
+//     if (setjmp(ec.env) == 0) {
+//         ... // work that may report an error
+//         error_context_leave(&ec);
+//     } else {
+//         ... // recover from the error described by ec
+//     }
+// Reporting an error leaves the innermost error context
+// (of the reporting thread) and returns from its setjmp call again,
+// this time with a nonzero value.
+// Error contexts nest, and each thread has its own.
+// A module that must release something when an error passes through it
+// can enter its own error context, release it, and then propagate the error.
+typedef struct error_context_s {
+    jmp_buf env;
+    // the exit code that the error would have caused
+    int status;
+    // the error's message (empty if it has none),
+    // as it would have been printed on stderr
+    char message[ERROR_MESSAGE_SIZE];
+    // the error context that was innermost when this one was entered
+    struct error_context_s *enclosing;
+} error_context;
+
+// Make ec the calling thread's innermost error context
+extern void error_context_enter(error_context *ec);
+
+// Requires: ec is the calling thread's innermost error context
+// Leave ec, making the error context it was entered in innermost again
+extern void error_context_leave(error_context *ec);
+
+// Requires: ec caught an error
+// Report that error again, to the calling thread's innermost error context,
+// so a call to this does not return.
+extern void error_context_propagate(const error_context *ec);
+
 // Format a string error message and print it using perror (for an OS error)
 // then exit with a failure code, so a call to this does not return.
+// If there is an error context, the message and failure code
+// are given to it instead (see above).
 extern void bail_with_error(const char *fmt, ...);
 
 // Print an error message on stderr
@@ -23,8 +69,15 @@ extern void bail_with_error(const char *fmt, ...);
 // (prints: filename, a colon, " line ", the line number, and a space)
 // and then the message.
 // Then exit with a failure code, so this function does not return.
+// If there is an error context, the message and failure code
+// are given to it instead (see above).
 extern void bail_with_prog_error(file_location floc, const char *fmt, ...);
 
+// Exit with the given exit code (without printing any message),
+// so this function does not return.
+// If there is an error context, the exit code is given to it instead.
+extern void bail_with_exit_code(int status);
+
 // print a newline on out and flush out
 extern void newline(FILE *out);
 
@@ -0,0 +1,42 @@
+	# $Id$
+	# benchmark: 2000 rounds of a recursive procedure, down,
+	# that calls itself to a depth of 1000,
+	# saving and restoring its return address on the stack;
+	# each activation also pushes a 0 for BEQ and BNE to test against
+	# (so no other conditional branches are used)
+	.text start
+start:	NOTR
+	LIT $sp, 0, 0       # top of stack is 0
+	CPW $gp, 0, $gp, 4  # rounds = numRounds
+round:	CPW $gp, 1, $gp, 5  # depth = maxDepth
+	CALL down
+	ADDI $gp, 0, -1     # rounds--
+	BNE $gp, 0, -3      # repeat while rounds != 0
+	CPW $sp, 0, $gp, 2  # check the number of calls
+	BEQ $gp, 3, 2
+	JMPA wrong
+	PSTR $gp, 6
+	EXIT 0
+wrong:	PSTR $gp, 8
+	EXIT 1
+down:	SRI $sp, 2          # push $ra and a 0
+	SWR $sp, 1, $ra
+	LIT $sp, 0, 0
+	ADDI $gp, 2, 1      # calls++
+	ADDI $gp, 1, -1     # depth--
+	BEQ $gp, 1, 2       # skip the recursive call if depth == 0
+	CALL down
+	LWR $ra, $sp, 1     # pop them
+	ARI $sp, 2
+	RTN
+	.data 1024
+	WORD rounds
+	WORD depth
+	WORD calls = 0
+	WORD expected = 2000000
+	WORD numRounds = 2000
+	WORD maxDepth = 1000
+	STRING[2] Passed = "Passed\n"
+	STRING[2] Wrong = "Wrong\n"
+	.stack 4096
+	.end
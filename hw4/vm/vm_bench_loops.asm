@@ -0,0 +1,37 @@
+	# $Id$
+	# benchmark: three nested counting loops (100 x 200 x 200 iterations),
+	# adding 3 to a sum in memory on each iteration of the innermost loop;
+	# the loops test their counters with BNE against the 0 on top of the stack
+	# (and so use no other conditional branches)
+	.text start
+start:	NOTR
+	LIT $sp, 0, 0       # top of stack is 0
+	LIT $gp, 3, 0       # sum = 0
+	CPW $gp, 0, $gp, 5  # i = numOuter
+outer:	LIT $gp, 1, 200     # j = 200
+middle:	LIT $gp, 2, 200     # k = 200
+inner:	ADDI $gp, 3, 3      # sum += 3
+	ADDI $gp, 2, -1     # k--
+	BNE $gp, 2, -2      # repeat inner while k != 0
+	ADDI $gp, 1, -1     # j--
+	BNE $gp, 1, -5      # repeat middle while j != 0
+	ADDI $gp, 0, -1     # i--
+	BNE $gp, 0, -8      # repeat outer while i != 0
+	CPW $sp, 0, $gp, 3  # check the sum
+	BEQ $gp, 4, 2
+	JMPA wrong
+	PSTR $gp, 6
+	EXIT 0
+wrong:	PSTR $gp, 8
+	EXIT 1
+	.data 1024
+	WORD i
+	WORD j
+	WORD k
+	WORD sum
+	WORD expected = 12000000
+	WORD numOuter = 100
+	STRING[2] Passed = "Passed\n"
+	STRING[2] Wrong = "Wrong\n"
+	.stack 4096
+	.end
@@ -0,0 +1,29 @@
+	# $Id$
+	# benchmark: prints 100000 lines, each the digits 0 to 9 followed by
+	# a short string, mostly one character at a time;
+	# the loops test their counters with BNE against the 0 on top of the stack,
+	# which has to be reset after each print, as printing overwrites it
+	.text start
+start:	NOTR
+	LIT $sp, 0, 0       # top of stack is 0
+	CPW $gp, 0, $gp, 3  # lines = numLines
+line:	LIT $gp, 1, 48      # c = '0'
+	LIT $gp, 2, 10      # n = 10
+digit:	PCH $gp, 1          # print c
+	LIT $sp, 0, 0
+	ADDI $gp, 1, 1      # c++
+	ADDI $gp, 2, -1     # n--
+	BNE $gp, 2, -4      # repeat digit while n != 0
+	PSTR $gp, 4         # print " line\n"
+	LIT $sp, 0, 0
+	ADDI $gp, 0, -1     # lines--
+	BNE $gp, 0, -10     # repeat line while lines != 0
+	EXIT 0
+	.data 1024
+	WORD lines
+	WORD c
+	WORD n
+	WORD numLines = 100000
+	STRING[2] suffix = " line\n"
+	.stack 4096
+	.end
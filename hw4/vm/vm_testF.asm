@@ -0,0 +1,26 @@
+	# $Id$
+	# tests the bulk output system calls PCHS and PBYT
+	.text 0
+	SRI $sp, 1          # allocate a word on the stack for the counts
+	LIT $sp, 0, 3       # print 3 chars, one per word
+	PCHS $gp, 0
+	BEQ $gp, 3, 2      # PCHS leaves the count printed on top of the stack
+	JMPA wrong
+	LIT $sp, 0, 8       # print the 8 bytes of "Passed!\n"
+	PBYT $gp, 4
+	BEQ $gp, 10, 2
+	JMPA wrong
+	EXIT 0
+wrong:	LIT $sp, 0, 7
+	PBYT $gp, 7
+	EXIT 1
+	.data 1024
+	CHAR h = 'H'
+	CHAR i = 'i'
+	CHAR nl = '\n'
+	WORD three = 3
+	STRING[3] Passed = "Passed!\n"
+	STRING[3] Wrong = "Wrong!\n"
+	WORD eight = 8
+	.stack 4096
+	.end
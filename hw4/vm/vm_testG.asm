@@ -0,0 +1,39 @@
+	# $Id$
+	# tests the block copy (BCP) and block fill (BFL) instructions
+	.text 0
+	SRI $sp, 1          # allocate a word on the stack for the counts
+	LIT $sp, 0, 4
+	BCP $gp, 4, $gp, 0  # copy a..d to e..h
+	LIT $sp, 0, 3
+	BCP $gp, 1, $gp, 0  # overlapping copy, a..d become 1, 1, 2, 3
+	LIT $sp, 0, 9
+	BFL $gp, 8, 3       # store 9 in x, y, and z
+	LIT $sp, 0, 3
+	BEQ $gp, 3, 2       # d should now be 3
+	JMPA wrong
+	LIT $sp, 0, 4
+	BEQ $gp, 7, 2       # h should be 4
+	JMPA wrong
+	LIT $sp, 0, 9
+	BEQ $gp, 10, 2      # z should be 9
+	JMPA wrong
+	PSTR $gp, 11
+	EXIT 0
+wrong:	PSTR $gp, 13
+	EXIT 1
+	.data 1024
+	WORD a = 1
+	WORD b = 2
+	WORD c = 3
+	WORD d = 4
+	WORD e
+	WORD f
+	WORD g
+	WORD h
+	WORD x
+	WORD y
+	WORD z
+	STRING[2] Passed = "Passed\n"
+	STRING[2] Wrong = "Wrong\n"
+	.stack 4096
+	.end
@@ -0,0 +1,44 @@
+	# $Id$
+	# tests the thread (SPWN, JOIN) and atomic (FADD, CAS) system calls
+	.text 0
+	NOTR                # tracing output from threads would be interleaved
+	SRI $sp, 1
+	SPWN $gp, 0         # start a thread at memory[$gp+0], stack memory[$gp+1]
+	CPW $gp, 4, $sp, 0  # save its thread number in tid1
+	SPWN $gp, 2
+	CPW $gp, 5, $sp, 0
+	JOIN $gp, 4
+	JOIN $gp, 5
+	LIT $sp, 0, 2000
+	BEQ $gp, 6, 2       # each thread added 1000 to count
+	JMPA wrong
+	SRI $sp, 1
+	LIT $sp, 1, 7       # the new value for CAS
+	LIT $sp, 0, 2000    # the expected value for CAS
+	CAS $gp, 6
+	LIT $sp, 0, 7
+	BEQ $gp, 6, 2       # count should now be 7
+	JMPA wrong
+	PSTR $gp, 7
+	EXIT 0
+wrong:	PSTR $gp, 9
+	EXIT 1
+adder:	SRI $sp, 2
+	LIT $sp, 1, 1000    # loop counter
+	LIT $sp, 0, 1
+	FADD $gp, 6         # atomically add 1 to count
+	ADDI $sp, 1, -1
+	BGTZ $sp, 1, -3
+	EXIT 0
+	.data 1024
+	WORD start1 = 22
+	WORD stack1 = 3000
+	WORD start2 = 22
+	WORD stack2 = 2000
+	WORD tid1
+	WORD tid2
+	WORD count
+	STRING[2] Passed = "Passed\n"
+	STRING[2] Wrong = "Wrong\n"
+	.stack 4096
+	.end
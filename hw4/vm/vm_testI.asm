@@ -0,0 +1,30 @@
+	# $Id$
+	# tests the coroutine system calls COCR, RSM, and YLD
+	.text 0
+	SRI $sp, 1
+	COCR $gp, 0         # create a producer, start memory[$gp], stack memory[$gp+1]
+	CPW $gp, 2, $sp, 0  # save its number in prod
+	RSM $gp, 2          # run the producer until it yields
+	PINT $gp, 3         # prints 1
+	RSM $gp, 2
+	PINT $gp, 3         # prints 2
+	YLD                 # the producer is the only other coroutine
+	PINT $gp, 3         # prints 3
+	RSM $gp, 2          # the producer finishes, so control comes back here
+	PCH $gp, 4
+	EXIT 0
+producer:	ADDI $gp, 3, 1
+	YLD
+	ADDI $gp, 3, 1
+	YLD
+	ADDI $gp, 3, 1
+	YLD
+	EXIT 0
+	.data 1024
+	WORD start = 12
+	WORD stack = 3000
+	WORD prod
+	WORD value
+	CHAR nl = '\n'
+	.stack 4096
+	.end
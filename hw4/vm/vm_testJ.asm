@@ -0,0 +1,44 @@
+	# $Id$
+	# tests the heap allocation system calls ALOC, FREE, and RSZ
+	.text 0
+	SRI $sp, 1          # allocate a word on the stack for the addresses
+	ALOC $gp, 0         # allocate 3 words
+	CPW $gp, 3, $sp, 0  # save the address in p1
+	ALOC $gp, 0
+	CPW $gp, 4, $sp, 0  # save the address in p2
+	BNE $gp, 3, 2       # the blocks should be different
+	JMPA wrong
+	FREE $gp, 3
+	ALOC $gp, 0         # the freed block should be reused
+	BEQ $gp, 3, 2
+	JMPA wrong
+	LIT $sp, 0, 100
+	RSZ $gp, 4          # grow p2 to 100 words, which moves it
+	CPW $gp, 5, $sp, 0  # save the new address in p3
+	BNE $gp, 4, 2
+	JMPA wrong
+	LIT $sp, 0, 90
+	RSZ $gp, 5          # shrinking within the size class stays in place
+	BEQ $gp, 5, 2
+	JMPA wrong
+	ALOC $gp, 1         # too big to allocate
+	BEQ $gp, 2, 2
+	JMPA wrong
+	FREE $gp, 5
+	FREE $gp, 3
+	FREE $gp, 2         # freeing address 0 does nothing
+	PSTR $gp, 6
+	EXIT 0
+wrong:	PSTR $gp, 8
+	EXIT 1
+	.data 1024
+	WORD three = 3
+	WORD big = 20000
+	WORD zero = 0
+	WORD p1
+	WORD p2
+	WORD p3
+	STRING[2] Passed = "Passed\n"
+	STRING[2] Wrong = "Wrong\n"
+	.stack 4096
+	.end
@@ -0,0 +1,44 @@
+	# $Id$
+	# tests the register ALU and register branch instructions
+	.text 0
+	LWR $r3, $gp, 0     # $r3 = 6
+	LWR $r4, $gp, 1     # $r4 = 7
+	RMUL $r5, $r3, $r4  # $r5 = 42
+	RADD $r5, $r5, $r3  # $r5 = 48
+	RSUB $r5, $r5, $r4  # $r5 = 41
+	RDIV $r6, $r5, $r3  # $r6 = 6
+	BREQ $r6, $r3, 2
+	JMPA wrong
+	RSLT $r6, $r3, $r4  # $r6 = 1
+	RSLT $r5, $r4, $r3  # $r5 = 0
+	BRGT $r6, $r5, 2
+	JMPA wrong
+	RAND $r5, $r3, $r4  # $r5 = 6
+	BRNE $r5, $r3, 2
+	RBOR $r5, $r3, $r4  # $r5 = 7
+	BRGE $r5, $r4, 2
+	JMPA wrong
+	RXOR $r5, $r5, $r5  # $r5 = 0
+	RXOR $r6, $r6, $r6  # $r6 = 0
+	ARI $r6, 1          # sum 1 to 7 in $r5
+	RADD $r5, $r5, $r6
+	BRLT $r6, $r4, -2
+	BRLE $r6, $r4, 2    # the loop ends with $r6 = 7
+	JMPA wrong
+	SWR $gp, 2, $r5
+	SRI $sp, 1
+	LIT $sp, 0, 28
+	BEQ $gp, 2, 2
+	JMPA wrong
+	PSTR $gp, 3
+	EXIT 0
+wrong:	PSTR $gp, 5
+	EXIT 1
+	.data 1024
+	WORD a = 6
+	WORD b = 7
+	WORD sum
+	STRING[2] Passed = "Passed\n"
+	STRING[2] Wrong = "Wrong\n"
+	.stack 4096
+	.end
@@ -0,0 +1,41 @@
+	# $Id$
+	# tests the bulk input system calls RLN and RBYT,
+	# reading vm_testL.in, including reads of no chars or bytes
+	.text 0
+	SRI $sp, 1          # allocate a word on the stack for the counts
+	LIT $sp, 0, 8       # read a line of at most 8 chars, one per word
+	RLN $gp, 0
+	BEQ $gp, 8, 2       # RLN leaves the count read ("Hi\n") on top of the stack
+	JMPA wrong
+	LIT $sp, 0, 0       # read no chars
+	RLN $gp, 4
+	BEQ $gp, 9, 2
+	JMPA wrong
+	LIT $sp, 0, 6       # read the 6 bytes of "bytes!"
+	RBYT $gp, 5
+	BEQ $gp, 10, 2      # RBYT leaves the count read on top of the stack
+	JMPA wrong
+	LIT $sp, 0, 0       # read no bytes
+	RBYT $gp, 7
+	BEQ $gp, 9, 2
+	JMPA wrong
+	LIT $sp, 0, 3       # print the line
+	PCHS $gp, 0
+	LIT $sp, 0, 6       # and the bytes
+	PBYT $gp, 5
+	EXIT 0
+wrong:	EXIT 1
+	.data 1024
+	WORD c0 = 0
+	WORD c1 = 0
+	WORD c2 = 0
+	WORD c3 = 0
+	WORD none = 0
+	WORD b0 = 0
+	WORD b1 = 0
+	WORD nobytes = 0
+	WORD three = 3
+	WORD zero = 0
+	WORD six = 6
+	.stack 4096
+	.end
@@ -0,0 +1,12 @@
+	# $Id$
+	# tests that RLN reports a count of words that goes past the memory
+	.text 0
+	SRI $sp, 1
+	CPW $sp, 0, $gp, 1  # read a line of at most 32768 chars
+	RLN $gp, 0
+	EXIT 1
+	.data 1024
+	WORD line = 0
+	WORD big = 32768
+	.stack 4096
+	.end
@@ -0,0 +1,11 @@
+	# $Id$
+	# tests that RBYT reports a negative count of bytes
+	.text 0
+	SRI $sp, 1
+	LIT $sp, 0, -1      # read -1 bytes
+	RBYT $gp, 0
+	EXIT 1
+	.data 1024
+	WORD buf = 0
+	.stack 4096
+	.end
@@ -0,0 +1,12 @@
+	# $Id$
+	# tests that RBYT reports a count of bytes that goes past the memory
+	.text 0
+	SRI $sp, 1
+	CPW $sp, 0, $gp, 1  # read 126977 bytes, one more than fit
+	RBYT $gp, 0
+	EXIT 1
+	.data 1024
+	WORD buf = 0
+	WORD big = 126977
+	.stack 4096
+	.end
@@ -0,0 +1,11 @@
+	# $Id$
+	# tests that SPWN reports a stack bottom address in the global data
+	.text 0
+	SRI $sp, 1
+	SPWN $gp, 0         # start a thread at memory[$gp+0], stack memory[$gp+1]
+	EXIT 1
+	.data 1024
+	WORD start = 2
+	WORD stack = 1025
+	.stack 4096
+	.end
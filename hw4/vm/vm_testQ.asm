@@ -0,0 +1,10 @@
+	# $Id$
+	# tests that CAS reports a new value (below its top of stack) that is
+	# outside the memory
+	.text 0
+	CAS $gp, 0          # the new value would be at memory[32768]
+	EXIT 1
+	.data 1024
+	WORD x = 0
+	.stack 32767
+	.end
@@ -0,0 +1,38 @@
+	# $Id$
+	# tests that the heap does not grow into the stack of another thread
+	# (ALOC fails while the spawned thread runs, but not once it has finished)
+	.text start
+start:	NOTR                # the thread's waiting would make the trace vary
+	SRI $sp, 1
+	SPWN $gp, 0         # start the thread at wait, with its stack at 2000
+	CPW $gp, 3, $sp, 0  # save its thread number
+	ALOC $gp, 4         # 1024 words would run into the thread's stack
+	BEQ $gp, 5, 2       # so ALOC gives 0
+	JMPA wrong
+	LIT $sp, 0, 1       # let the thread finish, by setting the flag
+	FADD $gp, 2
+	JOIN $gp, 3
+	ALOC $gp, 4         # now there is room
+	BNE $gp, 5, 2
+	JMPA wrong
+	PSTR $gp, 6
+	EXIT 0
+wrong:	PSTR $gp, 8
+	EXIT 1
+thread:	SRI $sp, 1
+wait:	LIT $sp, 0, 0       # wait until the flag is set
+	FADD $gp, 2         # (which is read atomically, by adding 0 to it)
+	BGTZ $sp, 0, 2
+	JMPA wait
+	EXIT 0
+	.data 1024
+	WORD entry = 17
+	WORD stack = 2000
+	WORD flag = 0
+	WORD tid = 0
+	WORD size = 1024
+	WORD zero = 0
+	STRING[2] Passed = "Passed\n"
+	STRING[2] Wrong = "Wrong\n"
+	.stack 4096
+	.end
@@ -0,0 +1,38 @@
+	# $Id$
+	# tests that register arithmetic and DIV wrap around on overflow,
+	# printing -2147483648, 0, 2147418112, -2147483648, and -2147483648
+	.text 0
+	LWR $r3, $gp, 0     # $r3 = -2147483648
+	LWR $r4, $gp, 1     # $r4 = -1
+	LWR $r5, $gp, 2     # $r5 = 65536
+	RDIV $r6, $r3, $r4  # $r6 = -2147483648
+	SWR $gp, 3, $r6
+	PINT $gp, 3
+	PCH $gp, 4
+	RMUL $r6, $r5, $r5  # $r6 = 0 (2^32 wraps around)
+	SWR $gp, 3, $r6
+	PINT $gp, 3
+	PCH $gp, 4
+	RSUB $r6, $r3, $r5  # $r6 = 2147418112
+	SWR $gp, 3, $r6
+	PINT $gp, 3
+	PCH $gp, 4
+	RADD $r6, $r6, $r5  # $r6 = -2147483648
+	SWR $gp, 3, $r6
+	PINT $gp, 3
+	PCH $gp, 4
+	SRI $sp, 1
+	CPW $sp, 0, $gp, 0
+	DIV $gp, 1          # LO = -2147483648, HI = 0
+	CFLO $gp, 3
+	PINT $gp, 3
+	PCH $gp, 4
+	EXIT 0
+	.data 1024
+	WORD min = -2147483648
+	WORD minus1 = -1
+	WORD big = 65536
+	WORD result = 0
+	CHAR nl = '\n'
+	.stack 4096
+	.end
@@ -0,0 +1,15 @@
+	# $Id$
+	# tests that an instruction that the program stores into is run
+	# as what was stored, not as what was loaded (so it prints Passed)
+	.text start
+start:	CPW $r3, 2, $r3, 4  # copy the instruction at 4 over the one at 2
+	NOP
+	PSTR $gp, 2         # replaced by PSTR $gp, 0
+	EXIT 0
+	PSTR $gp, 0
+	EXIT 1
+	.data 1024
+	STRING[2] Passed = "Passed\n"
+	STRING[2] Wrong = "Wrong\n"
+	.stack 4096
+	.end
@@ -0,0 +1,11 @@
+	# $Id$
+	# tests that a measurement region's name is not read past the end
+	# of memory (the last word holds "abcd", with no null char)
+	.text 0
+	CPW $sp, 0, $gp, 0  # copy the name's chars into memory[32767]
+	MBEG $sp, 0
+	EXIT 1
+	.data 1024
+	WORD abcd = 1684234849
+	.stack 32767
+	.end
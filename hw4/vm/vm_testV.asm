@@ -0,0 +1,9 @@
+	# $Id$
+	# tests that FADD reports a word to add to that is outside the memory
+	.text 0
+	FADD $sp, 1         # the word would be at memory[32768]
+	EXIT 1
+	.data 1024
+	WORD x = 0
+	.stack 32767
+	.end
@@ -0,0 +1,32 @@
+	# $Id$
+	# tests that the heap does not grow into the stack of a suspended coroutine
+	# (ALOC fails while the coroutine is suspended, but not once it has finished)
+	.text start
+start:	SRI $sp, 1
+	COCR $gp, 0         # create a coroutine at low, with its stack at 2000
+	CPW $gp, 2, $sp, 0  # save its number
+	RSM $gp, 2          # run it until it yields, with its stack below 2000
+	ALOC $gp, 3         # 1024 words would run into the coroutine's stack
+	BEQ $gp, 4, 2       # so ALOC gives 0
+	JMPA wrong
+	RSM $gp, 2          # let the coroutine finish
+	ALOC $gp, 3         # now there is room
+	BNE $gp, 4, 2
+	JMPA wrong
+	PSTR $gp, 5
+	EXIT 0
+wrong:	PSTR $gp, 7
+	EXIT 1
+low:	SRI $sp, 2          # push two words
+	YLD
+	EXIT 0
+	.data 1024
+	WORD entry = 15
+	WORD stack = 2000
+	WORD conum = 0
+	WORD size = 1024
+	WORD zero = 0
+	STRING[2] Passed = "Passed\n"
+	STRING[2] Wrong = "Wrong\n"
+	.stack 4096
+	.end